@@ -0,0 +1,96 @@
+//
+//  Skinning.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <TaggedFormat/Skinning.hpp>
+#include <TaggedFormat/Animation.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace TaggedFormat;
+
+// Rigid transforms with uniform scale, and vertices influenced by up to four of them:
+static void skinning_scene(std::size_t bone_count, std::size_t vertex_count, std::vector<float32> & palette, std::vector<VertexP3N3M2B4> & vertices) {
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<float32> unit(-1, 1);
+	std::uniform_int_distribution<int> bone(0, bone_count - 1);
+
+	palette.resize(bone_count * 16);
+
+	for (std::size_t i = 0; i < bone_count; i += 1) {
+		Transform transform = {{unit(generator), unit(generator), unit(generator), 0}, {unit(generator), unit(generator), unit(generator), unit(generator)}, {0, 0, 0, 0}};
+
+		float32 length = std::sqrt(transform.rotation[0] * transform.rotation[0] + transform.rotation[1] * transform.rotation[1] + transform.rotation[2] * transform.rotation[2] + transform.rotation[3] * transform.rotation[3]);
+		for (std::size_t k = 0; k < 4; k += 1) transform.rotation[k] /= length;
+
+		float32 scale = 1 + unit(generator) * 0.5f;
+		for (std::size_t k = 0; k < 3; k += 1) transform.scale[k] = scale;
+
+		Animation::compose(transform, palette.data() + i * 16);
+	}
+
+	vertices.resize(vertex_count);
+
+	for (auto & vertex : vertices) {
+		float32 total = 0;
+
+		for (std::size_t k = 0; k < 3; k += 1) {
+			vertex.position[k] = unit(generator) * 10;
+			vertex.normal[k] = unit(generator);
+		}
+
+		for (std::size_t k = 0; k < 4; k += 1) {
+			vertex.bones[k] = bone(generator);
+			vertex.weights[k] = unit(generator) + 1;
+			total += vertex.weights[k];
+		}
+
+		for (std::size_t k = 0; k < 4; k += 1) vertex.weights[k] /= total;
+	}
+}
+
+template <typename FunctionT>
+static double skinning_time(FunctionT function, std::size_t repeat) {
+	auto start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < repeat; i += 1) function();
+
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repeat;
+}
+
+// Compare the scalar reference with the skinning kernel on one thread and on every thread. Timings depend on the machine, so this is run on demand rather than with the unit tests.
+int main() {
+	const std::size_t bone_count = 64, vertex_count = 100000, repeat = 20;
+
+	std::vector<float32> palette;
+	std::vector<VertexP3N3M2B4> vertices;
+	skinning_scene(bone_count, vertex_count, palette, vertices);
+
+	std::vector<float32> positions(vertex_count * 3), normals(vertex_count * 3);
+	Parallel::Pool pool;
+
+	double reference = skinning_time([&]{
+		Skinning::skin_reference(palette.data(), bone_count, vertices.data(), vertex_count, positions.data(), normals.data());
+	}, repeat);
+
+	double single = skinning_time([&]{
+		Skinning::skin(palette.data(), bone_count, vertices.data(), vertex_count, positions.data(), normals.data());
+	}, repeat);
+
+	double parallel = skinning_time([&]{
+		Skinning::skin(pool, palette.data(), bone_count, vertices.data(), vertex_count, positions.data(), normals.data());
+	}, repeat);
+
+	std::cout << "Skinning " << vertex_count << " vertices: reference " << reference * 1e9 / vertex_count << "ns, ";
+	std::cout << "kernel " << single * 1e9 / vertex_count << "ns, ";
+	std::cout << pool.size() << " threads " << parallel * 1e9 / vertex_count << "ns per vertex" << std::endl;
+
+	return 0;
+}
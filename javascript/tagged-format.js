@@ -135,6 +135,13 @@ Block.Index16 = function(block) {
 
 Block.Tags['IN16'] = Block.Index16;
 
+Block.Index32 = function(block) {
+	block.elements = new Uint32Array(block.buffer, block.offset + 12, (block.byteSize - 12) / 4);
+	block.dataType = 'uint32';
+}
+
+Block.Tags['IN32'] = Block.Index32;
+
 Block.VertexP3N3M2 = function(block) {
 	block.format = [
 		{name: 'position', dataType: 'float32', count: 3},
@@ -165,6 +172,31 @@ Block.VertexP3N3M2B4 = function(block) {
 
 Block.Tags['3324'] = Block.VertexP3N3M2B4;
 
+Block.ProgressiveLevels = function(block) {
+	block.levels = [];
+	
+	Block.Extract.elements(block, 12, 8 + 8 + 4 + 4, function(offset) {
+		var offsets = Block.Extract.offsets(block, offset, 2);
+		
+		block.levels.push({
+			indicesOffset: offsets[0],
+			verticesOffset: offsets[1],
+			vertexCount: block.data.getUint32(offset + 16, true),
+			error: block.data.getFloat32(offset + 20, true)
+		});
+	});
+}
+
+Block.Tags['PRGL'] = Block.ProgressiveLevels;
+
+Block.VertexChunks = function(block) {
+	block.vertexTag = Block.Extract.fixedString(block, 12, 4);
+	block.vertexCount = Block.Extract.offsets(block, 16)[0];
+	block.chunkOffsets = Block.Extract.offsets(block, 24, (block.byteSize - 24) / 8);
+}
+
+Block.Tags['VCHK'] = Block.VertexChunks;
+
 Block.Skeleton = function(block) {
 	var offsets = Block.Extract.offsets(block, 16, 2)
 	
@@ -199,9 +231,12 @@ Block.Tags['ANIM'] = Block.SkeletonAnimation;
 
 Block.Tags['KEYF'] = Block.SkeletonKeyFrame;
 */
-Reader = function(buffer) {
+Reader = function(buffer, availableSize) {
 	this.buffer = buffer;
 	
+	// The number of bytes which have been loaded, when the buffer is still being streamed:
+	this.availableSize = (availableSize === undefined) ? buffer.byteLength : availableSize;
+	
 	return this;
 }
 
@@ -213,6 +248,70 @@ Reader.prototype.blockAtOffset = function(offset) {
 	return new Block(this.buffer, offset);
 }
 
+// Whether the block at the given offset has been loaded completely:
+Reader.prototype.isAvailable = function(offset) {
+	if (offset == 0 || offset + 12 > this.availableSize)
+		return false;
+	
+	var size = new DataView(this.buffer, offset + 4, 4).getUint32(0, true);
+	
+	return offset + size <= this.availableSize;
+}
+
+Reader.prototype.metadataOffset = function(block, name) {
+	if (!this.isAvailable(block.metadataOffset))
+		return 0;
+	
+	var metadata = this.blockAtOffset(block.metadataOffset);
+	
+	if (!metadata.offsetTable)
+		return 0;
+	
+	return metadata.offsetTable[name] || 0;
+}
+
+// Load the file incrementally, invoking the callback as each part arrives with the reader, the number of bytes loaded and whether the file is complete. Requires the server to provide the content length, otherwise the file is loaded in one go.
+Reader.stream = function(url, callback) {
+	if (!window.fetch || !window.ReadableStream)
+		return Reader.load(url, function(reader) {
+			callback(reader, reader ? reader.availableSize : 0, true);
+		});
+	
+	fetch(url).then(function(response) {
+		var length = parseInt(response.headers.get('Content-Length'));
+		
+		if (!response.ok || !response.body || !length) {
+			return response.arrayBuffer().then(function(buffer) {
+				callback(response.ok ? new Reader(buffer) : null, buffer.byteLength, true);
+			});
+		}
+		
+		var reader = new Reader(new ArrayBuffer(length), 0);
+		var bytes = new Uint8Array(reader.buffer);
+		var stream = response.body.getReader();
+		
+		var read = function() {
+			return stream.read().then(function(result) {
+				if (result.done) {
+					callback(reader, reader.availableSize, true);
+					return;
+				}
+				
+				bytes.set(result.value, reader.availableSize);
+				reader.availableSize += result.value.length;
+				
+				callback(reader, reader.availableSize, false);
+				
+				return read();
+			});
+		};
+		
+		return read();
+	}).catch(function(error) {
+		callback(null, 0, true);
+	});
+}
+
 Reader.load = function(url, callback) {
 	var xhr = new XMLHttpRequest();
 
@@ -291,26 +390,31 @@ TaggedFormat.Model = function(gl, reader, mesh) {
 	gl.bindBuffer(gl.ARRAY_BUFFER, this.vbo);
 	gl.bufferData(gl.ARRAY_BUFFER, this.verticesBlock.elements, gl.STATIC_DRAW);
 	
-	this.attributes = [];
+	this.attributes = this.attributesForVertices(this.verticesBlock);
+	
+	return this;
+}
+
+TaggedFormat.Model.prototype.attributesForVertices = function(verticesBlock) {
+	var attributes = [];
 	
 	var offset = 0;
-	for (var i in this.verticesBlock.format) {
-		var attribute = this.verticesBlock.format[i];
-		console.log(attribute);
+	for (var i in verticesBlock.format) {
+		var attribute = verticesBlock.format[i];
 		
-		this.attributes.push({
+		attributes.push({
 			name: attribute.name,
-			stride: this.verticesBlock.vertexSize,
+			stride: verticesBlock.vertexSize,
 			normalized: false,
 			count: attribute.count,
 			offset: offset,
-			type: TaggedFormat.glTypeForDataType(gl, attribute.dataType)
+			type: TaggedFormat.glTypeForDataType(this.gl, attribute.dataType)
 		});
 		
 		offset = offset + TaggedFormat.dataTypeLength(attribute.dataType) * attribute.count;
 	}
 	
-	return this;
+	return attributes;
 }
 
 TaggedFormat.Model.prototype.draw = function() {
@@ -327,4 +431,94 @@ TaggedFormat.Model.prototype.draw = function() {
 
 	// draw the buffer
 	this.gl.drawElements(this.gl.TRIANGLES, this.indicesBlock.elements.length, this.indicesType, 0);
-}
\ No newline at end of file
+}
+
+// A model for a mesh in a file which is being streamed with `Reader.stream`. Call `update` as more of the file arrives, and it draws the finest level of detail which has been loaded so far.
+TaggedFormat.ProgressiveModel = function(gl, reader, mesh) {
+	this.gl = gl;
+	this.reader = reader;
+	this.meshBlock = mesh;
+	
+	this.levels = null;
+	this.levelCount = 0;
+	
+	this.indicesBlock = null;
+	this.ibo = gl.createBuffer();
+	this.vbo = gl.createBuffer();
+	
+	this.update();
+	
+	return this;
+}
+
+TaggedFormat.ProgressiveModel.prototype.update = function() {
+	var gl = this.gl;
+	var reader = this.reader;
+	
+	if (!this.levels) {
+		var levelsOffset = reader.metadataOffset(this.meshBlock, 'progressive');
+		
+		if (levelsOffset == 0) {
+			// The mesh is not progressive, so it can only be drawn once it has been loaded completely:
+			if (reader.isAvailable(this.meshBlock.indicesOffset) && reader.isAvailable(this.meshBlock.verticesOffset)) {
+				TaggedFormat.Model.call(this, gl, reader, this.meshBlock);
+				this.levels = [];
+			}
+			
+			return;
+		}
+		
+		if (!reader.isAvailable(levelsOffset))
+			return;
+		
+		this.levels = reader.blockAtOffset(levelsOffset).levels;
+	}
+	
+	while (this.levelCount < this.levels.length) {
+		var level = this.levels[this.levelCount];
+		
+		if (!reader.isAvailable(level.indicesOffset))
+			break;
+		
+		if (level.verticesOffset && !reader.isAvailable(level.verticesOffset))
+			break;
+		
+		if (level.verticesOffset) {
+			var chunk = reader.blockAtOffset(level.verticesOffset);
+			var first = this.levelCount > 0 ? this.levels[this.levelCount - 1].vertexCount : 0;
+			
+			gl.bindBuffer(gl.ARRAY_BUFFER, this.vbo);
+			
+			// The buffer is allocated for the vertices of every level:
+			if (!this.attributes) {
+				gl.bufferData(gl.ARRAY_BUFFER, this.levels[this.levels.length - 1].vertexCount * chunk.vertexSize, gl.STATIC_DRAW);
+				this.attributes = this.attributesForVertices(chunk);
+			}
+			
+			gl.bufferSubData(gl.ARRAY_BUFFER, first * chunk.vertexSize, chunk.elements);
+		}
+		
+		this.levelCount += 1;
+	}
+	
+	if (this.levelCount > 0) {
+		var indicesBlock = reader.blockAtOffset(this.levels[this.levelCount - 1].indicesOffset);
+		
+		if (indicesBlock.offset != (this.indicesBlock && this.indicesBlock.offset)) {
+			this.indicesBlock = indicesBlock;
+			this.indicesType = TaggedFormat.glTypeForDataType(gl, indicesBlock.dataType);
+			
+			gl.bindBuffer(gl.ELEMENT_ARRAY_BUFFER, this.ibo);
+			gl.bufferData(gl.ELEMENT_ARRAY_BUFFER, indicesBlock.elements, gl.STATIC_DRAW);
+		}
+	}
+}
+
+TaggedFormat.ProgressiveModel.prototype.attributesForVertices = TaggedFormat.Model.prototype.attributesForVertices;
+
+TaggedFormat.ProgressiveModel.prototype.draw = function() {
+	if (!this.indicesBlock || !this.attributes)
+		return;
+	
+	TaggedFormat.Model.prototype.draw.call(this);
+}
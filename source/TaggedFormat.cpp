@@ -15,7 +15,27 @@
 #include <TaggedFormat/Parser.hpp>
 #include <TaggedFormat/Reader.hpp>
 #include <TaggedFormat/Table.hpp>
-
+#include <TaggedFormat/AnimationCompression.hpp>
+#include <TaggedFormat/AnimationTracks.hpp>
+#include <TaggedFormat/BVH.hpp>
+#include <TaggedFormat/Bounds.hpp>
+#include <TaggedFormat/Bundle.hpp>
+#include <TaggedFormat/Clusters.hpp>
+#include <TaggedFormat/Codec.hpp>
+#include <TaggedFormat/Instancing.hpp>
+#include <TaggedFormat/Merging.hpp>
+#include <TaggedFormat/Morph.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Progressive.hpp>
+#include <TaggedFormat/SceneGraph.hpp>
+#include <TaggedFormat/Simplification.hpp>
+#include <TaggedFormat/SpatialIndex.hpp>
+#include <TaggedFormat/Streams.hpp>
+#include <TaggedFormat/Tangents.hpp>
+#include <TaggedFormat/Update.hpp>
+#include <TaggedFormat/Welding.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
 #include <Buffers/File.hpp>
 #include <Buffers/MappedBuffer.hpp>
 
@@ -24,6 +44,7 @@ namespace {
 	using namespace TaggedFormat::Parser::IO;
 
 	void dump_offset(Reader * reader, OffsetT offset, std::ostream & output, std::size_t indentation = 0);
+	void dump_contents(Reader * reader, const Block * block, std::ostream & output, std::size_t indentation);
 
 	void dump_block(Reader * reader, const OffsetTable * block, std::ostream & output, std::size_t indentation) {
 		std::string indent(indentation, '\t');
@@ -35,6 +56,12 @@ namespace {
 		}
 	}
 
+	void dump_block(Reader * reader, const External * external, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "url = " << external->location() << std::endl;
+	}
+
 	void dump_block(Reader * reader, const Camera * camera, std::ostream & output, std::size_t indentation) {
 		std::string indent(indentation, '\t');
 
@@ -57,6 +84,121 @@ namespace {
 
 		output << indent << "axes:" << std::endl;
 		dump_offset(reader, mesh->axes_offset, output, indentation);
+
+		if (mesh->metadata_offset) {
+			output << indent << "metadata:" << std::endl;
+			dump_offset(reader, mesh->metadata_offset, output, indentation);
+		}
+	}
+
+	void dump_block(Reader * reader, const Node * node, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "name = " << node->name << std::endl;
+		output << indent << "transform = " << node->transform << std::endl;
+
+		for (auto & reference : *node) {
+			dump_offset(reader, reference.offset, output, indentation);
+		}
+	}
+
+	void dump_block(Reader * reader, const GeometryInstance * geometry_instance, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "mesh:" << std::endl;
+		dump_offset(reader, geometry_instance->mesh_offset, output, indentation);
+
+		output << indent << "skeleton:" << std::endl;
+		dump_offset(reader, geometry_instance->skeleton_offset, output, indentation);
+	}
+
+	void dump_block(Reader * reader, const Bounds * bounds, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "minimum = " << bounds->minimum << std::endl;
+		output << indent << "maximum = " << bounds->maximum << std::endl;
+		output << indent << "center = " << bounds->center << "; radius = " << bounds->radius << std::endl;
+	}
+
+	void dump_block(Reader * reader, const MeshClusters * mesh_clusters, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "clusters:" << std::endl;
+		dump_offset(reader, mesh_clusters->clusters_offset, output, indentation);
+
+		output << indent << "vertices:" << std::endl;
+		dump_offset(reader, mesh_clusters->vertices_offset, output, indentation);
+
+		output << indent << "triangles:" << std::endl;
+		dump_offset(reader, mesh_clusters->triangles_offset, output, indentation);
+	}
+
+	void dump_block(Reader * reader, const TriangleBVH * triangle_bvh, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		auto nodes = reader->block_at_offset<Array<BVHNode>>(triangle_bvh->nodes_offset);
+		auto triangles = reader->block_at_offset<Array<BVHTriangle>>(triangle_bvh->triangles_offset);
+
+		output << indent << "nodes = " << (nodes ? nodes->count() : 0) << "; triangles = " << (triangles ? triangles->count() : 0) << std::endl;
+	}
+
+	void dump_block(Reader * reader, const SceneIndex * scene_index, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		auto nodes = reader->block_at_offset<Array<BVHNode>>(scene_index->nodes_offset);
+		auto instances = reader->block_at_offset<Array<SceneInstance>>(scene_index->instances_offset);
+
+		output << indent << "nodes = " << (nodes ? nodes->count() : 0) << "; instances = " << (instances ? instances->count() : 0) << std::endl;
+	}
+
+	void dump_block(Reader * reader, const InstanceBatch * batch, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "mesh = " << batch->mesh_offset << "; skeleton = " << batch->skeleton_offset << "; material = " << batch->material_offset << "; " << batch->count() << " instances" << std::endl;
+
+		for (auto & instance : *batch) {
+			output << indent << "id = " << instance.id << "; translation = " << instance.transform[9] << " " << instance.transform[10] << " " << instance.transform[11] << std::endl;
+		}
+	}
+
+	void dump_block(Reader * reader, const Array<MergedSource> * sources, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		for (auto & source : *sources)
+			output << indent << "node = " << source.node_offset << "; " << source.triangle_count << " triangles at " << source.triangle_offset << std::endl;
+	}
+
+	void dump_block(Reader * reader, const FlatScene * flat_scene, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		auto levels = reader->block_at_offset<Array<Index32>>(flat_scene->levels_offset);
+
+		output << indent << "nodes = " << flat_scene->count() << "; levels = " << (levels && levels->count() ? levels->count() - 1 : 0) << std::endl;
+	}
+
+	void dump_block(Reader * reader, const NodeTransforms * transforms, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "nodes = " << transforms->node_count << "; " << transforms->plane_size << " elements per plane" << std::endl;
+	}
+
+	void dump_block(Reader * reader, const Array<Cluster> * clusters, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		for (auto & cluster : *clusters) {
+			output << indent << cluster.vertex_count << " vertices at " << cluster.vertex_offset << "; " << cluster.triangle_count << " triangles at " << cluster.triangle_offset;
+			output << "; radius = " << cluster.radius << "; cone_cutoff = " << cluster.cone_cutoff << std::endl;
+		}
+	}
+
+	void dump_block(Reader * reader, const Array<MeshLevel> * levels, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		for (auto & level : *levels) {
+			output << indent << "error = " << level.error << "; " << level.triangle_count << " triangles" << std::endl;
+
+			dump_offset(reader, level.indices_offset, output, indentation);
+		}
 	}
 
 	void dump_block(Reader * reader, const Skeleton * skeleton, std::ostream & output, std::size_t indentation) {
@@ -78,6 +220,114 @@ namespace {
 		dump_offset(reader, skeleton_animation->key_frames_offset, output, indentation);
 	}
 
+	void dump_block(Reader * reader, const CompressedAnimation * animation, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "Compressed=(" << animation->start_time << " -> " << animation->end_time << "); tolerance = " << animation->tolerance << std::endl;
+
+		output << indent << "tracks:" << std::endl;
+		dump_offset(reader, animation->tracks_offset, output, indentation);
+
+		output << indent << "keys:" << std::endl;
+		dump_offset(reader, animation->keys_offset, output, indentation);
+	}
+
+	void dump_block(Reader * reader, const Array<CompressedTrack> * tracks, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		for (auto & track : *tracks) {
+			output << indent << "bone = " << (int)track.bone << "; " << track.key_count << " keys from " << track.first_key << std::endl;
+		}
+	}
+
+	void dump_block(Reader * reader, const Array<CompressedKey> * keys, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << keys->count() << " keys; " << keys->count() * sizeof(CompressedKey) << " bytes" << std::endl;
+	}
+
+	void dump_block(Reader * reader, const ResampledAnimation * animation, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "Resampled=(" << animation->start_time << "; " << animation->sample_rate << " frames per second); " << animation->frame_count << " frames; " << animation->bone_count << " bones; ";
+		output << (animation->layout == ResampledAnimation::Layout::BONE_MAJOR ? "bone major" : "frame major") << std::endl;
+
+		output << indent << "samples:" << std::endl;
+		dump_offset(reader, animation->samples_offset, output, indentation);
+
+		output << indent << "key-frames:" << std::endl;
+		dump_offset(reader, animation->key_frames_offset, output, indentation);
+	}
+
+	void dump_block(Reader * reader, const Array<TrackSample> * samples, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << samples->count() << " samples; " << samples->count() * sizeof(TrackSample) << " bytes" << std::endl;
+	}
+
+	void dump_block(Reader * reader, const MorphTarget * target, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "mesh = " << target->mesh_offset << "; " << target->count() << " deltas" << std::endl;
+
+		for (auto & quantized : *target) {
+			Morph::Delta delta;
+			delta.index = quantized.index;
+
+			for (std::size_t i = 0; i < 3; i += 1) {
+				delta.position[i] = quantized.position[i] * target->position_scale;
+				delta.normal[i] = quantized.normal[i] * target->normal_scale;
+			}
+
+			output << indent << delta << std::endl;
+		}
+	}
+
+	void dump_block(Reader * reader, const VertexStreams * streams, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "vertices = " << identifier_from_tag(streams->vertex_tag) << "; " << streams->vertex_count << " elements" << std::endl;
+
+		for (auto & reference : *streams) {
+			dump_offset(reader, reference.offset, output, indentation);
+		}
+	}
+
+	void dump_block(Reader * reader, const VertexChunks * chunks, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "vertices = " << identifier_from_tag(chunks->vertex_tag) << "; " << chunks->vertex_count << " elements" << std::endl;
+
+		for (auto & reference : *chunks) {
+			dump_offset(reader, reference.offset, output, indentation);
+		}
+	}
+
+	void dump_block(Reader * reader, const Array<ProgressiveLevel> * levels, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		for (auto & level : *levels) {
+			output << indent << "error = " << level.error << "; " << level.vertex_count << " vertices" << std::endl;
+
+			dump_offset(reader, level.indices_offset, output, indentation);
+		}
+	}
+
+	void dump_block(Reader * reader, const VertexStream * stream, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "attribute = " << VertexStream::name_for_attribute(stream->attribute) << "; " << stream->components << " components; " << stream->plane_size << " elements per plane" << std::endl;
+	}
+
+	void dump_block(Reader * reader, OffsetT offset, const PackedArray * packed, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
+		output << indent << "method = " << PackedArray::name_for_method(packed->method) << std::endl;
+		output << indent << "array = " << identifier_from_tag(packed->array_tag) << "; " << packed->count << " elements; " << packed->decoded_size() << " bytes decoded" << std::endl;
+
+		dump_contents(reader, reader->unpacked_block_at_offset(offset), output, indentation);
+	}
+
 	template <typename ArrayT>
 	void dump_array(Reader * reader, const ArrayT * array, std::ostream & output, std::size_t indentation, bool separate = true) {
 		std::string indent(indentation, '\t');
@@ -103,6 +353,13 @@ namespace {
 		output << "; " << block->size << " bytes";
 		output << "; " << "magic = " << block->magic;
 		output << "; " << "top_offset = " << block->top_offset;
+		
+		if (auto generation = reader->generation())
+			output << "; " << "generation = " << generation->number;
+		
+		if (std::size_t count = reader->checksum_count())
+			output << "; " << "checksums = " << count;
+		
 		output << ">" << std::endl;
 		
 		dump_offset(reader, block->top_offset, output, indentation);
@@ -123,67 +380,177 @@ namespace {
 			output << "; " << block->size << " bytes";
 			output << "; " << "offset = " << offset;
 			output << "]" << std::endl;
+		} else if (offset && !reader->verify(offset)) {
+			output << indent << "[corrupt; offset = " << offset << "]" << std::endl;
+			
+			return;
 		} else {
 			output << indent << "[null: 0 bytes]" << std::endl;
 			
 			return;
 		}
 
+		if (block->tag == PackedArray::TAG) {
+			dump_block(reader, offset, (PackedArray *)block, output, indentation + 1);
+		} else {
+			dump_contents(reader, block, output, indentation + 1);
+		}
+	}
+
+	void dump_contents(Reader * reader, const Block * block, std::ostream & output, std::size_t indentation) {
+		std::string indent(indentation, '\t');
+
 		switch (block->tag) {
 			case Header::TAG:
-				dump_header(reader, (Header *)block, output, indentation + 1);
+				dump_header(reader, (Header *)block, output, indentation);
 				break;
 				
 			case Mesh::TAG:
-				dump_block(reader, (Mesh *)block, output, indentation + 1);
+				dump_block(reader, (Mesh *)block, output, indentation);
 				break;
 			
 			case Camera::TAG:
-				dump_block(reader, (Camera *)block, output, indentation + 1);
+				dump_block(reader, (Camera *)block, output, indentation);
+				break;
+
+			case External::TAG:
+				dump_block(reader, (External *)block, output, indentation);
 				break;
 
 			case OffsetTable::TAG:
-				dump_block(reader, (OffsetTable *)block, output, indentation + 1);
+				dump_block(reader, (OffsetTable *)block, output, indentation);
 				break;
 
 			case Index16::TAG:
-				dump_array(reader, (Array<Index16> *)block, output, indentation + 1, false);
+				dump_array(reader, (Array<Index16> *)block, output, indentation, false);
 				break;
 
 			case Index32::TAG:
-				dump_array(reader, (Array<Index32> *)block, output, indentation + 1, false);
+				dump_array(reader, (Array<Index32> *)block, output, indentation, false);
 				break;
 
 			case VertexP3N3M2::TAG:
-				dump_array(reader, (Array<VertexP3N3M2> *)block, output, indentation + 1);
+				dump_array(reader, (Array<VertexP3N3M2> *)block, output, indentation);
 				break;
 
 			case VertexP3N3M2B4::TAG:
-				dump_array(reader, (Array<VertexP3N3M2B4> *)block, output, indentation + 1);
+				dump_array(reader, (Array<VertexP3N3M2B4> *)block, output, indentation);
 				break;
 
 			case VertexP3N3M2C4::TAG:
-				dump_array(reader, (Array<VertexP3N3M2C4> *)block, output, indentation + 1);
+				dump_array(reader, (Array<VertexP3N3M2C4> *)block, output, indentation);
+				break;
+
+			case VertexP3N3M2T4::TAG:
+				dump_array(reader, (Array<VertexP3N3M2T4> *)block, output, indentation);
+				break;
+
+			case Node::TAG:
+				dump_block(reader, (Node *)block, output, indentation);
+				break;
+
+			case GeometryInstance::TAG:
+				dump_block(reader, (GeometryInstance *)block, output, indentation);
+				break;
+
+			case Bounds::TAG:
+				dump_block(reader, (Bounds *)block, output, indentation);
+				break;
+
+			case MeshClusters::TAG:
+				dump_block(reader, (MeshClusters *)block, output, indentation);
+				break;
+
+			case TriangleBVH::TAG:
+				dump_block(reader, (TriangleBVH *)block, output, indentation);
+				break;
+
+			case SceneIndex::TAG:
+				dump_block(reader, (SceneIndex *)block, output, indentation);
+				break;
+
+			case InstanceBatch::TAG:
+				dump_block(reader, (InstanceBatch *)block, output, indentation);
+				break;
+
+			case MergedSource::TAG:
+				dump_block(reader, (Array<MergedSource> *)block, output, indentation);
+				break;
+
+			case FlatScene::TAG:
+				dump_block(reader, (FlatScene *)block, output, indentation);
+				break;
+
+			case NodeTransforms::TAG:
+				dump_block(reader, (NodeTransforms *)block, output, indentation);
+				break;
+
+			case Cluster::TAG:
+				dump_block(reader, (Array<Cluster> *)block, output, indentation);
+				break;
+
+			case MeshLevel::TAG:
+				dump_block(reader, (Array<MeshLevel> *)block, output, indentation);
+				break;
+
+			case VertexStreams::TAG:
+				dump_block(reader, (VertexStreams *)block, output, indentation);
+				break;
+
+			case VertexChunks::TAG:
+				dump_block(reader, (VertexChunks *)block, output, indentation);
+				break;
+
+			case ProgressiveLevel::TAG:
+				dump_block(reader, (Array<ProgressiveLevel> *)block, output, indentation);
+				break;
+
+			case VertexStream::TAG:
+				dump_block(reader, (VertexStream *)block, output, indentation);
 				break;
 
 			case Axes::TAG:
-				dump_array(reader, (Axes *)block, output, indentation + 1);
+				dump_array(reader, (Axes *)block, output, indentation);
 				break;
 
 			case Skeleton::TAG:
-				dump_block(reader, (Skeleton *)block, output, indentation + 1);
+				dump_block(reader, (Skeleton *)block, output, indentation);
 				break;
 
 			case SkeletonBone::TAG:
-				dump_array(reader, (Array<SkeletonBone> *)block, output, indentation + 1);
+				dump_array(reader, (Array<SkeletonBone> *)block, output, indentation);
 				break;
 
 			case SkeletonAnimation::TAG:
-				dump_block(reader, (SkeletonAnimation *)block, output, indentation + 1);
+				dump_block(reader, (SkeletonAnimation *)block, output, indentation);
 				break;
 
 			case SkeletonAnimationKeyFrame::TAG:
-				dump_array(reader, (Array<SkeletonAnimationKeyFrame> *)block, output, indentation + 1);
+				dump_array(reader, (Array<SkeletonAnimationKeyFrame> *)block, output, indentation);
+				break;
+
+			case CompressedAnimation::TAG:
+				dump_block(reader, (CompressedAnimation *)block, output, indentation);
+				break;
+
+			case CompressedTrack::TAG:
+				dump_block(reader, (Array<CompressedTrack> *)block, output, indentation);
+				break;
+
+			case CompressedKey::TAG:
+				dump_block(reader, (Array<CompressedKey> *)block, output, indentation);
+				break;
+
+			case MorphTarget::TAG:
+				dump_block(reader, (MorphTarget *)block, output, indentation);
+				break;
+
+			case ResampledAnimation::TAG:
+				dump_block(reader, (ResampledAnimation *)block, output, indentation);
+				break;
+
+			case TrackSample::TAG:
+				dump_block(reader, (Array<TrackSample> *)block, output, indentation);
 				break;
 
 			default:
@@ -196,6 +563,83 @@ namespace {
 		
 		dump_header(&reader, reader.header(), std::cout, 0);
 	}
+
+	// The name of an asset is the file name without directories or extension:
+	std::string asset_name(const std::string & path) {
+		auto start = path.find_last_of('/');
+		start = (start == std::string::npos) ? 0 : start + 1;
+		
+		auto end = path.find('.', start);
+		
+		return path.substr(start, end == std::string::npos ? std::string::npos : end - start);
+	}
+	
+	void bundle(const std::vector<std::string> & input_paths, const std::string & output_path, const Pipeline & pipeline) {
+		Buffers::DynamicBuffer buffer;
+		BundleWriter bundle_writer(buffer, pipeline.checksums);
+		
+		for (auto & input_path : input_paths) {
+			Buffers::File file(input_path);
+			
+			file.read([&](Buffer & input){
+				bundle_writer.append(asset_name(input_path), input);
+			});
+		}
+		
+		bundle_writer.finish();
+		
+		buffer.write_to_file(output_path);
+	}
+	
+	// Add or replace the assets of a bundle in place, by appending a new generation:
+	void update(const std::string & bundle_path, const std::vector<std::string> & input_paths, const Pipeline & pipeline) {
+		Buffers::DynamicBuffer buffer;
+		
+		{
+			Buffers::File file(bundle_path);
+			
+			file.read([&](Buffer & input){
+				buffer.resize(input.size());
+				std::copy(input.begin(), input.end(), buffer.begin());
+			});
+		}
+		
+		Updater updater(buffer, pipeline.checksums);
+		
+		for (auto & input_path : input_paths) {
+			std::ifstream input(input_path);
+			Buffers::DynamicBuffer asset;
+			
+			Parser::serialize(input, asset);
+			
+			if (!pipeline.empty()) {
+				Buffers::DynamicBuffer output;
+				
+				pipeline.apply(asset, output);
+				std::swap(asset, output);
+			}
+			
+			updater.set_asset(asset_name(input_path), updater.append_file(asset));
+		}
+		
+		updater.commit();
+		updater.publish(bundle_path);
+	}
+	
+	void convert(std::istream & input, const std::string & output_path, const Pipeline & pipeline) {
+		Buffers::DynamicBuffer buffer;
+
+		Parser::serialize(input, buffer);
+
+		if (pipeline.empty()) {
+			buffer.write_to_file(output_path);
+		} else {
+			Buffers::DynamicBuffer output;
+
+			pipeline.apply(buffer, output);
+			output.write_to_file(output_path);
+		}
+	}
 }
 
 int main(int argc, const char * argv[]) {
@@ -203,13 +647,134 @@ int main(int argc, const char * argv[]) {
 	
 	std::vector<std::string> arguments(argv+1, argv+argc);
 	
+	// Conversion stages are enabled by options given before --text-to-binary:
+	Pipeline pipeline;
+
+	// Narrowing never changes the meaning of a file, so it's done unless the text asks to keep its index widths:
+	pipeline.narrow_indices = true;
+	
 	for (std::size_t i = 0; i < arguments.size(); i += 1) {
 		auto & argument = arguments[i];
 		
 		if (argument == "--help") {
 			std::cerr << argv[0] << " Copyright, 2016, by Samuel Williams. No warranty." << std::endl;
 			std::cerr << "\t--text-to-binary [input-text-path] [output-binary-path]" << std::endl;
+			std::cerr << "\t\t--merge-static: Merge static geometry instances with the same material within each cell of a grid into one mesh." << std::endl;
+			std::cerr << "\t\t--weld-vertices: Merge duplicate vertices of indexed meshes and remap their indices." << std::endl;
+			std::cerr << "\t\t--split-meshes: Split meshes with more than 65536 vertices into sub-meshes with 16-bit indices." << std::endl;
+			std::cerr << "\t\t--optimize-vertex-cache: Reorder triangles and vertices for vertex cache reuse and report ACMR/ATVR." << std::endl;
+			std::cerr << "\t\t--generate-tangents: Convert triangle meshes to vertex-p3n3m2t4 with tangents generated from their texture coordinates." << std::endl;
+			std::cerr << "\t\t--generate-lod: Generate simplified levels of detail for triangle meshes." << std::endl;
+			std::cerr << "\t\t--convert-layout: Convert between triangle lists and strips when it gives fewer indices." << std::endl;
+			std::cerr << "\t\t--keep-index-width: Keep 32-bit indices, which are otherwise replaced by 16-bit indices when every index fits." << std::endl;
+			std::cerr << "\t\t--compute-bounds: Compute bounding boxes and spheres for meshes and nodes." << std::endl;
+			std::cerr << "\t\t--build-clusters: Partition triangle meshes into clusters with culling bounds." << std::endl;
+			std::cerr << "\t\t--build-bvh: Build a triangle bounding volume hierarchy for ray and closest point queries." << std::endl;
+			std::cerr << "\t\t--build-scene-index: Build a spatial index over the geometry instances of each scene for visibility queries." << std::endl;
+			std::cerr << "\t\t--batch-instances: Replace repeated instances of the same geometry below a node with one batch of transforms." << std::endl;
+			std::cerr << "\t\t--flatten-scenes: Flatten each node hierarchy into breadth first levels for parallel world transform updates." << std::endl;
+			std::cerr << "\t\t--progressive: Lay out the file so that a prefix contains a coarse version of every mesh, refined by later bytes." << std::endl;
+			std::cerr << "\t\t--resample-animations: Bake skeletal animations into frame major tracks at a fixed rate, for evaluation without searching." << std::endl;
+			std::cerr << "\t\t--resample-bone-major: As above, but with all the frames of each bone together." << std::endl;
+			std::cerr << "\t\t--compress-animations: Remove redundant key frames of skeletal animations and quantize the rest." << std::endl;
+			std::cerr << "\t\t--vertex-streams: Store mesh vertices as aligned per-attribute streams." << std::endl;
+			std::cerr << "\t\t--pack-meshes: Compress mesh indices and vertices using the mesh codec." << std::endl;
+			std::cerr << "\t\t--checksums: Store a CRC32C checksum for every block, verified when the block is first read." << std::endl;
+			std::cerr << "\t--bundle [output-binary-path] [input-binary-paths...]: Merge binary files into a bundle indexed by file name." << std::endl;
+			std::cerr << "\t\t--checksums: Store a CRC32C checksum for every block." << std::endl;
+			std::cerr << "\t--update [bundle-binary-path] [input-text-paths...]: Convert text files using the options above, and add or replace the bundle assets named by them in place." << std::endl;
 			std::cerr << "\t--dump-binary [input-binary-path]" << std::endl;
+			std::cerr << "\t--verify-binary [input-binary-path]: Verify the checksum of every block." << std::endl;
+		}
+		
+		else if (argument == "--merge-static") {
+			pipeline.merge_cell_size = Merging::DEFAULT_CELL_SIZE;
+		}
+		
+		else if (argument == "--weld-vertices") {
+			pipeline.weld_tolerance = Welding::DEFAULT_TOLERANCE;
+		}
+		
+		else if (argument == "--split-meshes") {
+			pipeline.split_meshes = true;
+		}
+		
+		else if (argument == "--optimize-vertex-cache") {
+			pipeline.optimize_vertex_cache = true;
+			pipeline.log = &std::cerr;
+		}
+		
+		else if (argument == "--generate-tangents") {
+			pipeline.generate_tangents = true;
+		}
+		
+		else if (argument == "--generate-lod") {
+			pipeline.level_count = Simplification::DEFAULT_LEVEL_COUNT;
+		}
+		
+		else if (argument == "--convert-layout") {
+			pipeline.convert_layout = true;
+		}
+		
+		else if (argument == "--narrow-indices") {
+			pipeline.narrow_indices = true;
+		}
+		
+		else if (argument == "--keep-index-width") {
+			pipeline.narrow_indices = false;
+		}
+		
+		else if (argument == "--compute-bounds") {
+			pipeline.compute_bounds = true;
+		}
+		
+		else if (argument == "--build-clusters") {
+			pipeline.build_clusters = true;
+		}
+		
+		else if (argument == "--build-bvh") {
+			pipeline.build_bvh = true;
+		}
+		
+		else if (argument == "--build-scene-index") {
+			pipeline.build_scene_index = true;
+		}
+		
+		else if (argument == "--batch-instances") {
+			pipeline.batch_instances = true;
+		}
+		
+		else if (argument == "--flatten-scenes") {
+			pipeline.flatten_scenes = true;
+		}
+		
+		else if (argument == "--progressive") {
+			pipeline.progressive = true;
+		}
+		
+		else if (argument == "--resample-animations") {
+			pipeline.sample_rate = AnimationTracks::DEFAULT_SAMPLE_RATE;
+		}
+		
+		else if (argument == "--resample-bone-major") {
+			pipeline.sample_rate = AnimationTracks::DEFAULT_SAMPLE_RATE;
+			pipeline.sample_layout = ResampledAnimation::Layout::BONE_MAJOR;
+		}
+		
+		else if (argument == "--compress-animations") {
+			pipeline.animation_tolerance = AnimationCompression::DEFAULT_TOLERANCE;
+		}
+		
+		else if (argument == "--vertex-streams") {
+			pipeline.vertex_streams = true;
+		}
+		
+		else if (argument == "--pack-meshes") {
+			pipeline.pack_meshes = true;
+		}
+		
+		else if (argument == "--checksums") {
+			pipeline.checksums = true;
 		}
 		
 		else if (argument == "--text-to-binary") {
@@ -219,7 +784,7 @@ int main(int argc, const char * argv[]) {
 			std::string output_path(arguments[i+2]);
 			
 			try {
-				Parser::serialize(input, output_path);
+				convert(input, output_path, pipeline);
 			} catch (std::exception & exception) {
 				std::cerr << exception.what() << std::endl;
 				
@@ -230,6 +795,40 @@ int main(int argc, const char * argv[]) {
 			i += 2;
 		}
 
+		else if (argument == "--bundle") {
+			assert(i + 2 < arguments.size());
+			
+			std::string output_path(arguments[i+1]);
+			std::vector<std::string> input_paths(arguments.begin() + i + 2, arguments.end());
+			
+			try {
+				bundle(input_paths, output_path, pipeline);
+			} catch (std::exception & exception) {
+				std::cerr << exception.what() << std::endl;
+				
+				exit(1);
+			}
+			
+			i = arguments.size();
+		}
+		
+		else if (argument == "--update") {
+			assert(i + 2 < arguments.size());
+			
+			std::string bundle_path(arguments[i+1]);
+			std::vector<std::string> input_paths(arguments.begin() + i + 2, arguments.end());
+			
+			try {
+				update(bundle_path, input_paths, pipeline);
+			} catch (std::exception & exception) {
+				std::cerr << exception.what() << std::endl;
+				
+				exit(1);
+			}
+			
+			i = arguments.size();
+		}
+		
 		else if (argument == "--dump-binary") {
 			assert(i + 1 < arguments.size());
 			
@@ -245,6 +844,35 @@ int main(int argc, const char * argv[]) {
 			i += 1;
 		}
 		
+		else if (argument == "--verify-binary") {
+			assert(i + 1 < arguments.size());
+			
+			Buffers::File file(arguments[i+1]);
+			bool valid = true;
+			
+			file.read([&](Buffer & buffer){
+				Reader reader(buffer);
+				
+				if (reader.checksum_count() == 0) {
+					std::cerr << "No checksums found." << std::endl;
+					valid = false;
+					
+					return;
+				}
+				
+				for (auto offset : reader.verify_all()) {
+					std::cerr << "Block at offset " << offset << " is corrupt." << std::endl;
+					valid = false;
+				}
+				
+				std::cout << reader.checksum_count() << " blocks verified." << std::endl;
+			});
+			
+			if (!valid) exit(1);
+			
+			i += 1;
+		}
+		
 		else {
 			exit(1);
 		}
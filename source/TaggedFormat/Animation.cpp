@@ -0,0 +1,336 @@
+//
+//  Animation.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Animation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace TaggedFormat
+{
+	namespace Animation
+	{
+		static const Transform IDENTITY = {{0, 0, 0, 0}, {0, 0, 0, 1}, {1, 1, 1, 0}};
+
+		void decompose(const float32 matrix[16], Transform & transform) {
+			transform = IDENTITY;
+
+			for (std::size_t i = 0; i < 3; i += 1) {
+				transform.translation[i] = matrix[12 + i];
+				transform.scale[i] = std::sqrt(matrix[i*4] * matrix[i*4] + matrix[i*4+1] * matrix[i*4+1] + matrix[i*4+2] * matrix[i*4+2]);
+			}
+
+			float32 determinant =
+				matrix[0] * (matrix[5] * matrix[10] - matrix[9] * matrix[6]) -
+				matrix[4] * (matrix[1] * matrix[10] - matrix[9] * matrix[2]) +
+				matrix[8] * (matrix[1] * matrix[6] - matrix[5] * matrix[2]);
+
+			if (determinant < 0) transform.scale[0] = -transform.scale[0];
+
+			// The rotation matrix, where r[column][row]:
+			float32 r[3][3];
+
+			for (std::size_t i = 0; i < 3; i += 1) {
+				float32 scale = transform.scale[i];
+
+				for (std::size_t j = 0; j < 3; j += 1)
+					r[i][j] = scale != 0 ? matrix[i*4 + j] / scale : (i == j);
+			}
+
+			// Choose the largest component to divide by, for stability (Shepperd, 1978):
+			float32 * q = transform.rotation;
+			float32 trace = r[0][0] + r[1][1] + r[2][2];
+
+			if (trace > 0) {
+				float32 s = std::sqrt(trace + 1) * 2;
+				q[3] = s / 4;
+				q[0] = (r[1][2] - r[2][1]) / s;
+				q[1] = (r[2][0] - r[0][2]) / s;
+				q[2] = (r[0][1] - r[1][0]) / s;
+			} else if (r[0][0] > r[1][1] && r[0][0] > r[2][2]) {
+				float32 s = std::sqrt(1 + r[0][0] - r[1][1] - r[2][2]) * 2;
+				q[3] = (r[1][2] - r[2][1]) / s;
+				q[0] = s / 4;
+				q[1] = (r[1][0] + r[0][1]) / s;
+				q[2] = (r[2][0] + r[0][2]) / s;
+			} else if (r[1][1] > r[2][2]) {
+				float32 s = std::sqrt(1 + r[1][1] - r[0][0] - r[2][2]) * 2;
+				q[3] = (r[2][0] - r[0][2]) / s;
+				q[0] = (r[1][0] + r[0][1]) / s;
+				q[1] = s / 4;
+				q[2] = (r[2][1] + r[1][2]) / s;
+			} else {
+				float32 s = std::sqrt(1 + r[2][2] - r[0][0] - r[1][1]) * 2;
+				q[3] = (r[0][1] - r[1][0]) / s;
+				q[0] = (r[2][0] + r[0][2]) / s;
+				q[1] = (r[2][1] + r[1][2]) / s;
+				q[2] = s / 4;
+			}
+
+			float32 length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+			for (std::size_t i = 0; i < 4; i += 1) q[i] /= length;
+		}
+
+		void compose(const Transform & transform, float32 matrix[16]) {
+			const float32 * q = transform.rotation;
+			const float32 * s = transform.scale;
+
+			float32 xx = q[0] * q[0], yy = q[1] * q[1], zz = q[2] * q[2];
+			float32 xy = q[0] * q[1], xz = q[0] * q[2], yz = q[1] * q[2];
+			float32 wx = q[3] * q[0], wy = q[3] * q[1], wz = q[3] * q[2];
+
+			matrix[0] = (1 - 2 * (yy + zz)) * s[0];
+			matrix[1] = 2 * (xy + wz) * s[0];
+			matrix[2] = 2 * (xz - wy) * s[0];
+			matrix[3] = 0;
+
+			matrix[4] = 2 * (xy - wz) * s[1];
+			matrix[5] = (1 - 2 * (xx + zz)) * s[1];
+			matrix[6] = 2 * (yz + wx) * s[1];
+			matrix[7] = 0;
+
+			matrix[8] = 2 * (xz + wy) * s[2];
+			matrix[9] = 2 * (yz - wx) * s[2];
+			matrix[10] = (1 - 2 * (xx + yy)) * s[2];
+			matrix[11] = 0;
+
+			matrix[12] = transform.translation[0];
+			matrix[13] = transform.translation[1];
+			matrix[14] = transform.translation[2];
+			matrix[15] = 1;
+		}
+
+		// The weights of two unit quaternions with the given dot product, which is not negative:
+		static void slerp_weights(float32 dot, float32 factor, float32 & from_weight, float32 & to_weight) {
+			// Nearly parallel rotations are interpolated linearly, which avoids dividing by a tiny sine, and the result is normalized by the caller:
+			if (dot > 0.9995f) {
+				from_weight = 1 - factor;
+				to_weight = factor;
+			} else {
+				float32 angle = std::acos(dot);
+				float32 sine = std::sin(angle);
+
+				from_weight = std::sin((1 - factor) * angle) / sine;
+				to_weight = std::sin(factor * angle) / sine;
+			}
+		}
+
+		void interpolate(const Transform & from, const Transform & to, float32 factor, Transform & result) {
+#if defined(__SSE__)
+			__m128 f = _mm_set1_ps(factor);
+
+			__m128 from_translation = _mm_load_ps(from.translation), to_translation = _mm_load_ps(to.translation);
+			_mm_store_ps(result.translation, _mm_add_ps(from_translation, _mm_mul_ps(_mm_sub_ps(to_translation, from_translation), f)));
+
+			__m128 from_scale = _mm_load_ps(from.scale), to_scale = _mm_load_ps(to.scale);
+			_mm_store_ps(result.scale, _mm_add_ps(from_scale, _mm_mul_ps(_mm_sub_ps(to_scale, from_scale), f)));
+
+			__m128 a = _mm_load_ps(from.rotation), b = _mm_load_ps(to.rotation);
+
+			// The sum of the products in every lane:
+			__m128 products = _mm_mul_ps(a, b);
+			products = _mm_add_ps(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(2, 3, 0, 1)));
+			products = _mm_add_ps(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(1, 0, 3, 2)));
+
+			float32 dot = _mm_cvtss_f32(products);
+
+			// Take the shortest path, as q and -q are the same rotation:
+			if (dot < 0) {
+				b = _mm_sub_ps(_mm_setzero_ps(), b);
+				dot = -dot;
+			}
+
+			float32 from_weight, to_weight;
+			slerp_weights(dot, factor, from_weight, to_weight);
+
+			__m128 q = _mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(from_weight)), _mm_mul_ps(b, _mm_set1_ps(to_weight)));
+
+			__m128 length = _mm_mul_ps(q, q);
+			length = _mm_add_ps(length, _mm_shuffle_ps(length, length, _MM_SHUFFLE(2, 3, 0, 1)));
+			length = _mm_add_ps(length, _mm_shuffle_ps(length, length, _MM_SHUFFLE(1, 0, 3, 2)));
+
+			_mm_store_ps(result.rotation, _mm_div_ps(q, _mm_sqrt_ps(length)));
+#else
+			for (std::size_t i = 0; i < 4; i += 1) {
+				result.translation[i] = from.translation[i] + (to.translation[i] - from.translation[i]) * factor;
+				result.scale[i] = from.scale[i] + (to.scale[i] - from.scale[i]) * factor;
+			}
+
+			float32 dot = 0, sign = 1;
+
+			for (std::size_t i = 0; i < 4; i += 1) dot += from.rotation[i] * to.rotation[i];
+
+			if (dot < 0) {
+				sign = -1;
+				dot = -dot;
+			}
+
+			float32 from_weight, to_weight;
+			slerp_weights(dot, factor, from_weight, to_weight);
+
+			float32 length = 0;
+
+			for (std::size_t i = 0; i < 4; i += 1) {
+				result.rotation[i] = from.rotation[i] * from_weight + to.rotation[i] * sign * to_weight;
+				length += result.rotation[i] * result.rotation[i];
+			}
+
+			length = std::sqrt(length);
+
+			for (std::size_t i = 0; i < 4; i += 1) result.rotation[i] /= length;
+#endif
+		}
+
+		float32 ease(SkeletonAnimationKeyFrame::Interpolation interpolation, float32 fraction) {
+			fraction = std::min<float32>(std::max<float32>(fraction, 0), 1);
+
+			// Zero velocity at each key frame:
+			if (interpolation == SkeletonAnimationKeyFrame::Interpolation::BEZIER)
+				return fraction * fraction * (3 - 2 * fraction);
+
+			return fraction;
+		}
+	}
+
+	std::vector<AnimationSampler::Key> AnimationSampler::decompose_key_frames(const Array<SkeletonAnimationKeyFrame> * key_frames) {
+		std::vector<Key> keys;
+
+		if (key_frames) {
+			keys.resize(key_frames->count());
+
+			for (std::size_t i = 0; i < keys.size(); i += 1) {
+				auto & key_frame = key_frames->at(i);
+
+				keys[i].bone = key_frame.bone;
+				keys[i].interpolation = key_frame.interpolation;
+				keys[i].time = key_frame.time;
+
+				Animation::decompose(key_frame.transform, keys[i].transform);
+			}
+		}
+
+		return keys;
+	}
+
+	AnimationSampler::AnimationSampler(const Array<SkeletonBone> * bones, const Array<SkeletonAnimationKeyFrame> * key_frames) : AnimationSampler(bones, decompose_key_frames(key_frames))
+	{
+	}
+
+	AnimationSampler::AnimationSampler(const Array<SkeletonBone> * bones, std::vector<Key> keys)
+	{
+		std::size_t bone_count = bones ? bones->count() : 0;
+
+		if (!bones) {
+			for (auto & key : keys)
+				bone_count = std::max<std::size_t>(bone_count, key.bone + 1);
+		}
+
+		_rest.resize(bone_count, Animation::IDENTITY);
+
+		if (bones) {
+			for (std::size_t i = 0; i < bone_count; i += 1)
+				Animation::decompose(bones->at(i).transform, _rest[i]);
+		}
+
+		keys.erase(std::remove_if(keys.begin(), keys.end(), [&](const Key & key) {return key.bone >= bone_count;}), keys.end());
+
+		std::stable_sort(keys.begin(), keys.end(), [](const Key & a, const Key & b) {
+			return a.bone < b.bone || (a.bone == b.bone && a.time < b.time);
+		});
+
+		_ranges.assign(bone_count + 1, 0);
+		_times.reserve(keys.size());
+		_transforms.reserve(keys.size());
+		_interpolations.reserve(keys.size());
+
+		for (std::size_t i = 0; i < keys.size(); i += 1) {
+			_ranges[keys[i].bone + 1] += 1;
+			_times.push_back(keys[i].time);
+			_interpolations.push_back(keys[i].interpolation);
+			_transforms.push_back(keys[i].transform);
+
+			// Rotations of consecutive key frames are kept in the same hemisphere, so that interpolation takes the shortest path:
+			if (i > 0 && keys[i-1].bone == keys[i].bone) {
+				float32 * a = _transforms[i-1].rotation, * b = _transforms[i].rotation;
+
+				if (a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0) {
+					for (std::size_t k = 0; k < 4; k += 1) b[k] = -b[k];
+				}
+			}
+		}
+
+		std::partial_sum(_ranges.begin(), _ranges.end(), _ranges.begin());
+
+		if (!_times.empty()) {
+			auto range = std::minmax_element(_times.begin(), _times.end());
+			_start_time = *range.first;
+			_end_time = *range.second;
+		}
+	}
+
+	std::size_t AnimationSampler::find(std::size_t first, std::size_t last, float32 time, uint32_t & cursor) const {
+		const float32 * times = _times.data();
+		std::size_t index = first + cursor;
+
+		if (index >= last) index = first;
+
+		if (times[index] <= time) {
+			// Playing forwards, the key frame is usually the same or the next one:
+			if (index + 1 < last && times[index + 1] <= time) {
+				if (index + 2 >= last || time < times[index + 2])
+					index += 1;
+				else
+					index = std::upper_bound(times + index + 2, times + last, time) - times - 1;
+			}
+		} else {
+			index = std::upper_bound(times + first, times + index, time) - times;
+
+			// The time is before the first key frame:
+			if (index > first) index -= 1;
+		}
+
+		cursor = static_cast<uint32_t>(index - first);
+
+		return index;
+	}
+
+	void AnimationSampler::sample_bone(BoneID bone, float32 time, Cursors & cursors, Transform & transform) const {
+		std::size_t first = _ranges[bone], last = _ranges[bone + 1];
+
+		if (first == last) {
+			transform = _rest[bone];
+
+			return;
+		}
+
+		std::size_t index = find(first, last, time, cursors[bone]);
+
+		if (index + 1 == last || time <= _times[index]) {
+			transform = _transforms[index];
+
+			return;
+		}
+
+		float32 factor = Animation::ease(_interpolations[index], (time - _times[index]) / (_times[index + 1] - _times[index]));
+
+		Animation::interpolate(_transforms[index], _transforms[index + 1], factor, transform);
+	}
+
+	void AnimationSampler::sample(float32 time, Cursors & cursors, Transform * pose) const {
+		std::size_t count = bone_count();
+
+		for (std::size_t bone = 0; bone < count; bone += 1)
+			sample_bone(static_cast<BoneID>(bone), time, cursors, pose[bone]);
+	}
+}
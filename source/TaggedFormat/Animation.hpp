@@ -0,0 +1,94 @@
+//
+//  Animation.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Skeleton.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// A transform decomposed into translation, rotation and scale, which can be interpolated. The fourth components of the translation and scale are padding, so that each part can be processed as a vector.
+	struct alignas(16) Transform {
+		float32 translation[4];
+
+		/// A unit quaternion (x, y, z, w).
+		float32 rotation[4];
+
+		float32 scale[4];
+	};
+
+	namespace Animation
+	{
+		/// Decompose a column major matrix without shear or projection into a transform. A negative determinant is represented by a negative x scale.
+		void decompose(const float32 matrix[16], Transform & transform);
+
+		/// Compose a transform into a column major matrix.
+		void compose(const Transform & transform, float32 matrix[16]);
+
+		/// Interpolate linearly between the translations and scales, and spherically between the rotations, of two transforms.
+		void interpolate(const Transform & from, const Transform & to, float32 factor, Transform & result);
+
+		/// @returns the interpolation factor between two key frames, given the fraction of the time between them which has passed. `BEZIER` key frames ease in and out, as a cubic bezier with control points at 0, 0, 1 and 1, as key frames don't store tangents.
+		float32 ease(SkeletonAnimationKeyFrame::Interpolation interpolation, float32 fraction);
+	}
+
+	/// Evaluates the pose of a skeleton at any time from its key frames. Key frames are decomposed once when the sampler is constructed and grouped by bone in order of time. The interpolation of a key frame applies until the next key frame of the same bone, using `Animation::ease`. Before the first and after the last key frame of a bone, its transform is held.
+	class AnimationSampler {
+	public:
+		/// The key frame of each bone at which the previous sample was found. Playback which moves forward in small steps, the common case, finds the next key frame in constant time, and any other change in time uses a binary search. Each playing instance has its own cursors, so a sampler can be shared between threads.
+		typedef std::vector<uint32_t> Cursors;
+
+		/// A key frame in the working format of the sampler.
+		struct Key {
+			BoneID bone;
+			SkeletonAnimationKeyFrame::Interpolation interpolation;
+			float32 time;
+			Transform transform;
+		};
+
+		/// @param bones the bind pose, which is used for bones without key frames, or nullptr to use the identity. If given, key frames for bones outside the skeleton are ignored.
+		AnimationSampler(const Array<SkeletonBone> * bones, const Array<SkeletonAnimationKeyFrame> * key_frames);
+
+		/// Construct a sampler from key frames which are already decomposed, e.g. by decompression.
+		AnimationSampler(const Array<SkeletonBone> * bones, std::vector<Key> keys);
+
+		/// Decompose key frames into the working format of the sampler.
+		static std::vector<Key> decompose_key_frames(const Array<SkeletonAnimationKeyFrame> * key_frames);
+
+		std::size_t bone_count() const {return _ranges.size() - 1;}
+
+		/// The times of the first and last key frames.
+		float32 start_time() const {return _start_time;}
+		float32 end_time() const {return _end_time;}
+
+		Cursors cursors() const {return Cursors(bone_count(), 0);}
+
+		/// Evaluate the local transform of every bone, relative to its parent, at the given time.
+		/// @param pose space for `bone_count()` transforms.
+		void sample(float32 time, Cursors & cursors, Transform * pose) const;
+
+		/// Evaluate the local transform of a single bone.
+		void sample_bone(BoneID bone, float32 time, Cursors & cursors, Transform & transform) const;
+
+	private:
+		/// The key frames of bone `i` are `[_ranges[i], _ranges[i+1])`. Times are stored apart from the transforms, so that searching touches as little memory as possible.
+		std::vector<uint32_t> _ranges;
+		std::vector<float32> _times;
+		std::vector<Transform> _transforms;
+		std::vector<SkeletonAnimationKeyFrame::Interpolation> _interpolations;
+
+		/// The transform of bones without key frames.
+		std::vector<Transform> _rest;
+
+		float32 _start_time = 0, _end_time = 0;
+
+		std::size_t find(std::size_t first, std::size_t last, float32 time, uint32_t & cursor) const;
+	};
+}
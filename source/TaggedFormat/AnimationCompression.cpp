@@ -0,0 +1,381 @@
+//
+//  AnimationCompression.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "AnimationCompression.hpp"
+#include "AnimationTracks.hpp"
+#include "Reader.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+namespace TaggedFormat
+{
+	namespace AnimationCompression
+	{
+		typedef AnimationSampler::Key KeyT;
+		typedef SkeletonAnimationKeyFrame::Interpolation InterpolationT;
+
+		// The three smallest components of a unit quaternion are within this range:
+		const float32 ROTATION_RANGE = 0.70710678f;
+
+		float32 error(const Transform & a, const Transform & b) {
+			float32 distance = 0, dot = 0, scale = 0;
+
+			for (std::size_t i = 0; i < 3; i += 1) {
+				float32 difference = a.translation[i] - b.translation[i];
+				distance += difference * difference;
+
+				scale = std::max(scale, std::abs(a.scale[i] - b.scale[i]));
+			}
+
+			for (std::size_t i = 0; i < 4; i += 1)
+				dot += a.rotation[i] * b.rotation[i];
+
+			// The angle is computed from the chord between the quaternions, which unlike the dot product is accurate for small angles:
+			float32 sign = dot < 0 ? -1 : 1, chord = 0;
+
+			for (std::size_t i = 0; i < 4; i += 1) {
+				float32 difference = a.rotation[i] - b.rotation[i] * sign;
+				chord += difference * difference;
+			}
+
+			float32 angle = 4 * std::asin(std::min<float32>(std::sqrt(chord) / 2, 1));
+
+			return std::sqrt(distance) + angle + scale;
+		}
+
+		// Whether every key between the first and last can be reconstructed by interpolating between them:
+		static bool fits(const std::vector<KeyT> & keys, std::size_t first, std::size_t last, float32 tolerance) {
+			const KeyT & from = keys[first], & to = keys[last];
+			float32 duration = to.time - from.time;
+
+			for (std::size_t i = first + 1; i < last; i += 1) {
+				Transform interpolated;
+				float32 factor = Animation::ease(from.interpolation, duration > 0 ? (keys[i].time - from.time) / duration : 1);
+
+				Animation::interpolate(from.transform, to.transform, factor, interpolated);
+
+				if (error(interpolated, keys[i].transform) > tolerance)
+					return false;
+			}
+
+			return true;
+		}
+
+		// Group the keys by bone, in order of time:
+		static void sort_keys(std::vector<KeyT> & keys) {
+			std::stable_sort(keys.begin(), keys.end(), [](const KeyT & a, const KeyT & b) {
+				return a.bone < b.bone || (a.bone == b.bone && a.time < b.time);
+			});
+		}
+
+		std::vector<KeyT> reduce(std::vector<KeyT> keys, float32 tolerance) {
+			sort_keys(keys);
+
+			std::vector<KeyT> reduced;
+			reduced.reserve(keys.size());
+
+			for (std::size_t first = 0; first < keys.size();) {
+				std::size_t last = first;
+				while (last < keys.size() && keys[last].bone == keys[first].bone) last += 1;
+
+				// The held transform is enough for a track which doesn't move:
+				bool constant = true;
+
+				for (std::size_t i = first + 1; i < last && constant; i += 1)
+					constant = error(keys[first].transform, keys[i].transform) <= tolerance;
+
+				reduced.push_back(keys[first]);
+
+				if (!constant) {
+					// Extend each segment for as long as it reconstructs the keys it replaces:
+					for (std::size_t start = first; start + 1 < last;) {
+						std::size_t end = start + 1;
+
+						while (end + 1 < last && fits(keys, start, end + 1, tolerance))
+							end += 1;
+
+						reduced.push_back(keys[end]);
+						start = end;
+					}
+				}
+
+				first = last;
+			}
+
+			return reduced;
+		}
+
+		static uint16_t quantize(float32 value, float32 minimum, float32 extent) {
+			if (extent <= 0) return 0;
+
+			float32 unit = std::min<float32>(std::max<float32>((value - minimum) / extent, 0), 1);
+
+			return static_cast<uint16_t>(std::lround(unit * 65535));
+		}
+
+		static float32 dequantize(uint16_t value, float32 minimum, float32 extent) {
+			return minimum + extent * (value / 65535.0f);
+		}
+
+		static void quantize_rotation(const float32 rotation[4], bool bezier, uint16_t result[3]) {
+			std::size_t largest = 0;
+
+			for (std::size_t i = 1; i < 4; i += 1) {
+				if (std::abs(rotation[i]) > std::abs(rotation[largest])) largest = i;
+			}
+
+			// q and -q are the same rotation, so the largest component is made positive:
+			float32 sign = rotation[largest] < 0 ? -1 : 1;
+
+			for (std::size_t i = 0, k = 0; i < 4; i += 1) {
+				if (i == largest) continue;
+
+				float32 unit = (rotation[i] * sign + ROTATION_RANGE) / (2 * ROTATION_RANGE);
+				unit = std::min<float32>(std::max<float32>(unit, 0), 1);
+
+				result[k++] = static_cast<uint16_t>(std::lround(unit * 0x7FFF));
+			}
+
+			result[0] |= (largest & 1) << 15;
+			result[1] |= (largest >> 1) << 15;
+
+			if (bezier) result[2] |= 0x8000;
+		}
+
+		static void dequantize_rotation(const uint16_t value[3], float32 rotation[4]) {
+			std::size_t largest = (value[0] >> 15) | ((value[1] >> 15) << 1);
+			float32 sum = 0;
+
+			for (std::size_t i = 0, k = 0; i < 4; i += 1) {
+				if (i == largest) continue;
+
+				rotation[i] = (value[k++] & 0x7FFF) / float32(0x7FFF) * 2 * ROTATION_RANGE - ROTATION_RANGE;
+				sum += rotation[i] * rotation[i];
+			}
+
+			rotation[largest] = std::sqrt(std::max<float32>(1 - sum, 0));
+		}
+
+		static KeyT decompress_key(const CompressedKey & key, const CompressedTrack & track, float32 start_time, float32 end_time) {
+			KeyT decompressed;
+			decompressed.bone = track.bone;
+			decompressed.interpolation = key.rotation[2] & 0x8000 ? InterpolationT::BEZIER : InterpolationT::LINEAR;
+			decompressed.time = dequantize(key.time, start_time, end_time - start_time);
+
+			Transform & transform = decompressed.transform;
+			dequantize_rotation(key.rotation, transform.rotation);
+
+			for (std::size_t k = 0; k < 3; k += 1) {
+				transform.translation[k] = dequantize(key.translation[k], track.translation_minimum[k], track.translation_extent[k]);
+				transform.scale[k] = dequantize(key.scale[k], track.scale_minimum[k], track.scale_extent[k]);
+			}
+
+			transform.translation[3] = transform.scale[3] = 0;
+
+			return decompressed;
+		}
+
+		// Each track, which is a range of keys of the same bone, is quantized within its own range. Times are quantized within the range of the animation:
+		static void quantize_keys(const std::vector<KeyT> & keys, float32 start_time, float32 end_time, std::vector<CompressedTrack> & tracks, std::vector<CompressedKey> & compressed) {
+			const float32 infinity = std::numeric_limits<float32>::infinity();
+
+			tracks.clear();
+			compressed.resize(keys.size());
+
+			for (std::size_t first = 0; first < keys.size();) {
+				std::size_t last = first;
+				while (last < keys.size() && keys[last].bone == keys[first].bone) last += 1;
+
+				CompressedTrack track;
+				track.bone = keys[first].bone;
+				track.first_key = first;
+				track.key_count = last - first;
+
+				for (std::size_t k = 0; k < 3; k += 1) {
+					float32 translation_maximum = -infinity, scale_maximum = -infinity;
+					track.translation_minimum[k] = track.scale_minimum[k] = infinity;
+
+					for (std::size_t i = first; i < last; i += 1) {
+						track.translation_minimum[k] = std::min(track.translation_minimum[k], keys[i].transform.translation[k]);
+						track.scale_minimum[k] = std::min(track.scale_minimum[k], keys[i].transform.scale[k]);
+
+						translation_maximum = std::max(translation_maximum, keys[i].transform.translation[k]);
+						scale_maximum = std::max(scale_maximum, keys[i].transform.scale[k]);
+					}
+
+					track.translation_extent[k] = translation_maximum - track.translation_minimum[k];
+					track.scale_extent[k] = scale_maximum - track.scale_minimum[k];
+				}
+
+				for (std::size_t i = first; i < last; i += 1) {
+					auto & key = compressed[i];
+					auto & transform = keys[i].transform;
+
+					key.time = quantize(keys[i].time, start_time, end_time - start_time);
+					quantize_rotation(transform.rotation, keys[i].interpolation == InterpolationT::BEZIER, key.rotation);
+
+					for (std::size_t k = 0; k < 3; k += 1) {
+						key.translation[k] = quantize(transform.translation[k], track.translation_minimum[k], track.translation_extent[k]);
+						key.scale[k] = quantize(transform.scale[k], track.scale_minimum[k], track.scale_extent[k]);
+					}
+				}
+
+				tracks.push_back(track);
+				first = last;
+			}
+		}
+
+		// The largest error between the original keys and the keys as they are decompressed, including the error of interpolating between the keys which remain:
+		static float32 compressed_error(const std::vector<KeyT> & original, float32 start_time, float32 end_time, const std::vector<CompressedTrack> & tracks, const std::vector<CompressedKey> & compressed) {
+			std::vector<KeyT> decompressed;
+			decompressed.reserve(compressed.size());
+
+			for (auto & track : tracks) {
+				for (std::size_t i = track.first_key; i < track.first_key + track.key_count; i += 1)
+					decompressed.push_back(decompress_key(compressed[i], track, start_time, end_time));
+			}
+
+			AnimationSampler sampler(nullptr, std::move(decompressed));
+			auto cursors = sampler.cursors();
+
+			float32 maximum = 0;
+
+			for (auto & key : original) {
+				Transform transform;
+				sampler.sample_bone(key.bone, key.time, cursors, transform);
+
+				maximum = std::max(maximum, error(transform, key.transform));
+			}
+
+			return maximum;
+		}
+
+		OffsetT compress(Writer & writer, OffsetT key_frames_offset, float32 tolerance) {
+			if (!key_frames_offset || writer.block_at_offset<Block>(key_frames_offset)->tag != SkeletonAnimationKeyFrame::TAG)
+				return 0;
+
+			auto original = AnimationSampler::decompose_key_frames(*writer.block_at_offset<Array<SkeletonAnimationKeyFrame>>(key_frames_offset));
+
+			if (original.empty())
+				return 0;
+
+			float32 start_time = original.front().time, end_time = original.front().time;
+
+			for (auto & key : original) {
+				start_time = std::min(start_time, key.time);
+				end_time = std::max(end_time, key.time);
+			}
+
+			std::vector<CompressedTrack> tracks;
+			std::vector<CompressedKey> compressed;
+
+			// Quantizing every key shows how much of the tolerance quantization uses, e.g. 16 bits over a 100m track is a 1.5mm step, and the rest is left for removing keys:
+			sort_keys(original);
+			quantize_keys(original, start_time, end_time, tracks, compressed);
+
+			float32 quantization_error = compressed_error(original, start_time, end_time, tracks, compressed);
+
+			if (quantization_error > tolerance)
+				return 0;
+
+			auto keys = reduce(original, tolerance - quantization_error);
+			quantize_keys(keys, start_time, end_time, tracks, compressed);
+
+			// Tracks of the reduced keys have smaller ranges, so this is usually within the tolerance, but if not, the key frames are kept uncompressed:
+			if (compressed_error(original, start_time, end_time, tracks, compressed) > tolerance)
+				return 0;
+
+			auto keys_array = writer.append<Array<CompressedKey>>(Array<CompressedKey>::array_size(compressed.size()));
+			std::copy(compressed.begin(), compressed.end(), keys_array->begin());
+			OffsetT keys_offset = keys_array;
+
+			auto tracks_array = writer.append<Array<CompressedTrack>>(Array<CompressedTrack>::array_size(tracks.size()));
+			std::copy(tracks.begin(), tracks.end(), tracks_array->begin());
+			OffsetT tracks_offset = tracks_array;
+
+			auto animation = writer.append<CompressedAnimation>();
+			animation->start_time = start_time;
+			animation->end_time = end_time;
+			animation->tolerance = tolerance;
+			animation->tracks_offset = tracks_offset;
+			animation->keys_offset = keys_offset;
+
+			return animation;
+		}
+
+		void compress_animations(Writer & writer, const std::vector<OffsetT> & offsets, float32 tolerance) {
+			// Key frames shared between animations are only compressed once:
+			std::map<OffsetT, OffsetT> compressed;
+
+			for (auto offset : offsets) {
+				if (writer.block_at_offset<Block>(offset)->tag != SkeletonAnimation::TAG) continue;
+
+				OffsetT key_frames_offset = writer.block_at_offset<SkeletonAnimation>(offset)->key_frames_offset;
+				OffsetT resampled_offset = 0;
+
+				// Resampled animations keep a reference to their key frames, which are compressed instead:
+				if (key_frames_offset && writer.block_at_offset<Block>(key_frames_offset)->tag == ResampledAnimation::TAG) {
+					resampled_offset = key_frames_offset;
+					key_frames_offset = writer.block_at_offset<ResampledAnimation>(resampled_offset)->key_frames_offset;
+				}
+
+				if (!compressed.count(key_frames_offset))
+					compressed[key_frames_offset] = compress(writer, key_frames_offset, tolerance);
+
+				if (auto compressed_offset = compressed[key_frames_offset]) {
+					if (resampled_offset)
+						writer.block_at_offset<ResampledAnimation>(resampled_offset)->key_frames_offset = compressed_offset;
+					else
+						writer.block_at_offset<SkeletonAnimation>(offset)->key_frames_offset = compressed_offset;
+				}
+			}
+		}
+
+		std::vector<KeyT> decompress(const CompressedAnimation * animation, const Array<CompressedTrack> * tracks, const Array<CompressedKey> * keys) {
+			std::vector<KeyT> result;
+
+			if (!animation || !tracks || !keys)
+				return result;
+
+			result.reserve(keys->count());
+
+			for (auto & track : *tracks) {
+				if (track.first_key + track.key_count > keys->count()) continue;
+
+				for (std::size_t i = track.first_key; i < track.first_key + track.key_count; i += 1)
+					result.push_back(decompress_key(keys->at(i), track, animation->start_time, animation->end_time));
+			}
+
+			return result;
+		}
+
+		std::vector<KeyT> read_keys(Reader & reader, OffsetT key_frames_offset) {
+			auto block = reader.block_at_offset(key_frames_offset);
+
+			if (!block)
+				return {};
+
+			if (block->tag == SkeletonAnimationKeyFrame::TAG)
+				return AnimationSampler::decompose_key_frames(reader.array_at_offset<SkeletonAnimationKeyFrame>(key_frames_offset));
+
+			if (block->tag == CompressedAnimation::TAG) {
+				auto animation = static_cast<const CompressedAnimation *>(block);
+
+				return decompress(animation, reader.array_at_offset<CompressedTrack>(animation->tracks_offset), reader.array_at_offset<CompressedKey>(animation->keys_offset));
+			}
+
+			if (block->tag == ResampledAnimation::TAG)
+				return read_keys(reader, static_cast<const ResampledAnimation *>(block)->key_frames_offset);
+
+			return {};
+		}
+	}
+}
@@ -0,0 +1,89 @@
+//
+//  AnimationCompression.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Animation.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	class Reader;
+
+	/// The key frames of one bone in a `CompressedAnimation`. Translations and scales are quantized within the range of the track.
+	struct CompressedTrack {
+		static const TagT TAG = tag_from_identifier("CTRK");
+
+		alignas(4) BoneID bone;
+
+		/// The keys of this track are `[first_key, first_key + key_count)`, in order of time.
+		uint32_t first_key;
+		uint32_t key_count;
+
+		float32 translation_minimum[3], translation_extent[3];
+		float32 scale_minimum[3], scale_extent[3];
+	};
+
+	/// A quantized key frame.
+	struct CompressedKey {
+		static const TagT TAG = tag_from_identifier("CKEY");
+
+		/// The time within the range of the animation.
+		uint16_t time;
+
+		/// The rotation as its three smallest components, each in the low 15 bits. The high bits of the first two give the index of the largest component, which is positive and derived from the others, and the high bit of the last is set for `BEZIER` interpolation.
+		uint16_t rotation[3];
+
+		uint16_t translation[3];
+		uint16_t scale[3];
+	};
+
+	/// A compressed replacement for an `Array<SkeletonAnimationKeyFrame>`, which can be referenced by `SkeletonAnimation::key_frames_offset`.
+	struct CompressedAnimation : public Block {
+		static const TagT TAG = tag_from_identifier("CANM");
+
+		/// The range of the times of the keys.
+		float32 start_time, end_time;
+
+		/// The error tolerance used to remove keys.
+		float32 tolerance;
+
+		/// An `Array<CompressedTrack>`.
+		OffsetT tracks_offset;
+
+		/// An `Array<CompressedKey>`.
+		OffsetT keys_offset;
+	};
+
+	/// Lossy compression of skeletal animation. Key frames are decomposed into translation, rotation and scale, keys which can be reconstructed by interpolating their neighbours are removed, and the remaining keys are quantized to 20 bytes.
+	namespace AnimationCompression
+	{
+		const float32 DEFAULT_TOLERANCE = 0.001f;
+
+		/// @returns the error between two transforms: the distance between their translations, plus the angle between their rotations in radians, i.e. the distance a point at unit distance moves, plus the largest difference in scale.
+		float32 error(const Transform & a, const Transform & b);
+
+		/// Remove keys, other than the first of each bone, whose transform differs from the interpolation of the keys which remain by no more than the tolerance.
+		std::vector<AnimationSampler::Key> reduce(std::vector<AnimationSampler::Key> keys, float32 tolerance);
+
+		/// Compress an `Array<SkeletonAnimationKeyFrame>`. Keys are removed within the part of the tolerance which quantization doesn't use, and the decompressed keys are checked against the original keys.
+		/// @returns the offset of the new `CompressedAnimation`, or 0 if there are no key frames, or if they can't be quantized within the tolerance, e.g. a track with a very large range, in which case they should be kept uncompressed.
+		OffsetT compress(Writer & writer, OffsetT key_frames_offset, float32 tolerance = DEFAULT_TOLERANCE);
+
+		/// Compress the key frames of every `SkeletonAnimation` within `offsets`, including those kept by a `ResampledAnimation`.
+		void compress_animations(Writer & writer, const std::vector<OffsetT> & offsets, float32 tolerance = DEFAULT_TOLERANCE);
+
+		/// Decompress the keys directly into the working format of the sampler.
+		std::vector<AnimationSampler::Key> decompress(const CompressedAnimation * animation, const Array<CompressedTrack> * tracks, const Array<CompressedKey> * keys);
+
+		/// @returns the keys of an `Array<SkeletonAnimationKeyFrame>`, a `CompressedAnimation`, or the key frames of a `ResampledAnimation`, e.g. referenced by `SkeletonAnimation::key_frames_offset`, or no keys if the block is missing.
+		std::vector<AnimationSampler::Key> read_keys(Reader & reader, OffsetT key_frames_offset);
+	}
+}
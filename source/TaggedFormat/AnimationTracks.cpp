@@ -0,0 +1,225 @@
+//
+//  AnimationTracks.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "AnimationTracks.hpp"
+#include "AnimationCompression.hpp"
+#include "Skeleton.hpp"
+#include "Table.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+namespace TaggedFormat
+{
+	TrackSampler::TrackSampler(const ResampledAnimation * animation, const Array<TrackSample> * samples) {
+		if (!animation || !samples)
+			throw std::invalid_argument("Resampled animation is missing!");
+
+		if (animation->frame_count == 0 || !(animation->sample_rate > 0))
+			throw std::invalid_argument("Resampled animation has no frames!");
+
+		if (samples->count() < std::size_t(animation->frame_count) * animation->bone_count)
+			throw std::invalid_argument("Resampled animation has too few samples!");
+
+		_samples = samples->begin();
+		_bone_count = animation->bone_count;
+		_frame_count = animation->frame_count;
+
+		if (animation->layout == ResampledAnimation::Layout::BONE_MAJOR) {
+			_bone_stride = _frame_count;
+			_frame_stride = 1;
+		} else {
+			_bone_stride = 1;
+			_frame_stride = _bone_count;
+		}
+
+		_start_time = animation->start_time;
+		_sample_rate = animation->sample_rate;
+	}
+
+	void TrackSampler::find(float32 time, std::size_t & frame, std::size_t & next, float32 & factor) const {
+		float32 last = static_cast<float32>(_frame_count - 1);
+		float32 position = std::min(std::max((time - _start_time) * _sample_rate, 0.0f), last);
+
+		frame = static_cast<std::size_t>(position);
+		next = std::min(frame + 1, _frame_count - 1);
+		factor = position - frame;
+	}
+
+	static void blend(const TrackSample & from, const TrackSample & to, float32 factor, Transform & transform) {
+		float32 length = 0;
+
+		for (std::size_t i = 0; i < 3; i += 1) {
+			transform.translation[i] = from.translation[i] + (to.translation[i] - from.translation[i]) * factor;
+			transform.scale[i] = from.scale[i] + (to.scale[i] - from.scale[i]) * factor;
+		}
+
+		for (std::size_t i = 0; i < 4; i += 1) {
+			transform.rotation[i] = from.rotation[i] + (to.rotation[i] - from.rotation[i]) * factor;
+			length += transform.rotation[i] * transform.rotation[i];
+		}
+
+		// Adjacent samples are in the same hemisphere, so the length is never close to zero:
+		float32 reciprocal = 1 / std::sqrt(length);
+
+		for (std::size_t i = 0; i < 4; i += 1)
+			transform.rotation[i] *= reciprocal;
+
+		transform.translation[3] = transform.scale[3] = 0;
+	}
+
+	void TrackSampler::sample_bone(BoneID bone, float32 time, Transform & transform) const {
+		std::size_t frame, next;
+		float32 factor;
+
+		find(time, frame, next, factor);
+
+		const TrackSample * samples = _samples + bone * _bone_stride;
+		blend(samples[frame * _frame_stride], samples[next * _frame_stride], factor, transform);
+	}
+
+	void TrackSampler::sample(float32 time, Transform * pose) const {
+		std::size_t frame, next;
+		float32 factor;
+
+		find(time, frame, next, factor);
+
+		const TrackSample * from = _samples + frame * _frame_stride, * to = _samples + next * _frame_stride;
+
+		for (std::size_t bone = 0; bone < _bone_count; bone += 1)
+			blend(from[bone * _bone_stride], to[bone * _bone_stride], factor, pose[bone]);
+	}
+
+	namespace AnimationTracks
+	{
+		// The keys of either format, read from the buffer being written:
+		static std::vector<AnimationSampler::Key> keys_at_offset(Writer & writer, OffsetT key_frames_offset) {
+			if (!key_frames_offset)
+				return {};
+
+			auto block = writer.block_at_offset<Block>(key_frames_offset);
+
+			if (block->tag == SkeletonAnimationKeyFrame::TAG)
+				return AnimationSampler::decompose_key_frames(*writer.block_at_offset<Array<SkeletonAnimationKeyFrame>>(key_frames_offset));
+
+			if (block->tag == CompressedAnimation::TAG) {
+				auto animation = writer.block_at_offset<CompressedAnimation>(key_frames_offset);
+
+				return AnimationCompression::decompress(*animation, *writer.block_at_offset<Array<CompressedTrack>>(animation->tracks_offset), *writer.block_at_offset<Array<CompressedKey>>(animation->keys_offset));
+			}
+
+			return {};
+		}
+
+		OffsetT resample(Writer & writer, OffsetT animation_offset, float32 sample_rate, ResampledAnimation::Layout layout, OffsetT bones_offset) {
+			if (!(sample_rate > 0))
+				throw std::invalid_argument("Sample rate must be positive!");
+
+			OffsetT key_frames_offset = writer.block_at_offset<SkeletonAnimation>(animation_offset)->key_frames_offset;
+			auto keys = keys_at_offset(writer, key_frames_offset);
+
+			if (keys.empty())
+				return 0;
+
+			const Array<SkeletonBone> * bones = nullptr;
+
+			if (bones_offset && writer.block_at_offset<Block>(bones_offset)->tag == SkeletonBone::TAG)
+				bones = *writer.block_at_offset<Array<SkeletonBone>>(bones_offset);
+
+			// The sampler copies the bind pose, so it doesn't refer to the buffer after it is constructed:
+			AnimationSampler sampler(bones, std::move(keys));
+
+			float32 start_time = writer.block_at_offset<SkeletonAnimation>(animation_offset)->start_time;
+			float32 end_time = writer.block_at_offset<SkeletonAnimation>(animation_offset)->end_time;
+
+			if (!(end_time > start_time)) {
+				start_time = sampler.start_time();
+				end_time = sampler.end_time();
+			}
+
+			// The last frame is at or just after the end time, allowing for rounding when the duration is a whole number of frames:
+			std::size_t frame_count = static_cast<std::size_t>(std::ceil((end_time - start_time) * sample_rate - 1e-3f)) + 1;
+			std::size_t bone_count = sampler.bone_count();
+
+			std::size_t bone_stride = layout == ResampledAnimation::Layout::BONE_MAJOR ? frame_count : 1;
+			std::size_t frame_stride = layout == ResampledAnimation::Layout::BONE_MAJOR ? 1 : bone_count;
+
+			std::vector<TrackSample> samples(frame_count * bone_count);
+			std::vector<Transform> pose(bone_count);
+			auto cursors = sampler.cursors();
+
+			for (std::size_t frame = 0; frame < frame_count; frame += 1) {
+				sampler.sample(std::min(start_time + frame / sample_rate, end_time), cursors, pose.data());
+
+				for (std::size_t bone = 0; bone < bone_count; bone += 1) {
+					auto & sample = samples[bone * bone_stride + frame * frame_stride];
+					auto & transform = pose[bone];
+
+					std::copy(transform.translation, transform.translation + 3, sample.translation);
+					std::copy(transform.rotation, transform.rotation + 4, sample.rotation);
+					std::copy(transform.scale, transform.scale + 3, sample.scale);
+
+					// Keep each rotation in the same hemisphere as the previous frame, so that the sampler can interpolate without checking:
+					if (frame > 0) {
+						auto & previous = samples[bone * bone_stride + (frame - 1) * frame_stride];
+						float32 dot = 0;
+
+						for (std::size_t i = 0; i < 4; i += 1) dot += previous.rotation[i] * sample.rotation[i];
+
+						if (dot < 0)
+							for (std::size_t i = 0; i < 4; i += 1) sample.rotation[i] = -sample.rotation[i];
+					}
+				}
+			}
+
+			auto samples_array = writer.append<Array<TrackSample>>(Array<TrackSample>::array_size(samples.size()));
+			std::copy(samples.begin(), samples.end(), samples_array->begin());
+			OffsetT samples_offset = samples_array;
+
+			auto resampled = writer.append<ResampledAnimation>();
+			resampled->sample_rate = sample_rate;
+			resampled->start_time = start_time;
+			resampled->frame_count = frame_count;
+			resampled->bone_count = bone_count;
+			resampled->layout = layout;
+			resampled->samples_offset = samples_offset;
+			resampled->key_frames_offset = key_frames_offset;
+
+			return resampled;
+		}
+
+		void resample_animations(Writer & writer, const std::vector<OffsetT> & offsets, float32 sample_rate, ResampledAnimation::Layout layout) {
+			// The bones of the skeleton which each animation belongs to. An animation shared by several skeletons uses the first:
+			std::map<OffsetT, OffsetT> bones_for_animation;
+
+			for (auto offset : offsets) {
+				if (writer.block_at_offset<Block>(offset)->tag != Skeleton::TAG) continue;
+
+				auto skeleton = writer.block_at_offset<Skeleton>(offset);
+
+				if (!skeleton->bones_offset || !skeleton->sequences_offset) continue;
+				if (writer.block_at_offset<Block>(skeleton->sequences_offset)->tag != OffsetTable::TAG) continue;
+
+				for (auto & sequence : **writer.block_at_offset<OffsetTable>(skeleton->sequences_offset))
+					bones_for_animation.insert({sequence.offset, skeleton->bones_offset});
+			}
+
+			for (auto offset : offsets) {
+				if (writer.block_at_offset<Block>(offset)->tag != SkeletonAnimation::TAG) continue;
+
+				auto bones = bones_for_animation.find(offset);
+				OffsetT bones_offset = bones != bones_for_animation.end() ? bones->second : 0;
+
+				if (auto resampled_offset = resample(writer, offset, sample_rate, layout, bones_offset))
+					writer.block_at_offset<SkeletonAnimation>(offset)->key_frames_offset = resampled_offset;
+			}
+		}
+	}
+}
@@ -0,0 +1,104 @@
+//
+//  AnimationTracks.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Animation.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// The local transform of one bone in one frame of a `ResampledAnimation`.
+	struct TrackSample {
+		static const TagT TAG = tag_from_identifier("TSMP");
+
+		float32 translation[3];
+
+		/// A unit quaternion (x, y, z, w), in the same hemisphere as the sample of the same bone in the previous frame.
+		float32 rotation[4];
+
+		float32 scale[3];
+	};
+
+	/// An animation baked into frames at a fixed rate, which can be referenced by `SkeletonAnimation::key_frames_offset`. Every bone has a sample in every frame, so evaluation needs no search.
+	struct ResampledAnimation : public Block {
+		static const TagT TAG = tag_from_identifier("RSMP");
+
+		enum class Layout : uint32_t {
+			/// The samples of every bone in the first frame, then the second frame, etc. Evaluating a whole pose reads two contiguous runs of samples.
+			FRAME_MAJOR = 0,
+
+			/// All the frames of the first bone, then the second bone, etc. Evaluating a single bone over time reads contiguous samples.
+			BONE_MAJOR = 1,
+		};
+
+		/// Frames per second.
+		float32 sample_rate;
+
+		/// The time of the first frame.
+		float32 start_time;
+
+		uint32_t frame_count;
+		uint32_t bone_count;
+
+		Layout layout;
+
+		/// An `Array<TrackSample>` with `frame_count * bone_count` samples.
+		OffsetT samples_offset;
+
+		/// The key frames which were resampled, either an `Array<SkeletonAnimationKeyFrame>` or a `CompressedAnimation`.
+		OffsetT key_frames_offset;
+	};
+
+	/// Evaluates a `ResampledAnimation` directly from the mapped samples. The frame is found from the time with one multiplication, and each bone interpolates between two adjacent frames, normalizing the linear interpolation of the rotations, which is accurate at typical sample rates as adjacent rotations are close. There are no searches or branches which depend on the time, so the cost is the same for every sample.
+	class TrackSampler {
+	public:
+		TrackSampler(const ResampledAnimation * animation, const Array<TrackSample> * samples);
+
+		std::size_t bone_count() const {return _bone_count;}
+		std::size_t frame_count() const {return _frame_count;}
+
+		float32 start_time() const {return _start_time;}
+		float32 end_time() const {return _start_time + (_frame_count - 1) / _sample_rate;}
+
+		/// Evaluate the local transform of every bone at the given time. Outside the range of the frames, the first or last frame is held.
+		/// @param pose space for `bone_count()` transforms.
+		void sample(float32 time, Transform * pose) const;
+
+		/// Evaluate the local transform of a single bone.
+		void sample_bone(BoneID bone, float32 time, Transform & transform) const;
+
+	private:
+		const TrackSample * _samples;
+
+		std::size_t _bone_count, _frame_count;
+
+		/// The distance between consecutive samples of the same frame, and of the same bone, which depend on the layout.
+		std::size_t _bone_stride, _frame_stride;
+
+		float32 _start_time, _sample_rate;
+
+		void find(float32 time, std::size_t & frame, std::size_t & next, float32 & factor) const;
+	};
+
+	/// Baking of skeletal animations into fixed rate tracks.
+	namespace AnimationTracks
+	{
+		const float32 DEFAULT_SAMPLE_RATE = 30;
+
+		/// Resample the key frames of a `SkeletonAnimation` between its start and end times, or the times of its key frames if the range is empty. The key frames may be compressed.
+		/// @param bones_offset the bones of the skeleton which plays the animation, whose bind pose is used for bones without key frames, or 0 to use the identity and only sample the bones up to the highest one with key frames.
+		/// @returns the offset of the new `ResampledAnimation`, or 0 if there are no key frames.
+		OffsetT resample(Writer & writer, OffsetT animation_offset, float32 sample_rate = DEFAULT_SAMPLE_RATE, ResampledAnimation::Layout layout = ResampledAnimation::Layout::FRAME_MAJOR, OffsetT bones_offset = 0);
+
+		/// Replace the key frames of every `SkeletonAnimation` within `offsets` with a `ResampledAnimation`, which keeps a reference to them. Animations in the sequences of a `Skeleton` within `offsets` are resampled with the bones of that skeleton.
+		void resample_animations(Writer & writer, const std::vector<OffsetT> & offsets, float32 sample_rate = DEFAULT_SAMPLE_RATE, ResampledAnimation::Layout layout = ResampledAnimation::Layout::FRAME_MAJOR);
+	}
+}
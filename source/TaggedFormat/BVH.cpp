@@ -0,0 +1,686 @@
+//
+//  BVH.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "BVH.hpp"
+#include "Geometry.hpp"
+#include "Reader.hpp"
+#include "Topology.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace TaggedFormat
+{
+	namespace BVH
+	{
+		// The number of candidate split planes per axis:
+		const std::size_t BIN_COUNT = 16;
+
+		// Nodes with this many triangles or fewer are always leaves:
+		const std::size_t LEAF_SIZE = 4;
+
+		// The surface area heuristic may choose leaves up to this size:
+		const std::size_t MAX_LEAF_SIZE = 16;
+
+		// Limits the depth of the tree, and therefore the traversal stack, for degenerate input:
+		const std::size_t MAX_DEPTH = 64;
+		const std::size_t STACK_SIZE = MAX_DEPTH * 3 + 4;
+
+		struct Vector {
+			float x, y, z;
+
+			Vector() {}
+			Vector(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+			explicit Vector(const float32 * v) : x(v[0]), y(v[1]), z(v[2]) {}
+
+			Vector operator+(const Vector & other) const {return {x + other.x, y + other.y, z + other.z};}
+			Vector operator-(const Vector & other) const {return {x - other.x, y - other.y, z - other.z};}
+			Vector operator*(float factor) const {return {x * factor, y * factor, z * factor};}
+
+			float dot(const Vector & other) const {return x * other.x + y * other.y + z * other.z;}
+
+			Vector cross(const Vector & other) const {
+				return {y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x};
+			}
+
+			float operator[](std::size_t i) const {return i == 0 ? x : (i == 1 ? y : z);}
+		};
+
+		struct Box {
+			float minimum[3], maximum[3];
+
+			Box() {
+				std::fill_n(minimum, 3, std::numeric_limits<float>::infinity());
+				std::fill_n(maximum, 3, -std::numeric_limits<float>::infinity());
+			}
+
+			void extend(const Vector & point) {
+				for (std::size_t k = 0; k < 3; k += 1) {
+					minimum[k] = std::min(minimum[k], point[k]);
+					maximum[k] = std::max(maximum[k], point[k]);
+				}
+			}
+
+			void extend(const Box & other) {
+				for (std::size_t k = 0; k < 3; k += 1) {
+					minimum[k] = std::min(minimum[k], other.minimum[k]);
+					maximum[k] = std::max(maximum[k], other.maximum[k]);
+				}
+			}
+
+			float area() const {
+				float dx = maximum[0] - minimum[0], dy = maximum[1] - minimum[1], dz = maximum[2] - minimum[2];
+
+				if (dx < 0 || dy < 0 || dz < 0) return 0;
+
+				return 2 * (dx * dy + dy * dz + dz * dx);
+			}
+		};
+
+		// A node of the binary tree, which is a leaf if count > 0:
+		struct BuildNode {
+			Box box;
+			uint32_t left = 0, right = 0;
+			uint32_t first = 0, count = 0;
+		};
+
+		class Builder {
+		public:
+			Builder(const std::vector<Box> & boxes) : _boxes(boxes), _order(boxes.size())
+			{
+				_centroids.reserve(boxes.size());
+
+				for (std::size_t i = 0; i < boxes.size(); i += 1) {
+					_order[i] = static_cast<uint32_t>(i);
+
+					auto & box = boxes[i];
+					_centroids.push_back({(box.minimum[0] + box.maximum[0]) / 2, (box.minimum[1] + box.maximum[1]) / 2, (box.minimum[2] + box.maximum[2]) / 2});
+				}
+
+				build(0, static_cast<uint32_t>(boxes.size()), 0);
+			}
+
+			const std::vector<BuildNode> & nodes() const {return _nodes;}
+			const std::vector<uint32_t> & order() const {return _order;}
+
+		private:
+			const std::vector<Box> & _boxes;
+			std::vector<Vector> _centroids;
+			std::vector<uint32_t> _order;
+			std::vector<BuildNode> _nodes;
+
+			uint32_t build(uint32_t first, uint32_t count, std::size_t depth) {
+				uint32_t index = static_cast<uint32_t>(_nodes.size());
+				_nodes.emplace_back();
+
+				Box box, centroid_box;
+
+				for (uint32_t i = first; i < first + count; i += 1) {
+					box.extend(_boxes[_order[i]]);
+					centroid_box.extend(_centroids[_order[i]]);
+				}
+
+				_nodes[index].box = box;
+
+				auto leaf = [&]() {
+					_nodes[index].first = first;
+					_nodes[index].count = count;
+
+					return index;
+				};
+
+				if (count <= LEAF_SIZE || depth >= MAX_DEPTH)
+					return leaf();
+
+				// Find the cheapest split by binning centroids along each axis:
+				float best_cost = std::numeric_limits<float>::infinity();
+				int best_axis = -1;
+				std::size_t best_split = 0;
+
+				for (std::size_t axis = 0; axis < 3; axis += 1) {
+					float minimum = centroid_box.minimum[axis], extent = centroid_box.maximum[axis] - minimum;
+
+					if (!(extent > 0)) continue;
+
+					Box bins[BIN_COUNT];
+					uint32_t bin_counts[BIN_COUNT] = {0};
+
+					float scale = BIN_COUNT / extent;
+
+					for (uint32_t i = first; i < first + count; i += 1) {
+						std::size_t bin = std::min<std::size_t>(BIN_COUNT - 1, static_cast<std::size_t>((_centroids[_order[i]][axis] - minimum) * scale));
+
+						bins[bin].extend(_boxes[_order[i]]);
+						bin_counts[bin] += 1;
+					}
+
+					float right_areas[BIN_COUNT];
+					uint32_t right_counts[BIN_COUNT];
+					Box right;
+					uint32_t right_count = 0;
+
+					for (std::size_t bin = BIN_COUNT - 1; bin > 0; bin -= 1) {
+						right.extend(bins[bin]);
+						right_count += bin_counts[bin];
+
+						right_areas[bin] = right.area();
+						right_counts[bin] = right_count;
+					}
+
+					Box left;
+					uint32_t left_count = 0;
+
+					for (std::size_t split = 1; split < BIN_COUNT; split += 1) {
+						left.extend(bins[split - 1]);
+						left_count += bin_counts[split - 1];
+
+						if (left_count == 0 || right_counts[split] == 0) continue;
+
+						float cost = left.area() * left_count + right_areas[split] * right_counts[split];
+
+						if (cost < best_cost) {
+							best_cost = cost;
+							best_axis = static_cast<int>(axis);
+							best_split = split;
+						}
+					}
+				}
+
+				uint32_t middle = first + count / 2;
+
+				if (best_axis >= 0) {
+					float area = box.area();
+
+					// A traversal step costs about the same as a triangle test:
+					if (count <= MAX_LEAF_SIZE && area > 0 && 1 + best_cost / area >= count)
+						return leaf();
+
+					float minimum = centroid_box.minimum[best_axis];
+					float scale = BIN_COUNT / (centroid_box.maximum[best_axis] - minimum);
+
+					auto partition = std::partition(_order.begin() + first, _order.begin() + first + count, [&](uint32_t triangle) {
+						return std::min<std::size_t>(BIN_COUNT - 1, static_cast<std::size_t>((_centroids[triangle][best_axis] - minimum) * scale)) < best_split;
+					});
+
+					middle = static_cast<uint32_t>(partition - _order.begin());
+				} else if (count <= MAX_LEAF_SIZE) {
+					return leaf();
+				}
+
+				// Fall back to splitting in the middle if the partition was degenerate:
+				if (middle == first || middle == first + count)
+					middle = first + count / 2;
+
+				uint32_t left = build(first, middle - first, depth + 1);
+				uint32_t right = build(middle, first + count - middle, depth + 1);
+
+				_nodes[index].left = left;
+				_nodes[index].right = right;
+
+				return index;
+			}
+		};
+
+		// Collapse the binary tree by repeatedly opening the child with the largest surface area:
+		static uint32_t collapse(const std::vector<BuildNode> & binary, uint32_t index, std::vector<BVHNode> & nodes) {
+			std::vector<uint32_t> children;
+
+			if (binary[index].count)
+				children.push_back(index);
+			else
+				children = {binary[index].left, binary[index].right};
+
+			while (children.size() < 4) {
+				int largest = -1;
+				float largest_area = -1;
+
+				for (std::size_t i = 0; i < children.size(); i += 1) {
+					auto & child = binary[children[i]];
+
+					if (child.count == 0 && child.box.area() > largest_area) {
+						largest = static_cast<int>(i);
+						largest_area = child.box.area();
+					}
+				}
+
+				if (largest < 0) break;
+
+				uint32_t opened = children[largest];
+				children[largest] = binary[opened].left;
+				children.push_back(binary[opened].right);
+			}
+
+			uint32_t result = static_cast<uint32_t>(nodes.size());
+			nodes.emplace_back();
+
+			BVHNode node;
+			std::memset(&node, 0, sizeof(node));
+			std::fill_n(node.children, 4, BVHNode::EMPTY);
+
+			for (std::size_t i = 0; i < children.size(); i += 1) {
+				auto & child = binary[children[i]];
+
+				node.minimum_x[i] = child.box.minimum[0];
+				node.minimum_y[i] = child.box.minimum[1];
+				node.minimum_z[i] = child.box.minimum[2];
+				node.maximum_x[i] = child.box.maximum[0];
+				node.maximum_y[i] = child.box.maximum[1];
+				node.maximum_z[i] = child.box.maximum[2];
+
+				if (child.count) {
+					node.children[i] = child.first;
+					node.counts[i] = child.count;
+				} else {
+					node.children[i] = collapse(binary, children[i], nodes);
+				}
+			}
+
+			nodes[result] = node;
+
+			return result;
+		}
+
+		void build_boxes(const std::vector<float32> & boxes, std::vector<BVHNode> & nodes, std::vector<uint32_t> & order) {
+			nodes.clear();
+			order.clear();
+
+			std::vector<Box> input(boxes.size() / 6);
+
+			for (std::size_t i = 0; i < input.size(); i += 1) {
+				std::copy_n(&boxes[i * 6], 3, input[i].minimum);
+				std::copy_n(&boxes[i * 6 + 3], 3, input[i].maximum);
+			}
+
+			if (input.empty()) return;
+
+			Builder builder(input);
+			collapse(builder.nodes(), 0, nodes);
+
+			order = builder.order();
+		}
+
+		void build(const std::vector<uint32_t> & indices, const std::vector<float32> & positions, std::vector<BVHNode> & nodes, std::vector<BVHTriangle> & triangles) {
+			nodes.clear();
+			triangles.clear();
+
+			std::size_t vertex_count = positions.size() / 3;
+			std::size_t triangle_count = indices.size() / 3;
+
+			std::vector<Box> boxes;
+			std::vector<uint32_t> sources;
+
+			for (std::size_t t = 0; t < triangle_count; t += 1) {
+				const uint32_t * triangle = &indices[t * 3];
+
+				if (triangle[0] >= vertex_count || triangle[1] >= vertex_count || triangle[2] >= vertex_count)
+					continue;
+
+				Box box;
+				for (std::size_t j = 0; j < 3; j += 1)
+					box.extend(Vector(&positions[triangle[j] * 3]));
+
+				boxes.push_back(box);
+				sources.push_back(static_cast<uint32_t>(t));
+			}
+
+			if (boxes.empty()) return;
+
+			Builder builder(boxes);
+			collapse(builder.nodes(), 0, nodes);
+
+			for (auto index : builder.order()) {
+				const uint32_t * triangle = &indices[sources[index] * 3];
+				Vector a(&positions[triangle[0] * 3]), b(&positions[triangle[1] * 3]), c(&positions[triangle[2] * 3]);
+				Vector edge1 = b - a, edge2 = c - a;
+
+				BVHTriangle output;
+				output.origin[0] = a.x; output.origin[1] = a.y; output.origin[2] = a.z;
+				output.edge1[0] = edge1.x; output.edge1[1] = edge1.y; output.edge1[2] = edge1.z;
+				output.edge2[0] = edge2.x; output.edge2[1] = edge2.y; output.edge2[2] = edge2.z;
+				output.index = sources[index];
+
+				triangles.push_back(output);
+			}
+		}
+
+		OffsetT build_mesh_bvh(Writer & writer, OffsetT mesh_offset) {
+			auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+
+			if (!mesh->indices_offset || !mesh->vertices_offset) return 0;
+
+			std::vector<uint32_t> indices;
+
+			if (mesh->layout == Mesh::Layout::TRIANGLES)
+				indices = read_indices(*writer.block_at_offset<Block>(mesh->indices_offset));
+			else if (mesh->layout == Mesh::Layout::TRIANGLE_STRIP)
+				indices = Topology::triangles_from_strip(read_indices(*writer.block_at_offset<Block>(mesh->indices_offset)));
+			else
+				return 0;
+
+			auto positions = read_positions(*writer.block_at_offset<Block>(mesh->vertices_offset));
+
+			std::vector<BVHNode> nodes;
+			std::vector<BVHTriangle> triangles;
+			build(indices, positions, nodes, triangles);
+
+			if (nodes.empty()) return 0;
+
+			auto nodes_block = writer.append<Array<BVHNode>>(Array<BVHNode>::array_size(nodes.size()));
+			std::copy(nodes.begin(), nodes.end(), nodes_block->begin());
+
+			auto triangles_block = writer.append<Array<BVHTriangle>>(Array<BVHTriangle>::array_size(triangles.size()));
+			std::copy(triangles.begin(), triangles.end(), triangles_block->begin());
+
+			auto tree = writer.append<TriangleBVH>();
+			tree->nodes_offset = nodes_block;
+			tree->triangles_offset = triangles_block;
+
+			set_mesh_metadata(writer, mesh_offset, METADATA_NAME, tree);
+
+			return tree;
+		}
+
+		bool tree_for_mesh(Reader & reader, const Mesh * mesh, Tree & tree) {
+			auto block = reader.block_at_offset<TriangleBVH>(reader.metadata_offset(mesh, METADATA_NAME));
+			if (!block) return false;
+
+			auto nodes = reader.block_at_offset<Array<BVHNode>>(block->nodes_offset);
+			auto triangles = reader.block_at_offset<Array<BVHTriangle>>(block->triangles_offset);
+
+			if (!nodes || !triangles || nodes->count() == 0) return false;
+
+			tree.nodes = nodes->begin();
+			tree.node_count = nodes->count();
+			tree.triangles = triangles->begin();
+			tree.triangle_count = triangles->count();
+
+			return true;
+		}
+
+#if !defined(__SSE__)
+		// Like minps and maxps, these return the second operand if either is NaN, which happens when a ray lies in the plane of a box face:
+		static inline float minimum(float a, float b) {return a < b ? a : b;}
+		static inline float maximum(float a, float b) {return a > b ? a : b;}
+#endif
+
+		// Intersect a ray with the 4 child boxes of a node.
+		// @returns a mask of the children which are hit within [0, limit], and their entry distances.
+		static int intersect_boxes(const BVHNode & node, const Vector & origin, const Vector & inverse, float limit, float entry[4]) {
+#if defined(__SSE__)
+			__m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+			__m128 ix = _mm_set1_ps(inverse.x), iy = _mm_set1_ps(inverse.y), iz = _mm_set1_ps(inverse.z);
+
+			__m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minimum_x), ox), ix);
+			__m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maximum_x), ox), ix);
+			__m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minimum_y), oy), iy);
+			__m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maximum_y), oy), iy);
+			__m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minimum_z), oz), iz);
+			__m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maximum_z), oz), iz);
+
+			__m128 near = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)), _mm_max_ps(_mm_min_ps(t0z, t1z), _mm_setzero_ps()));
+			__m128 far = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)), _mm_min_ps(_mm_max_ps(t0z, t1z), _mm_set1_ps(limit)));
+
+			_mm_storeu_ps(entry, near);
+
+			return _mm_movemask_ps(_mm_cmple_ps(near, far));
+#else
+			int mask = 0;
+
+			for (std::size_t i = 0; i < 4; i += 1) {
+				float t0x = (node.minimum_x[i] - origin.x) * inverse.x, t1x = (node.maximum_x[i] - origin.x) * inverse.x;
+				float t0y = (node.minimum_y[i] - origin.y) * inverse.y, t1y = (node.maximum_y[i] - origin.y) * inverse.y;
+				float t0z = (node.minimum_z[i] - origin.z) * inverse.z, t1z = (node.maximum_z[i] - origin.z) * inverse.z;
+
+				float near = maximum(maximum(minimum(t0x, t1x), minimum(t0y, t1y)), maximum(minimum(t0z, t1z), 0.0f));
+				float far = minimum(minimum(maximum(t0x, t1x), maximum(t0y, t1y)), minimum(maximum(t0z, t1z), limit));
+
+				entry[i] = near;
+				if (near <= far) mask |= 1 << i;
+			}
+
+			return mask;
+#endif
+		}
+
+		// Möller and Trumbore (1997), accepting hits from either side:
+		static bool intersect_triangle(const BVHTriangle & triangle, const Vector & origin, const Vector & direction, float limit, float & distance, float & u, float & v) {
+			Vector edge1(triangle.edge1), edge2(triangle.edge2);
+
+			Vector p = direction.cross(edge2);
+			float determinant = edge1.dot(p);
+
+			if (determinant == 0) return false;
+
+			float inverse = 1 / determinant;
+			Vector s = origin - Vector(triangle.origin);
+
+			u = s.dot(p) * inverse;
+			if (u < 0 || u > 1) return false;
+
+			Vector q = s.cross(edge1);
+
+			v = direction.dot(q) * inverse;
+			if (v < 0 || u + v > 1) return false;
+
+			distance = edge2.dot(q) * inverse;
+
+			return distance >= 0 && distance <= limit;
+		}
+
+		struct Entry {
+			uint32_t node;
+			float distance;
+		};
+
+		// Visit the nodes and leaves of the tree in order of distance. The leaf callback returns the new limit, and traversal stops if it is negative.
+		template <typename BoxesT, typename LeafT>
+		static void traverse(const Tree & tree, float limit, BoxesT && boxes, LeafT && leaf) {
+			if (tree.node_count == 0) return;
+
+			Entry stack[STACK_SIZE];
+			std::size_t top = 0;
+
+			stack[top++] = {0, 0};
+
+			while (top) {
+				Entry entry = stack[--top];
+
+				if (entry.distance > limit || entry.node >= tree.node_count) continue;
+
+				const BVHNode & node = tree.nodes[entry.node];
+
+				float distances[4];
+				int mask = boxes(node, limit, distances);
+
+				Entry children[4];
+				std::size_t child_count = 0;
+
+				for (std::size_t i = 0; i < 4; i += 1) {
+					if (!(mask & (1 << i)) || node.children[i] == BVHNode::EMPTY) continue;
+
+					if (node.counts[i]) {
+						std::size_t first = node.children[i], last = std::min<std::size_t>(first + node.counts[i], tree.triangle_count);
+
+						for (std::size_t t = first; t < last; t += 1) {
+							limit = leaf(tree.triangles[t], limit);
+
+							if (limit < 0) return;
+						}
+					} else {
+						children[child_count++] = {node.children[i], distances[i]};
+					}
+				}
+
+				// Push the farthest child first, so that the nearest is visited next:
+				for (std::size_t i = 1; i < child_count; i += 1) {
+					for (std::size_t j = i; j > 0 && children[j - 1].distance < children[j].distance; j -= 1)
+						std::swap(children[j - 1], children[j]);
+				}
+
+				for (std::size_t i = 0; i < child_count && top < STACK_SIZE; i += 1) {
+					stack[top++] = children[i];
+				}
+			}
+		}
+
+		static Vector inverse_of(const Vector & direction) {
+			return {1 / direction.x, 1 / direction.y, 1 / direction.z};
+		}
+
+		bool raycast(const Tree & tree, const float32 origin_[3], const float32 direction_[3], float32 limit, Hit & hit) {
+			Vector origin(origin_), direction(direction_), inverse = inverse_of(direction);
+			bool found = false;
+
+			auto boxes = [&](const BVHNode & node, float limit, float distances[4]) {
+				return intersect_boxes(node, origin, inverse, limit, distances);
+			};
+
+			traverse(tree, limit, boxes, [&](const BVHTriangle & triangle, float limit) {
+				float distance, u, v;
+
+				if (intersect_triangle(triangle, origin, direction, limit, distance, u, v)) {
+					hit.distance = distance;
+					hit.triangle = triangle.index;
+					hit.u = u;
+					hit.v = v;
+
+					found = true;
+
+					return distance;
+				}
+
+				return limit;
+			});
+
+			return found;
+		}
+
+		bool intersects_segment(const Tree & tree, const float32 from[3], const float32 to[3]) {
+			Vector origin(from), direction = Vector(to) - origin, inverse = inverse_of(direction);
+			bool found = false;
+
+			auto boxes = [&](const BVHNode & node, float limit, float distances[4]) {
+				return intersect_boxes(node, origin, inverse, limit, distances);
+			};
+
+			traverse(tree, 1, boxes, [&](const BVHTriangle & triangle, float limit) {
+				float distance, u, v;
+
+				if (intersect_triangle(triangle, origin, direction, limit, distance, u, v)) {
+					found = true;
+
+					// Any intersection will do:
+					return -1.0f;
+				}
+
+				return limit;
+			});
+
+			return found;
+		}
+
+		// Squared distances from a point to the 4 child boxes of a node.
+		static int box_distances(const BVHNode & node, const Vector & point, float limit, float distances[4]) {
+#if defined(__SSE__)
+			__m128 zero = _mm_setzero_ps();
+			__m128 px = _mm_set1_ps(point.x), py = _mm_set1_ps(point.y), pz = _mm_set1_ps(point.z);
+
+			__m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(node.minimum_x), px), _mm_sub_ps(px, _mm_loadu_ps(node.maximum_x))), zero);
+			__m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(node.minimum_y), py), _mm_sub_ps(py, _mm_loadu_ps(node.maximum_y))), zero);
+			__m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(node.minimum_z), pz), _mm_sub_ps(pz, _mm_loadu_ps(node.maximum_z))), zero);
+
+			__m128 squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+			_mm_storeu_ps(distances, squared);
+
+			return _mm_movemask_ps(_mm_cmple_ps(squared, _mm_set1_ps(limit)));
+#else
+			int mask = 0;
+
+			for (std::size_t i = 0; i < 4; i += 1) {
+				float dx = std::max(std::max(node.minimum_x[i] - point.x, point.x - node.maximum_x[i]), 0.0f);
+				float dy = std::max(std::max(node.minimum_y[i] - point.y, point.y - node.maximum_y[i]), 0.0f);
+				float dz = std::max(std::max(node.minimum_z[i] - point.z, point.z - node.maximum_z[i]), 0.0f);
+
+				distances[i] = dx * dx + dy * dy + dz * dz;
+				if (distances[i] <= limit) mask |= 1 << i;
+			}
+
+			return mask;
+#endif
+		}
+
+		// Ericson, Real-Time Collision Detection (2005), section 5.1.5:
+		static Vector closest_point_on_triangle(const BVHTriangle & triangle, const Vector & p) {
+			Vector a(triangle.origin), ab(triangle.edge1), ac(triangle.edge2);
+			Vector b = a + ab, c = a + ac;
+
+			Vector ap = p - a;
+			float d1 = ab.dot(ap), d2 = ac.dot(ap);
+			if (d1 <= 0 && d2 <= 0) return a;
+
+			Vector bp = p - b;
+			float d3 = ab.dot(bp), d4 = ac.dot(bp);
+			if (d3 >= 0 && d4 <= d3) return b;
+
+			float vc = d1 * d4 - d3 * d2;
+			if (vc <= 0 && d1 >= 0 && d3 <= 0) return a + ab * (d1 / (d1 - d3));
+
+			Vector cp = p - c;
+			float d5 = ab.dot(cp), d6 = ac.dot(cp);
+			if (d6 >= 0 && d5 <= d6) return c;
+
+			float vb = d5 * d2 - d1 * d6;
+			if (vb <= 0 && d2 >= 0 && d6 <= 0) return a + ac * (d2 / (d2 - d6));
+
+			float va = d3 * d6 - d5 * d4;
+			if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+			float denominator = 1 / (va + vb + vc);
+
+			return a + ab * (vb * denominator) + ac * (vc * denominator);
+		}
+
+		bool closest_point(const Tree & tree, const float32 point_[3], float32 limit_squared, ClosestPoint & result) {
+			Vector point(point_);
+			bool found = false;
+
+			auto boxes = [&](const BVHNode & node, float limit, float distances[4]) {
+				return box_distances(node, point, limit, distances);
+			};
+
+			traverse(tree, limit_squared, boxes, [&](const BVHTriangle & triangle, float limit) {
+				Vector closest = closest_point_on_triangle(triangle, point);
+				Vector offset = closest - point;
+				float distance_squared = offset.dot(offset);
+
+				if (distance_squared <= limit) {
+					result.point[0] = closest.x;
+					result.point[1] = closest.y;
+					result.point[2] = closest.z;
+					result.distance_squared = distance_squared;
+					result.triangle = triangle.index;
+
+					found = true;
+
+					return distance_squared;
+				}
+
+				return limit;
+			});
+
+			return found;
+		}
+	}
+}
@@ -0,0 +1,116 @@
+//
+//  BVH.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	class Reader;
+
+	/// A node with up to 4 children, with the bounds of each child stored as planes so that all 4 can be tested at once.
+	struct BVHNode {
+		static const TagT TAG = tag_from_identifier("BVN4");
+
+		/// Marks an unused child.
+		static const uint32_t EMPTY = 0xFFFFFFFF;
+
+		float32 minimum_x[4], minimum_y[4], minimum_z[4];
+		float32 maximum_x[4], maximum_y[4], maximum_z[4];
+
+		/// If `counts[i]` is 0, the index of the child node, otherwise the index of the first triangle of a leaf.
+		uint32_t children[4];
+
+		/// The number of triangles in each leaf, or 0 for child nodes.
+		uint32_t counts[4];
+	};
+
+	/// A triangle stored as a vertex and two edges, ready for intersection tests without access to the vertex array.
+	struct BVHTriangle {
+		static const TagT TAG = tag_from_identifier("BVTR");
+
+		float32 origin[3], edge1[3], edge2[3];
+
+		/// The index of the triangle in the mesh.
+		uint32_t index;
+	};
+
+	/// A bounding volume hierarchy over the triangles of a mesh, referenced by the `bvh` entry of the mesh metadata. The root is the first node.
+	struct TriangleBVH : public Block {
+		static const TagT TAG = tag_from_identifier("TBVH");
+
+		/// An `Array<BVHNode>`.
+		OffsetT nodes_offset;
+
+		/// An `Array<BVHTriangle>`, ordered so that every leaf is a contiguous range.
+		OffsetT triangles_offset;
+	};
+
+	/// Offline construction of triangle bounding volume hierarchies, and queries which run directly over the stored blocks.
+	namespace BVH
+	{
+		/// The name of the metadata entry which references the hierarchy of a mesh.
+		const char * const METADATA_NAME = "bvh";
+
+		/// Build a hierarchy using the surface area heuristic, and collapse it into nodes with 4 children.
+		/// @param positions x, y, z triples for each vertex.
+		void build(const std::vector<uint32_t> & indices, const std::vector<float32> & positions, std::vector<BVHNode> & nodes, std::vector<BVHTriangle> & triangles);
+
+		/// Build a hierarchy over axis aligned boxes, given as minimum x, y, z and maximum x, y, z. Leaves refer to ranges of `order`, which lists the indices of the boxes in leaf order.
+		void build_boxes(const std::vector<float32> & boxes, std::vector<BVHNode> & nodes, std::vector<uint32_t> & order);
+
+		/// Build a hierarchy for a triangle list or strip mesh and reference it from the mesh metadata.
+		/// @returns the offset of the new `TriangleBVH`, or 0 if the mesh has no triangles.
+		OffsetT build_mesh_bvh(Writer & writer, OffsetT mesh_offset);
+
+		/// A view of a stored hierarchy.
+		struct Tree {
+			const BVHNode * nodes = nullptr;
+			std::size_t node_count = 0;
+
+			const BVHTriangle * triangles = nullptr;
+			std::size_t triangle_count = 0;
+		};
+
+		/// @returns true if the mesh has a valid hierarchy, which is assigned to the tree.
+		bool tree_for_mesh(Reader & reader, const Mesh * mesh, Tree & tree);
+
+		struct Hit {
+			/// The distance along the ray, in multiples of the direction.
+			float32 distance;
+
+			/// The index of the triangle in the mesh.
+			uint32_t triangle;
+
+			/// Barycentric coordinates of the hit relative to the second and third vertices.
+			float32 u, v;
+		};
+
+		/// Find the nearest triangle, from either side, hit by `origin + direction * t` for `0 <= t <= limit`.
+		bool raycast(const Tree & tree, const float32 origin[3], const float32 direction[3], float32 limit, Hit & hit);
+
+		/// @returns true if any triangle intersects the segment between two points, e.g. for line of sight tests.
+		bool intersects_segment(const Tree & tree, const float32 from[3], const float32 to[3]);
+
+		struct ClosestPoint {
+			float32 point[3];
+
+			/// The squared distance from the query point.
+			float32 distance_squared;
+
+			uint32_t triangle;
+		};
+
+		/// Find the closest point on the surface within `sqrt(limit_squared)` of the given point.
+		bool closest_point(const Tree & tree, const float32 point[3], float32 limit_squared, ClosestPoint & result);
+	}
+}
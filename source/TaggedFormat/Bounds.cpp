@@ -0,0 +1,382 @@
+//
+//  Bounds.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Bounds.hpp"
+#include "Geometry.hpp"
+#include "Instancing.hpp"
+#include "Reader.hpp"
+#include "Table.hpp"
+#include "Traversal.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace TaggedFormat
+{
+	namespace BoundingVolumes
+	{
+		void minimum_maximum(const float32 * positions, std::size_t count, float32 minimum[3], float32 maximum[3]) {
+			const float32 infinity = std::numeric_limits<float32>::infinity();
+
+			std::fill_n(minimum, 3, infinity);
+			std::fill_n(maximum, 3, -infinity);
+
+			std::size_t i = 0;
+
+#if defined(__SSE__)
+			if (count >= 4) {
+				// Four positions are three registers, so lane k of the accumulators holds component k % 3:
+				__m128 minimum_a = _mm_set1_ps(infinity), minimum_b = minimum_a, minimum_c = minimum_a;
+				__m128 maximum_a = _mm_set1_ps(-infinity), maximum_b = maximum_a, maximum_c = maximum_a;
+
+				for (; i + 4 <= count; i += 4) {
+					const float * p = positions + i * 3;
+
+					__m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), c = _mm_loadu_ps(p + 8);
+
+					minimum_a = _mm_min_ps(minimum_a, a);
+					minimum_b = _mm_min_ps(minimum_b, b);
+					minimum_c = _mm_min_ps(minimum_c, c);
+
+					maximum_a = _mm_max_ps(maximum_a, a);
+					maximum_b = _mm_max_ps(maximum_b, b);
+					maximum_c = _mm_max_ps(maximum_c, c);
+				}
+
+				float minimums[12], maximums[12];
+
+				_mm_storeu_ps(minimums, minimum_a);
+				_mm_storeu_ps(minimums + 4, minimum_b);
+				_mm_storeu_ps(minimums + 8, minimum_c);
+
+				_mm_storeu_ps(maximums, maximum_a);
+				_mm_storeu_ps(maximums + 4, maximum_b);
+				_mm_storeu_ps(maximums + 8, maximum_c);
+
+				for (std::size_t k = 0; k < 12; k += 1) {
+					minimum[k % 3] = std::min(minimum[k % 3], minimums[k]);
+					maximum[k % 3] = std::max(maximum[k % 3], maximums[k]);
+				}
+			}
+#endif
+
+			for (; i < count; i += 1) {
+				for (std::size_t k = 0; k < 3; k += 1) {
+					minimum[k] = std::min(minimum[k], positions[i * 3 + k]);
+					maximum[k] = std::max(maximum[k], positions[i * 3 + k]);
+				}
+			}
+		}
+
+		bool compute(const std::vector<float32> & positions, Bounds & bounds) {
+			std::size_t count = positions.size() / 3;
+
+			if (count == 0) return false;
+
+			minimum_maximum(positions.data(), count, bounds.minimum, bounds.maximum);
+
+			for (std::size_t k = 0; k < 3; k += 1)
+				bounds.center[k] = (bounds.minimum[k] + bounds.maximum[k]) / 2;
+
+			float32 radius = 0;
+
+			for (std::size_t i = 0; i < count; i += 1) {
+				float32 dx = positions[i*3] - bounds.center[0], dy = positions[i*3+1] - bounds.center[1], dz = positions[i*3+2] - bounds.center[2];
+
+				radius = std::max(radius, dx*dx + dy*dy + dz*dz);
+			}
+
+			bounds.radius = std::sqrt(radius);
+
+			return true;
+		}
+
+		OffsetT compute_mesh_bounds(Writer & writer, OffsetT mesh_offset) {
+			OffsetT vertices_offset = writer.block_at_offset<Mesh>(mesh_offset)->vertices_offset;
+
+			if (!vertices_offset) return 0;
+
+			Bounds bounds;
+			clear(bounds);
+
+			if (!compute(read_positions(*writer.block_at_offset<Block>(vertices_offset)), bounds))
+				return 0;
+
+			auto block = writer.append<Bounds>();
+			**block = bounds;
+
+			set_mesh_metadata(writer, mesh_offset, METADATA_NAME, block);
+
+			return block;
+		}
+
+		bool stored_mesh_bounds(Writer & writer, OffsetT mesh_offset, Bounds & bounds) {
+			OffsetT metadata_offset = writer.block_at_offset<Mesh>(mesh_offset)->metadata_offset;
+
+			if (!metadata_offset || writer.block_at_offset<Block>(metadata_offset)->tag != OffsetTable::TAG)
+				return false;
+
+			OffsetT bounds_offset = writer.block_at_offset<OffsetTable>(metadata_offset)->offset_named(METADATA_NAME);
+
+			if (!bounds_offset || writer.block_at_offset<Block>(bounds_offset)->tag != Bounds::TAG)
+				return false;
+
+			bounds = **writer.block_at_offset<Bounds>(bounds_offset);
+
+			return true;
+		}
+
+		void transform(const Bounds & bounds, const float32 matrix[16], Bounds & result) {
+			clear(result);
+
+			float32 center[3], extent[3];
+
+			for (std::size_t k = 0; k < 3; k += 1) {
+				center[k] = (bounds.minimum[k] + bounds.maximum[k]) / 2;
+				extent[k] = (bounds.maximum[k] - bounds.minimum[k]) / 2;
+			}
+
+			float32 scale = 0;
+
+			// The extent of a transformed box is the sum of the absolute values of the transformed axes (Arvo, 1990):
+			for (std::size_t row = 0; row < 3; row += 1) {
+				float32 box_center = matrix[12 + row], box_extent = 0, sphere_center = matrix[12 + row];
+
+				for (std::size_t column = 0; column < 3; column += 1) {
+					float32 value = matrix[column * 4 + row];
+
+					box_center += value * center[column];
+					box_extent += std::fabs(value) * extent[column];
+					sphere_center += value * bounds.center[column];
+				}
+
+				result.minimum[row] = box_center - box_extent;
+				result.maximum[row] = box_center + box_extent;
+				result.center[row] = sphere_center;
+			}
+
+			for (std::size_t column = 0; column < 3; column += 1) {
+				const float32 * axis = matrix + column * 4;
+
+				scale = std::max(scale, std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]));
+			}
+
+			result.radius = bounds.radius * scale;
+		}
+
+		void merge(Bounds & bounds, const Bounds & other) {
+			for (std::size_t k = 0; k < 3; k += 1) {
+				bounds.minimum[k] = std::min(bounds.minimum[k], other.minimum[k]);
+				bounds.maximum[k] = std::max(bounds.maximum[k], other.maximum[k]);
+			}
+
+			float32 offset[3] = {other.center[0] - bounds.center[0], other.center[1] - bounds.center[1], other.center[2] - bounds.center[2]};
+			float32 distance = std::sqrt(offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2]);
+
+			// One sphere contains the other:
+			if (distance + other.radius <= bounds.radius) return;
+
+			if (distance + bounds.radius <= other.radius) {
+				std::copy_n(other.center, 3, bounds.center);
+				bounds.radius = other.radius;
+
+				return;
+			}
+
+			float32 radius = (distance + bounds.radius + other.radius) / 2;
+			float32 factor = (radius - bounds.radius) / distance;
+
+			for (std::size_t k = 0; k < 3; k += 1)
+				bounds.center[k] += offset[k] * factor;
+
+			bounds.radius = radius;
+		}
+
+		// Aggregates bounds bottom up through the scene graph. Replacement nodes are recorded and all references are updated at the end, so the cost is linear in the size of the scene.
+		class NodeBounds {
+		public:
+			NodeBounds(Writer & writer) : _writer(writer)
+			{
+			}
+
+			bool bounds_for(OffsetT offset, Bounds & bounds) {
+				auto existing = _bounds.find(offset);
+
+				if (existing != _bounds.end()) {
+					bounds = existing->second;
+
+					return true;
+				}
+
+				if (_visited.count(offset)) return false;
+				_visited.insert(offset);
+
+				bool valid = false;
+
+				switch (_writer.block_at_offset<Block>(offset)->tag) {
+					case Mesh::TAG:
+						valid = stored_mesh_bounds(_writer, offset, bounds);
+						break;
+
+					case OffsetTable::TAG:
+						valid = table_bounds(offset, bounds);
+						break;
+
+					case GeometryInstance::TAG: {
+						OffsetT mesh_offset = _writer.block_at_offset<GeometryInstance>(offset)->mesh_offset;
+
+						if (mesh_offset)
+							valid = bounds_for(mesh_offset, bounds);
+
+						break;
+					}
+
+					case Node::TAG:
+						valid = node_bounds(offset, bounds);
+						break;
+
+					case InstanceBatch::TAG:
+						valid = batch_bounds(offset, bounds);
+						break;
+				}
+
+				if (valid) _bounds[offset] = bounds;
+
+				return valid;
+			}
+
+			const std::map<OffsetT, OffsetT> & replacements() const {return _replacements;}
+
+		private:
+			Writer & _writer;
+
+			std::map<OffsetT, Bounds> _bounds;
+			std::set<OffsetT> _visited;
+			std::map<OffsetT, OffsetT> _replacements;
+
+			bool merge_child(OffsetT offset, bool valid, Bounds & bounds) {
+				Bounds child;
+
+				if (!offset || !bounds_for(offset, child)) return valid;
+
+				if (valid)
+					merge(bounds, child);
+				else
+					bounds = child;
+
+				return true;
+			}
+
+			bool table_bounds(OffsetT offset, Bounds & bounds) {
+				std::vector<OffsetT> entries;
+
+				for (auto & entry : **_writer.block_at_offset<OffsetTable>(offset))
+					entries.push_back(entry.offset);
+
+				bool valid = false;
+
+				for (auto entry : entries)
+					valid = merge_child(entry, valid, bounds);
+
+				return valid;
+			}
+
+			// Batched instances are placed relative to the node which references the batch:
+			bool batch_bounds(OffsetT offset, Bounds & bounds) {
+				OffsetT mesh_offset = _writer.block_at_offset<InstanceBatch>(offset)->mesh_offset;
+				Bounds local;
+
+				if (!mesh_offset || !bounds_for(mesh_offset, local)) return false;
+
+				bool valid = false;
+
+				for (auto & instance : **_writer.block_at_offset<InstanceBatch>(offset)) {
+					float32 matrix[16];
+					Bounds placed;
+
+					Instancing::unpack(instance, matrix);
+					transform(local, matrix, placed);
+
+					if (valid)
+						merge(bounds, placed);
+					else
+						bounds = placed;
+
+					valid = true;
+				}
+
+				return valid;
+			}
+
+			bool node_bounds(OffsetT offset, Bounds & bounds) {
+				std::vector<OffsetT> references;
+
+				// Drop bounds from a previous conversion:
+				for (auto & reference : **_writer.block_at_offset<Node>(offset)) {
+					if (!reference.offset || _writer.block_at_offset<Block>(reference.offset)->tag != Bounds::TAG)
+						references.push_back(reference.offset);
+				}
+
+				bool valid = false;
+				Bounds local;
+
+				for (auto reference : references)
+					valid = merge_child(reference, valid, local);
+
+				if (!valid) return false;
+
+				transform(local, _writer.block_at_offset<Node>(offset)->transform, bounds);
+
+				auto bounds_block = _writer.append<Bounds>();
+				**bounds_block = bounds;
+				references.push_back(bounds_block);
+
+				auto node = _writer.append<Node>(Node::array_size(references.size()));
+				auto original = _writer.block_at_offset<Node>(offset);
+
+				node->name = original->name;
+				std::copy_n(original->transform, 16, node->transform);
+				for (std::size_t i = 0; i < references.size(); i += 1)
+					node->begin()[i].offset = references[i];
+
+				_replacements[offset] = node;
+
+				return true;
+			}
+		};
+
+		void compute_node_bounds(Writer & writer, const std::vector<OffsetT> & offsets) {
+			NodeBounds node_bounds(writer);
+
+			for (auto offset : offsets) {
+				if (writer.block_at_offset<Block>(offset)->tag == Node::TAG) {
+					Bounds bounds;
+					node_bounds.bounds_for(offset, bounds);
+				}
+			}
+
+			relocate_offsets(writer, offsets, node_bounds.replacements());
+		}
+
+		const Bounds * node_bounds(Reader & reader, const Node * node) {
+			for (auto & reference : *node) {
+				if (auto bounds = reader.block_at_offset<Bounds>(reference.offset))
+					return bounds;
+			}
+
+			return nullptr;
+		}
+	}
+}
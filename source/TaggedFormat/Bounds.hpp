@@ -0,0 +1,64 @@
+//
+//  Bounds.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Scene.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	class Reader;
+
+	/// An axis aligned bounding box and a bounding sphere. Mesh bounds are referenced by the `bounds` entry of the mesh metadata and are in the coordinate system of the mesh. Node bounds are stored as one of the references of the node and are in the coordinate system of the parent, i.e. including the transform of the node itself.
+	struct Bounds : public Block {
+		static const TagT TAG = tag_from_identifier("BNDS");
+
+		float32 minimum[3], maximum[3];
+
+		float32 center[3];
+		float32 radius;
+	};
+
+	/// Computation of bounding volumes at conversion time, so that they are available before the first cull.
+	namespace BoundingVolumes
+	{
+		/// The name of the metadata entry which references the bounds of a mesh.
+		const char * const METADATA_NAME = "bounds";
+
+		/// Compute the minimum and maximum of x, y, z triples. If `count` is 0, the minimum is greater than the maximum.
+		void minimum_maximum(const float32 * positions, std::size_t count, float32 minimum[3], float32 maximum[3]);
+
+		/// Compute an axis aligned box, and a sphere around its center, for x, y, z triples.
+		/// @returns false if there are no positions.
+		bool compute(const std::vector<float32> & positions, Bounds & bounds);
+
+		/// Compute the bounds of the vertices of a mesh and reference them from the mesh metadata.
+		/// @returns the offset of the new bounds, or 0 if the mesh has no known vertex array.
+		OffsetT compute_mesh_bounds(Writer & writer, OffsetT mesh_offset);
+
+		/// Read the bounds referenced by the mesh metadata.
+		/// @returns false if the bounds of the mesh have not been computed.
+		bool stored_mesh_bounds(Writer & writer, OffsetT mesh_offset, Bounds & bounds);
+
+		/// Compute aggregate bounds for every node hierarchy, from the bounds of the meshes of each geometry instance and instance batch, which must already be computed. Nodes are replaced by a copy with an additional reference to their bounds, and all references to the original nodes within `offsets` and the header are updated.
+		void compute_node_bounds(Writer & writer, const std::vector<OffsetT> & offsets);
+
+		/// Transform bounds by a column major 4x4 matrix.
+		void transform(const Bounds & bounds, const float32 matrix[16], Bounds & result);
+
+		/// Expand bounds to contain other bounds.
+		void merge(Bounds & bounds, const Bounds & other);
+
+		/// @returns the bounds of the node, or nullptr if none were computed.
+		const Bounds * node_bounds(Reader & reader, const Node * node);
+	}
+}
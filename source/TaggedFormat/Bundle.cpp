@@ -0,0 +1,89 @@
+//
+//  Bundle.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Bundle.hpp"
+#include "Reader.hpp"
+#include "Table.hpp"
+#include "Traversal.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace TaggedFormat
+{
+	static_assert(BundleWriter::ALIGNMENT % VertexStream::ALIGNMENT == 0, "bundle alignment must preserve block alignment");
+	static_assert(BundleWriter::ALIGNMENT % NodeTransforms::ALIGNMENT == 0, "bundle alignment must preserve block alignment");
+
+	BundleWriter::BundleWriter(ResizableBuffer & output, bool checksums) : _writer(output), _checksums(checksums)
+	{
+		_writer.header();
+	}
+
+	OffsetT BundleWriter::append(const std::string & name, const Buffer & input) {
+		if (name.empty() || name.size() > sizeof(NamedOffset::name))
+			throw std::invalid_argument("Asset name must be between 1 and 32 characters: " + name);
+
+		auto existing = std::find_if(_assets.begin(), _assets.end(), [&](const std::pair<std::string, OffsetT> & asset) {
+			return asset.first == name;
+		});
+
+		if (existing != _assets.end())
+			throw std::invalid_argument("Duplicate asset name: " + name);
+
+		if (input.size() < sizeof(Header))
+			throw std::invalid_argument("Asset is not a binary file: " + name);
+
+		Reader reader(input);
+		auto header = reader.header();
+
+		if (!header || header->tag != Header::TAG)
+			throw std::invalid_argument("Asset is not a binary file: " + name);
+
+		if (!reader.verify_all().empty())
+			throw std::invalid_argument("Asset has corrupt blocks: " + name);
+
+		auto offsets = reachable_offsets(input);
+
+		_writer.align(ALIGNMENT);
+		OffsetT base = _writer.copy(input);
+
+		// Offsets are relative to the start of the file, so relocation is a single addition:
+		for (auto offset : offsets) {
+			each_offset(*_writer.block_at_offset<Block>(base + offset), [&](OffsetT & child) {
+				if (child) child += base;
+			});
+
+			if (_checksums) _writer.checksum(base + offset);
+		}
+
+		OffsetT top_offset = header->top_offset ? base + header->top_offset : 0;
+		_assets.emplace_back(name, top_offset);
+
+		return top_offset;
+	}
+
+	void BundleWriter::finish() {
+		auto index = _writer.append<OffsetTable>(OffsetTable::array_size(_assets.size()));
+
+		for (std::size_t i = 0; i < _assets.size(); i += 1) {
+			auto & entry = index->begin()[i];
+
+			std::memset(&entry.name, 0, sizeof(entry.name));
+			entry.name = _assets[i].first;
+			entry.offset = _assets[i].second;
+		}
+
+		if (_checksums) _writer.checksum(index);
+
+		_writer.header()->top_offset = index;
+
+		if (_checksums) _writer.append_checksums();
+
+		_assets.clear();
+	}
+}
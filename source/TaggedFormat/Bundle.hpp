@@ -0,0 +1,44 @@
+//
+//  Bundle.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Writer.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TaggedFormat
+{
+	using Buffers::Buffer;
+
+	/// Merges binary files into a single bundle without parsing them again. The top block of the bundle is an `OffsetTable` from asset name to the top block of each file, so that `Reader::asset_offset` can find any asset with a single lookup.
+	class BundleWriter {
+	public:
+		/// Files are placed at multiples of the largest block alignment, so that aligned blocks remain aligned after relocation.
+		static const std::size_t ALIGNMENT = 16;
+
+		/// @param checksums if true, the checksum of every relocated block is written to a directory at the end of the bundle.
+		BundleWriter(ResizableBuffer & output, bool checksums = false);
+
+		/// Append a copy of a file, and relocate every offset in the blocks reachable from its header by the offset at which it was placed.
+		/// @throws std::invalid_argument if the name is too long or already used, or the input is not a valid file or fails verification.
+		/// @returns the relocated top offset of the file.
+		OffsetT append(const std::string & name, const Buffer & input);
+
+		/// Write the index of assets, and checksums if requested. No more files can be appended.
+		void finish();
+
+	private:
+		Writer _writer;
+		bool _checksums;
+
+		std::vector<std::pair<std::string, OffsetT>> _assets;
+	};
+}
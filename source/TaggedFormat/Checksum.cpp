@@ -0,0 +1,129 @@
+//
+//  Checksum.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Checksum.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define TAGGED_FORMAT_CRC32C_SSE42
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#define TAGGED_FORMAT_CRC32C_ARMV8
+#include <arm_acle.h>
+#endif
+
+namespace TaggedFormat
+{
+	namespace Checksum
+	{
+		// The reflected Castagnoli polynomial:
+		const uint32_t POLYNOMIAL = 0x82F63B78;
+
+		struct Table {
+			uint32_t entries[8][256];
+
+			Table() {
+				for (uint32_t i = 0; i < 256; i += 1) {
+					uint32_t crc = i;
+
+					for (std::size_t bit = 0; bit < 8; bit += 1)
+						crc = (crc >> 1) ^ (POLYNOMIAL & (0 - (crc & 1)));
+
+					entries[0][i] = crc;
+				}
+
+				for (uint32_t i = 0; i < 256; i += 1) {
+					for (std::size_t k = 1; k < 8; k += 1)
+						entries[k][i] = (entries[k - 1][i] >> 8) ^ entries[0][entries[k - 1][i] & 0xFF];
+				}
+			}
+		};
+
+		// Slicing by 8 (Kounavis and Berry, 2005), for processors without CRC instructions:
+		static uint32_t crc32c_table(uint32_t crc, const Byte * data, std::size_t size) {
+			static const Table table;
+			auto & entries = table.entries;
+
+			for (; size >= 8; size -= 8, data += 8) {
+				uint32_t low, high;
+				std::memcpy(&low, data, 4);
+				std::memcpy(&high, data + 4, 4);
+
+				low ^= crc;
+
+				crc = entries[7][low & 0xFF] ^ entries[6][(low >> 8) & 0xFF] ^ entries[5][(low >> 16) & 0xFF] ^ entries[4][low >> 24]
+					^ entries[3][high & 0xFF] ^ entries[2][(high >> 8) & 0xFF] ^ entries[1][(high >> 16) & 0xFF] ^ entries[0][high >> 24];
+			}
+
+			for (; size; size -= 1, data += 1)
+				crc = (crc >> 8) ^ entries[0][(crc ^ *data) & 0xFF];
+
+			return crc;
+		}
+
+#if defined(TAGGED_FORMAT_CRC32C_SSE42)
+		// Compiled for SSE4.2 regardless of the target, and only called if the processor supports it:
+		__attribute__((target("sse4.2")))
+		static uint32_t crc32c_hardware(uint32_t crc, const Byte * data, std::size_t size) {
+			uint64_t crc64 = crc;
+
+			for (; size >= 8; size -= 8, data += 8) {
+				uint64_t value;
+				std::memcpy(&value, data, 8);
+
+				crc64 = _mm_crc32_u64(crc64, value);
+			}
+
+			crc = static_cast<uint32_t>(crc64);
+
+			for (; size; size -= 1, data += 1)
+				crc = _mm_crc32_u8(crc, *data);
+
+			return crc;
+		}
+
+		static bool has_hardware() {
+			static const bool supported = __builtin_cpu_supports("sse4.2");
+
+			return supported;
+		}
+#elif defined(TAGGED_FORMAT_CRC32C_ARMV8)
+		static uint32_t crc32c_hardware(uint32_t crc, const Byte * data, std::size_t size) {
+			for (; size >= 8; size -= 8, data += 8) {
+				uint64_t value;
+				std::memcpy(&value, data, 8);
+
+				crc = __crc32cd(crc, value);
+			}
+
+			for (; size; size -= 1, data += 1)
+				crc = __crc32cb(crc, *data);
+
+			return crc;
+		}
+
+		static bool has_hardware() {
+			return true;
+		}
+#endif
+
+		uint32_t crc32c(const void * data, std::size_t size, uint32_t crc) {
+			auto bytes = static_cast<const Byte *>(data);
+
+			crc = ~crc;
+
+#if defined(TAGGED_FORMAT_CRC32C_SSE42) || defined(TAGGED_FORMAT_CRC32C_ARMV8)
+			if (has_hardware())
+				return ~crc32c_hardware(crc, bytes, size);
+#endif
+
+			return ~crc32c_table(crc, bytes, size);
+		}
+	}
+}
@@ -0,0 +1,46 @@
+//
+//  Checksum.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Block.hpp"
+
+namespace TaggedFormat
+{
+	/// The checksum of a single block, including its tag and size.
+	struct BlockChecksum {
+		static const TagT TAG = tag_from_identifier("CRCB");
+
+		OffsetT offset;
+		uint32_t crc;
+	};
+
+	/// The last block of a file with checksums, which refers to an `Array<BlockChecksum>` ordered by offset. It is not reachable from the header, so readers which don't know about checksums ignore it.
+	struct ChecksumTrailer : public Block {
+		static const TagT TAG = tag_from_identifier("CRCT");
+
+		OffsetT directory_offset;
+
+		/// The trailer of the checksums of the previous generation of an updated file, or 0. Each directory only contains the blocks appended by its own generation, which all follow the blocks of the previous directories.
+		OffsetT previous_offset;
+
+		/// The checksum of the directory itself.
+		uint32_t directory_crc;
+	};
+
+	namespace Checksum
+	{
+		/// Compute the CRC32C (Castagnoli) checksum of the given data, continuing from a previous checksum. Uses the SSE4.2 or ARMv8 CRC instructions where available.
+		uint32_t crc32c(const void * data, std::size_t size, uint32_t crc = 0);
+
+		/// @returns the checksum of a block, including its tag and size.
+		inline uint32_t block_crc(const Block * block) {
+			return crc32c(block, block->size);
+		}
+	}
+}
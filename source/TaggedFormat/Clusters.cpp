@@ -0,0 +1,322 @@
+//
+//  Clusters.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Clusters.hpp"
+#include "Geometry.hpp"
+#include "Parallel.hpp"
+#include "Topology.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace TaggedFormat
+{
+	namespace Clusters
+	{
+		struct Vector {
+			float x, y, z;
+
+			Vector operator+(const Vector & other) const {return {x + other.x, y + other.y, z + other.z};}
+			Vector operator-(const Vector & other) const {return {x - other.x, y - other.y, z - other.z};}
+			Vector operator*(float factor) const {return {x * factor, y * factor, z * factor};}
+
+			float dot(const Vector & other) const {return x * other.x + y * other.y + z * other.z;}
+
+			Vector cross(const Vector & other) const {
+				return {y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x};
+			}
+
+			float length() const {return std::sqrt(dot(*this));}
+		};
+
+		static Vector position_at(const std::vector<float32> & positions, uint32_t index) {
+			return {positions[index*3], positions[index*3+1], positions[index*3+2]};
+		}
+
+		static void store(float32 * output, const Vector & vector) {
+			output[0] = vector.x;
+			output[1] = vector.y;
+			output[2] = vector.z;
+		}
+
+		// Ritter's bounding sphere, which is within about 5% of the minimal sphere:
+		static void compute_sphere(const std::vector<Vector> & points, Cluster & cluster) {
+			auto farthest = [&](const Vector & from) {
+				std::size_t result = 0;
+				float distance = -1;
+
+				for (std::size_t i = 0; i < points.size(); i += 1) {
+					float d = (points[i] - from).dot(points[i] - from);
+					if (d > distance) {distance = d; result = i;}
+				}
+
+				return points[result];
+			};
+
+			Vector a = farthest(points[0]);
+			Vector b = farthest(a);
+
+			Vector center = (a + b) * 0.5f;
+			float radius = (b - a).length() * 0.5f;
+
+			for (auto & point : points) {
+				float distance = (point - center).length();
+
+				if (distance > radius) {
+					float grown = (radius + distance) * 0.5f;
+					center = center + (point - center) * ((grown - radius) / distance);
+					radius = grown;
+				}
+			}
+
+			store(cluster.center, center);
+			cluster.radius = radius;
+		}
+
+		static void compute_cone(const std::vector<Vector> & points, const std::vector<uint8_t> & triangles, Cluster & cluster) {
+			Vector center{cluster.center[0], cluster.center[1], cluster.center[2]};
+
+			std::vector<Vector> normals;
+			std::vector<std::size_t> corners;
+			Vector sum{0, 0, 0};
+
+			for (std::size_t i = 0; i < triangles.size(); i += 3) {
+				const Vector & p0 = points[triangles[i]];
+				Vector normal = (points[triangles[i+1]] - p0).cross(points[triangles[i+2]] - p0);
+				float length = normal.length();
+
+				if (length == 0) continue;
+
+				normal = normal * (1 / length);
+				normals.push_back(normal);
+				corners.push_back(triangles[i]);
+				sum = sum + normal;
+			}
+
+			// By default the cone covers every direction:
+			store(cluster.cone_apex, center);
+			store(cluster.cone_axis, Vector{0, 0, 1});
+			cluster.cone_cutoff = 1;
+
+			float length = sum.length();
+			if (normals.empty() || length == 0) return;
+
+			Vector axis = sum * (1 / length);
+			float minimum = 1;
+
+			for (auto & normal : normals) minimum = std::min(minimum, axis.dot(normal));
+
+			// A cone wider than a hemisphere is never entirely backfacing:
+			if (minimum <= 0) return;
+
+			// Place the apex so that every triangle is in front of it along the axis:
+			float offset = 0;
+			for (std::size_t i = 0; i < normals.size(); i += 1) {
+				float distance = (center - points[corners[i]]).dot(normals[i]) / axis.dot(normals[i]);
+				offset = std::max(offset, distance);
+			}
+
+			store(cluster.cone_apex, center - axis * offset);
+			store(cluster.cone_axis, axis);
+			cluster.cone_cutoff = std::sqrt(1 - minimum * minimum);
+		}
+
+		Partition partition(const std::vector<uint32_t> & indices, const std::vector<float32> & positions, std::size_t vertex_limit, std::size_t triangle_limit) {
+			Partition partition;
+
+			std::size_t vertex_count = positions.size() / 3;
+			std::size_t triangle_count = indices.size() / 3;
+
+			if (vertex_limit < 3 || vertex_limit > 256 || triangle_limit < 1 || indices.size() % 3 != 0)
+				return partition;
+
+			for (auto index : indices) {
+				if (index >= vertex_count) return partition;
+			}
+
+			// The triangles which use each vertex, in compressed rows:
+			std::vector<uint32_t> first(vertex_count + 1, 0), adjacency(indices.size());
+
+			for (auto index : indices) first[index + 1] += 1;
+			for (std::size_t i = 0; i < vertex_count; i += 1) first[i + 1] += first[i];
+
+			{
+				std::vector<uint32_t> cursor(first.begin(), first.end() - 1);
+				for (std::size_t i = 0; i < indices.size(); i += 1) adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+
+			const int UNUSED = -1;
+			std::vector<int> local(vertex_count, UNUSED);
+			std::vector<bool> emitted(triangle_count, false);
+
+			std::vector<uint32_t> cluster_vertices;
+			std::vector<uint8_t> cluster_triangles;
+
+			auto added_vertices = [&](std::size_t t) {
+				std::size_t added = 0;
+
+				for (std::size_t j = 0; j < 3; j += 1)
+					if (local[indices[t*3+j]] == UNUSED) added += 1;
+
+				return added;
+			};
+
+			auto fits = [&](std::size_t t) {
+				return cluster_vertices.size() + added_vertices(t) <= vertex_limit && cluster_triangles.size() / 3 < triangle_limit;
+			};
+
+			auto finish = [&]() {
+				if (cluster_triangles.empty()) return;
+
+				Cluster cluster;
+				cluster.vertex_offset = static_cast<uint32_t>(partition.vertices.size());
+				cluster.vertex_count = static_cast<uint32_t>(cluster_vertices.size());
+				cluster.triangle_offset = static_cast<uint32_t>(partition.triangles.size() / 3);
+				cluster.triangle_count = static_cast<uint32_t>(cluster_triangles.size() / 3);
+
+				std::vector<Vector> points;
+				for (auto vertex : cluster_vertices) points.push_back(position_at(positions, vertex));
+
+				compute_sphere(points, cluster);
+				compute_cone(points, cluster_triangles, cluster);
+
+				partition.clusters.push_back(cluster);
+				partition.vertices.insert(partition.vertices.end(), cluster_vertices.begin(), cluster_vertices.end());
+				partition.triangles.insert(partition.triangles.end(), cluster_triangles.begin(), cluster_triangles.end());
+
+				for (auto vertex : cluster_vertices) local[vertex] = UNUSED;
+
+				cluster_vertices.clear();
+				cluster_triangles.clear();
+			};
+
+			auto add = [&](std::size_t t) {
+				emitted[t] = true;
+
+				for (std::size_t j = 0; j < 3; j += 1) {
+					uint32_t vertex = indices[t*3+j];
+
+					if (local[vertex] == UNUSED) {
+						local[vertex] = static_cast<int>(cluster_vertices.size());
+						cluster_vertices.push_back(vertex);
+					}
+
+					cluster_triangles.push_back(static_cast<uint8_t>(local[vertex]));
+				}
+			};
+
+			std::size_t seed = 0;
+
+			while (true) {
+				// Prefer the adjacent triangle which adds the fewest vertices:
+				std::size_t best = triangle_count, best_added = 4;
+
+				for (auto vertex : cluster_vertices) {
+					for (uint32_t i = first[vertex]; i < first[vertex + 1]; i += 1) {
+						uint32_t t = adjacency[i];
+						if (emitted[t]) continue;
+
+						std::size_t added = added_vertices(t);
+
+						if (fits(t) && (added < best_added || (added == best_added && t < best))) {
+							best = t;
+							best_added = added;
+						}
+					}
+
+					if (best_added == 0) break;
+				}
+
+				if (best == triangle_count) {
+					while (seed < triangle_count && emitted[seed]) seed += 1;
+
+					if (seed == triangle_count) break;
+
+					if (!fits(seed)) finish();
+
+					best = seed;
+				}
+
+				add(best);
+			}
+
+			finish();
+
+			return partition;
+		}
+
+		std::vector<OffsetT> partition_meshes(Writer & writer, const std::vector<OffsetT> & mesh_offsets, std::size_t vertex_limit, std::size_t triangle_limit) {
+			std::size_t count = mesh_offsets.size();
+
+			std::vector<std::vector<uint32_t>> indices(count);
+			std::vector<std::vector<float32>> positions(count);
+
+			for (std::size_t i = 0; i < count; i += 1) {
+				auto mesh = writer.block_at_offset<Mesh>(mesh_offsets[i]);
+
+				if (!mesh->indices_offset || !mesh->vertices_offset) continue;
+
+				if (mesh->layout == Mesh::Layout::TRIANGLES)
+					indices[i] = read_indices(*writer.block_at_offset<Block>(mesh->indices_offset));
+				else if (mesh->layout == Mesh::Layout::TRIANGLE_STRIP)
+					indices[i] = Topology::triangles_from_strip(read_indices(*writer.block_at_offset<Block>(mesh->indices_offset)));
+				else
+					continue;
+
+				positions[i] = read_positions(*writer.block_at_offset<Block>(mesh->vertices_offset));
+			}
+
+			std::vector<Partition> partitions(count);
+
+			Parallel::each(count, [&](std::size_t i) {
+				partitions[i] = partition(indices[i], positions[i], vertex_limit, triangle_limit);
+			});
+
+			// Blocks are appended in mesh order, so the output does not depend on scheduling:
+			std::vector<OffsetT> offsets(count, 0);
+
+			for (std::size_t i = 0; i < count; i += 1) {
+				auto & partition = partitions[i];
+
+				if (partition.clusters.empty()) continue;
+
+				auto clusters = writer.append<Array<Cluster>>(Array<Cluster>::array_size(partition.clusters.size()));
+				std::copy(partition.clusters.begin(), partition.clusters.end(), clusters->begin());
+
+				OffsetT vertices_offset = append_indices(writer, partition.vertices, Index32::TAG);
+
+				std::size_t padded_size = (partition.triangles.size() + 3) & ~std::size_t(3);
+				auto triangles = writer.append<Array<ClusterIndex>>(Array<ClusterIndex>::array_size(padded_size));
+				std::fill_n(reinterpret_cast<uint8_t *>(triangles->begin()), padded_size, 0);
+				std::copy(partition.triangles.begin(), partition.triangles.end(), reinterpret_cast<uint8_t *>(triangles->begin()));
+
+				auto mesh_clusters = writer.append<MeshClusters>();
+				mesh_clusters->clusters_offset = clusters;
+				mesh_clusters->vertices_offset = vertices_offset;
+				mesh_clusters->triangles_offset = triangles;
+
+				set_mesh_metadata(writer, mesh_offsets[i], METADATA_NAME, mesh_clusters);
+
+				offsets[i] = mesh_clusters;
+			}
+
+			return offsets;
+		}
+
+		bool is_backfacing(const Cluster & cluster, const float32 camera_position[3]) {
+			Vector apex{cluster.cone_apex[0], cluster.cone_apex[1], cluster.cone_apex[2]};
+			Vector axis{cluster.cone_axis[0], cluster.cone_axis[1], cluster.cone_axis[2]};
+			Vector direction = apex - Vector{camera_position[0], camera_position[1], camera_position[2]};
+
+			float length = direction.length();
+			if (length == 0) return false;
+
+			return direction.dot(axis) > cluster.cone_cutoff * length;
+		}
+	}
+}
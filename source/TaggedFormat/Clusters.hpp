@@ -0,0 +1,86 @@
+//
+//  Clusters.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// A small group of triangles with its own local vertex indices, suitable for mesh shaders and cluster culling.
+	struct Cluster {
+		static const TagT TAG = tag_from_identifier("#CLU");
+
+		/// The range of vertex indices in `MeshClusters::vertices_offset` used by this cluster.
+		uint32_t vertex_offset, vertex_count;
+
+		/// The range of triangles in `MeshClusters::triangles_offset`, each of which is 3 local vertex indices.
+		uint32_t triangle_offset, triangle_count;
+
+		/// A sphere which contains every vertex of the cluster.
+		float32 center[3];
+		float32 radius;
+
+		/// A cone which contains the normals of every triangle. The cluster faces away from a camera at position `p` if `dot(normalize(cone_apex - p), cone_axis) > cone_cutoff`. A cutoff of 1 means the cluster can not be culled this way.
+		float32 cone_apex[3];
+		float32 cone_axis[3];
+		float32 cone_cutoff;
+	};
+
+	/// A local vertex index within a cluster.
+	struct ClusterIndex {
+		static const TagT TAG = tag_from_identifier("CI08");
+
+		uint8_t value;
+	};
+
+	/// The clusters of a mesh, referenced by the `clusters` entry of the mesh metadata.
+	struct MeshClusters : public Block {
+		static const TagT TAG = tag_from_identifier("CLUS");
+
+		/// An `Array<Cluster>`.
+		OffsetT clusters_offset;
+
+		/// An `Array<Index32>` which maps local vertex indices to the vertex array of the mesh.
+		OffsetT vertices_offset;
+
+		/// An `Array<ClusterIndex>` of local triangles, padded to a multiple of 4 bytes.
+		OffsetT triangles_offset;
+	};
+
+	/// Partitioning of triangle meshes into clusters with culling bounds.
+	namespace Clusters
+	{
+		/// The name of the metadata entry which references the clusters of a mesh.
+		const char * const METADATA_NAME = "clusters";
+
+		/// Limits which suit most mesh shader implementations.
+		const std::size_t DEFAULT_VERTEX_LIMIT = 64;
+		const std::size_t DEFAULT_TRIANGLE_LIMIT = 124;
+
+		struct Partition {
+			std::vector<Cluster> clusters;
+			std::vector<uint32_t> vertices;
+			std::vector<uint8_t> triangles;
+		};
+
+		/// Partition a triangle list into clusters. Clusters are grown from triangles which share vertices with the current cluster, adding the fewest new vertices first.
+		/// @param positions x, y, z triples for each vertex.
+		Partition partition(const std::vector<uint32_t> & indices, const std::vector<float32> & positions, std::size_t vertex_limit = DEFAULT_VERTEX_LIMIT, std::size_t triangle_limit = DEFAULT_TRIANGLE_LIMIT);
+
+		/// Partition each triangle list or strip mesh, in parallel, and reference the results from the mesh metadata.
+		/// @returns the offset of the `MeshClusters` block for each mesh, or 0 for meshes which were not partitioned.
+		std::vector<OffsetT> partition_meshes(Writer & writer, const std::vector<OffsetT> & mesh_offsets, std::size_t vertex_limit = DEFAULT_VERTEX_LIMIT, std::size_t triangle_limit = DEFAULT_TRIANGLE_LIMIT);
+
+		/// @returns true if every triangle of the cluster faces away from the camera position.
+		bool is_backfacing(const Cluster & cluster, const float32 camera_position[3]);
+	}
+}
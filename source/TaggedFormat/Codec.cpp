@@ -0,0 +1,682 @@
+//
+//  Codec.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Codec.hpp"
+#include "Geometry.hpp"
+
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace TaggedFormat
+{
+	std::string PackedArray::name_for_method(Method method) {
+		switch (method) {
+			case Method::INDEX_SEQUENCE:
+				return "index-sequence";
+
+			case Method::INDEX_TRIANGLES:
+				return "index-triangles";
+
+			case Method::VERTEX_DELTA:
+				return "vertex-delta";
+
+			default:
+				return "unspecified/unknown";
+		}
+	}
+
+	namespace Codec
+	{
+		DecodeError::DecodeError(const std::string & message) : std::runtime_error(message)
+		{
+		}
+
+		// Vertices are processed in blocks so that the transposed byte planes stay in cache.
+		const std::size_t VERTEX_BLOCK_SIZE = 256;
+
+		// Byte planes are coded in groups of 16 bytes, each prefixed by a mode.
+		const std::size_t GROUP_SIZE = 16;
+
+		enum GroupMode : Byte {
+			GROUP_ZERO = 0,
+			GROUP_SPARSE = 1,
+			GROUP_RAW = 2
+		};
+
+		static uint32_t zigzag(uint32_t value) {
+			return (value << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(value) >> 31);
+		}
+
+		static uint32_t unzigzag(uint32_t value) {
+			return (value >> 1) ^ (0 - (value & 1));
+		}
+
+		static void write_varint(std::vector<Byte> & output, uint32_t value) {
+			while (value >= 0x80) {
+				output.push_back(static_cast<Byte>(value | 0x80));
+				value >>= 7;
+			}
+
+			output.push_back(static_cast<Byte>(value));
+		}
+
+		// A small cursor over the encoded data which checks for truncation.
+		struct Input {
+			const Byte * current;
+			const Byte * end;
+
+			Byte next() {
+				if (current == end) throw DecodeError("Packed array data is truncated!");
+
+				return *current++;
+			}
+
+			uint32_t varint() {
+				uint32_t value = 0;
+
+				for (unsigned shift = 0; shift < 35; shift += 7) {
+					Byte byte = next();
+					value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+
+					if ((byte & 0x80) == 0) return value;
+				}
+
+				throw DecodeError("Packed array contains an invalid varint!");
+			}
+		};
+
+		// Recently seen edges and vertices, shared by the triangle encoder and decoder so that both sides evolve identically.
+		struct TriangleCache {
+			uint32_t edges[8][2] = {};
+			std::size_t edge_head = 0;
+
+			uint32_t vertices[8] = {};
+			std::size_t vertex_head = 0;
+
+			uint32_t next = 0, last = 0;
+
+			void push_edge(uint32_t a, uint32_t b) {
+				edges[edge_head & 7][0] = a;
+				edges[edge_head & 7][1] = b;
+				edge_head += 1;
+			}
+
+			void push_triangle(uint32_t a, uint32_t b, uint32_t c) {
+				// Adjacent triangles share edges with the opposite winding:
+				push_edge(b, a);
+				push_edge(c, b);
+				push_edge(a, c);
+			}
+
+			void push_vertex(uint32_t v) {
+				vertices[vertex_head & 7] = v;
+				vertex_head += 1;
+			}
+
+			const uint32_t * edge(std::size_t distance) const {
+				return edges[(edge_head - 1 - distance) & 7];
+			}
+
+			uint32_t vertex(std::size_t distance) const {
+				return vertices[(vertex_head - 1 - distance) & 7];
+			}
+
+			int find_edge(uint32_t a, uint32_t b) const {
+				for (std::size_t i = 0; i < 8 && i < edge_head; i += 1) {
+					auto e = edge(i);
+					if (e[0] == a && e[1] == b) return static_cast<int>(i);
+				}
+
+				return -1;
+			}
+
+			int find_vertex(uint32_t v) const {
+				for (std::size_t i = 0; i < 6 && i < vertex_head; i += 1) {
+					if (vertex(i) == v) return static_cast<int>(i);
+				}
+
+				return -1;
+			}
+		};
+
+		// Each triangle is coded as one byte, followed by any explicit vertices:
+		//   bits 7-6: rotation applied to the triangle to find a cached edge, or 3 if no edge was found.
+		//   bits 5-3: the distance of the cached edge.
+		//   bits 2-0: 0 for the next new vertex, 1-6 for a cached vertex, 7 for an explicit zig-zag delta.
+		// When no edge was found, bits 2-0 flag which of the three vertices are the next new vertex, the others are explicit.
+		static void encode_triangles(const std::vector<uint32_t> & indices, std::vector<Byte> & output) {
+			TriangleCache cache;
+
+			for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+				uint32_t triangle[3] = {indices[i], indices[i+1], indices[i+2]};
+
+				int rotation = 0, distance = -1;
+				for (; rotation < 3; rotation += 1) {
+					distance = cache.find_edge(triangle[rotation], triangle[(rotation+1) % 3]);
+					if (distance >= 0) break;
+				}
+
+				if (distance >= 0) {
+					uint32_t third = triangle[(rotation+2) % 3];
+					Byte code = (rotation << 6) | (distance << 3);
+
+					if (third == cache.next) {
+						output.push_back(code);
+						cache.next += 1;
+						cache.push_vertex(third);
+					} else {
+						int cached = cache.find_vertex(third);
+
+						if (cached >= 0) {
+							output.push_back(code | (1 + cached));
+						} else {
+							output.push_back(code | 7);
+							write_varint(output, zigzag(third - cache.last));
+							cache.last = third;
+							cache.push_vertex(third);
+						}
+					}
+				} else {
+					std::size_t code_offset = output.size();
+					Byte code = 3 << 6;
+					output.push_back(code);
+
+					for (std::size_t j = 0; j < 3; j += 1) {
+						if (triangle[j] == cache.next) {
+							code |= 1 << j;
+							cache.next += 1;
+						} else {
+							write_varint(output, zigzag(triangle[j] - cache.last));
+							cache.last = triangle[j];
+						}
+
+						cache.push_vertex(triangle[j]);
+					}
+
+					output[code_offset] = code;
+				}
+
+				cache.push_triangle(triangle[0], triangle[1], triangle[2]);
+			}
+		}
+
+		template <typename IndexT>
+		static void decode_triangles(Input & input, IndexT * output, std::size_t count) {
+			TriangleCache cache;
+
+			for (std::size_t i = 0; i + 2 < count; i += 3) {
+				Byte code = input.next();
+				unsigned rotation = code >> 6;
+				uint32_t a, b, c;
+
+				if (rotation < 3) {
+					std::size_t distance = (code >> 3) & 7;
+					unsigned mode = code & 7;
+					uint32_t third;
+
+					// The encoder only refers to edges and vertices which are already in the cache:
+					if (distance >= cache.edge_head)
+						throw DecodeError("Packed triangle refers to an edge before the start of the cache!");
+
+					auto edge = cache.edge(distance);
+
+					if (mode == 0) {
+						third = cache.next++;
+						cache.push_vertex(third);
+					} else if (mode < 7) {
+						if (mode - 1 >= cache.vertex_head)
+							throw DecodeError("Packed triangle refers to a vertex before the start of the cache!");
+
+						third = cache.vertex(mode - 1);
+					} else {
+						third = cache.last + unzigzag(input.varint());
+						cache.last = third;
+						cache.push_vertex(third);
+					}
+
+					// Undo the rotation applied by the encoder:
+					if (rotation == 0) {
+						a = edge[0]; b = edge[1]; c = third;
+					} else if (rotation == 1) {
+						a = third; b = edge[0]; c = edge[1];
+					} else {
+						a = edge[1]; b = third; c = edge[0];
+					}
+				} else {
+					uint32_t triangle[3];
+
+					for (std::size_t j = 0; j < 3; j += 1) {
+						if (code & (1 << j)) {
+							triangle[j] = cache.next++;
+						} else {
+							triangle[j] = cache.last + unzigzag(input.varint());
+							cache.last = triangle[j];
+						}
+
+						cache.push_vertex(triangle[j]);
+					}
+
+					a = triangle[0]; b = triangle[1]; c = triangle[2];
+				}
+
+				output[i] = static_cast<IndexT>(a);
+				output[i+1] = static_cast<IndexT>(b);
+				output[i+2] = static_cast<IndexT>(c);
+
+				cache.push_triangle(a, b, c);
+			}
+		}
+
+		static void encode_sequence(const std::vector<uint32_t> & indices, std::vector<Byte> & output) {
+			uint32_t last = 0;
+
+			for (auto index : indices) {
+				write_varint(output, zigzag(index - last));
+				last = index;
+			}
+		}
+
+		template <typename IndexT>
+		static void decode_sequence(Input & input, IndexT * output, std::size_t count) {
+			uint32_t last = 0;
+
+			for (std::size_t i = 0; i < count; i += 1) {
+				last += unzigzag(input.varint());
+				output[i] = static_cast<IndexT>(last);
+			}
+		}
+
+		static void encode_group(const Byte * plane, std::size_t count, std::vector<Byte> & output) {
+			uint16_t mask = 0;
+			std::size_t non_zero = 0;
+
+			for (std::size_t i = 0; i < count; i += 1) {
+				if (plane[i]) {
+					mask |= 1 << i;
+					non_zero += 1;
+				}
+			}
+
+			if (non_zero == 0) {
+				output.push_back(GROUP_ZERO);
+			} else if (2 + non_zero < count) {
+				output.push_back(GROUP_SPARSE);
+				output.push_back(mask & 0xFF);
+				output.push_back(mask >> 8);
+
+				for (std::size_t i = 0; i < count; i += 1) {
+					if (plane[i]) output.push_back(plane[i]);
+				}
+			} else {
+				output.push_back(GROUP_RAW);
+				output.insert(output.end(), plane, plane + count);
+			}
+		}
+
+		// Planes hold a whole block, so a whole group is always written, which is a single store. Only `count` bytes are read from the input:
+		static void decode_group(Input & input, Byte * plane, std::size_t count) {
+			switch (input.next()) {
+				case GROUP_ZERO:
+					std::memset(plane, 0, GROUP_SIZE);
+					break;
+
+				case GROUP_SPARSE: {
+					uint16_t mask = input.next();
+					mask |= input.next() << 8;
+
+					// Only the bits of bytes in the group refer to encoded bytes:
+					mask &= (1u << count) - 1;
+
+					// Check for truncation once, then copy the bytes so that they can be selected without branches:
+					std::size_t non_zero = __builtin_popcount(mask);
+
+					if (static_cast<std::size_t>(input.end - input.current) < non_zero)
+						throw DecodeError("Packed array data is truncated!");
+
+					Byte values[GROUP_SIZE] = {};
+					std::memcpy(values, input.current, non_zero);
+					input.current += non_zero;
+
+					for (std::size_t i = 0, j = 0; i < GROUP_SIZE; i += 1) {
+						Byte present = (mask >> i) & 1;
+
+						plane[i] = values[j] & -present;
+						j += present;
+					}
+
+					break;
+				}
+
+				case GROUP_RAW:
+					if (static_cast<std::size_t>(input.end - input.current) < count)
+						throw DecodeError("Packed array data is truncated!");
+
+					if (count == GROUP_SIZE)
+						std::memcpy(plane, input.current, GROUP_SIZE);
+					else
+						std::memcpy(plane, input.current, count);
+
+					input.current += count;
+					break;
+
+				default:
+					throw DecodeError("Packed array contains an invalid group mode!");
+			}
+		}
+
+		static void encode_vertices(const Byte * vertices, std::size_t count, std::size_t stride, std::vector<Byte> & output) {
+			std::vector<Byte> previous(stride, 0), plane(VERTEX_BLOCK_SIZE);
+
+			for (std::size_t base = 0; base < count; base += VERTEX_BLOCK_SIZE) {
+				std::size_t block_count = std::min(VERTEX_BLOCK_SIZE, count - base);
+
+				for (std::size_t k = 0; k < stride; k += 1) {
+					// Transpose one byte of every vertex in the block into a plane, as the difference from the previous vertex:
+					Byte last = previous[k];
+
+					for (std::size_t i = 0; i < block_count; i += 1) {
+						Byte value = vertices[(base + i) * stride + k];
+						plane[i] = value ^ last;
+						last = value;
+					}
+
+					previous[k] = last;
+
+					for (std::size_t i = 0; i < block_count; i += GROUP_SIZE) {
+						encode_group(plane.data() + i, std::min(GROUP_SIZE, block_count - i), output);
+					}
+				}
+			}
+		}
+
+#if defined(__SSE2__)
+		// Replace each plane of differences by the running values, continuing from the previous block. The prefix is computed 16 bytes at a time using shifts:
+		static void accumulate_planes(Byte * planes, Byte * previous, std::size_t stride, std::size_t block_count) {
+			for (std::size_t k = 0; k < stride; k += 1) {
+				Byte * plane = planes + k * VERTEX_BLOCK_SIZE;
+				__m128i carry = _mm_set1_epi8(static_cast<char>(previous[k]));
+
+				// Planes hold a whole block, so reading beyond the last vertex is safe, and the extra bytes are ignored:
+				for (std::size_t i = 0; i < block_count; i += 16) {
+					__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(plane + i));
+
+					x = _mm_xor_si128(x, _mm_slli_si128(x, 1));
+					x = _mm_xor_si128(x, _mm_slli_si128(x, 2));
+					x = _mm_xor_si128(x, _mm_slli_si128(x, 4));
+					x = _mm_xor_si128(x, _mm_slli_si128(x, 8));
+					x = _mm_xor_si128(x, carry);
+
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(plane + i), x);
+
+					// Broadcast the last byte without leaving the vector registers:
+					carry = _mm_unpackhi_epi8(x, x);
+					carry = _mm_unpackhi_epi16(carry, carry);
+					carry = _mm_shuffle_epi32(carry, 0xFF);
+				}
+
+				previous[k] = plane[block_count - 1];
+			}
+		}
+
+		static void store_words(Byte * output, std::size_t stride, __m128i words) {
+			for (std::size_t j = 0; j < 4; j += 1) {
+				uint32_t word = static_cast<uint32_t>(_mm_cvtsi128_si32(words));
+				std::memcpy(output + j * stride, &word, sizeof(word));
+				words = _mm_srli_si128(words, 4);
+			}
+		}
+
+		// Interleave the first and second halves of 16 rows of 16 bytes, which rotates the bits of each byte's row and column index by one. Written out, so that the rows stay in registers:
+		static inline void interleave_rows(const __m128i * in, __m128i * out) {
+			out[0] = _mm_unpacklo_epi8(in[0], in[8]); out[1] = _mm_unpackhi_epi8(in[0], in[8]);
+			out[2] = _mm_unpacklo_epi8(in[1], in[9]); out[3] = _mm_unpackhi_epi8(in[1], in[9]);
+			out[4] = _mm_unpacklo_epi8(in[2], in[10]); out[5] = _mm_unpackhi_epi8(in[2], in[10]);
+			out[6] = _mm_unpacklo_epi8(in[3], in[11]); out[7] = _mm_unpackhi_epi8(in[3], in[11]);
+			out[8] = _mm_unpacklo_epi8(in[4], in[12]); out[9] = _mm_unpackhi_epi8(in[4], in[12]);
+			out[10] = _mm_unpacklo_epi8(in[5], in[13]); out[11] = _mm_unpackhi_epi8(in[5], in[13]);
+			out[12] = _mm_unpacklo_epi8(in[6], in[14]); out[13] = _mm_unpackhi_epi8(in[6], in[14]);
+			out[14] = _mm_unpacklo_epi8(in[7], in[15]); out[15] = _mm_unpackhi_epi8(in[7], in[15]);
+		}
+
+		// Four rounds of interleaving swap the row and column of every byte:
+		static inline void transpose_16x16(__m128i * rows) {
+			__m128i interleaved[16];
+
+			interleave_rows(rows, interleaved);
+			interleave_rows(interleaved, rows);
+			interleave_rows(rows, interleaved);
+			interleave_rows(interleaved, rows);
+		}
+
+		// Interleave the planes of a block into vertices:
+		static void transpose_planes(const Byte * planes, Byte * output, std::size_t stride, std::size_t block_count) {
+			std::size_t i = 0;
+
+			for (; i + 16 <= block_count; i += 16) {
+				std::size_t k = 0;
+
+				// 16 planes of 16 vertices become 16 bytes of each vertex, which are stored whole:
+				for (; k + 16 <= stride; k += 16) {
+					__m128i rows[16];
+
+					for (std::size_t j = 0; j < 16; j += 1)
+						rows[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(planes + (k + j) * VERTEX_BLOCK_SIZE + i));
+
+					transpose_16x16(rows);
+
+					for (std::size_t j = 0; j < 16; j += 1)
+						_mm_storeu_si128(reinterpret_cast<__m128i *>(output + (i + j) * stride + k), rows[j]);
+				}
+
+				for (; k < stride; k += 4) {
+					const Byte * plane = planes + k * VERTEX_BLOCK_SIZE + i;
+
+					__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(plane));
+					__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(plane + VERTEX_BLOCK_SIZE));
+					__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(plane + VERTEX_BLOCK_SIZE * 2));
+					__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(plane + VERTEX_BLOCK_SIZE * 3));
+
+					__m128i ab_low = _mm_unpacklo_epi8(a, b), ab_high = _mm_unpackhi_epi8(a, b);
+					__m128i cd_low = _mm_unpacklo_epi8(c, d), cd_high = _mm_unpackhi_epi8(c, d);
+
+					Byte * vertex = output + i * stride + k;
+
+					store_words(vertex, stride, _mm_unpacklo_epi16(ab_low, cd_low));
+					store_words(vertex + 4 * stride, stride, _mm_unpackhi_epi16(ab_low, cd_low));
+					store_words(vertex + 8 * stride, stride, _mm_unpacklo_epi16(ab_high, cd_high));
+					store_words(vertex + 12 * stride, stride, _mm_unpackhi_epi16(ab_high, cd_high));
+				}
+			}
+
+			for (; i < block_count; i += 1) {
+				for (std::size_t k = 0; k < stride; k += 1)
+					output[i * stride + k] = planes[k * VERTEX_BLOCK_SIZE + i];
+			}
+		}
+#endif
+
+		static void decode_vertices(Input & input, Byte * vertices, std::size_t count, std::size_t stride) {
+			std::vector<Byte> previous(stride, 0), planes(stride * VERTEX_BLOCK_SIZE);
+
+			for (std::size_t base = 0; base < count; base += VERTEX_BLOCK_SIZE) {
+				std::size_t block_count = std::min(VERTEX_BLOCK_SIZE, count - base);
+
+				for (std::size_t k = 0; k < stride; k += 1) {
+					Byte * plane = planes.data() + k * VERTEX_BLOCK_SIZE;
+
+					for (std::size_t i = 0; i < block_count; i += GROUP_SIZE) {
+						decode_group(input, plane + i, std::min(GROUP_SIZE, block_count - i));
+					}
+				}
+
+				Byte * output = vertices + base * stride;
+
+#if defined(__SSE2__)
+				// Vertex sizes are a multiple of 4 bytes, so 4 planes at a time are interleaved into 16 vertices:
+				if (stride % 4 == 0) {
+					accumulate_planes(planes.data(), previous.data(), stride, block_count);
+					transpose_planes(planes.data(), output, stride, block_count);
+
+					continue;
+				}
+#endif
+
+				// Transpose the planes back into vertices, accumulating the differences:
+				for (std::size_t i = 0; i < block_count; i += 1) {
+					for (std::size_t k = 0; k < stride; k += 1) {
+						previous[k] ^= planes[k * VERTEX_BLOCK_SIZE + i];
+					}
+
+					std::memcpy(output + i * stride, previous.data(), stride);
+				}
+			}
+		}
+
+		static OffsetT append_packed(Writer & writer, PackedArray::Method method, TagT array_tag, std::size_t element_size, std::size_t count, const std::vector<Byte> & data) {
+			// Only replace arrays which actually get smaller:
+			if (sizeof(PackedArray) + data.size() >= sizeof(Block) + element_size * count)
+				return 0;
+
+			// Padding keeps any following blocks aligned:
+			auto packed = writer.append<PackedArray>((data.size() + 3) & ~std::size_t(3));
+
+			packed->method = method;
+			packed->array_tag = array_tag;
+			packed->element_size = static_cast<uint32_t>(element_size);
+			packed->count = count;
+
+			std::memcpy(reinterpret_cast<Byte *>(*packed) + sizeof(PackedArray), data.data(), data.size());
+
+			return packed;
+		}
+
+		OffsetT pack_indices(Writer & writer, OffsetT indices_offset, Mesh::Layout layout) {
+			if (!indices_offset) return 0;
+
+			auto block = *writer.block_at_offset<Block>(indices_offset);
+			TagT tag = block->tag;
+			std::size_t element_size;
+
+			if (tag == Index16::TAG)
+				element_size = sizeof(Index16);
+			else if (tag == Index32::TAG)
+				element_size = sizeof(Index32);
+			else
+				return 0;
+
+			auto indices = read_indices(block);
+
+			std::vector<Byte> data;
+			auto method = PackedArray::Method::INDEX_SEQUENCE;
+
+			if (layout == Mesh::Layout::TRIANGLES && indices.size() % 3 == 0) {
+				method = PackedArray::Method::INDEX_TRIANGLES;
+				encode_triangles(indices, data);
+			} else {
+				encode_sequence(indices, data);
+			}
+
+			return append_packed(writer, method, tag, element_size, indices.size(), data);
+		}
+
+		OffsetT pack_vertices(Writer & writer, OffsetT vertices_offset) {
+			if (!vertices_offset) return 0;
+
+			auto block = *writer.block_at_offset<Block>(vertices_offset);
+			TagT tag = block->tag;
+			std::size_t stride = vertex_size_for_tag(tag);
+
+			if (stride == 0) return 0;
+
+			std::size_t count = vertex_count(block);
+
+			std::vector<Byte> data;
+			encode_vertices(reinterpret_cast<const Byte *>(block) + sizeof(Block), count, stride, data);
+
+			return append_packed(writer, PackedArray::Method::VERTEX_DELTA, tag, stride, count, data);
+		}
+
+		void validate(const PackedArray * packed) {
+			if (packed->size < sizeof(PackedArray))
+				throw DecodeError("Packed array is smaller than its header!");
+
+			switch (packed->method) {
+				case PackedArray::Method::INDEX_SEQUENCE:
+				case PackedArray::Method::INDEX_TRIANGLES:
+					if (packed->array_tag == Index16::TAG) {
+						if (packed->element_size != sizeof(Index16))
+							throw DecodeError("Packed array element size doesn't match its index type!");
+					} else if (packed->array_tag == Index32::TAG) {
+						if (packed->element_size != sizeof(Index32))
+							throw DecodeError("Packed array element size doesn't match its index type!");
+					} else {
+						throw DecodeError("Packed indices must decode to an index array!");
+					}
+
+					// Triangles are decoded three indices at a time:
+					if (packed->method == PackedArray::Method::INDEX_TRIANGLES && packed->count % 3 != 0)
+						throw DecodeError("Packed triangles must have a multiple of 3 indices!");
+
+					break;
+
+				case PackedArray::Method::VERTEX_DELTA: {
+					std::size_t vertex_size = vertex_size_for_tag(packed->array_tag);
+
+					if (!vertex_size)
+						throw DecodeError("Packed vertices must decode to a vertex array!");
+
+					if (packed->element_size != vertex_size)
+						throw DecodeError("Packed array element size doesn't match its vertex type!");
+
+					break;
+				}
+
+				default:
+					throw DecodeError("Unknown packed array method!");
+			}
+
+			// Every method uses at least one byte for each group of 16 elements, so a larger count can't be decoded and would only cause a huge allocation:
+			if (packed->count / GROUP_SIZE > packed->data_size())
+				throw DecodeError("Packed array count exceeds its encoded data!");
+		}
+
+		void unpack(const PackedArray * packed, Byte * output) {
+			validate(packed);
+
+			Block * block = reinterpret_cast<Block *>(output);
+			block->tag = packed->array_tag;
+			block->size = packed->decoded_size();
+
+			Byte * elements = output + sizeof(Block);
+			Input input{packed->data(), packed->data() + packed->data_size()};
+
+			switch (packed->method) {
+				case PackedArray::Method::INDEX_SEQUENCE:
+					if (packed->element_size == sizeof(Index16))
+						decode_sequence(input, reinterpret_cast<uint16_t *>(elements), packed->count);
+					else
+						decode_sequence(input, reinterpret_cast<uint32_t *>(elements), packed->count);
+					break;
+
+				case PackedArray::Method::INDEX_TRIANGLES:
+					if (packed->element_size == sizeof(Index16))
+						decode_triangles(input, reinterpret_cast<uint16_t *>(elements), packed->count);
+					else
+						decode_triangles(input, reinterpret_cast<uint32_t *>(elements), packed->count);
+					break;
+
+				case PackedArray::Method::VERTEX_DELTA:
+					decode_vertices(input, elements, packed->count, packed->element_size);
+					break;
+			}
+		}
+	}
+}
@@ -0,0 +1,84 @@
+//
+//  Codec.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Writer.hpp"
+
+#include <stdexcept>
+
+namespace TaggedFormat
+{
+	/// An index or vertex array compressed using a mesh specific codec. Decodes to an `Array` block identical to the original.
+	struct PackedArray : public Block {
+		static const TagT TAG = tag_from_identifier("PACK");
+
+		enum class Method : uint32_t {
+			/// Indices stored as zig-zag encoded deltas, suitable for any layout.
+			INDEX_SEQUENCE = 0,
+
+			/// Triangle list indices coded using a FIFO of recently seen edges and vertices.
+			INDEX_TRIANGLES = 1,
+
+			/// Vertices stored as the byte planes of the difference between consecutive vertices.
+			VERTEX_DELTA = 2
+		};
+
+		Aligned<Method>::TypeT method;
+
+		/// The tag of the decoded array.
+		TagT array_tag;
+
+		/// The size of each decoded element in bytes.
+		uint32_t element_size;
+
+		/// The number of decoded elements.
+		OffsetT count;
+
+		/// The size of the decoded array block, including the block header.
+		std::size_t decoded_size() const {
+			return sizeof(Block) + element_size * count;
+		}
+
+		/// The encoded data which follows this structure.
+		const Byte * data() const {
+			return reinterpret_cast<const Byte *>(this) + sizeof(PackedArray);
+		}
+
+		std::size_t data_size() const {
+			return size - sizeof(PackedArray);
+		}
+
+		static std::string name_for_method(Method method);
+	};
+
+	namespace Codec
+	{
+		class DecodeError : public std::runtime_error {
+		public:
+			explicit DecodeError(const std::string & message);
+		};
+
+		/// Append a packed copy of the index array at the given offset. Triangle lists use the edge cache coding, other layouts are delta coded.
+		/// @returns the offset of the packed array, or 0 if the block is not an index array or packing would not make it smaller.
+		OffsetT pack_indices(Writer & writer, OffsetT indices_offset, Mesh::Layout layout);
+
+		/// Append a packed copy of the vertex array at the given offset.
+		/// @returns the offset of the packed array, or 0 if the block is not a vertex array or packing would not make it smaller.
+		OffsetT pack_vertices(Writer & writer, OffsetT vertices_offset);
+
+		/// Check that the header of a packed array is consistent, so that `decoded_size()` can be trusted before allocating the output. The element size must match the array tag, and the count is bounded by the size of the encoded data.
+		/// @throws DecodeError if the header is invalid.
+		void validate(const PackedArray * packed);
+
+		/// Decode a packed array into the equivalent array block, which must have space for `decoded_size()` bytes.
+		/// @throws DecodeError if the packed array is invalid or the encoded data is corrupt.
+		void unpack(const PackedArray * packed, Byte * output);
+	}
+}
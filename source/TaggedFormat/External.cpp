@@ -7,3 +7,16 @@
 //
 
 #include "External.hpp"
+
+namespace TaggedFormat {
+	std::string External::location() const {
+		std::size_t capacity = size > sizeof(External) ? size - sizeof(External) : 0;
+		std::size_t length = 0;
+
+		while (length < capacity && url[length]) {
+			length += 1;
+		}
+
+		return std::string(url, url + length);
+	}
+}
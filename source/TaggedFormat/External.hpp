@@ -11,8 +11,10 @@
 
 #include "Block.hpp"
 
+#include <string>
+
 namespace TaggedFormat {
-	/// Reference an external resource. Implementation defined.
+	/// Reference an external resource. Implementation defined, but see `Resolver` for the URLs which the `Reader` can follow.
 	struct External : public Block {
 		static const TagT TAG = tag_from_identifier("EXRN");
 
@@ -20,6 +22,9 @@ namespace TaggedFormat {
 
 		/// Null terminated URL referencing external resource.
 		unsigned char url[0];
+
+		/// @returns the URL, which is bounded by the size of the block even if it is not terminated.
+		std::string location() const;
 	};
 }
 
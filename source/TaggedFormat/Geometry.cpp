@@ -0,0 +1,193 @@
+//
+//  Geometry.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Geometry.hpp"
+#include "Table.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace TaggedFormat
+{
+	std::size_t vertex_size_for_tag(TagT tag) {
+		switch (tag) {
+			case VertexP2::TAG: return sizeof(VertexP2);
+			case VertexP2C4::TAG: return sizeof(VertexP2C4);
+			case VertexP3::TAG: return sizeof(VertexP3);
+			case VertexP3N3::TAG: return sizeof(VertexP3N3);
+			case VertexP3N3M2::TAG: return sizeof(VertexP3N3M2);
+			case VertexP3N3M2C4::TAG: return sizeof(VertexP3N3M2C4);
+			case VertexP3N3M2B4::TAG: return sizeof(VertexP3N3M2B4);
+			case VertexP3N3M2T4::TAG: return sizeof(VertexP3N3M2T4);
+			default: return 0;
+		}
+	}
+
+	std::size_t vertex_count(const Block * block) {
+		std::size_t stride = vertex_size_for_tag(block->tag);
+
+		if (stride == 0) return 0;
+
+		return (block->size - sizeof(Block)) / stride;
+	}
+
+	std::vector<float32> read_positions(const Block * block) {
+		std::vector<float32> positions;
+
+		visit_vertices(const_cast<Block *>(block), [&](auto * array) {
+			positions.reserve(array->count() * 3);
+
+			for (auto & vertex : *array) {
+				const std::size_t dimensions = sizeof(vertex.position) / sizeof(float32);
+
+				for (std::size_t i = 0; i < 3; i += 1)
+					positions.push_back(i < dimensions ? vertex.position[i] : 0);
+			}
+		});
+
+		return positions;
+	}
+
+	template <typename IndexT>
+	static void copy_indices(const Block * block, std::vector<uint32_t> & indices) {
+		auto array = static_cast<const Array<IndexT> *>(block);
+
+		indices.reserve(array->count());
+		for (auto index : *array) indices.push_back(index.value);
+	}
+
+	std::vector<uint32_t> read_indices(const Block * block) {
+		std::vector<uint32_t> indices;
+
+		if (block->tag == Index16::TAG)
+			copy_indices<Index16>(block, indices);
+		else if (block->tag == Index32::TAG)
+			copy_indices<Index32>(block, indices);
+
+		return indices;
+	}
+
+	template <typename IndexT>
+	static void assign_indices(Block * block, const std::vector<uint32_t> & indices) {
+		auto array = static_cast<Array<IndexT> *>(block);
+
+		if (array->count() != indices.size())
+			throw std::length_error("Index count does not match the existing array!");
+
+		IndexT * output = array->begin();
+		for (std::size_t i = 0; i < indices.size(); i += 1) {
+			output[i].value = indices[i];
+		}
+	}
+
+	void write_indices(Block * block, const std::vector<uint32_t> & indices) {
+		if (block->tag == Index16::TAG)
+			assign_indices<Index16>(block, indices);
+		else if (block->tag == Index32::TAG)
+			assign_indices<Index32>(block, indices);
+		else
+			throw std::invalid_argument("Block is not an index array!");
+	}
+
+	OffsetT append_indices(Writer & writer, const std::vector<uint32_t> & indices, TagT tag) {
+		if (tag == Index16::TAG) {
+			auto array = writer.append<Array<Index16>>(Array<Index16>::array_size(indices.size()));
+			assign_indices<Index16>(*array, indices);
+
+			return array;
+		} else {
+			auto array = writer.append<Array<Index32>>(Array<Index32>::array_size(indices.size()));
+			assign_indices<Index32>(*array, indices);
+
+			return array;
+		}
+	}
+
+	OffsetT append_vertices(Writer & writer, OffsetT vertices_offset, const std::vector<uint32_t> & selection) {
+		OffsetT offset = 0;
+
+		visit_vertices(*writer.block_at_offset<Block>(vertices_offset), [&](auto * array) {
+			typedef typename std::remove_pointer<decltype(array)>::type ArrayT;
+			typedef typename ArrayT::ElementT VertexT;
+
+			// Copy the vertices first, as appending may move the source array:
+			std::vector<VertexT> vertices;
+			vertices.reserve(selection.size());
+
+			for (auto index : selection) vertices.push_back(array->at(index));
+
+			auto output = writer.append<ArrayT>(ArrayT::array_size(vertices.size()));
+			std::copy(vertices.begin(), vertices.end(), output->begin());
+
+			offset = output;
+		});
+
+		return offset;
+	}
+
+	void set_mesh_metadata(Writer & writer, OffsetT mesh_offset, const std::string & name, OffsetT offset) {
+		std::vector<NamedOffset> entries;
+
+		if (OffsetT metadata_offset = writer.block_at_offset<Mesh>(mesh_offset)->metadata_offset) {
+			auto metadata = writer.block_at_offset<Block>(metadata_offset);
+
+			if (metadata->tag == OffsetTable::TAG) {
+				auto table = static_cast<OffsetTable *>(*metadata);
+				entries.assign(table->begin(), table->end());
+			} else {
+				entries.emplace_back();
+				entries.back().name = "metadata";
+				entries.back().offset = metadata_offset;
+			}
+		}
+
+		auto existing = std::find_if(entries.begin(), entries.end(), [&](const NamedOffset & entry) {
+			return entry.match(name);
+		});
+
+		if (existing == entries.end()) {
+			entries.emplace_back();
+			existing = entries.end() - 1;
+			existing->name = name;
+		}
+
+		existing->offset = offset;
+
+		auto table = writer.append<OffsetTable>(OffsetTable::array_size(entries.size()));
+		std::copy(entries.begin(), entries.end(), table->begin());
+
+		writer.block_at_offset<Mesh>(mesh_offset)->metadata_offset = table;
+	}
+
+	void remap_vertices(Block * block, const std::vector<uint32_t> & remap) {
+		visit_vertices(block, [&](auto * array) {
+			typedef typename std::remove_pointer<decltype(array)>::type::ElementT VertexT;
+
+			std::vector<VertexT> vertices(array->begin(), array->end());
+			VertexT * output = array->begin();
+
+			for (std::size_t i = 0; i < vertices.size(); i += 1) {
+				output[remap[i]] = vertices[i];
+			}
+		});
+	}
+
+	void multiply_matrices(const float32 a[16], const float32 b[16], float32 result[16]) {
+		for (std::size_t column = 0; column < 4; column += 1) {
+			for (std::size_t row = 0; row < 4; row += 1) {
+				float32 sum = 0;
+
+				for (std::size_t k = 0; k < 4; k += 1)
+					sum += a[k * 4 + row] * b[column * 4 + k];
+
+				result[column * 4 + row] = sum;
+			}
+		}
+	}
+}
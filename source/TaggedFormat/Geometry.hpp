@@ -0,0 +1,91 @@
+//
+//  Geometry.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Skeleton.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// Invoke the callback with the block cast to the matching vertex array type, e.g. `Array<VertexP3N3M2> *`.
+	/// @returns false if the block is not a known vertex array.
+	template <typename CallbackT>
+	bool visit_vertices(Block * block, CallbackT && callback) {
+		switch (block->tag) {
+			case VertexP2::TAG:
+				callback(static_cast<Array<VertexP2> *>(block));
+				return true;
+
+			case VertexP2C4::TAG:
+				callback(static_cast<Array<VertexP2C4> *>(block));
+				return true;
+
+			case VertexP3::TAG:
+				callback(static_cast<Array<VertexP3> *>(block));
+				return true;
+
+			case VertexP3N3::TAG:
+				callback(static_cast<Array<VertexP3N3> *>(block));
+				return true;
+
+			case VertexP3N3M2::TAG:
+				callback(static_cast<Array<VertexP3N3M2> *>(block));
+				return true;
+
+			case VertexP3N3M2C4::TAG:
+				callback(static_cast<Array<VertexP3N3M2C4> *>(block));
+				return true;
+
+			case VertexP3N3M2B4::TAG:
+				callback(static_cast<Array<VertexP3N3M2B4> *>(block));
+				return true;
+
+			case VertexP3N3M2T4::TAG:
+				callback(static_cast<Array<VertexP3N3M2T4> *>(block));
+				return true;
+
+			default:
+				return false;
+		}
+	}
+
+	/// @returns the size of a single vertex for the given array tag, or 0 if the tag is not a known vertex type.
+	std::size_t vertex_size_for_tag(TagT tag);
+
+	/// @returns the number of vertices in a vertex array, or 0 if the block is not a known vertex array.
+	std::size_t vertex_count(const Block * block);
+
+	/// @returns the positions of every vertex in a vertex array as x, y, z triples, with z = 0 for 2D vertices, or an empty list if the block is not a known vertex array.
+	std::vector<float32> read_positions(const Block * block);
+
+	/// @returns the indices stored in an `Index16` or `Index32` array, or an empty list for any other block.
+	std::vector<uint32_t> read_indices(const Block * block);
+
+	/// Overwrite the contents of an existing index array with the same number of indices.
+	void write_indices(Block * block, const std::vector<uint32_t> & indices);
+
+	/// Append a new index array with the given tag, either `Index16::TAG` or `Index32::TAG`.
+	OffsetT append_indices(Writer & writer, const std::vector<uint32_t> & indices, TagT tag);
+
+	/// Append a new vertex array of the same type, containing the given vertices in order.
+	/// @returns the offset of the new array, or 0 if the block is not a known vertex array.
+	OffsetT append_vertices(Writer & writer, OffsetT vertices_offset, const std::vector<uint32_t> & selection);
+
+	/// Add or replace a named entry in the metadata table of a mesh. A new table is appended, so tables shared with other meshes are not modified. If the existing metadata is not an `OffsetTable`, it is kept in the new table as `metadata`.
+	void set_mesh_metadata(Writer & writer, OffsetT mesh_offset, const std::string & name, OffsetT offset);
+
+	/// Reorder the vertices of a vertex array in place, such that the vertex at index `i` moves to `remap[i]`.
+	void remap_vertices(Block * block, const std::vector<uint32_t> & remap);
+
+	/// Multiply two column major matrices, i.e. `m[column * 4 + row]`, giving the transform `b` followed by `a`.
+	void multiply_matrices(const float32 a[16], const float32 b[16], float32 result[16]);
+}
@@ -0,0 +1,168 @@
+//
+//  Instancing.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Instancing.hpp"
+#include "Bounds.hpp"
+#include "Traversal.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace TaggedFormat
+{
+	namespace Instancing
+	{
+		// The geometry instance of a child node which can be batched, or 0. Node bounds are dropped, as the bounds of the parent already contain them:
+		static OffsetT batchable_geometry(Writer & writer, OffsetT node_offset) {
+			if (!node_offset || writer.block_at_offset<Block>(node_offset)->tag != Node::TAG) return 0;
+
+			auto node = *writer.block_at_offset<Node>(node_offset);
+
+			if (node->transform[3] != 0 || node->transform[7] != 0 || node->transform[11] != 0 || node->transform[15] != 1) return 0;
+
+			OffsetT geometry_offset = 0;
+
+			for (auto & reference : *node) {
+				if (!reference.offset) continue;
+
+				TagT tag = writer.block_at_offset<Block>(reference.offset)->tag;
+
+				if (tag == GeometryInstance::TAG && !geometry_offset)
+					geometry_offset = reference.offset;
+				else if (tag != Bounds::TAG)
+					return 0;
+			}
+
+			return geometry_offset;
+		}
+
+		struct Group {
+			OffsetT mesh_offset, skeleton_offset, material_offset;
+			std::vector<OffsetT> node_offsets;
+		};
+
+		std::size_t batch_instances(Writer & writer, const std::vector<OffsetT> & offsets, std::size_t minimum_count) {
+			std::vector<OffsetT> node_offsets;
+			uint32_t next_id = 0;
+
+			for (auto offset : offsets) {
+				TagT tag = writer.block_at_offset<Block>(offset)->tag;
+
+				if (tag == Node::TAG) {
+					node_offsets.push_back(offset);
+				} else if (tag == InstanceBatch::TAG) {
+					// Batches from a previous conversion keep their identifiers:
+					for (auto & instance : **writer.block_at_offset<InstanceBatch>(offset))
+						next_id = std::max(next_id, instance.id + 1);
+				}
+			}
+
+			std::map<OffsetT, OffsetT> replacements;
+			std::size_t batched = 0;
+
+			for (auto offset : node_offsets) {
+				std::vector<OffsetT> references;
+				for (auto & reference : **writer.block_at_offset<Node>(offset))
+					references.push_back(reference.offset);
+
+				std::vector<Group> groups;
+
+				for (auto reference : references) {
+					OffsetT geometry_offset = batchable_geometry(writer, reference);
+					if (!geometry_offset) continue;
+
+					auto geometry = writer.block_at_offset<GeometryInstance>(geometry_offset);
+
+					auto group = std::find_if(groups.begin(), groups.end(), [&](const Group & group) {
+						return group.mesh_offset == geometry->mesh_offset && group.skeleton_offset == geometry->skeleton_offset && group.material_offset == geometry->material_offset;
+					});
+
+					if (group == groups.end())
+						group = groups.insert(groups.end(), Group{geometry->mesh_offset, geometry->skeleton_offset, geometry->material_offset, {}});
+
+					group->node_offsets.push_back(reference);
+				}
+
+				groups.erase(std::remove_if(groups.begin(), groups.end(), [&](const Group & group) {
+					return group.node_offsets.size() < std::max<std::size_t>(minimum_count, 1);
+				}), groups.end());
+
+				if (groups.empty()) continue;
+
+				std::set<OffsetT> removed;
+				for (auto & group : groups)
+					removed.insert(group.node_offsets.begin(), group.node_offsets.end());
+
+				references.erase(std::remove_if(references.begin(), references.end(), [&](OffsetT reference) {
+					return removed.count(reference) != 0;
+				}), references.end());
+
+				for (auto & group : groups) {
+					auto batch = writer.append<InstanceBatch>(InstanceBatch::array_size(group.node_offsets.size()));
+					batch->mesh_offset = group.mesh_offset;
+					batch->skeleton_offset = group.skeleton_offset;
+					batch->material_offset = group.material_offset;
+
+					for (std::size_t i = 0; i < group.node_offsets.size(); i += 1) {
+						auto node = writer.block_at_offset<Node>(group.node_offsets[i]);
+						auto & instance = batch->begin()[i];
+
+						instance.id = next_id++;
+
+						for (std::size_t column = 0; column < 4; column += 1)
+							std::copy_n(node->transform + column * 4, 3, instance.transform + column * 3);
+					}
+
+					batched += group.node_offsets.size();
+					references.push_back(batch);
+				}
+
+				auto node = writer.append<Node>(Node::array_size(references.size()));
+				auto original = writer.block_at_offset<Node>(offset);
+
+				node->name = original->name;
+				std::copy_n(original->transform, 16, node->transform);
+				for (std::size_t i = 0; i < references.size(); i += 1)
+					node->begin()[i].offset = references[i];
+
+				replacements[offset] = node;
+			}
+
+			relocate_offsets(writer, offsets, replacements);
+
+			return batched;
+		}
+
+		void unpack(const BatchedInstance & instance, float32 transform[16]) {
+			for (std::size_t column = 0; column < 4; column += 1) {
+				std::copy_n(instance.transform + column * 3, 3, transform + column * 4);
+				transform[column * 4 + 3] = column == 3 ? 1 : 0;
+			}
+		}
+
+		void world_transforms(const InstanceBatch * batch, const float32 parent[16], float32 * transforms) {
+			for (auto & instance : *batch) {
+				const float32 * local = instance.transform;
+
+				// The last row of the local transform is (0, 0, 0, 1):
+				for (std::size_t column = 0; column < 4; column += 1) {
+					for (std::size_t row = 0; row < 4; row += 1) {
+						float32 sum = parent[row] * local[column * 3] + parent[4 + row] * local[column * 3 + 1] + parent[8 + row] * local[column * 3 + 2];
+
+						if (column == 3) sum += parent[12 + row];
+
+						transforms[column * 4 + row] = sum;
+					}
+				}
+
+				transforms += 16;
+			}
+		}
+	}
+}
@@ -0,0 +1,54 @@
+//
+//  Instancing.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Scene.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// One instance of a batch, placed relative to the node which references the batch.
+	struct BatchedInstance {
+		static const TagT TAG = tag_from_identifier("#INS");
+
+		/// Identifies the instance, e.g. for picking. Unique within the file.
+		uint32_t id;
+
+		/// The first three rows of a column major affine transform, whose last row is always (0, 0, 0, 1).
+		float32 transform[12];
+	};
+
+	/// Many instances of the same geometry, e.g. the rocks or trees of a level, in place of a child node and `GeometryInstance` for each.
+	struct InstanceBatch : public Array<BatchedInstance, InstanceBatch> {
+		static const TagT TAG = tag_from_identifier("IBAT");
+
+		OffsetT mesh_offset;
+		OffsetT skeleton_offset;
+		OffsetT material_offset;
+	};
+
+	/// Grouping of repeated geometry instances at conversion time.
+	namespace Instancing
+	{
+		/// The fewest instances of the same geometry below one node which are batched.
+		const std::size_t DEFAULT_MINIMUM_COUNT = 2;
+
+		/// Replace the children of each node within `offsets` which only contain a `GeometryInstance`, apart from their bounds, with one `InstanceBatch` for each distinct mesh, skeleton and material, if there are at least `minimum_count` of them. Children with projective transforms are not batched. Nodes are replaced by a copy, and all references to the original nodes within `offsets` and the header are updated.
+		/// @returns the number of instances which were batched.
+		std::size_t batch_instances(Writer & writer, const std::vector<OffsetT> & offsets, std::size_t minimum_count = DEFAULT_MINIMUM_COUNT);
+
+		/// Expand the transform of an instance into a column major 4x4 matrix.
+		void unpack(const BatchedInstance & instance, float32 transform[16]);
+
+		/// Compute the column major world transform of every instance of a batch, given the world transform of the node which references it, with 16 values per instance in order, e.g. for uploading to an instance buffer.
+		void world_transforms(const InstanceBatch * batch, const float32 parent[16], float32 * transforms);
+	}
+}
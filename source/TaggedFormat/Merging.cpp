@@ -0,0 +1,420 @@
+//
+//  Merging.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Merging.hpp"
+#include "Geometry.hpp"
+#include "Morph.hpp"
+#include "Traversal.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+
+namespace TaggedFormat
+{
+	namespace Merging
+	{
+		// A geometry instance for each path through the node hierarchy of a root, with its transform relative to the root:
+		struct Instance {
+			OffsetT root_offset, node_offset, geometry_offset;
+			float32 world[16];
+		};
+
+		class InstanceCollector {
+		public:
+			InstanceCollector(Writer & writer, std::vector<Instance> & instances) : _writer(writer), _instances(instances) {}
+
+			void collect(OffsetT root_offset, OffsetT offset, const float32 parent[16]) {
+				// Guard against cycles, which would otherwise recurse forever:
+				if (std::find(_path.begin(), _path.end(), offset) != _path.end()) return;
+
+				Instance instance;
+				instance.root_offset = root_offset;
+				instance.node_offset = offset;
+
+				// Merged nodes are children of the root, so its own transform is applied to them by the root:
+				if (offset == root_offset)
+					std::copy_n(parent, 16, instance.world);
+				else
+					multiply_matrices(parent, _writer.block_at_offset<Node>(offset)->transform, instance.world);
+
+				std::vector<OffsetT> references;
+				for (auto & reference : **_writer.block_at_offset<Node>(offset))
+					references.push_back(reference.offset);
+
+				_path.push_back(offset);
+
+				for (auto reference : references) {
+					if (!reference) continue;
+
+					TagT tag = _writer.block_at_offset<Block>(reference)->tag;
+
+					if (tag == Node::TAG) {
+						collect(root_offset, reference, instance.world);
+					} else if (tag == GeometryInstance::TAG) {
+						instance.geometry_offset = reference;
+						_instances.push_back(instance);
+					}
+				}
+
+				_path.pop_back();
+			}
+
+		private:
+			Writer & _writer;
+			std::vector<Instance> & _instances;
+
+			std::vector<OffsetT> _path;
+		};
+
+		// @returns the vertex array tag of a static instance, or 0 if it can't be merged.
+		static TagT static_vertex_tag(Writer & writer, const Instance & instance, const std::set<OffsetT> & morphed_offsets) {
+			const float32 * world = instance.world;
+
+			if (world[3] != 0 || world[7] != 0 || world[11] != 0 || world[15] != 1) return 0;
+
+			auto geometry = writer.block_at_offset<GeometryInstance>(instance.geometry_offset);
+			OffsetT mesh_offset = geometry->mesh_offset;
+
+			if (geometry->skeleton_offset || !mesh_offset || morphed_offsets.count(mesh_offset)) return 0;
+			if (writer.block_at_offset<Block>(mesh_offset)->tag != Mesh::TAG) return 0;
+
+			auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+
+			if (mesh->layout != Mesh::Layout::TRIANGLES || !mesh->indices_offset || !mesh->vertices_offset) return 0;
+
+			TagT index_tag = writer.block_at_offset<Block>(mesh->indices_offset)->tag;
+			TagT vertex_tag = writer.block_at_offset<Block>(mesh->vertices_offset)->tag;
+
+			if (index_tag != Index16::TAG && index_tag != Index32::TAG) return 0;
+
+			// Packed arrays and vertex streams are not known vertex types, and 2D vertices can't be transformed:
+			if (!vertex_size_for_tag(vertex_tag) || vertex_tag == VertexP2::TAG || vertex_tag == VertexP2C4::TAG) return 0;
+
+			return vertex_tag;
+		}
+
+		// The world transform of an instance, and the matrix which transforms its normals, i.e. the inverse transpose scaled by the determinant:
+		struct WorldTransform {
+			const float32 * matrix;
+			float32 normal_matrix[9];
+
+			// Mirrored instances reverse the winding of their triangles:
+			bool mirrored;
+
+			WorldTransform(const float32 * world) : matrix(world) {
+				const float32 * a = world, * b = world + 4, * c = world + 8;
+
+				float32 columns[3][3] = {
+					{b[1] * c[2] - b[2] * c[1], b[2] * c[0] - b[0] * c[2], b[0] * c[1] - b[1] * c[0]},
+					{c[1] * a[2] - c[2] * a[1], c[2] * a[0] - c[0] * a[2], c[0] * a[1] - c[1] * a[0]},
+					{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]},
+				};
+
+				float32 determinant = a[0] * columns[0][0] + a[1] * columns[0][1] + a[2] * columns[0][2];
+				mirrored = determinant < 0;
+
+				for (std::size_t column = 0; column < 3; column += 1) {
+					for (std::size_t row = 0; row < 3; row += 1)
+						normal_matrix[column * 3 + row] = mirrored ? -columns[column][row] : columns[column][row];
+				}
+			}
+
+			void transform_position(float32 position[3]) const {
+				float32 result[3];
+
+				for (std::size_t row = 0; row < 3; row += 1)
+					result[row] = matrix[row] * position[0] + matrix[4 + row] * position[1] + matrix[8 + row] * position[2] + matrix[12 + row];
+
+				std::copy(result, result + 3, position);
+			}
+
+			void transform_normal(float32 normal[3]) const {
+				float32 result[3];
+
+				for (std::size_t row = 0; row < 3; row += 1)
+					result[row] = normal_matrix[row] * normal[0] + normal_matrix[3 + row] * normal[1] + normal_matrix[6 + row] * normal[2];
+
+				float32 length = std::sqrt(result[0] * result[0] + result[1] * result[1] + result[2] * result[2]);
+
+				for (std::size_t row = 0; row < 3; row += 1)
+					normal[row] = length > 0 ? result[row] / length : 0;
+			}
+
+			// Tangents lie in the surface, so they are transformed like the edges of triangles:
+			void transform_tangent(float32 tangent[3]) const {
+				float32 result[3];
+
+				for (std::size_t row = 0; row < 3; row += 1)
+					result[row] = matrix[row] * tangent[0] + matrix[4 + row] * tangent[1] + matrix[8 + row] * tangent[2];
+
+				float32 length = std::sqrt(result[0] * result[0] + result[1] * result[1] + result[2] * result[2]);
+
+				for (std::size_t row = 0; row < 3; row += 1)
+					tangent[row] = length > 0 ? result[row] / length : 0;
+			}
+		};
+
+		static void transform_vertex(VertexP2 &, const WorldTransform &) {
+		}
+
+		static void transform_vertex(VertexP3 & vertex, const WorldTransform & transform) {
+			transform.transform_position(vertex.position);
+		}
+
+		static void transform_vertex(VertexP3N3 & vertex, const WorldTransform & transform) {
+			transform.transform_position(vertex.position);
+			transform.transform_normal(vertex.normal);
+		}
+
+		static void transform_vertex(VertexP3N3M2T4 & vertex, const WorldTransform & transform) {
+			transform_vertex(static_cast<VertexP3N3 &>(vertex), transform);
+			transform.transform_tangent(vertex.tangent);
+
+			// Mirroring reverses the bitangent relative to the normal and tangent:
+			if (transform.mirrored) vertex.tangent[3] = -vertex.tangent[3];
+		}
+
+		// @returns the offset of a new node containing the merged instances.
+		static OffsetT merge_group(Writer & writer, const std::vector<Instance> & instances, const std::vector<std::size_t> & group, OffsetT material_offset) {
+			OffsetT first_mesh_offset = writer.block_at_offset<GeometryInstance>(instances[group.front()].geometry_offset)->mesh_offset;
+			OffsetT mesh_offset = 0, sources_offset = 0;
+
+			visit_vertices(*writer.block_at_offset<Block>(writer.block_at_offset<Mesh>(first_mesh_offset)->vertices_offset), [&](auto * first_array) {
+				typedef typename std::remove_pointer<decltype(first_array)>::type ArrayT;
+				typedef typename ArrayT::ElementT VertexT;
+
+				std::vector<VertexT> vertices;
+				std::vector<uint32_t> indices;
+				std::vector<MergedSource> sources;
+
+				// Every instance is copied before anything is appended, which may move the source arrays:
+				for (auto index : group) {
+					auto & instance = instances[index];
+					auto mesh = writer.block_at_offset<Mesh>(writer.block_at_offset<GeometryInstance>(instance.geometry_offset)->mesh_offset);
+					auto array = static_cast<const ArrayT *>(*writer.block_at_offset<Block>(mesh->vertices_offset));
+					auto mesh_indices = read_indices(*writer.block_at_offset<Block>(mesh->indices_offset));
+
+					WorldTransform transform(instance.world);
+					uint32_t base = vertices.size();
+
+					for (auto vertex : *array) {
+						transform_vertex(vertex, transform);
+						vertices.push_back(vertex);
+					}
+
+					MergedSource source;
+					source.node_offset = instance.node_offset;
+					source.triangle_offset = indices.size() / 3;
+					source.triangle_count = mesh_indices.size() / 3;
+
+					for (std::size_t i = 0; i + 2 < mesh_indices.size(); i += 3) {
+						indices.push_back(base + mesh_indices[i]);
+						indices.push_back(base + mesh_indices[i + (transform.mirrored ? 2 : 1)]);
+						indices.push_back(base + mesh_indices[i + (transform.mirrored ? 1 : 2)]);
+					}
+
+					sources.push_back(source);
+				}
+
+				auto vertices_block = writer.append<ArrayT>(ArrayT::array_size(vertices.size()));
+				std::copy(vertices.begin(), vertices.end(), vertices_block->begin());
+
+				OffsetT indices_offset = append_indices(writer, indices, vertices.size() <= 0x10000 ? Index16::TAG : Index32::TAG);
+
+				auto mesh = writer.append<Mesh>();
+				mesh->layout = Mesh::Layout::TRIANGLES;
+				mesh->indices_offset = indices_offset;
+				mesh->vertices_offset = vertices_block;
+				mesh->axes_offset = 0;
+				mesh->metadata_offset = 0;
+				mesh_offset = mesh;
+
+				auto sources_block = writer.append<Array<MergedSource>>(Array<MergedSource>::array_size(sources.size()));
+				std::copy(sources.begin(), sources.end(), sources_block->begin());
+				sources_offset = sources_block;
+			});
+
+			auto geometry = writer.append<GeometryInstance>();
+			geometry->mesh_offset = mesh_offset;
+			geometry->skeleton_offset = 0;
+			geometry->material_offset = material_offset;
+			OffsetT geometry_offset = geometry;
+
+			const float32 identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+			auto node = writer.append<Node>(Node::array_size(2));
+			node->name = std::string("merged");
+			std::copy_n(identity, 16, node->transform);
+			node->begin()[0].offset = geometry_offset;
+			node->begin()[1].offset = sources_offset;
+
+			return node;
+		}
+
+		// The center of the bounds of an instance, relative to its root:
+		static void instance_center(Writer & writer, const Instance & instance, float32 center[3]) {
+			auto mesh = writer.block_at_offset<Mesh>(writer.block_at_offset<GeometryInstance>(instance.geometry_offset)->mesh_offset);
+			auto positions = read_positions(*writer.block_at_offset<Block>(mesh->vertices_offset));
+
+			WorldTransform transform(instance.world);
+			float32 minimum[3], maximum[3];
+
+			std::fill_n(minimum, 3, std::numeric_limits<float32>::max());
+			std::fill_n(maximum, 3, std::numeric_limits<float32>::lowest());
+
+			for (std::size_t i = 0; i + 2 < positions.size(); i += 3) {
+				transform.transform_position(&positions[i]);
+
+				for (std::size_t k = 0; k < 3; k += 1) {
+					minimum[k] = std::min(minimum[k], positions[i + k]);
+					maximum[k] = std::max(maximum[k], positions[i + k]);
+				}
+			}
+
+			for (std::size_t k = 0; k < 3; k += 1)
+				center[k] = positions.empty() ? instance.world[12 + k] : (minimum[k] + maximum[k]) / 2;
+		}
+
+		std::size_t merge_static_instances(Writer & writer, const std::vector<OffsetT> & offsets, float32 cell_size) {
+			if (!(cell_size > 0))
+				throw std::invalid_argument("Merge cell size must be positive!");
+
+			std::vector<OffsetT> node_offsets;
+			std::set<OffsetT> children;
+
+			for (auto offset : offsets) {
+				if (writer.block_at_offset<Block>(offset)->tag != Node::TAG) continue;
+
+				node_offsets.push_back(offset);
+
+				for (auto & reference : **writer.block_at_offset<Node>(offset)) {
+					if (reference.offset && writer.block_at_offset<Block>(reference.offset)->tag == Node::TAG)
+						children.insert(reference.offset);
+				}
+			}
+
+			const float32 identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+			std::vector<Instance> instances;
+			InstanceCollector collector(writer, instances);
+
+			for (auto offset : node_offsets) {
+				if (!children.count(offset))
+					collector.collect(offset, offset, identity);
+			}
+
+			// Instances reached by more than one path are left alone, as removing them would remove every path:
+			std::map<std::pair<OffsetT, OffsetT>, std::size_t> paths;
+			for (auto & instance : instances)
+				paths[{instance.node_offset, instance.geometry_offset}] += 1;
+
+			auto morphed = Morph::morphed_meshes(writer, offsets);
+			std::set<OffsetT> morphed_offsets(morphed.begin(), morphed.end());
+
+			// Groups are ordered by root, material, vertex type and cell, so the output doesn't depend on the order of the blocks:
+			typedef std::tuple<OffsetT, OffsetT, TagT, float32, float32, float32> GroupKeyT;
+			std::map<GroupKeyT, std::vector<std::size_t>> groups;
+
+			for (std::size_t i = 0; i < instances.size(); i += 1) {
+				auto & instance = instances[i];
+
+				if (paths[{instance.node_offset, instance.geometry_offset}] != 1) continue;
+
+				TagT vertex_tag = static_vertex_tag(writer, instance, morphed_offsets);
+				if (!vertex_tag) continue;
+
+				float32 center[3];
+				instance_center(writer, instance, center);
+
+				OffsetT material_offset = writer.block_at_offset<GeometryInstance>(instance.geometry_offset)->material_offset;
+				GroupKeyT key{instance.root_offset, material_offset, vertex_tag, std::floor(center[0] / cell_size), std::floor(center[1] / cell_size), std::floor(center[2] / cell_size)};
+
+				groups[key].push_back(i);
+			}
+
+			std::map<OffsetT, std::vector<OffsetT>> merged_nodes;
+			std::set<std::pair<OffsetT, OffsetT>> merged_references;
+			std::vector<OffsetT> sources_offsets;
+			std::size_t merged = 0;
+
+			for (auto & group : groups) {
+				if (group.second.size() < 2) continue;
+
+				OffsetT node_offset = merge_group(writer, instances, group.second, std::get<1>(group.first));
+
+				merged_nodes[std::get<0>(group.first)].push_back(node_offset);
+				sources_offsets.push_back(writer.block_at_offset<Node>(node_offset)->begin()[1].offset);
+
+				for (auto index : group.second)
+					merged_references.insert({instances[index].node_offset, instances[index].geometry_offset});
+
+				merged += group.second.size();
+			}
+
+			if (!merged) return 0;
+
+			// Nodes lose the instances which were merged, and roots gain the merged nodes:
+			std::set<OffsetT> changed_offsets;
+			for (auto & reference : merged_references) changed_offsets.insert(reference.first);
+			for (auto & root : merged_nodes) changed_offsets.insert(root.first);
+
+			std::map<OffsetT, OffsetT> replacements;
+
+			for (auto offset : changed_offsets) {
+				std::vector<OffsetT> references;
+
+				for (auto & reference : **writer.block_at_offset<Node>(offset)) {
+					if (!merged_references.count({offset, reference.offset}))
+						references.push_back(reference.offset);
+				}
+
+				auto root = merged_nodes.find(offset);
+				if (root != merged_nodes.end())
+					references.insert(references.end(), root->second.begin(), root->second.end());
+
+				auto node = writer.append<Node>(Node::array_size(references.size()));
+				auto original = writer.block_at_offset<Node>(offset);
+
+				node->name = original->name;
+				std::copy_n(original->transform, 16, node->transform);
+				for (std::size_t i = 0; i < references.size(); i += 1)
+					node->begin()[i].offset = references[i];
+
+				replacements[offset] = node;
+			}
+
+			// The sources refer to the original nodes:
+			std::vector<OffsetT> relocated_offsets = offsets;
+			relocated_offsets.insert(relocated_offsets.end(), sources_offsets.begin(), sources_offsets.end());
+
+			relocate_offsets(writer, relocated_offsets, replacements);
+
+			return merged;
+		}
+
+		const MergedSource * source_for_triangle(const Array<MergedSource> * sources, std::size_t triangle) {
+			// Sources are in order of their triangles:
+			auto source = std::upper_bound(sources->begin(), sources->end(), triangle, [](std::size_t triangle, const MergedSource & source) {
+				return triangle < source.triangle_offset;
+			});
+
+			if (source == sources->begin()) return nullptr;
+
+			source -= 1;
+
+			if (triangle >= source->triangle_offset + source->triangle_count) return nullptr;
+
+			return source;
+		}
+	}
+}
@@ -0,0 +1,42 @@
+//
+//  Merging.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Scene.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// The range of triangles of a merged mesh which came from one node.
+	struct MergedSource {
+		static const TagT TAG = tag_from_identifier("MSRC");
+
+		/// The `Node` which contained the geometry instance.
+		OffsetT node_offset;
+
+		uint32_t triangle_offset, triangle_count;
+	};
+
+	/// Merging of static geometry at conversion time, to reduce the number of objects drawn or tested for collisions.
+	namespace Merging
+	{
+		/// The edge length of the cells used by `--merge-static`.
+		const float32 DEFAULT_CELL_SIZE = 64;
+
+		/// Merge the static geometry instances below each root node within `offsets`, i.e. those without a skeleton whose meshes are triangle lists without morph targets, into one mesh for each material, vertex type and cell of a grid in the space of the root, with their transforms relative to the root applied, as the root's own transform also applies to the merged meshes. Each instance is assigned to the cell containing the center of its bounds, so merged meshes may extend beyond their cell. Each merged mesh is stored as a `GeometryInstance` of a new child node of the root, which also references an `Array<MergedSource>` in order of triangles. Nodes keep their names and transforms, but no longer reference the merged instances. Instances which are reached by more than one path, or which would be alone in their mesh, are not merged.
+		/// @param cell_size the edge length of the cells, which may be infinite to merge every instance of a material together.
+		/// @returns the number of instances which were merged.
+		std::size_t merge_static_instances(Writer & writer, const std::vector<OffsetT> & offsets, float32 cell_size = DEFAULT_CELL_SIZE);
+
+		/// @returns the source of the triangle at the given index of a merged mesh, e.g. for picking, or nullptr if it is out of range.
+		const MergedSource * source_for_triangle(const Array<MergedSource> * sources, std::size_t triangle);
+	}
+}
@@ -98,6 +98,13 @@ namespace TaggedFormat {
 
 		float32 color[4];
 	};
+
+	/// For normal mapped triangle mesh. The tangent points in the direction of increasing u, and its fourth component is the sign of the bitangent, i.e. `bitangent = tangent[3] * cross(normal, tangent)`, which points in the direction of increasing v.
+	struct VertexP3N3M2T4 : public VertexP3N3M2 {
+		static const TagT TAG = tag_from_identifier("332T");
+
+		float32 tangent[4];
+	};
 }
 
 #endif
@@ -0,0 +1,197 @@
+//
+//  Morph.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Morph.hpp"
+#include "Geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace TaggedFormat
+{
+	namespace Morph
+	{
+		static const float32 QUANTIZED_MAXIMUM = 32767;
+
+		static void append_normal(const VertexP2 &, std::vector<float32> & normals) {
+			normals.insert(normals.end(), 3, 0);
+		}
+
+		static void append_normal(const VertexP3 &, std::vector<float32> & normals) {
+			normals.insert(normals.end(), 3, 0);
+		}
+
+		static void append_normal(const VertexP3N3 & vertex, std::vector<float32> & normals) {
+			normals.insert(normals.end(), vertex.normal, vertex.normal + 3);
+		}
+
+		void read_attributes(const Block * vertices, std::vector<float32> & positions, std::vector<float32> & normals) {
+			positions = read_positions(vertices);
+			normals.clear();
+
+			visit_vertices(const_cast<Block *>(vertices), [&](auto * array) {
+				normals.reserve(array->count() * 3);
+
+				for (auto & vertex : *array)
+					append_normal(vertex, normals);
+			});
+		}
+
+		static int16_t quantize(float32 value, float32 scale) {
+			return static_cast<int16_t>(std::lround(std::min(std::max(value / scale, -QUANTIZED_MAXIMUM), QUANTIZED_MAXIMUM)));
+		}
+
+		OffsetT append_target(Writer & writer, OffsetT mesh_offset, std::vector<Delta> deltas) {
+			std::stable_sort(deltas.begin(), deltas.end(), [](const Delta & a, const Delta & b) {
+				return a.index < b.index;
+			});
+
+			float32 position_maximum = 0, normal_maximum = 0;
+
+			for (auto & delta : deltas) {
+				for (std::size_t i = 0; i < 3; i += 1) {
+					position_maximum = std::max(position_maximum, std::abs(delta.position[i]));
+					normal_maximum = std::max(normal_maximum, std::abs(delta.normal[i]));
+				}
+			}
+
+			float32 position_scale = position_maximum > 0 ? position_maximum / QUANTIZED_MAXIMUM : 1;
+			float32 normal_scale = normal_maximum > 0 ? normal_maximum / QUANTIZED_MAXIMUM : 1;
+
+			auto target = writer.append<MorphTarget>(MorphTarget::array_size(deltas.size()));
+			target->mesh_offset = mesh_offset;
+			target->position_scale = position_scale;
+			target->normal_scale = normal_scale;
+
+			auto quantized = target->begin();
+
+			for (std::size_t i = 0; i < deltas.size(); i += 1) {
+				quantized[i].index = deltas[i].index;
+
+				for (std::size_t k = 0; k < 3; k += 1) {
+					quantized[i].position[k] = quantize(deltas[i].position[k], position_scale);
+					quantized[i].normal[k] = quantize(deltas[i].normal[k], normal_scale);
+				}
+			}
+
+			return target;
+		}
+
+		OffsetT build_target(Writer & writer, OffsetT mesh_offset, OffsetT target_vertices_offset, float32 threshold) {
+			OffsetT vertices_offset = writer.block_at_offset<Mesh>(mesh_offset)->vertices_offset;
+
+			if (!vertices_offset || !target_vertices_offset)
+				throw std::invalid_argument("Morph target requires vertices!");
+
+			auto base = writer.block_at_offset<Block>(vertices_offset);
+			auto target = writer.block_at_offset<Block>(target_vertices_offset);
+
+			if (base->tag != target->tag || vertex_count(*base) != vertex_count(*target) || !vertex_count(*base))
+				throw std::invalid_argument("Morph target vertices don't match the mesh!");
+
+			std::vector<float32> base_positions, base_normals, target_positions, target_normals;
+			read_attributes(*base, base_positions, base_normals);
+			read_attributes(*target, target_positions, target_normals);
+
+			std::vector<Delta> deltas;
+
+			for (std::size_t i = 0; i < base_positions.size() / 3; i += 1) {
+				Delta delta;
+				bool changed = false;
+
+				delta.index = i;
+
+				for (std::size_t k = 0; k < 3; k += 1) {
+					delta.position[k] = target_positions[i * 3 + k] - base_positions[i * 3 + k];
+					delta.normal[k] = target_normals[i * 3 + k] - base_normals[i * 3 + k];
+
+					if (std::abs(delta.position[k]) > threshold || std::abs(delta.normal[k]) > threshold)
+						changed = true;
+				}
+
+				if (changed) deltas.push_back(delta);
+			}
+
+			return append_target(writer, mesh_offset, std::move(deltas));
+		}
+
+		static void accumulate(const MorphTarget * target, float32 weight, std::size_t vertex_count, float32 * positions, float32 * normals) {
+			float32 position_factor = weight * target->position_scale, normal_factor = weight * target->normal_scale;
+
+#if defined(__SSE2__)
+			// The fourth lane would add to the next vertex, so it's always zero:
+			__m128 position_factors = _mm_set_ps(0, position_factor, position_factor, position_factor);
+			__m128 normal_factors = _mm_set_ps(0, normal_factor, normal_factor, normal_factor);
+#endif
+
+			for (auto & delta : *target) {
+				std::size_t index = delta.index;
+
+				if (index >= vertex_count)
+					throw std::invalid_argument("Morph delta references a vertex beyond the mesh!");
+
+				float32 * position = positions + index * 3, * normal = normals ? normals + index * 3 : nullptr;
+
+#if defined(__SSE2__)
+				// Writing four components would overrun the last vertex:
+				if (index + 1 < vertex_count) {
+					// The delta is 8 16-bit lanes: the index, then the position and normal deltas:
+					__m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&delta));
+
+					// Sign extend the position and normal deltas into 32-bit lanes:
+					__m128i position_lanes = _mm_srli_si128(packed, 4);
+					__m128 position_delta = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(position_lanes, position_lanes), 16));
+
+					_mm_storeu_ps(position, _mm_add_ps(_mm_loadu_ps(position), _mm_mul_ps(position_delta, position_factors)));
+
+					if (normal) {
+						__m128i normal_lanes = _mm_srli_si128(packed, 10);
+						__m128 normal_delta = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(normal_lanes, normal_lanes), 16));
+
+						_mm_storeu_ps(normal, _mm_add_ps(_mm_loadu_ps(normal), _mm_mul_ps(normal_delta, normal_factors)));
+					}
+
+					continue;
+				}
+#endif
+
+				for (std::size_t k = 0; k < 3; k += 1) {
+					position[k] += delta.position[k] * position_factor;
+
+					if (normal) normal[k] += delta.normal[k] * normal_factor;
+				}
+			}
+		}
+
+		void apply(const MorphTarget * const * targets, const float32 * weights, std::size_t target_count, std::size_t vertex_count, float32 * positions, float32 * normals) {
+			for (std::size_t i = 0; i < target_count; i += 1) {
+				if (!targets[i] || weights[i] == 0) continue;
+
+				accumulate(targets[i], weights[i], vertex_count, positions, normals);
+			}
+		}
+
+		std::vector<OffsetT> morphed_meshes(Writer & writer, const std::vector<OffsetT> & offsets) {
+			std::vector<OffsetT> meshes;
+
+			for (auto offset : offsets) {
+				auto block = writer.block_at_offset<Block>(offset);
+
+				if (block->tag == MorphTarget::TAG)
+					meshes.push_back(writer.block_at_offset<MorphTarget>(offset)->mesh_offset);
+			}
+
+			return meshes;
+		}
+	}
+}
@@ -0,0 +1,73 @@
+//
+//  Morph.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// The change to one vertex of a morph target, quantized relative to the scales of the target.
+	struct MorphDelta {
+		static const TagT TAG = tag_from_identifier("MDLT");
+
+		/// The index of the vertex in the base mesh.
+		uint32_t index;
+
+		int16_t position[3];
+		int16_t normal[3];
+	};
+
+	/// A blend shape, e.g. a facial expression, stored as the vertices of a base mesh which it moves, in order of index. Vertices which don't move take no space.
+	struct MorphTarget : public Array<MorphDelta, MorphTarget> {
+		static const TagT TAG = tag_from_identifier("MRPH");
+
+		/// The `Mesh` which the target applies to.
+		OffsetT mesh_offset;
+
+		/// The size of one unit of a quantized position or normal delta.
+		float32 position_scale;
+		float32 normal_scale;
+	};
+
+	/// Sparse blend shapes. Targets reference the vertices of their base mesh by index, so the pipeline doesn't reorder or split meshes which have morph targets.
+	namespace Morph
+	{
+		/// A delta before quantization.
+		struct Delta {
+			uint32_t index;
+			float32 position[3];
+			float32 normal[3];
+		};
+
+		/// The smallest change to a position or normal component which is stored by `build_target`.
+		const float32 DEFAULT_THRESHOLD = 1e-5f;
+
+		/// Quantize the deltas, which are sorted by index, and append them as a `MorphTarget` of the given mesh.
+		OffsetT append_target(Writer & writer, OffsetT mesh_offset, std::vector<Delta> deltas);
+
+		/// Build a sparse target from a complete copy of the vertices of a mesh, in the same order, e.g. as exported for each expression.
+		/// @returns the offset of the new `MorphTarget`.
+		/// @throws std::invalid_argument if the vertex arrays aren't compatible.
+		OffsetT build_target(Writer & writer, OffsetT mesh_offset, OffsetT target_vertices_offset, float32 threshold = DEFAULT_THRESHOLD);
+
+		/// Read the positions and normals of a vertex array as packed triples, the layout used by `apply`. Vertex types without normals have zero normals.
+		void read_attributes(const Block * vertices, std::vector<float32> & positions, std::vector<float32> & normals);
+
+		/// Add several weighted targets to positions and normals, which initially hold the base mesh. Targets with zero weight are skipped, and each delta is dequantized, scaled and accumulated with SIMD. Normals are not normalized.
+		/// @param normals packed normals, or nullptr to only update positions.
+		/// @throws std::invalid_argument if a delta references a vertex beyond `vertex_count`.
+		void apply(const MorphTarget * const * targets, const float32 * weights, std::size_t target_count, std::size_t vertex_count, float32 * positions, float32 * normals);
+
+		/// @returns the offsets of the meshes referenced by morph targets within `offsets`.
+		std::vector<OffsetT> morphed_meshes(Writer & writer, const std::vector<OffsetT> & offsets);
+	}
+}
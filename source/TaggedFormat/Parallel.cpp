@@ -0,0 +1,101 @@
+//
+//  Parallel.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Parallel.hpp"
+
+namespace TaggedFormat
+{
+	namespace Parallel
+	{
+		std::size_t concurrency() {
+			std::size_t count = std::thread::hardware_concurrency();
+
+			return count ? count : 1;
+		}
+
+		Pool::Pool(std::size_t size)
+		{
+			for (std::size_t i = 1; i < size; i += 1) {
+				_threads.emplace_back([this, i]() {
+					std::size_t generation = 0;
+					std::unique_lock<std::mutex> lock(_mutex);
+
+					while (true) {
+						_started.wait(lock, [&]() {return _stopping || _generation != generation;});
+
+						if (_stopping) return;
+
+						generation = _generation;
+
+						lock.unlock();
+						work(i);
+						lock.lock();
+
+						if (--_active == 0) _finished.notify_one();
+					}
+				});
+			}
+		}
+
+		Pool::~Pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stopping = true;
+			}
+
+			_started.notify_all();
+
+			for (auto & thread : _threads) thread.join();
+		}
+
+		void Pool::work(std::size_t thread)
+		{
+			while (true) {
+				std::size_t i = _next.fetch_add(1);
+				if (i >= _count) break;
+
+				try {
+					(*_callback)(i, thread);
+				} catch (...) {
+					std::lock_guard<std::mutex> lock(_mutex);
+					if (!_error) _error = std::current_exception();
+
+					// Stop handing out further work:
+					_next = _count;
+				}
+			}
+		}
+
+		void Pool::run(std::size_t count, const CallbackT & callback)
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+
+				_callback = &callback;
+				_count = count;
+				_next = 0;
+				_error = nullptr;
+
+				_active = _threads.size();
+				_generation += 1;
+			}
+
+			_started.notify_all();
+
+			work(0);
+
+			std::unique_lock<std::mutex> lock(_mutex);
+			_finished.wait(lock, [&]() {return _active == 0;});
+
+			_callback = nullptr;
+
+			if (_error) std::rethrow_exception(_error);
+		}
+	}
+}
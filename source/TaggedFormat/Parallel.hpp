@@ -0,0 +1,116 @@
+//
+//  Parallel.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// Simple data parallelism for conversion stages.
+	namespace Parallel
+	{
+		/// @returns the number of threads used by `each`, which is at least 1.
+		std::size_t concurrency();
+
+		/// Invoke the callback with every index in `[0, count)`, distributed across up to `concurrency()` threads. The callback must be safe to invoke concurrently for different indices. The first exception thrown by the callback is rethrown once all threads have finished.
+		template <typename CallbackT>
+		void each(std::size_t count, CallbackT && callback) {
+			std::size_t workers = std::min(concurrency(), count);
+
+			if (workers <= 1) {
+				for (std::size_t i = 0; i < count; i += 1) callback(i);
+
+				return;
+			}
+
+			std::atomic<std::size_t> next{0};
+			std::exception_ptr error;
+			std::mutex error_mutex;
+
+			auto work = [&]() {
+				while (true) {
+					std::size_t i = next.fetch_add(1);
+					if (i >= count) break;
+
+					try {
+						callback(i);
+					} catch (...) {
+						std::lock_guard<std::mutex> lock(error_mutex);
+						if (!error) error = std::current_exception();
+
+						// Stop handing out further work:
+						next = count;
+					}
+				}
+			};
+
+			std::vector<std::thread> threads;
+			for (std::size_t i = 1; i < workers; i += 1) threads.emplace_back(work);
+
+			work();
+
+			for (auto & thread : threads) thread.join();
+
+			if (error) std::rethrow_exception(error);
+		}
+
+		/// A fixed set of threads which are reused by every call to `each`, for work which is repeated many times per second, where starting threads for each call would cost more than the work itself.
+		class Pool {
+		public:
+			/// @param size the number of threads including the calling thread, which takes part in the work.
+			Pool(std::size_t size = concurrency());
+			~Pool();
+
+			Pool(const Pool &) = delete;
+			Pool & operator=(const Pool &) = delete;
+
+			std::size_t size() const {return _threads.size() + 1;}
+
+			/// Invoke the callback with every index in `[0, count)` and the index of the thread in `[0, size())`, which can be used to select per-thread storage. Otherwise the same as `Parallel::each`. Only one thread may call `each` at a time.
+			template <typename CallbackT>
+			void each(std::size_t count, CallbackT && callback) {
+				if (_threads.empty() || count <= 1) {
+					for (std::size_t i = 0; i < count; i += 1) callback(i, 0);
+
+					return;
+				}
+
+				run(count, callback);
+			}
+
+		private:
+			typedef std::function<void(std::size_t, std::size_t)> CallbackT;
+
+			std::vector<std::thread> _threads;
+
+			std::mutex _mutex;
+			std::condition_variable _started, _finished;
+
+			/// Incremented for each call to `each`, so that a thread only works once per call.
+			std::size_t _generation = 0;
+			std::size_t _active = 0;
+			bool _stopping = false;
+
+			const CallbackT * _callback = nullptr;
+			std::size_t _count = 0;
+			std::atomic<std::size_t> _next{0};
+			std::exception_ptr _error;
+
+			void run(std::size_t count, const CallbackT & callback);
+			void work(std::size_t thread);
+		};
+	}
+}
@@ -115,6 +115,13 @@ namespace TaggedFormat
 				return input;
 			}
 
+			std::istream & operator>>(std::istream & input, VertexP3N3M2T4 & vertex) {
+				input >> (VertexP3N3M2 &)vertex;
+				input >> vertex.tangent[0] >> vertex.tangent[1] >> vertex.tangent[2] >> vertex.tangent[3];
+				
+				return input;
+			}
+
 			std::istream & operator>>(std::istream & input, NamedAxis & axis) {
 				input >> axis.name;
 				input >> axis.translation[0] >> axis.translation[1] >> axis.translation[2];
@@ -150,6 +157,14 @@ namespace TaggedFormat
 				return input;
 			}
 
+			std::istream & operator>>(std::istream & input, Morph::Delta & delta) {
+				input >> delta.index;
+				input >> delta.position[0] >> delta.position[1] >> delta.position[2];
+				input >> delta.normal[0] >> delta.normal[1] >> delta.normal[2];
+
+				return input;
+			}
+
 			std::ostream & operator<<(std::ostream & output, const Index16 & index) {
 				output << index.value;
 
@@ -183,6 +198,13 @@ namespace TaggedFormat
 				return output;
 			}
 
+			std::ostream & operator<<(std::ostream & output, const VertexP3N3M2T4 & vertex) {
+				output << (VertexP3N3M2 &)vertex;
+				output << " T=(" << vertex.tangent[0] << ", " << vertex.tangent[1] << ", " << vertex.tangent[2] << ", " << vertex.tangent[3] << ")";
+				
+				return output;
+			}
+
 			std::ostream & operator<<(std::ostream & output, const VertexP3N3M2B4 & vertex) {
 				output << (VertexP3N3M2 &)vertex;
 
@@ -218,6 +240,14 @@ namespace TaggedFormat
 
 				return output;
 			}
+
+			std::ostream & operator<<(std::ostream & output, const Morph::Delta & delta) {
+				output << "I=" << delta.index;
+				output << " P=(" << delta.position[0] << ", " << delta.position[1] << ", " << delta.position[2] << ")";
+				output << " N=(" << delta.normal[0] << ", " << delta.normal[1] << ", " << delta.normal[2] << ")";
+
+				return output;
+			}
 		}
 
 //MARK: -
@@ -335,6 +365,21 @@ namespace TaggedFormat
 			return camera_block;
 		}
 		
+		OffsetT Context::parse_external() {
+			std::string url;
+			
+			_input >> url;
+			
+			// The URL is null terminated and padded so that the next block remains aligned:
+			std::size_t capacity = (url.size() + 1 + 3) & ~std::size_t(3);
+			auto external_block = _writer->append<External>(capacity);
+			
+			std::memset(external_block->url, 0, capacity);
+			std::memcpy(external_block->url, url.data(), url.size());
+			
+			return external_block;
+		}
+		
 		template <typename ElementT>
 		void parse_items(std::istream & input, std::vector<ElementT> & items) {
 			std::string symbol;
@@ -370,6 +415,24 @@ namespace TaggedFormat
 			}
 		}
 		
+		OffsetT Context::parse_morph_target() {
+			std::string mesh;
+			_input >> mesh;
+
+			if (mesh.empty() || mesh.front() != '$')
+				throw InvalidSequenceError(std::string("Morph target requires a mesh reference: ") + mesh);
+
+			OffsetT mesh_offset = lookup(std::string(mesh.begin() + 1, mesh.end()));
+
+			if (!mesh_offset)
+				throw InvalidSequenceError(std::string("Could not find mesh for morph target: ") + mesh);
+
+			std::vector<Morph::Delta> deltas;
+			parse_items(_input, deltas);
+
+			return Morph::append_target(*_writer, mesh_offset, std::move(deltas));
+		}
+
 		OffsetT Context::parse_offset_table() {
 			Context child(this);
 			child.parse();
@@ -419,6 +482,8 @@ namespace TaggedFormat
 				return parse_block<Array<VertexP3N3M2B4>>();
 			} else if (value_type == "vertex-p3n3m2c4") {
 				return parse_block<Array<VertexP3N3M2C4>>();
+			} else if (value_type == "vertex-p3n3m2t4") {
+				return parse_block<Array<VertexP3N3M2T4>>();
 			} else if (value_type == "axis") {
 				return parse_block<Axes>();
 			} else if (value_type == "skeleton-bone") {
@@ -471,12 +536,16 @@ namespace TaggedFormat
 					offset = parse_skeleton();
 				} else if (symbol == "skeleton-animation") {
 					offset = parse_animation();
+				} else if (symbol == "morph-target") {
+					offset = parse_morph_target();
 				} else if (symbol == "node") {
 					offset = parse_node();
 				} else if (symbol == "geometry-instance") {
 					offset = parse_geometry_instance();
 				} else if (symbol == "camera") {
 					offset = parse_camera();
+				} else if (symbol == "external") {
+					offset = parse_external();
 				} else {
 					throw InvalidSequenceError(std::string("Could not parse symbol: ") + symbol);
 				}
@@ -13,6 +13,8 @@
 #include "Axes.hpp"
 #include "Scene.hpp"
 #include "Camera.hpp"
+#include "External.hpp"
+#include "Morph.hpp"
 
 #include "Writer.hpp"
 
@@ -65,19 +67,23 @@ namespace TaggedFormat
 			std::istream & operator>>(std::istream & input, VertexP3N3M2 & vertex);
 			std::istream & operator>>(std::istream & input, VertexP3N3M2B4 & vertex);
 			std::istream & operator>>(std::istream & input, VertexP3N3M2C4 & vertex);
+			std::istream & operator>>(std::istream & input, VertexP3N3M2T4 & vertex);
 			std::istream & operator>>(std::istream & input, NamedAxis & axis);
 			std::istream & operator>>(std::istream & input, SkeletonBone & bone);
 			std::istream & operator>>(std::istream & input, SkeletonAnimationKeyFrame & frame);
+			std::istream & operator>>(std::istream & input, Morph::Delta & delta);
 
 			std::ostream & operator<<(std::ostream & output, const Index16 & index);
 			std::ostream & operator<<(std::ostream & output, const Index32 & index);
 			std::ostream & operator<<(std::ostream & output, const VertexP3N3 & vertex);
 			std::ostream & operator<<(std::ostream & output, const VertexP3N3M2 & vertex);
 			std::ostream & operator<<(std::ostream & output, const VertexP3N3M2C4 & vertex);
+			std::ostream & operator<<(std::ostream & output, const VertexP3N3M2T4 & vertex);
 			std::ostream & operator<<(std::ostream & output, const VertexP3N3M2B4 & vertex);
 			std::ostream & operator<<(std::ostream & output, const NamedAxis & axis);
 			std::ostream & operator<<(std::ostream & output, const SkeletonBone & bone);
 			std::ostream & operator<<(std::ostream & output, const SkeletonAnimationKeyFrame & frame);
+			std::ostream & operator<<(std::ostream & output, const Morph::Delta & delta);
 
 			template <typename ElementT>
 			std::ostream & operator<<(std::ostream & output, std::vector<ElementT> & items) {
@@ -127,9 +133,12 @@ namespace TaggedFormat
 			OffsetT parse_skeleton();
 			OffsetT parse_animation();
 
+			OffsetT parse_morph_target();
+
 			OffsetT parse_geometry_instance();
 			OffsetT parse_node();
 			OffsetT parse_camera();
+			OffsetT parse_external();
 
 			void parse();
 		};
@@ -0,0 +1,324 @@
+//
+//  Pipeline.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Pipeline.hpp"
+
+#include "AnimationCompression.hpp"
+#include "AnimationTracks.hpp"
+#include "BVH.hpp"
+#include "Bounds.hpp"
+#include "Clusters.hpp"
+#include "Codec.hpp"
+#include "Instancing.hpp"
+#include "Merging.hpp"
+#include "Morph.hpp"
+#include "Progressive.hpp"
+#include "SceneGraph.hpp"
+#include "Simplification.hpp"
+#include "SpatialIndex.hpp"
+#include "Streams.hpp"
+#include "Tangents.hpp"
+#include "Topology.hpp"
+#include "Traversal.hpp"
+#include "VertexCache.hpp"
+#include "Welding.hpp"
+
+#include <algorithm>
+#include <map>
+#include <ostream>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+namespace TaggedFormat
+{
+	static std::vector<OffsetT> offsets_with_tag(Writer & writer, const std::vector<OffsetT> & offsets, TagT tag) {
+		std::vector<OffsetT> matching;
+
+		for (auto offset : offsets) {
+			if (writer.block_at_offset<Block>(offset)->tag == tag)
+				matching.push_back(offset);
+		}
+
+		return matching;
+	}
+
+	// Stages which modify arrays in place must skip meshes which share them:
+	static bool is_shared(Writer & writer, const std::vector<OffsetT> & mesh_offsets, OffsetT mesh_offset) {
+		auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+
+		for (auto other_offset : mesh_offsets) {
+			if (other_offset == mesh_offset) continue;
+
+			auto other = writer.block_at_offset<Mesh>(other_offset);
+
+			if ((mesh->indices_offset && mesh->indices_offset == other->indices_offset) || (mesh->vertices_offset && mesh->vertices_offset == other->vertices_offset))
+				return true;
+		}
+
+		return false;
+	}
+
+	// Replace every reference to one block with another:
+	static void retarget(Writer & writer, const std::vector<OffsetT> & offsets, OffsetT from, OffsetT to) {
+		auto replace = [&](OffsetT & offset) {
+			if (offset == from) offset = to;
+		};
+
+		each_offset(*writer.header(), replace);
+
+		for (auto offset : offsets) {
+			each_offset(*writer.block_at_offset<Block>(offset), replace);
+		}
+	}
+
+	// @returns the meshes which replace the given mesh, if it was split:
+	static std::vector<OffsetT> split_mesh(Writer & writer, const std::vector<OffsetT> & offsets, OffsetT mesh_offset) {
+		OffsetT table_offset = Topology::split_mesh(writer, mesh_offset);
+
+		if (!table_offset) return {mesh_offset};
+
+		retarget(writer, offsets, mesh_offset, table_offset);
+
+		std::vector<OffsetT> parts;
+		for (auto & entry : **writer.block_at_offset<OffsetTable>(table_offset)) {
+			parts.push_back(entry.offset);
+		}
+
+		return parts;
+	}
+
+	static void optimize_mesh(Writer & writer, OffsetT mesh_offset, std::ostream * log) {
+		auto report = VertexCache::optimize_mesh(writer, mesh_offset);
+
+		if (log && report.before.acmr) {
+			*log << "Mesh at offset " << mesh_offset << ": ";
+			*log << "ACMR " << report.before.acmr << " -> " << report.after.acmr << ", ";
+			*log << "ATVR " << report.before.atvr << " -> " << report.after.atvr << std::endl;
+		}
+	}
+
+	static void weld_mesh(Writer & writer, OffsetT mesh_offset, float32 tolerance, std::ostream * log) {
+		auto removed = Welding::weld_mesh(writer, mesh_offset, tolerance);
+
+		if (log && removed) {
+			*log << "Mesh at offset " << mesh_offset << ": ";
+			*log << "welded " << removed << " duplicate vertices" << std::endl;
+		}
+	}
+
+	// Arrays shared between meshes are only converted once:
+	typedef std::map<OffsetT, OffsetT> ConvertedOffsetsT;
+
+	static void deinterleave_mesh(Writer & writer, OffsetT mesh_offset, ConvertedOffsetsT & converted) {
+		auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+
+		if (mesh->vertices_offset) {
+			if (!converted.count(mesh->vertices_offset))
+				converted[mesh->vertices_offset] = Streams::deinterleave(writer, mesh->vertices_offset);
+
+			if (auto vertices_offset = converted[mesh->vertices_offset])
+				mesh->vertices_offset = vertices_offset;
+		}
+	}
+
+	static void pack_levels(Writer & writer, OffsetT levels_offset, ConvertedOffsetsT & packed) {
+		auto levels = writer.block_at_offset<Array<MeshLevel>>(levels_offset);
+
+		for (std::size_t i = 0; i < levels->count(); i += 1) {
+			OffsetT indices_offset = levels->begin()[i].indices_offset;
+
+			if (!packed.count(indices_offset))
+				packed[indices_offset] = Codec::pack_indices(writer, indices_offset, Mesh::Layout::TRIANGLES);
+
+			if (auto packed_offset = packed[indices_offset])
+				levels->begin()[i].indices_offset = packed_offset;
+		}
+	}
+
+	static void pack_progressive_levels(Writer & writer, OffsetT mesh_offset, OffsetT levels_offset, ConvertedOffsetsT & packed) {
+		auto levels = writer.block_at_offset<Array<ProgressiveLevel>>(levels_offset);
+
+		for (std::size_t i = 0; i < levels->count(); i += 1) {
+			OffsetT indices_offset = levels->begin()[i].indices_offset;
+			OffsetT vertices_offset = levels->begin()[i].vertices_offset;
+
+			// The finest level uses the indices of the mesh, which have already been packed with the layout of the mesh:
+			if (!packed.count(indices_offset))
+				packed[indices_offset] = Codec::pack_indices(writer, indices_offset, Mesh::Layout::TRIANGLES);
+
+			if (vertices_offset && !packed.count(vertices_offset))
+				packed[vertices_offset] = Codec::pack_vertices(writer, vertices_offset);
+
+			if (auto packed_offset = packed[indices_offset])
+				levels->begin()[i].indices_offset = packed_offset;
+
+			if (vertices_offset)
+				if (auto packed_offset = packed[vertices_offset])
+					levels->begin()[i].vertices_offset = packed_offset;
+		}
+
+		auto chunks = writer.block_at_offset<VertexChunks>(writer.block_at_offset<Mesh>(mesh_offset)->vertices_offset);
+
+		for (auto & reference : **chunks) {
+			if (auto packed_offset = packed[reference.offset])
+				reference.offset = packed_offset;
+		}
+	}
+
+	static void pack_mesh(Writer & writer, OffsetT mesh_offset, ConvertedOffsetsT & packed) {
+		auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+
+		if (mesh->indices_offset) {
+			if (!packed.count(mesh->indices_offset))
+				packed[mesh->indices_offset] = Codec::pack_indices(writer, mesh->indices_offset, mesh->layout);
+
+			if (auto indices_offset = packed[mesh->indices_offset])
+				mesh->indices_offset = indices_offset;
+		}
+
+		if (mesh->vertices_offset) {
+			if (!packed.count(mesh->vertices_offset))
+				packed[mesh->vertices_offset] = Codec::pack_vertices(writer, mesh->vertices_offset);
+
+			if (auto vertices_offset = packed[mesh->vertices_offset])
+				mesh->vertices_offset = vertices_offset;
+		}
+	}
+
+	bool Pipeline::empty() const {
+		return !(merge_cell_size || weld_tolerance || split_meshes || optimize_vertex_cache || generate_tangents || level_count || convert_layout || narrow_indices || compute_bounds || build_clusters || build_bvh || build_scene_index || batch_instances || flatten_scenes || progressive || sample_rate || animation_tolerance || vertex_streams || pack_meshes || checksums);
+	}
+
+	void Pipeline::apply(const Buffer & input, ResizableBuffer & output) const {
+		Buffers::DynamicBuffer buffer;
+
+		buffer.expand(input.size());
+		std::memcpy(buffer.begin(), input.begin(), input.size());
+
+		Writer writer(buffer);
+		auto offsets = reachable_offsets(buffer);
+
+		// Meshes which were merged are no longer reachable, and the merged meshes are new:
+		if (merge_cell_size) {
+			Merging::merge_static_instances(writer, offsets, merge_cell_size);
+			offsets = reachable_offsets(buffer);
+		}
+
+		auto mesh_offsets = offsets_with_tag(writer, offsets, Mesh::TAG);
+
+		std::vector<OffsetT> part_offsets, progressive_offsets;
+		std::map<OffsetT, OffsetT> levels_offsets, progressive_levels_offsets;
+
+		auto morphed_offsets = Morph::morphed_meshes(writer, offsets);
+
+		for (auto mesh_offset : mesh_offsets) {
+			// Morph targets reference vertices by index, so their meshes are treated like shared meshes and are never split:
+			bool morphed = std::find(morphed_offsets.begin(), morphed_offsets.end(), mesh_offset) != morphed_offsets.end();
+			bool shared_arrays = is_shared(writer, mesh_offsets, mesh_offset);
+			bool shared = morphed || shared_arrays;
+			std::vector<OffsetT> parts{mesh_offset};
+
+			// Welding may bring meshes back within the limit of `Index16`, so it happens before splitting:
+			if (weld_tolerance && !shared)
+				weld_mesh(writer, mesh_offset, weld_tolerance, log);
+
+			if (split_meshes && !morphed)
+				parts = split_mesh(writer, offsets, mesh_offset);
+
+			// Split meshes have their own arrays:
+			if (parts.size() > 1) shared = shared_arrays = false;
+
+			for (auto part_offset : parts) {
+				if (optimize_vertex_cache && !shared)
+					optimize_mesh(writer, part_offset, log);
+
+				// Tangents keep the order of vertices, so meshes with morph targets have them too:
+				if (generate_tangents && !shared_arrays)
+					Tangents::generate_mesh_tangents(writer, part_offset);
+
+				// Levels share the vertex array, so they are generated after vertices are reordered:
+				if (level_count || progressive)
+					levels_offsets[part_offset] = Simplification::generate_mesh_levels(writer, part_offset, level_count ? level_count : Simplification::DEFAULT_LEVEL_COUNT);
+
+				// Progressive meshes reorder their vertices again once every other stage has used them:
+				if (progressive && !shared)
+					progressive_offsets.push_back(part_offset);
+
+				if (convert_layout)
+					Topology::convert_layout(writer, part_offset);
+
+				if (narrow_indices)
+					Topology::narrow_indices(writer, part_offset);
+
+				if (compute_bounds)
+					BoundingVolumes::compute_mesh_bounds(writer, part_offset);
+
+				if (build_bvh)
+					BVH::build_mesh_bvh(writer, part_offset);
+
+				part_offsets.push_back(part_offset);
+			}
+		}
+
+		// Batches are bounded and indexed in place of the nodes they replace, which would otherwise be kept by the scene index:
+		if (batch_instances) {
+			Instancing::batch_instances(writer, offsets);
+			offsets = reachable_offsets(buffer);
+		}
+
+		if (compute_bounds)
+			BoundingVolumes::compute_node_bounds(writer, offsets);
+
+		// Nodes may have been replaced by the previous stage, so the blocks are collected again:
+		if (build_scene_index)
+			SpatialIndex::build_scene_indices(writer, reachable_offsets(buffer));
+
+		// Batched instances are not nodes, so they are not flattened:
+		if (flatten_scenes)
+			SceneGraph::flatten_scenes(writer, reachable_offsets(buffer));
+
+		// Meshes are partitioned together so that the work can be done in parallel:
+		if (build_clusters)
+			Clusters::partition_meshes(writer, part_offsets);
+
+		for (auto part_offset : progressive_offsets)
+			progressive_levels_offsets[part_offset] = Progressive::build_mesh_levels(writer, part_offset);
+
+		auto animation_offsets = offsets_with_tag(writer, offsets, SkeletonAnimation::TAG);
+
+		// Animations are resampled from the original key frames, before they are compressed:
+		if (sample_rate)
+			AnimationTracks::resample_animations(writer, offsets, sample_rate, sample_layout);
+
+		if (animation_tolerance)
+			AnimationCompression::compress_animations(writer, animation_offsets, animation_tolerance);
+
+		ConvertedOffsetsT streams, packed;
+
+		for (auto part_offset : part_offsets) {
+			if (vertex_streams)
+				deinterleave_mesh(writer, part_offset, streams);
+
+			// Packing must come last as other stages operate on the decoded arrays:
+			if (pack_meshes) {
+				pack_mesh(writer, part_offset, packed);
+
+				if (OffsetT levels_offset = levels_offsets[part_offset])
+					pack_levels(writer, levels_offset, packed);
+
+				if (OffsetT levels_offset = progressive_levels_offsets[part_offset])
+					pack_progressive_levels(writer, part_offset, levels_offset, packed);
+			}
+		}
+
+		if (progressive)
+			compact(buffer, output, Progressive::streaming_order(buffer), checksums);
+		else
+			compact(buffer, output, checksums);
+	}
+}
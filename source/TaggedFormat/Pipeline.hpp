@@ -0,0 +1,95 @@
+//
+//  Pipeline.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "AnimationTracks.hpp"
+#include "Writer.hpp"
+
+#include <iosfwd>
+
+namespace TaggedFormat
+{
+	using Buffers::Buffer;
+
+	/// Optional conversion stages applied to the binary output of the parser. Stages append new blocks and update offsets, and the result is compacted to remove any blocks which were replaced.
+	class Pipeline {
+	public:
+		/// If non-zero, merge static geometry instances with the same material into one mesh for each cell of a grid with this edge length, with their transforms applied. Merged meshes are then processed by every other stage.
+		float32 merge_cell_size = 0;
+
+		/// If non-zero, merge vertices of indexed meshes whose components are all within this tolerance of each other, and remap their indices. Shared and morphed meshes are not welded.
+		float32 weld_tolerance = 0;
+
+		/// Split triangle meshes with more vertices than `Index16` can address into sub-meshes grouped in an `OffsetTable`.
+		bool split_meshes = false;
+
+		/// Reorder triangles and vertices of triangle meshes for vertex cache reuse and fetch locality.
+		bool optimize_vertex_cache = false;
+
+		/// Replace `VertexP3N3M2` vertex arrays of triangle meshes with `VertexP3N3M2T4`, with tangents generated from their texture coordinates. Arrays shared between meshes are not converted.
+		bool generate_tangents = false;
+
+		/// Generate up to this many simplified levels of detail for each triangle mesh.
+		std::size_t level_count = 0;
+
+		/// Convert between triangle lists and strips, whichever needs fewer indices.
+		bool convert_layout = false;
+
+		/// Use `Index16` rather than `Index32` when every index fits. The converter enables this unless given `--keep-index-width`.
+		bool narrow_indices = false;
+
+		/// Compute bounding boxes and spheres for meshes, and aggregate them for node hierarchies.
+		bool compute_bounds = false;
+
+		/// Partition triangle meshes into clusters with bounding spheres and normal cones for culling.
+		bool build_clusters = false;
+
+		/// Build a triangle bounding volume hierarchy for each mesh, for ray and proximity queries.
+		bool build_bvh = false;
+
+		/// Build a spatial index over the world space bounds of the geometry instances of each root node.
+		bool build_scene_index = false;
+
+		/// Replace child nodes which only contain the same geometry with an `InstanceBatch` of their transforms. Node bounds and scene indices are computed first, as they refer to the original instances.
+		bool batch_instances = false;
+
+		/// Flatten the node hierarchy below each root node into breadth first order, for updating world transforms with `SceneTransforms`.
+		bool flatten_scenes = false;
+
+		/// Reorder the vertices of triangle meshes so that each level of detail uses a prefix of the vertex array, and lay out the file so that the coarsest level of every mesh comes first and each finer level follows. Levels of detail are generated if `level_count` is 0.
+		bool progressive = false;
+
+		/// If non-zero, bake skeletal animations into a `ResampledAnimation` with this many frames per second, which keeps the key frames.
+		float32 sample_rate = 0;
+
+		/// The layout of the samples of resampled animations.
+		ResampledAnimation::Layout sample_layout = ResampledAnimation::Layout::FRAME_MAJOR;
+
+		/// If non-zero, replace the key frames of skeletal animations with a `CompressedAnimation`, removing keys which can be interpolated within this tolerance.
+		float32 animation_tolerance = 0;
+
+		/// Replace interleaved mesh vertex arrays with aligned per-attribute `VertexStreams`.
+		bool vertex_streams = false;
+
+		/// Replace mesh index and vertex arrays with packed arrays. Vertex streams are not packed.
+		bool pack_meshes = false;
+
+		/// Store a CRC32C checksum for every block, verified by the `Reader` when the block is first read.
+		bool checksums = false;
+
+		/// If set, stages report statistics about the changes they make.
+		std::ostream * log = nullptr;
+
+		/// @returns true if no stages are enabled.
+		bool empty() const;
+
+		/// Apply the enabled stages to the input, writing the result to the output.
+		void apply(const Buffer & input, ResizableBuffer & output) const;
+	};
+}
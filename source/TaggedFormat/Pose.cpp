@@ -0,0 +1,282 @@
+//
+//  Pose.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Pose.hpp"
+#include "Geometry.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace TaggedFormat
+{
+	// The inverse of a matrix without projection:
+	static void invert_affine(const float32 m[16], float32 result[16]) {
+		float32 determinant =
+			m[0] * (m[5] * m[10] - m[9] * m[6]) -
+			m[4] * (m[1] * m[10] - m[9] * m[2]) +
+			m[8] * (m[1] * m[6] - m[5] * m[2]);
+
+		float32 inverse = determinant != 0 ? 1 / determinant : 0;
+
+		result[0] = (m[5] * m[10] - m[9] * m[6]) * inverse;
+		result[1] = (m[9] * m[2] - m[1] * m[10]) * inverse;
+		result[2] = (m[1] * m[6] - m[5] * m[2]) * inverse;
+		result[3] = 0;
+
+		result[4] = (m[8] * m[6] - m[4] * m[10]) * inverse;
+		result[5] = (m[0] * m[10] - m[8] * m[2]) * inverse;
+		result[6] = (m[4] * m[2] - m[0] * m[6]) * inverse;
+		result[7] = 0;
+
+		result[8] = (m[4] * m[9] - m[8] * m[5]) * inverse;
+		result[9] = (m[8] * m[1] - m[0] * m[9]) * inverse;
+		result[10] = (m[0] * m[5] - m[4] * m[1]) * inverse;
+		result[11] = 0;
+
+		for (std::size_t row = 0; row < 3; row += 1)
+			result[12 + row] = -(result[row] * m[12] + result[4 + row] * m[13] + result[8 + row] * m[14]);
+
+		result[15] = 1;
+	}
+
+	// One element of a matrix for each of the instances in a group:
+#if defined(__SSE__)
+	typedef __m128 LaneT;
+
+	static inline LaneT lane_load(const float32 * values) {return _mm_loadu_ps(values);}
+	static inline void lane_store(float32 * values, LaneT lane) {_mm_storeu_ps(values, lane);}
+	static inline LaneT lane_set(float32 value) {return _mm_set1_ps(value);}
+	static inline LaneT lane_add(LaneT a, LaneT b) {return _mm_add_ps(a, b);}
+	static inline LaneT lane_multiply(LaneT a, LaneT b) {return _mm_mul_ps(a, b);}
+#else
+	struct LaneT {float32 values[4];};
+
+	static inline LaneT lane_load(const float32 * values) {return {{values[0], values[1], values[2], values[3]}};}
+	static inline void lane_store(float32 * values, LaneT lane) {std::copy(lane.values, lane.values + 4, values);}
+	static inline LaneT lane_set(float32 value) {return {{value, value, value, value}};}
+	static inline LaneT lane_add(LaneT a, LaneT b) {return {{a.values[0] + b.values[0], a.values[1] + b.values[1], a.values[2] + b.values[2], a.values[3] + b.values[3]}};}
+	static inline LaneT lane_multiply(LaneT a, LaneT b) {return {{a.values[0] * b.values[0], a.values[1] * b.values[1], a.values[2] * b.values[2], a.values[3] * b.values[3]}};}
+#endif
+
+	// Multiply matrices stored as 16 lanes of 4 values, where the elements of the second matrix are given by a function, so that it may instead be the same for every lane:
+	template <typename ElementT>
+	static inline void multiply_lanes(const float32 * a, ElementT && b, float32 * result) {
+		for (std::size_t column = 0; column < 4; column += 1) {
+			for (std::size_t row = 0; row < 4; row += 1) {
+				LaneT sum = lane_multiply(lane_load(a + row * 4), b(column * 4));
+
+				for (std::size_t k = 1; k < 4; k += 1)
+					sum = lane_add(sum, lane_multiply(lane_load(a + (k * 4 + row) * 4), b(column * 4 + k)));
+
+				lane_store(result + (column * 4 + row) * 4, sum);
+			}
+		}
+	}
+
+	PoseBatch::PoseBatch(std::size_t concurrency) : _pool(concurrency)
+	{
+		_scratch.resize(_pool.size());
+	}
+
+	std::size_t PoseBatch::add_skeleton(const Array<SkeletonBone> * bones)
+	{
+		SkeletonData skeleton;
+		std::size_t count = bones ? bones->count() : 0;
+
+		skeleton.parents.resize(count);
+
+		for (std::size_t i = 0; i < count; i += 1) {
+			skeleton.parents[i] = bones->at(i).parent;
+
+			if (skeleton.parents[i] >= count)
+				throw std::invalid_argument("Bone parent is out of range!");
+		}
+
+		// Each bone is added after its parent:
+		std::vector<bool> visited(count, false), visiting(count, false);
+
+		for (std::size_t i = 0; i < count; i += 1) {
+			std::vector<uint32_t> path;
+
+			for (uint32_t bone = i; !visited[bone]; bone = skeleton.parents[bone]) {
+				if (visiting[bone])
+					throw std::invalid_argument("Bone hierarchy contains a cycle!");
+
+				visiting[bone] = true;
+				path.push_back(bone);
+
+				if (skeleton.parents[bone] == bone) break;
+			}
+
+			for (auto bone = path.rbegin(); bone != path.rend(); ++bone) {
+				visited[*bone] = true;
+				skeleton.order.push_back(*bone);
+			}
+		}
+
+		std::vector<float32> bind_matrices(count * 16);
+		skeleton.inverse_bind_matrices.resize(count * 16);
+
+		for (auto bone : skeleton.order) {
+			float32 * bind = bind_matrices.data() + bone * 16;
+			uint32_t parent = skeleton.parents[bone];
+
+			if (parent == bone)
+				std::copy(bones->at(bone).transform, bones->at(bone).transform + 16, bind);
+			else
+				multiply_matrices(bind_matrices.data() + parent * 16, bones->at(bone).transform, bind);
+
+			invert_affine(bind, skeleton.inverse_bind_matrices.data() + bone * 16);
+		}
+
+		_skeletons.push_back(std::move(skeleton));
+
+		if (count > _maximum_bone_count) {
+			_maximum_bone_count = count;
+
+			for (auto & scratch : _scratch) {
+				scratch.pose.resize(count * LANES);
+				scratch.local.resize(count * 16 * LANES);
+				scratch.world.resize(count * 16 * LANES);
+			}
+		}
+
+		return _skeletons.size() - 1;
+	}
+
+	std::size_t PoseBatch::add_instance(std::size_t skeleton, const AnimationSampler * sampler, float32 time)
+	{
+		if (sampler->bone_count() != _skeletons.at(skeleton).parents.size())
+			throw std::invalid_argument("Sampler does not match the skeleton!");
+
+		InstanceData instance;
+		instance.skeleton = skeleton;
+		instance.sampler = sampler;
+		instance.cursors = sampler->cursors();
+		instance.time = time;
+		instance.palette_offset = _palettes.size();
+
+		_palettes.resize(_palettes.size() + sampler->bone_count() * 16);
+		_instances.push_back(std::move(instance));
+
+		_grouped = false;
+
+		return _instances.size() - 1;
+	}
+
+	void PoseBatch::set_sampler(std::size_t instance, const AnimationSampler * sampler)
+	{
+		auto & data = _instances[instance];
+
+		if (sampler->bone_count() != _skeletons[data.skeleton].parents.size())
+			throw std::invalid_argument("Sampler does not match the skeleton!");
+
+		data.sampler = sampler;
+		data.cursors.assign(sampler->bone_count(), 0);
+		data.time = sampler->start_time();
+	}
+
+	void PoseBatch::group()
+	{
+		std::vector<std::size_t> ordered(_instances.size());
+
+		for (std::size_t i = 0; i < ordered.size(); i += 1) ordered[i] = i;
+
+		std::stable_sort(ordered.begin(), ordered.end(), [&](std::size_t a, std::size_t b) {
+			return _instances[a].skeleton < _instances[b].skeleton;
+		});
+
+		_groups.clear();
+
+		for (auto instance : ordered) {
+			std::size_t skeleton = _instances[instance].skeleton;
+
+			if (_groups.empty() || _groups.back().skeleton != skeleton || _groups.back().count == LANES)
+				_groups.push_back({skeleton, 0, {}});
+
+			auto & group = _groups.back();
+			group.instances[group.count++] = instance;
+		}
+
+		_grouped = true;
+	}
+
+	void PoseBatch::evaluate_group(const Group & group, Scratch & scratch)
+	{
+		const SkeletonData & skeleton = _skeletons[group.skeleton];
+		std::size_t bone_count = skeleton.parents.size();
+
+		Transform * poses = scratch.pose.data();
+
+		for (std::size_t lane = 0; lane < group.count; lane += 1) {
+			auto & instance = _instances[group.instances[lane]];
+
+			instance.sampler->sample(instance.time, instance.cursors, poses + lane * bone_count);
+		}
+
+		// Unused lanes repeat the first instance:
+		for (std::size_t lane = group.count; lane < LANES; lane += 1)
+			std::copy(poses, poses + bone_count, poses + lane * bone_count);
+
+		float32 * local = scratch.local.data();
+		float32 * world = scratch.world.data();
+
+		for (std::size_t lane = 0; lane < LANES; lane += 1) {
+			for (std::size_t bone = 0; bone < bone_count; bone += 1) {
+				float32 matrix[16];
+				Animation::compose(poses[lane * bone_count + bone], matrix);
+
+				float32 * elements = local + bone * 16 * LANES;
+
+				for (std::size_t i = 0; i < 16; i += 1)
+					elements[i * LANES + lane] = matrix[i];
+			}
+		}
+
+		for (auto bone : skeleton.order) {
+			uint32_t parent = skeleton.parents[bone];
+			float32 * elements = world + bone * 16 * LANES;
+
+			if (parent == bone) {
+				std::copy(local + bone * 16 * LANES, local + (bone + 1) * 16 * LANES, elements);
+			} else {
+				const float32 * b = local + bone * 16 * LANES;
+
+				multiply_lanes(world + parent * 16 * LANES, [&](std::size_t i) {return lane_load(b + i * LANES);}, elements);
+			}
+		}
+
+		// The skinning matrix is the world transform of the inverse bind pose, which is the same for every lane:
+		for (std::size_t bone = 0; bone < bone_count; bone += 1) {
+			const float32 * inverse_bind = skeleton.inverse_bind_matrices.data() + bone * 16;
+			alignas(16) float32 skinning[16 * LANES];
+
+			multiply_lanes(world + bone * 16 * LANES, [&](std::size_t i) {return lane_set(inverse_bind[i]);}, skinning);
+
+			for (std::size_t lane = 0; lane < group.count; lane += 1) {
+				float32 * palette = _palettes.data() + _instances[group.instances[lane]].palette_offset + bone * 16;
+
+				for (std::size_t i = 0; i < 16; i += 1)
+					palette[i] = skinning[i * LANES + lane];
+			}
+		}
+	}
+
+	void PoseBatch::evaluate()
+	{
+		if (!_grouped) group();
+
+		_pool.each(_groups.size(), [&](std::size_t i, std::size_t thread) {
+			evaluate_group(_groups[i], _scratch[thread]);
+		});
+	}
+}
@@ -0,0 +1,104 @@
+//
+//  Pose.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Animation.hpp"
+#include "Parallel.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// Evaluates the poses of many instances of a few skeletons, e.g. a crowd of characters, producing a palette of skinning matrices for each instance. Instances of the same skeleton are evaluated four at a time, with each matrix stored as 16 vectors of one element from each instance, so that transforms are propagated through the hierarchy with one SIMD lane per instance. Groups of instances are distributed across a thread pool. Storage is allocated when skeletons and instances are added, and by the first `evaluate` after that, so evaluating each frame doesn't allocate.
+	class PoseBatch {
+	public:
+		/// @param concurrency the number of threads used by `evaluate`.
+		PoseBatch(std::size_t concurrency = Parallel::concurrency());
+
+		/// Add a skeleton. Bones whose parent is themselves are roots, and parents may come after their children.
+		/// @returns the index of the skeleton.
+		/// @throws std::invalid_argument if the parents of the bones form a cycle.
+		std::size_t add_skeleton(const Array<SkeletonBone> * bones);
+
+		/// Add an instance of a skeleton, playing the animation of the sampler, which must remain valid and was constructed with the bones of the same skeleton.
+		/// @returns the index of the instance.
+		/// @throws std::invalid_argument if the sampler has a different number of bones.
+		std::size_t add_instance(std::size_t skeleton, const AnimationSampler * sampler, float32 time = 0);
+
+		/// Play a different animation from the start of its key frames, i.e. the time of the instance becomes the start time of the sampler.
+		/// @throws std::invalid_argument if the sampler has a different number of bones.
+		void set_sampler(std::size_t instance, const AnimationSampler * sampler);
+
+		void set_time(std::size_t instance, float32 time) {_instances[instance].time = time;}
+		float32 time(std::size_t instance) const {return _instances[instance].time;}
+
+		std::size_t instance_count() const {return _instances.size();}
+		std::size_t bone_count(std::size_t instance) const {return _skeletons[_instances[instance].skeleton].parents.size();}
+
+		/// Sample the animation of every instance at its current time, and compute its skinning matrices.
+		void evaluate();
+
+		/// The column major skinning matrices of every instance, one per bone in order, each of which transforms from the bind pose to the animated pose. The palettes of all instances are contiguous, in the order the instances were added.
+		const float32 * palettes() const {return _palettes.data();}
+
+		/// The skinning matrices of one instance, with 16 values per bone.
+		const float32 * palette(std::size_t instance) const {return _palettes.data() + _instances[instance].palette_offset;}
+
+	private:
+		/// The number of instances evaluated together.
+		static const std::size_t LANES = 4;
+
+		struct SkeletonData {
+			/// The bones in an order where every parent precedes its children.
+			std::vector<uint32_t> order;
+
+			/// The parent of each bone, or the bone itself for roots.
+			std::vector<uint32_t> parents;
+
+			/// The inverse of the world transform of each bone in the bind pose.
+			std::vector<float32> inverse_bind_matrices;
+		};
+
+		struct InstanceData {
+			std::size_t skeleton;
+			const AnimationSampler * sampler;
+			AnimationSampler::Cursors cursors;
+			float32 time;
+			std::size_t palette_offset;
+		};
+
+		/// Up to `LANES` instances of the same skeleton.
+		struct Group {
+			std::size_t skeleton;
+			std::size_t count;
+			std::size_t instances[LANES];
+		};
+
+		/// The storage used by each thread for one group.
+		struct Scratch {
+			std::vector<Transform> pose;
+			std::vector<float32> local, world;
+		};
+
+		std::vector<SkeletonData> _skeletons;
+		std::vector<InstanceData> _instances;
+		std::vector<float32> _palettes;
+
+		std::vector<Group> _groups;
+		bool _grouped = true;
+
+		std::size_t _maximum_bone_count = 0;
+
+		Parallel::Pool _pool;
+		std::vector<Scratch> _scratch;
+
+		void group();
+		void evaluate_group(const Group & group, Scratch & scratch);
+	};
+}
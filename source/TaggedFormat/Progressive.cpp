@@ -0,0 +1,333 @@
+//
+//  Progressive.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Progressive.hpp"
+
+#include "Clusters.hpp"
+#include "Geometry.hpp"
+#include "Reader.hpp"
+#include "Simplification.hpp"
+#include "Table.hpp"
+#include "Traversal.hpp"
+#include "Update.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <set>
+
+namespace TaggedFormat
+{
+	namespace Progressive
+	{
+		static OffsetT metadata_entry(Writer & writer, OffsetT mesh_offset, const char * name) {
+			OffsetT metadata_offset = writer.block_at_offset<Mesh>(mesh_offset)->metadata_offset;
+
+			if (!metadata_offset || writer.block_at_offset<Block>(metadata_offset)->tag != OffsetTable::TAG)
+				return 0;
+
+			return writer.block_at_offset<OffsetTable>(metadata_offset)->offset_named(name);
+		}
+
+		OffsetT build_mesh_levels(Writer & writer, OffsetT mesh_offset) {
+			OffsetT indices_offset = writer.block_at_offset<Mesh>(mesh_offset)->indices_offset;
+			OffsetT vertices_offset = writer.block_at_offset<Mesh>(mesh_offset)->vertices_offset;
+
+			if (!indices_offset || !vertices_offset)
+				return 0;
+
+			TagT vertex_tag = writer.block_at_offset<Block>(vertices_offset)->tag;
+			std::size_t vertex_count = TaggedFormat::vertex_count(*writer.block_at_offset<Block>(vertices_offset));
+
+			if (!vertex_count)
+				return 0;
+
+			OffsetT lod_offset = metadata_entry(writer, mesh_offset, Simplification::METADATA_NAME);
+
+			if (!lod_offset || writer.block_at_offset<Block>(lod_offset)->tag != MeshLevel::TAG)
+				return 0;
+
+			// The simplified levels are stored finest first, and are followed by the mesh itself:
+			std::vector<ProgressiveLevel> levels;
+
+			auto lod = writer.block_at_offset<Array<MeshLevel>>(lod_offset);
+
+			for (std::size_t i = lod->count(); i-- > 0;)
+				levels.push_back({lod->begin()[i].indices_offset, 0, 0, lod->begin()[i].error});
+
+			if (levels.empty())
+				return 0;
+
+			levels.push_back({indices_offset, 0, 0, 0});
+
+			// Vertices are ordered by the first level which uses them:
+			const uint32_t UNUSED = 0xFFFFFFFF;
+			std::vector<uint32_t> remap(vertex_count, UNUSED), selection;
+			selection.reserve(vertex_count);
+
+			for (auto & level : levels) {
+				for (auto index : read_indices(*writer.block_at_offset<Block>(level.indices_offset))) {
+					if (index < vertex_count && remap[index] == UNUSED) {
+						remap[index] = selection.size();
+						selection.push_back(index);
+					}
+				}
+
+				level.vertex_count = selection.size();
+			}
+
+			// Unused vertices are kept, so that the vertex array is unchanged apart from its order:
+			for (std::size_t index = 0; index < vertex_count; index += 1) {
+				if (remap[index] == UNUSED) {
+					remap[index] = selection.size();
+					selection.push_back(index);
+				}
+			}
+
+			levels.back().vertex_count = selection.size();
+
+			std::set<OffsetT> updated;
+
+			auto update = [&](OffsetT offset) {
+				if (!offset || !updated.insert(offset).second) return;
+
+				auto block = writer.block_at_offset<Block>(offset);
+				auto indices = read_indices(*block);
+
+				if (indices.empty()) return;
+
+				for (auto & index : indices) {
+					if (index < vertex_count) index = remap[index];
+				}
+
+				write_indices(*block, indices);
+			};
+
+			for (auto & level : levels)
+				update(level.indices_offset);
+
+			OffsetT clusters_offset = metadata_entry(writer, mesh_offset, Clusters::METADATA_NAME);
+
+			if (clusters_offset && writer.block_at_offset<Block>(clusters_offset)->tag == MeshClusters::TAG)
+				update(writer.block_at_offset<MeshClusters>(clusters_offset)->vertices_offset);
+
+			// Each level appends the vertices it adds:
+			std::vector<OffsetT> chunk_offsets;
+			std::size_t first = 0;
+
+			for (auto & level : levels) {
+				if (level.vertex_count > first) {
+					std::vector<uint32_t> chunk(selection.begin() + first, selection.begin() + level.vertex_count);
+
+					level.vertices_offset = append_vertices(writer, vertices_offset, chunk);
+					chunk_offsets.push_back(level.vertices_offset);
+				}
+
+				first = level.vertex_count;
+			}
+
+			auto chunks = writer.append<VertexChunks>(VertexChunks::array_size(chunk_offsets.size()));
+			chunks->vertex_tag = vertex_tag;
+			chunks->vertex_count = selection.size();
+
+			for (std::size_t i = 0; i < chunk_offsets.size(); i += 1)
+				chunks->begin()[i].offset = chunk_offsets[i];
+
+			auto array = writer.append<Array<ProgressiveLevel>>(Array<ProgressiveLevel>::array_size(levels.size()));
+			std::copy(levels.begin(), levels.end(), array->begin());
+
+			OffsetT levels_offset = array;
+
+			writer.block_at_offset<Mesh>(mesh_offset)->vertices_offset = chunks;
+			set_mesh_metadata(writer, mesh_offset, METADATA_NAME, levels_offset);
+
+			return levels_offset;
+		}
+
+		static const Block * block_at(const Buffer & buffer, OffsetT offset) {
+			if (offset == 0 || offset + sizeof(Block) > buffer.size())
+				return nullptr;
+
+			auto block = reinterpret_cast<const Block *>(buffer + offset);
+
+			if (block->size < sizeof(Block) || offset + block->size > buffer.size())
+				return nullptr;
+
+			return block;
+		}
+
+		// @returns the levels of a progressive mesh, or nullptr:
+		static const Array<ProgressiveLevel> * mesh_levels(const Buffer & buffer, const Mesh * mesh) {
+			auto table = block_at(buffer, mesh->metadata_offset);
+
+			if (!table || table->tag != OffsetTable::TAG)
+				return nullptr;
+
+			auto levels = block_at(buffer, static_cast<const OffsetTable *>(table)->offset_named(METADATA_NAME));
+
+			if (!levels || levels->tag != ProgressiveLevel::TAG)
+				return nullptr;
+
+			return static_cast<const Array<ProgressiveLevel> *>(levels);
+		}
+
+		std::vector<OffsetT> streaming_order(const Buffer & buffer) {
+			auto offsets = reachable_offsets(buffer);
+
+			// The number of levels of each progressive mesh, and of its metadata table:
+			std::map<OffsetT, std::size_t> meshes, tables;
+
+			for (auto offset : offsets) {
+				auto block = block_at(buffer, offset);
+
+				if (block->tag != Mesh::TAG) continue;
+
+				auto mesh = static_cast<const Mesh *>(block);
+
+				if (auto levels = mesh_levels(buffer, mesh)) {
+					meshes[offset] = levels->count();
+					tables[mesh->metadata_offset] = levels->count();
+				}
+			}
+
+			if (meshes.empty())
+				return offsets;
+
+			// Each block is ranked by the coarsest level which requires it, where 0 is the structure of the file:
+			typedef std::pair<std::size_t, OffsetT> EntryT;
+			std::priority_queue<EntryT, std::vector<EntryT>, std::greater<EntryT>> queue;
+			std::map<OffsetT, std::size_t> ranks;
+
+			auto visit = [&](OffsetT offset, std::size_t rank) {
+				if (!offset) return;
+
+				auto existing = ranks.find(offset);
+
+				if (existing == ranks.end() || rank < existing->second) {
+					ranks[offset] = rank;
+					queue.push({rank, offset});
+				}
+			};
+
+			visit(Update::top_offset(buffer), 0);
+
+			while (!queue.empty()) {
+				auto entry = queue.top();
+				queue.pop();
+
+				std::size_t rank = entry.first;
+				OffsetT offset = entry.second;
+
+				auto block = block_at(buffer, offset);
+
+				if (!block || ranks[offset] != rank) continue;
+
+				auto mesh = meshes.find(offset);
+				auto table = tables.find(offset);
+
+				if (mesh != meshes.end()) {
+					auto finest = std::max(rank, mesh->second);
+					auto progressive_mesh = static_cast<const Mesh *>(block);
+
+					visit(progressive_mesh->indices_offset, finest);
+					visit(progressive_mesh->vertices_offset, finest);
+					visit(progressive_mesh->axes_offset, rank);
+					visit(progressive_mesh->metadata_offset, rank);
+				} else if (table != tables.end()) {
+					// Other metadata, e.g. a bounding volume hierarchy, is only needed with the finest level:
+					for (auto & named_offset : *static_cast<const OffsetTable *>(block))
+						visit(named_offset.offset, named_offset.match(METADATA_NAME) ? rank : std::max(rank, table->second));
+				} else if (block->tag == ProgressiveLevel::TAG) {
+					auto levels = static_cast<const Array<ProgressiveLevel> *>(block);
+
+					for (std::size_t i = 0; i < levels->count(); i += 1) {
+						visit(levels->begin()[i].indices_offset, std::max(rank, i + 1));
+						visit(levels->begin()[i].vertices_offset, std::max(rank, i + 1));
+					}
+				} else {
+					each_offset(block, [&](OffsetT child) {
+						visit(child, rank);
+					});
+				}
+			}
+
+			std::stable_sort(offsets.begin(), offsets.end(), [&](OffsetT a, OffsetT b) {
+				return ranks[a] < ranks[b];
+			});
+
+			return offsets;
+		}
+
+		std::size_t available_levels(Reader & reader, const Mesh * mesh, std::size_t available_size) {
+			auto contained = [&](OffsetT offset) {
+				if (offset + sizeof(Block) > available_size)
+					return false;
+
+				auto block = reader.block_at_offset(offset);
+
+				return block && offset + block->size <= available_size;
+			};
+
+			if (!mesh->metadata_offset || !contained(mesh->metadata_offset))
+				return 0;
+
+			OffsetT levels_offset = reader.metadata_offset(mesh, METADATA_NAME);
+
+			if (!levels_offset || !contained(levels_offset))
+				return 0;
+
+			auto levels = reader.block_at_offset<Array<ProgressiveLevel>>(levels_offset);
+
+			if (!levels)
+				return 0;
+
+			std::size_t count = 0;
+
+			for (auto & level : *levels) {
+				if (!contained(level.indices_offset)) break;
+				if (level.vertices_offset && !contained(level.vertices_offset)) break;
+
+				count += 1;
+			}
+
+			return count;
+		}
+
+		std::size_t concatenated_size(Reader & reader, const VertexChunks * chunks) {
+			std::size_t size = sizeof(Block);
+
+			for (auto & reference : *chunks) {
+				auto chunk = reader.unpacked_block_at_offset(reference.offset);
+
+				if (!chunk || chunk->tag != chunks->vertex_tag)
+					return 0;
+
+				size += chunk->size - sizeof(Block);
+			}
+
+			return size;
+		}
+
+		void concatenate(Reader & reader, const VertexChunks * chunks, Byte * output) {
+			auto block = reinterpret_cast<Block *>(output);
+			block->tag = chunks->vertex_tag;
+			block->size = concatenated_size(reader, chunks);
+
+			Byte * vertices = output + sizeof(Block);
+
+			for (auto & reference : *chunks) {
+				auto chunk = reader.unpacked_block_at_offset(reference.offset);
+				std::size_t size = chunk->size - sizeof(Block);
+
+				std::memcpy(vertices, reinterpret_cast<const Byte *>(chunk) + sizeof(Block), size);
+				vertices += size;
+			}
+		}
+	}
+}
@@ -0,0 +1,72 @@
+//
+//  Progressive.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	class Reader;
+
+	using Buffers::Buffer;
+
+	/// A level of a progressive mesh. Levels are stored in an `Array<ProgressiveLevel>` referenced by the `progressive` entry of the mesh metadata, ordered from coarsest to finest. Each level uses the first `vertex_count` vertices of the mesh, so a client can append the vertices of each level to those it already has.
+	struct ProgressiveLevel {
+		static const TagT TAG = tag_from_identifier("PRGL");
+
+		/// The indices of this level. The finest level uses the indices and layout of the mesh itself, and the other levels are triangle lists.
+		OffsetT indices_offset;
+
+		/// A vertex array with the vertices added by this level, or 0 if it adds none.
+		OffsetT vertices_offset;
+
+		/// The total number of vertices used by this level and all coarser levels.
+		uint32_t vertex_count;
+
+		/// The approximate geometric error of this level.
+		float32 error;
+	};
+
+	/// A vertex array stored as consecutive chunks, one per progressive level, which can be referenced by `Mesh::vertices_offset` in place of a single array. Contains references to `Array` blocks of the same vertex type.
+	struct VertexChunks : public Array<Reference, VertexChunks> {
+		static const TagT TAG = tag_from_identifier("VCHK");
+
+		/// The tag of the equivalent vertex array.
+		TagT vertex_tag;
+
+		/// The total number of vertices.
+		OffsetT vertex_count;
+	};
+
+	/// A streaming layout in which the start of a file contains a coarse version of every mesh, and later bytes refine it.
+	namespace Progressive
+	{
+		/// The name of the metadata entry which references the levels of a mesh.
+		const char * const METADATA_NAME = "progressive";
+
+		/// Reorder the vertices of a mesh with levels of detail so that each level uses a prefix of the vertex array, coarsest first, and split the vertex array into `VertexChunks`. Index arrays of the mesh, its levels and its clusters are updated in place, so they must not be shared with other meshes.
+		/// @returns the offset of the new `Array<ProgressiveLevel>`, or 0 if the mesh has no levels of detail or its vertices are not an interleaved vertex array.
+		OffsetT build_mesh_levels(Writer & writer, OffsetT mesh_offset);
+
+		/// @returns the reachable blocks in streaming order: the structure of the file and each mesh which isn't progressive, then the coarsest level of every progressive mesh, then each finer level, and finally any other blocks which belong to progressive meshes, e.g. bounding volume hierarchies.
+		std::vector<OffsetT> streaming_order(const Buffer & buffer);
+
+		/// @returns the number of levels of the mesh whose blocks are contained within the first `available_size` bytes of the file, e.g. while it is being downloaded. The best approximation available is the level before this.
+		std::size_t available_levels(Reader & reader, const Mesh * mesh, std::size_t available_size);
+
+		/// @returns the size of the equivalent single vertex array block, including the block header, or 0 if a chunk is missing.
+		std::size_t concatenated_size(Reader & reader, const VertexChunks * chunks);
+
+		/// Concatenate the chunks into a single vertex array block, which must have space for `concatenated_size()` bytes.
+		void concatenate(Reader & reader, const VertexChunks * chunks, Byte * output);
+	}
+}
@@ -7,10 +7,23 @@
 //
 
 #include "Reader.hpp"
+#include "Codec.hpp"
+#include "Progressive.hpp"
+#include "Resolver.hpp"
+#include "Simplification.hpp"
+#include "Streams.hpp"
+#include "Table.hpp"
+
+#include <algorithm>
 #include <string>
 
 namespace TaggedFormat {
 	
+	struct Reader::ExternalFile {
+		std::shared_ptr<const Buffer> buffer;
+		std::unique_ptr<Reader> reader;
+	};
+	
 	Reader::Reader(const Buffer & buffer) : _buffer(buffer)
 	{
 	}
@@ -21,13 +34,28 @@ namespace TaggedFormat {
 	const Header * Reader::header() {
 		if (!_header) {
 			_header = reinterpret_cast<const Header *>(_buffer.begin());
+			
+			if (_header->magic == 42) {
+				_generation = Update::latest_generation(_buffer);
+			}
+			
+			if (_generation) {
+				_generation_header = *_header;
+				_generation_header.top_offset = _generation->top_offset;
+			}
 		}
 
 		if (_header->magic != 42) {
 			return nullptr;
 		}
 
-		return _header;
+		return _generation ? &_generation_header : _header;
+	}
+	
+	const Generation * Reader::generation() {
+		header();
+		
+		return _generation;
 	}
 
 	bool Reader::flipped() {
@@ -45,6 +73,283 @@ namespace TaggedFormat {
 			return nullptr;
 		}
 		
+		if (!verify(offset)) {
+			return nullptr;
+		}
+		
 		return reinterpret_cast<const Block *>(_buffer + offset);
 	}
+	
+	std::vector<Reader::ChecksumDirectory> & Reader::checksums() {
+		if (_checksums_loaded) {
+			return _checksums;
+		}
+		
+		_checksums_loaded = true;
+		
+		OffsetT trailer_offset = Update::checksums_offset(_buffer);
+		
+		// Each generation has its own directory, chained to the previous one. Trailers must move towards the start of the file, so the chain ends:
+		while (trailer_offset && trailer_offset >= sizeof(Header) && trailer_offset + sizeof(ChecksumTrailer) <= _buffer.size()) {
+			auto trailer = reinterpret_cast<const ChecksumTrailer *>(_buffer + trailer_offset);
+			
+			if (trailer->tag != ChecksumTrailer::TAG || trailer->size != sizeof(ChecksumTrailer)) {
+				break;
+			}
+			
+			OffsetT offset = trailer->directory_offset;
+			
+			if (offset < sizeof(Header) || offset + sizeof(Block) > trailer_offset) {
+				break;
+			}
+			
+			auto directory = reinterpret_cast<const Array<BlockChecksum> *>(_buffer + offset);
+			
+			if (directory->tag != BlockChecksum::TAG || directory->size < sizeof(Block) || offset + directory->size > trailer_offset) {
+				break;
+			}
+			
+			// A corrupt directory can't be trusted, so every block is reported as corrupt:
+			if (directory->count()) _checksums.push_back({directory, std::vector<Verification>(directory->count(), Checksum::block_crc(directory) == trailer->directory_crc ? Verification::UNKNOWN : Verification::CORRUPT)});
+			
+			if (trailer->previous_offset >= offset) {
+				break;
+			}
+			
+			trailer_offset = trailer->previous_offset;
+		}
+		
+		std::reverse(_checksums.begin(), _checksums.end());
+		
+		return _checksums;
+	}
+	
+	std::size_t Reader::checksum_count() {
+		std::size_t count = 0;
+		
+		for (auto & directory : checksums()) {
+			count += directory.entries->count();
+		}
+		
+		return count;
+	}
+	
+	bool Reader::verify(OffsetT offset) {
+		auto & directories = checksums();
+		
+		// The directory of the generation which appended the block is the last one which starts at or before it:
+		auto directory = std::upper_bound(directories.begin(), directories.end(), offset, [](OffsetT offset, const ChecksumDirectory & directory) {
+			return offset < directory.entries->begin()->offset;
+		});
+		
+		if (directory == directories.begin()) {
+			return true;
+		}
+		
+		directory -= 1;
+		
+		auto entries = directory->entries;
+		auto entry = std::lower_bound(entries->begin(), entries->end(), offset, [](const BlockChecksum & checksum, OffsetT offset) {
+			return checksum.offset < offset;
+		});
+		
+		// Blocks without a checksum, e.g. the header, are not verified:
+		if (entry == entries->end() || entry->offset != offset) {
+			return true;
+		}
+		
+		auto & verified = directory->verified[entry - entries->begin()];
+		
+		if (verified == Verification::UNKNOWN) {
+			auto block = reinterpret_cast<const Block *>(_buffer + offset);
+			bool valid = offset + sizeof(Block) <= _buffer.size() && block->size >= sizeof(Block) && offset + block->size <= _buffer.size() && Checksum::block_crc(block) == entry->crc;
+			
+			verified = valid ? Verification::VALID : Verification::CORRUPT;
+		}
+		
+		return verified == Verification::VALID;
+	}
+	
+	std::vector<OffsetT> Reader::verify_all() {
+		std::vector<OffsetT> corrupt;
+		
+		for (auto & directory : checksums()) {
+			for (auto & entry : *directory.entries) {
+				if (!verify(entry.offset)) {
+					corrupt.push_back(entry.offset);
+				}
+			}
+		}
+		
+		return corrupt;
+	}
+	
+	const Block * Reader::unpacked_block_at_offset(OffsetT offset) {
+		const Block * block = block_at_offset(offset);
+		
+		if (!block || (block->tag != PackedArray::TAG && block->tag != VertexStreams::TAG && block->tag != VertexChunks::TAG)) {
+			return block;
+		}
+		
+		auto & unpacked = _unpacked[offset];
+
+		if (!unpacked) {
+			std::unique_ptr<Byte[]> output;
+
+			if (block->tag == PackedArray::TAG) {
+				auto packed = static_cast<const PackedArray *>(block);
+
+				// The header is checked before allocating, since the decoded size comes from the file:
+				try {
+					Codec::validate(packed);
+					output.reset(new Byte[packed->decoded_size()]);
+
+					Codec::unpack(packed, output.get());
+				} catch (Codec::DecodeError &) {
+					// Corrupt data is treated like a block with the wrong tag:
+					_unpacked.erase(offset);
+
+					return nullptr;
+				}
+			} else if (block->tag == VertexChunks::TAG) {
+				auto chunks = static_cast<const VertexChunks *>(block);
+				std::size_t size = Progressive::concatenated_size(*this, chunks);
+
+				// A chunk is missing, e.g. the file is incomplete:
+				if (!size) {
+					_unpacked.erase(offset);
+
+					return nullptr;
+				}
+
+				output.reset(new Byte[size]);
+
+				Progressive::concatenate(*this, chunks, output.get());
+			} else {
+				auto streams = static_cast<const VertexStreams *>(block);
+				std::size_t size = Streams::interleaved_size(*this, streams);
+
+				// A stream is missing or doesn't match the vertex count:
+				if (!size) {
+					_unpacked.erase(offset);
+
+					return nullptr;
+				}
+
+				output.reset(new Byte[size]);
+
+				Streams::interleave(*this, streams, output.get());
+			}
+
+			unpacked = std::move(output);
+		}
+
+		return reinterpret_cast<const Block *>(unpacked.get());
+	}
+	
+	void Reader::set_resolver(std::shared_ptr<Resolver> resolver) {
+		_resolver = resolver;
+	}
+	
+	Reader * Reader::resolve(const External * external, OffsetT & offset) {
+		if (!_resolver) {
+			return nullptr;
+		}
+		
+		std::string url = external->location();
+		auto separator = url.find('#');
+		
+		std::string location = url.substr(0, separator);
+		std::string fragment = (separator == std::string::npos) ? "" : url.substr(separator + 1);
+		
+		auto & file = _external_files[location];
+		
+		if (!file) {
+			auto buffer = _resolver->resolve(location);
+			
+			if (!buffer || buffer->size() < sizeof(Header)) {
+				_external_files.erase(location);
+				
+				return nullptr;
+			}
+			
+			file.reset(new ExternalFile);
+			file->buffer = buffer;
+			file->reader.reset(new Reader(*buffer));
+			file->reader->set_resolver(_resolver);
+		}
+		
+		Reader * reader = file->reader.get();
+		auto header = reader->header();
+		
+		if (!header) {
+			return nullptr;
+		}
+		
+		offset = fragment.empty() ? header->top_offset : reader->asset_offset(fragment);
+		
+		return offset ? reader : nullptr;
+	}
+	
+	Reader * Reader::resolve_offset(OffsetT & offset) {
+		Reader * reader = this;
+		
+		for (std::size_t depth = 0; depth <= MAX_EXTERNAL_DEPTH; depth += 1) {
+			auto external = reader->block_at_offset<External>(offset);
+			
+			if (!external) {
+				return reader;
+			}
+			
+			reader = reader->resolve(external, offset);
+			
+			if (!reader) {
+				return nullptr;
+			}
+		}
+		
+		return nullptr;
+	}
+	
+	OffsetT Reader::asset_offset(const std::string & name) {
+		auto header = this->header();
+		
+		if (!header) {
+			return 0;
+		}
+		
+		auto index = block_at_offset<OffsetTable>(header->top_offset);
+		
+		if (!index) {
+			return 0;
+		}
+		
+		return index->offset_named(name);
+	}
+	
+	OffsetT Reader::metadata_offset(const Mesh * mesh, const std::string & name) {
+		auto table = block_at_offset<OffsetTable>(mesh->metadata_offset);
+		
+		if (!table) {
+			return 0;
+		}
+		
+		return table->offset_named(name);
+	}
+	
+	OffsetT Reader::level_of_detail(const Mesh * mesh, float32 error_threshold) {
+		OffsetT indices_offset = mesh->indices_offset;
+		auto levels = array_at_offset<MeshLevel>(metadata_offset(mesh, Simplification::METADATA_NAME));
+		
+		if (levels) {
+			// Levels are ordered from finest to coarsest:
+			for (auto & level : *levels) {
+				if (level.error > error_threshold) break;
+				
+				indices_offset = level.indices_offset;
+			}
+		}
+		
+		return indices_offset;
+	}
 }
@@ -9,11 +9,21 @@
 #pragma once
 
 #include "Block.hpp"
+#include "Checksum.hpp"
+#include "External.hpp"
+#include "Mesh.hpp"
+#include "Update.hpp"
 
 #include <Buffers/Buffer.hpp>
 
+#include <map>
+#include <memory>
+#include <vector>
+
 namespace TaggedFormat {
 	using Buffers::Buffer;
+	
+	class Resolver;
 
 	/// Provides support for reading blocks from a given data buffer.
 	class Reader {
@@ -24,14 +34,29 @@ namespace TaggedFormat {
 		Reader(const Reader & other) = delete;
 		Reader & operator=(const Reader & other) = delete;
 		
+		/// @returns the header, or if the file has been updated, a copy of the header with the top offset of the latest generation.
 		const Header * header();
 		
+		/// @returns the latest generation, or nullptr if the file has never been updated.
+		const Generation * generation();
+		
 		/// If this returns true, all data is flipped (e.g. reversed).
 		/// This function is not implemented correctly and generally reverse byte order is not handled correctly yet.
 		bool flipped();
 
-		/// @returns a pointer to the block at a given offset.
+		/// @returns a pointer to the block at a given offset, or nullptr if the block fails verification.
 		const Block * block_at_offset(OffsetT offset);
+		
+		/// @returns the number of blocks with checksums in every generation, or 0 if the file has no checksum directory.
+		std::size_t checksum_count();
+		
+		/// Verify the checksum of the block at the given offset, if it has one. Each block is verified the first time it is read, and the result is cached.
+		/// @returns false if the block is corrupt.
+		bool verify(OffsetT offset);
+		
+		/// Verify every block which has a checksum.
+		/// @returns the offsets of the corrupt blocks.
+		std::vector<OffsetT> verify_all();
 
 		/// Read a given block of a specific type from a given offset. Provides basic sanity checking.
 		/// @returns nullptr in the event that the block is not the correct type.
@@ -40,22 +65,80 @@ namespace TaggedFormat {
 			const Block * block = block_at_offset(offset);
 			
 			// Basic error checking:
-			if (block->tag != BlockT::TAG) {
+			if (!block || block->tag != BlockT::TAG) {
 				return nullptr;
 			}
 			
 			return (const BlockT *)block;
 		}
 
-		/// Read a given array, similar to block_at_offset.
+		/// @returns a pointer to the block at a given offset. Packed arrays are decoded, vertex streams interleaved and vertex chunks concatenated on first access and the result is owned by the reader. Returns nullptr if the block can't be decoded.
+		const Block * unpacked_block_at_offset(OffsetT offset);
+
+		/// Read a given array, similar to block_at_offset. Packed arrays, vertex streams and vertex chunks are transparently converted.
 		template <typename ElementT>
 		const Array<ElementT> * array_at_offset(OffsetT offset) {
-			return block_at_offset<Array<ElementT>>(offset);
+			const Block * block = unpacked_block_at_offset(offset);
+			
+			if (!block || block->tag != Array<ElementT>::TAG) {
+				return nullptr;
+			}
+			
+			return (const Array<ElementT> *)block;
 		}
 		
+		/// External blocks which refer to further external blocks are followed up to this depth.
+		static const std::size_t MAX_EXTERNAL_DEPTH = 8;
+		
+		/// Set the resolver used to follow `External` blocks. It is also used by the readers of resolved files.
+		void set_resolver(std::shared_ptr<Resolver> resolver);
+		
+		/// Follow an `External` block to the asset named by the fragment of its URL, e.g. `shared.tfb#crate`, or to the top block of the file if there is no fragment. Each file is resolved once per reader, and the file and its reader are kept until this reader is destroyed.
+		/// @returns the reader of the file which contains the block and assigns its offset, or nullptr if it can't be resolved.
+		Reader * resolve(const External * external, OffsetT & offset);
+		
+		/// If the block at the given offset is an `External` block, follow it, and any external block it refers to.
+		/// @returns the reader of the file which contains the block and updates the offset, or nullptr if it can't be resolved.
+		Reader * resolve_offset(OffsetT & offset);
+		
+		/// @returns the top offset of the named asset in a bundle written by `BundleWriter`, or 0 if there is none.
+		OffsetT asset_offset(const std::string & name);
+		
+		/// @returns the offset of the named entry in the metadata table of the mesh, or 0 if there is none.
+		OffsetT metadata_offset(const Mesh * mesh, const std::string & name);
+
+		/// Select the coarsest level of detail of the mesh with an error no greater than the threshold, e.g. as computed by `Simplification::error_threshold`.
+		/// @returns the offset of the indices for that level, or the indices of the mesh itself if no level is suitable.
+		OffsetT level_of_detail(const Mesh * mesh, float32 error_threshold);
+		
 	protected:
 		const Buffer & _buffer;
 		const Header * _header = nullptr;
+		
+		const Generation * _generation = nullptr;
+		Header _generation_header;
+		
+		/// Decoded copies of packed arrays and vertex streams, keyed by offset.
+		std::map<OffsetT, std::unique_ptr<Byte[]>> _unpacked;
+		
+		enum class Verification : Byte {UNKNOWN, VALID, CORRUPT};
+		
+		struct ChecksumDirectory {
+			const Array<BlockChecksum> * entries;
+			std::vector<Verification> verified;
+		};
+		
+		/// The checksum directories of every generation, ordered by offset, located on first use.
+		std::vector<ChecksumDirectory> & checksums();
+		
+		bool _checksums_loaded = false;
+		std::vector<ChecksumDirectory> _checksums;
+		
+		std::shared_ptr<Resolver> _resolver;
+		
+		/// Resolved files, keyed by location.
+		struct ExternalFile;
+		std::map<std::string, std::unique_ptr<ExternalFile>> _external_files;
 	};
 
 };
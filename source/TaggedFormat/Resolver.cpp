@@ -0,0 +1,231 @@
+//
+//  Resolver.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Resolver.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TaggedFormat
+{
+	MappedFile::MappedFile(const std::string & path)
+	{
+		int descriptor = ::open(path.c_str(), O_RDONLY);
+
+		if (descriptor == -1)
+			throw std::system_error(errno, std::generic_category(), "open " + path);
+
+		struct stat status;
+
+		if (::fstat(descriptor, &status) == -1) {
+			int error = errno;
+			::close(descriptor);
+
+			throw std::system_error(error, std::generic_category(), "fstat " + path);
+		}
+
+		_size = static_cast<std::size_t>(status.st_size);
+
+		if (_size) {
+			void * data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+			if (data == MAP_FAILED) {
+				int error = errno;
+				::close(descriptor);
+
+				throw std::system_error(error, std::generic_category(), "mmap " + path);
+			}
+
+			_data = static_cast<const Byte *>(data);
+		}
+
+		// The mapping remains valid after the descriptor is closed:
+		::close(descriptor);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (_data)
+			::munmap(const_cast<Byte *>(_data), _size);
+	}
+
+	const Byte * MappedFile::begin() const
+	{
+		return _data;
+	}
+
+	std::size_t MappedFile::size() const
+	{
+		return _size;
+	}
+
+	MappedFileCache::MappedFileCache(std::size_t capacity) : _capacity(capacity)
+	{
+	}
+
+	std::shared_ptr<const Buffer> MappedFileCache::open(const std::string & path)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			auto existing = _index.find(path);
+
+			if (existing != _index.end()) {
+				_entries.splice(_entries.begin(), _entries, existing->second);
+
+				return existing->second->second;
+			}
+		}
+
+		// Map the file without holding the lock, as it may be slow:
+		std::shared_ptr<const Buffer> buffer;
+
+		try {
+			buffer = std::make_shared<MappedFile>(path);
+		} catch (std::system_error &) {
+			return nullptr;
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		// Another thread may have mapped the same file in the meantime:
+		auto existing = _index.find(path);
+
+		if (existing != _index.end()) {
+			_entries.splice(_entries.begin(), _entries, existing->second);
+
+			return existing->second->second;
+		}
+
+		if (_capacity == 0) return buffer;
+
+		_entries.emplace_front(path, buffer);
+		_index[path] = _entries.begin();
+
+		while (_entries.size() > _capacity) {
+			_index.erase(_entries.back().first);
+			_entries.pop_back();
+		}
+
+		return buffer;
+	}
+
+	std::size_t MappedFileCache::size()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		return _entries.size();
+	}
+
+	void MappedFileCache::clear()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_index.clear();
+		_entries.clear();
+	}
+
+	std::shared_ptr<MappedFileCache> MappedFileCache::shared()
+	{
+		static std::shared_ptr<MappedFileCache> cache = std::make_shared<MappedFileCache>();
+
+		return cache;
+	}
+
+	Resolver::~Resolver()
+	{
+	}
+
+	static bool has_prefix(const std::string & string, const std::string & prefix)
+	{
+		return string.compare(0, prefix.size(), prefix) == 0;
+	}
+
+	FileResolver::FileResolver(const std::string & root, std::shared_ptr<MappedFileCache> cache) : _root(root), _cache(cache)
+	{
+	}
+
+	std::shared_ptr<const Buffer> FileResolver::resolve(const std::string & location)
+	{
+		std::string path = location;
+
+		if (has_prefix(path, "file:"))
+			path = path.substr(5);
+		else if (path.find(':') != std::string::npos)
+			return nullptr;
+
+		if (path.empty() || path.front() == '/')
+			return nullptr;
+
+		// Reject any `..` component:
+		std::size_t start = 0;
+
+		while (start <= path.size()) {
+			std::size_t end = path.find('/', start);
+			if (end == std::string::npos) end = path.size();
+
+			if (path.compare(start, end - start, "..") == 0)
+				return nullptr;
+
+			start = end + 1;
+		}
+
+		if (_root.empty())
+			return _cache->open(path);
+		else
+			return _cache->open(_root + "/" + path);
+	}
+
+	ContentStoreResolver::ContentStoreResolver(const std::string & root, std::shared_ptr<MappedFileCache> cache) : _root(root), _cache(cache)
+	{
+	}
+
+	std::string ContentStoreResolver::path_for(const std::string & hash) const
+	{
+		if (hash.size() < 3) return "";
+
+		for (auto character : hash) {
+			if (!std::isxdigit(static_cast<unsigned char>(character)) || std::isupper(static_cast<unsigned char>(character)))
+				return "";
+		}
+
+		return _root + "/" + hash.substr(0, 2) + "/" + hash.substr(2);
+	}
+
+	std::shared_ptr<const Buffer> ContentStoreResolver::resolve(const std::string & location)
+	{
+		if (!has_prefix(location, "cas:")) return nullptr;
+
+		std::string path = path_for(location.substr(4));
+
+		if (path.empty()) return nullptr;
+
+		return _cache->open(path);
+	}
+
+	void CompositeResolver::add(std::shared_ptr<Resolver> resolver)
+	{
+		_resolvers.push_back(resolver);
+	}
+
+	std::shared_ptr<const Buffer> CompositeResolver::resolve(const std::string & location)
+	{
+		for (auto & resolver : _resolvers) {
+			if (auto buffer = resolver->resolve(location))
+				return buffer;
+		}
+
+		return nullptr;
+	}
+}
@@ -0,0 +1,119 @@
+//
+//  Resolver.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <Buffers/Buffer.hpp>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TaggedFormat
+{
+	using Buffers::Buffer;
+
+	/// A read only memory mapping of an entire file.
+	class MappedFile : public Buffer {
+	public:
+		/// @throws std::system_error if the file can't be opened or mapped.
+		MappedFile(const std::string & path);
+		virtual ~MappedFile();
+
+		MappedFile(const MappedFile & other) = delete;
+		MappedFile & operator=(const MappedFile & other) = delete;
+
+		virtual const Byte * begin() const;
+		virtual std::size_t size() const;
+
+	private:
+		const Byte * _data = nullptr;
+		std::size_t _size = 0;
+	};
+
+	/// A thread safe cache of the most recently used mapped files, which can be shared by many readers. A file evicted from the cache stays mapped until the last reader using it releases it.
+	class MappedFileCache {
+	public:
+		static const std::size_t DEFAULT_CAPACITY = 64;
+
+		MappedFileCache(std::size_t capacity = DEFAULT_CAPACITY);
+
+		/// @returns the mapped file at the given path, mapping it if it is not already cached, or nullptr if it can't be mapped.
+		std::shared_ptr<const Buffer> open(const std::string & path);
+
+		/// The number of files currently cached.
+		std::size_t size();
+
+		void clear();
+
+		/// The cache used by resolvers unless another is given.
+		static std::shared_ptr<MappedFileCache> shared();
+
+	private:
+		typedef std::pair<std::string, std::shared_ptr<const Buffer>> EntryT;
+
+		std::size_t _capacity;
+		std::mutex _mutex;
+
+		/// Ordered from most to least recently used.
+		std::list<EntryT> _entries;
+		std::map<std::string, std::list<EntryT>::iterator> _index;
+	};
+
+	/// Maps the location of an `External` block, i.e. the URL without any `#fragment`, to the buffer of another file.
+	class Resolver {
+	public:
+		virtual ~Resolver();
+
+		/// @returns the buffer of the file at the given location, or nullptr if this resolver can't resolve it.
+		virtual std::shared_ptr<const Buffer> resolve(const std::string & location) = 0;
+	};
+
+	/// Resolves relative paths, or `file:` URLs with relative paths, within a directory. Absolute paths and `..` components are rejected so that files can't refer to anything outside the directory.
+	class FileResolver : public Resolver {
+	public:
+		FileResolver(const std::string & root, std::shared_ptr<MappedFileCache> cache = MappedFileCache::shared());
+
+		virtual std::shared_ptr<const Buffer> resolve(const std::string & location);
+
+	private:
+		std::string _root;
+		std::shared_ptr<MappedFileCache> _cache;
+	};
+
+	/// Resolves `cas:` URLs with a hexadecimal content hash, e.g. `cas:3f9a...`, to files stored as `root/3f/9a...`.
+	class ContentStoreResolver : public Resolver {
+	public:
+		ContentStoreResolver(const std::string & root, std::shared_ptr<MappedFileCache> cache = MappedFileCache::shared());
+
+		virtual std::shared_ptr<const Buffer> resolve(const std::string & location);
+
+		/// @returns the path of the file for the given hash within the store, or an empty string if the hash is invalid.
+		std::string path_for(const std::string & hash) const;
+
+	private:
+		std::string _root;
+		std::shared_ptr<MappedFileCache> _cache;
+	};
+
+	/// Tries each resolver in turn.
+	class CompositeResolver : public Resolver {
+	public:
+		void add(std::shared_ptr<Resolver> resolver);
+
+		virtual std::shared_ptr<const Buffer> resolve(const std::string & location);
+
+	private:
+		std::vector<std::shared_ptr<Resolver>> _resolvers;
+	};
+}
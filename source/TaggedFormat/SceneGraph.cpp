@@ -0,0 +1,312 @@
+//
+//  SceneGraph.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "SceneGraph.hpp"
+#include "Reader.hpp"
+#include "Traversal.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace TaggedFormat
+{
+	namespace SceneGraph
+	{
+		void attach_to_roots(Writer & writer, const std::vector<OffsetT> & offsets, TagT tag, const std::function<OffsetT(OffsetT)> & build) {
+			std::vector<OffsetT> node_offsets;
+			std::set<OffsetT> children;
+
+			for (auto offset : offsets) {
+				if (writer.block_at_offset<Block>(offset)->tag != Node::TAG) continue;
+
+				node_offsets.push_back(offset);
+
+				for (auto & reference : **writer.block_at_offset<Node>(offset)) {
+					if (reference.offset && writer.block_at_offset<Block>(reference.offset)->tag == Node::TAG)
+						children.insert(reference.offset);
+				}
+			}
+
+			std::map<OffsetT, OffsetT> replacements;
+
+			for (auto offset : node_offsets) {
+				if (children.count(offset)) continue;
+
+				OffsetT block = build(offset);
+				if (!block) continue;
+
+				// Drop the block from a previous conversion:
+				std::vector<OffsetT> references;
+				for (auto & reference : **writer.block_at_offset<Node>(offset)) {
+					if (!reference.offset || writer.block_at_offset<Block>(reference.offset)->tag != tag)
+						references.push_back(reference.offset);
+				}
+
+				references.push_back(block);
+
+				auto node = writer.append<Node>(Node::array_size(references.size()));
+				auto original = writer.block_at_offset<Node>(offset);
+
+				node->name = original->name;
+				std::copy_n(original->transform, 16, node->transform);
+				for (std::size_t i = 0; i < references.size(); i += 1)
+					node->begin()[i].offset = references[i];
+
+				replacements[offset] = node;
+			}
+
+			relocate_offsets(writer, offsets, replacements);
+		}
+
+		OffsetT flatten(Writer & writer, OffsetT node_offset) {
+			std::vector<OffsetT> sources{node_offset};
+			std::vector<uint32_t> parents{0}, levels{0};
+
+			// Each level is visited in order, appending the children of its nodes to form the next level:
+			for (std::size_t first = 0; first < sources.size(); ) {
+				std::size_t last = sources.size();
+
+				for (std::size_t i = first; i < last; i += 1) {
+					for (auto & reference : **writer.block_at_offset<Node>(sources[i])) {
+						if (!reference.offset || writer.block_at_offset<Block>(reference.offset)->tag != Node::TAG) continue;
+
+						bool cycle = false;
+
+						for (std::size_t ancestor = i; !cycle; ancestor = parents[ancestor]) {
+							cycle = sources[ancestor] == reference.offset;
+
+							if (parents[ancestor] == ancestor) break;
+						}
+
+						if (cycle) continue;
+
+						sources.push_back(reference.offset);
+						parents.push_back(i);
+					}
+				}
+
+				levels.push_back(last);
+				first = last;
+			}
+
+			std::size_t count = sources.size(), plane_size = (count + 3) & ~std::size_t(3);
+
+			auto levels_block = writer.append<Array<Index32>>(Array<Index32>::array_size(levels.size()));
+			for (std::size_t i = 0; i < levels.size(); i += 1)
+				levels_block->begin()[i].value = levels[i];
+
+			auto parents_block = writer.append<Array<Index32>>(Array<Index32>::array_size(count));
+			for (std::size_t i = 0; i < count; i += 1)
+				parents_block->begin()[i].value = parents[i];
+
+			writer.align(NodeTransforms::ALIGNMENT);
+
+			auto transforms = writer.append<NodeTransforms>(16 * plane_size * sizeof(float32));
+			transforms->node_count = static_cast<uint32_t>(count);
+			transforms->reserved[0] = transforms->reserved[1] = 0;
+			transforms->plane_size = plane_size;
+
+			OffsetT transforms_offset = transforms;
+
+			for (std::size_t i = 0; i < count; i += 1) {
+				auto node = writer.block_at_offset<Node>(sources[i]);
+				auto block = writer.block_at_offset<NodeTransforms>(transforms_offset);
+
+				for (std::size_t element = 0; element < 16; element += 1)
+					block->plane(element)[i] = node->transform[element];
+			}
+
+			auto transforms_block = writer.block_at_offset<NodeTransforms>(transforms_offset);
+			for (std::size_t element = 0; element < 16; element += 1)
+				std::fill(transforms_block->plane(element) + count, transforms_block->plane(element) + plane_size, 0);
+
+			auto scene = writer.append<FlatScene>(FlatScene::array_size(count));
+			scene->levels_offset = levels_block;
+			scene->parents_offset = parents_block;
+			scene->transforms_offset = transforms_offset;
+
+			scene->begin()[0].offset = 0;
+			for (std::size_t i = 1; i < count; i += 1)
+				scene->begin()[i].offset = sources[i];
+
+			return scene;
+		}
+
+		void flatten_scenes(Writer & writer, const std::vector<OffsetT> & offsets) {
+			attach_to_roots(writer, offsets, FlatScene::TAG, [&](OffsetT node_offset) {
+				return flatten(writer, node_offset);
+			});
+		}
+
+		const FlatScene * scene_for_node(Reader & reader, const Node * node) {
+			for (auto & reference : *node) {
+				if (auto scene = reader.block_at_offset<FlatScene>(reference.offset))
+					return scene;
+			}
+
+			return nullptr;
+		}
+	}
+
+	// The world transform of a node is the world transform of its parent followed by its local transform. Columns of the result are combinations of the columns of the parent, scaled by the elements of the local transform, which are stored as planes:
+	static inline void multiply(const float32 * parent, const float32 * local, std::size_t plane_size, float32 * world) {
+#if defined(__SSE__)
+		// Neither matrix is necessarily aligned:
+		__m128 c0 = _mm_loadu_ps(parent), c1 = _mm_loadu_ps(parent + 4), c2 = _mm_loadu_ps(parent + 8), c3 = _mm_loadu_ps(parent + 12);
+
+		for (std::size_t column = 0; column < 4; column += 1) {
+			const float32 * elements = local + column * 4 * plane_size;
+
+			__m128 result = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(elements[0])), _mm_mul_ps(c1, _mm_set1_ps(elements[plane_size]))),
+				_mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(elements[2 * plane_size])), _mm_mul_ps(c3, _mm_set1_ps(elements[3 * plane_size])))
+			);
+
+			_mm_storeu_ps(world + column * 4, result);
+		}
+#else
+		for (std::size_t column = 0; column < 4; column += 1) {
+			for (std::size_t row = 0; row < 4; row += 1) {
+				float32 sum = 0;
+
+				for (std::size_t k = 0; k < 4; k += 1)
+					sum += parent[k * 4 + row] * local[(column * 4 + k) * plane_size];
+
+				world[column * 4 + row] = sum;
+			}
+		}
+#endif
+	}
+
+	SceneTransforms::SceneTransforms(Reader & reader, const FlatScene * scene, std::size_t concurrency) : _pool(concurrency)
+	{
+		auto levels = reader.block_at_offset<Array<Index32>>(scene->levels_offset);
+		auto parents = reader.block_at_offset<Array<Index32>>(scene->parents_offset);
+		auto transforms = reader.block_at_offset<NodeTransforms>(scene->transforms_offset);
+
+		std::size_t count = scene->count();
+
+		if (!levels || !parents || !transforms || levels->count() < 2 || parents->count() != count || transforms->node_count != count || transforms->plane_size < count)
+			throw std::invalid_argument("Flat scene is incomplete!");
+
+		for (auto & level : *levels)
+			_levels.push_back(level.value);
+
+		if (_levels.front() != 0 || _levels.back() != count || _levels[1] != 1)
+			throw std::invalid_argument("Flat scene levels don't contain every node!");
+
+		_parents.resize(count);
+		_node_levels.resize(count);
+
+		// Parents must be in the previous level, so that they are always updated first:
+		for (std::size_t level = 0; level + 1 < _levels.size(); level += 1) {
+			if (_levels[level] > _levels[level + 1])
+				throw std::invalid_argument("Flat scene levels are out of order!");
+
+			for (std::size_t node = _levels[level]; node < _levels[level + 1]; node += 1) {
+				uint32_t parent = parents->begin()[node].value;
+
+				if (level == 0 ? parent != node : (parent < _levels[level - 1] || parent >= _levels[level]))
+					throw std::invalid_argument("Flat scene parent is not in the previous level!");
+
+				_parents[node] = parent;
+				_node_levels[node] = level;
+			}
+		}
+
+		_plane_size = (count + 3) & ~std::size_t(3);
+		_locals.assign(16 * _plane_size, 0);
+
+		for (std::size_t element = 0; element < 16; element += 1)
+			std::copy_n(transforms->plane(element), count, _locals.data() + element * _plane_size);
+
+		_worlds.resize(count * 16);
+
+		_node_generations.assign(count, _generation);
+		_level_generations.assign(level_count(), _generation);
+	}
+
+	void SceneTransforms::local(std::size_t node, float32 transform[16]) const
+	{
+		for (std::size_t element = 0; element < 16; element += 1)
+			transform[element] = _locals[element * _plane_size + node];
+	}
+
+	void SceneTransforms::set_local(std::size_t node, const float32 transform[16])
+	{
+		for (std::size_t element = 0; element < 16; element += 1)
+			_locals[element * _plane_size + node] = transform[element];
+
+		_node_generations[node] = _generation;
+		_level_generations[_node_levels[node]] = _generation;
+	}
+
+	std::size_t SceneTransforms::update_nodes(std::size_t first, std::size_t last)
+	{
+		std::size_t updated = 0;
+
+		for (std::size_t node = first; node < last; node += 1) {
+			uint32_t parent = _parents[node];
+
+			// A node is out of date if it was changed, or if its parent was recomputed:
+			if (_node_generations[node] != _generation) {
+				if (parent == node || _node_generations[parent] != _generation) continue;
+
+				_node_generations[node] = _generation;
+			}
+
+			if (parent == node) {
+				for (std::size_t element = 0; element < 16; element += 1)
+					_worlds[node * 16 + element] = _locals[element * _plane_size + node];
+			} else {
+				multiply(world(parent), _locals.data() + node, _plane_size, _worlds.data() + node * 16);
+			}
+
+			updated += 1;
+		}
+
+		return updated;
+	}
+
+	std::size_t SceneTransforms::update()
+	{
+		std::size_t total = 0;
+		bool parents_updated = false;
+
+		for (std::size_t level = 0; level < level_count(); level += 1) {
+			// Levels where nothing changed are skipped entirely:
+			if (!parents_updated && _level_generations[level] != _generation) continue;
+
+			std::size_t first = _levels[level], last = _levels[level + 1];
+			std::size_t chunks = (last - first + CHUNK_SIZE - 1) / CHUNK_SIZE;
+			std::atomic<std::size_t> updated{0};
+
+			_pool.each(chunks, [&](std::size_t chunk, std::size_t) {
+				std::size_t chunk_first = first + chunk * CHUNK_SIZE;
+
+				if (std::size_t count = update_nodes(chunk_first, std::min(chunk_first + CHUNK_SIZE, last)))
+					updated += count;
+			});
+
+			parents_updated = updated > 0;
+			total += updated;
+		}
+
+		// Every node which was out of date is now up to date. After the generation wraps around, nodes which haven't changed since may be recomputed once more, which is harmless:
+		_generation += 1;
+
+		return total;
+	}
+}
@@ -0,0 +1,133 @@
+//
+//  SceneGraph.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Parallel.hpp"
+#include "Scene.hpp"
+#include "Writer.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace TaggedFormat
+{
+	class Reader;
+
+	/// The local transforms of a flattened node hierarchy, stored as 16 planes, one per element of the column major matrices, e.g. the first element of every transform followed by the second element of every transform. Each plane is padded to a multiple of 4 elements, and the block is aligned so that planes start on a 16 byte boundary.
+	struct NodeTransforms : public Block {
+		static const TagT TAG = tag_from_identifier("NXFM");
+
+		/// The alignment of the block within the file.
+		static const std::size_t ALIGNMENT = 16;
+
+		/// The number of nodes.
+		uint32_t node_count;
+
+		/// Unused, keeps the planes aligned to 16 bytes.
+		uint32_t reserved[2];
+
+		/// The number of elements in each plane, including padding.
+		OffsetT plane_size;
+
+		const float32 * plane(std::size_t element) const {
+			return reinterpret_cast<const float32 *>(reinterpret_cast<const Byte *>(this) + sizeof(NodeTransforms)) + element * plane_size;
+		}
+
+		float32 * plane(std::size_t element) {
+			return reinterpret_cast<float32 *>(reinterpret_cast<Byte *>(this) + sizeof(NodeTransforms)) + element * plane_size;
+		}
+	};
+
+	/// A node hierarchy in breadth first order, so that every level is a contiguous range of nodes which follows the level of their parents, stored as one of the references of the root node. Contains a reference to the source `Node` of each flattened node. A node reached by several paths appears once for every path. The first node is the root, which refers to this block, so its reference is 0 to avoid a cycle.
+	struct FlatScene : public Array<Reference, FlatScene> {
+		static const TagT TAG = tag_from_identifier("FSCN");
+
+		/// An `Array<Index32>` of the first node of every level, followed by the number of nodes.
+		OffsetT levels_offset;
+
+		/// An `Array<Index32>` of the parent of every node. The root is its own parent.
+		OffsetT parents_offset;
+
+		/// The `NodeTransforms` of every node.
+		OffsetT transforms_offset;
+	};
+
+	/// Flattening of node hierarchies at conversion time, and evaluation of their world transforms.
+	namespace SceneGraph
+	{
+		/// Build a block for every root node within `offsets`, i.e. every node which is not a child of another node, using `build(root_offset)`, which may return 0 to skip the node. Root nodes are replaced by a copy which references the new block in place of any previous block with the same tag, and all references to the original nodes within `offsets` and the header are updated.
+		void attach_to_roots(Writer & writer, const std::vector<OffsetT> & offsets, TagT tag, const std::function<OffsetT(OffsetT)> & build);
+
+		/// Flatten the hierarchy below a node. Cycles are skipped, as they would otherwise never end.
+		/// @returns the offset of the new `FlatScene`.
+		OffsetT flatten(Writer & writer, OffsetT node_offset);
+
+		/// Flatten every root node within `offsets`, using `attach_to_roots`.
+		void flatten_scenes(Writer & writer, const std::vector<OffsetT> & offsets);
+
+		/// @returns the flattened hierarchy of the given root node, or nullptr if it has none.
+		const FlatScene * scene_for_node(Reader & reader, const Node * node);
+	}
+
+	/// Evaluates the world transforms of a flattened hierarchy, e.g. every frame after some nodes were moved. Levels are updated in order, and the nodes of each level are divided into chunks which are updated in parallel, with one SIMD 4x4 multiply per node. Only nodes whose local transform was changed since the last update, and the nodes below them, are recomputed. Storage is allocated on construction, so updating doesn't allocate.
+	class SceneTransforms {
+	public:
+		/// The number of nodes in a level updated by one thread at a time.
+		static const std::size_t CHUNK_SIZE = 512;
+
+		/// Copy the hierarchy and local transforms of a flattened scene. Every node is initially out of date.
+		/// @param concurrency the number of threads used by `update`.
+		/// @throws std::invalid_argument if the levels or parents are inconsistent.
+		SceneTransforms(Reader & reader, const FlatScene * scene, std::size_t concurrency = Parallel::concurrency());
+
+		std::size_t node_count() const {return _parents.size();}
+		std::size_t level_count() const {return _levels.size() - 1;}
+
+		/// The parent of a node, or the node itself for the root.
+		std::size_t parent(std::size_t node) const {return _parents[node];}
+
+		/// The range of nodes `[first, last)` in a level.
+		std::size_t level_first(std::size_t level) const {return _levels[level];}
+		std::size_t level_last(std::size_t level) const {return _levels[level + 1];}
+
+		/// Copy the column major local transform of a node.
+		void local(std::size_t node, float32 transform[16]) const;
+
+		/// Change the column major local transform of a node, which, along with every node below it, is recomputed by the next `update`.
+		void set_local(std::size_t node, const float32 transform[16]);
+
+		/// Compute the world transforms of every node which is out of date.
+		/// @returns the number of nodes which were recomputed.
+		std::size_t update();
+
+		/// The column major world transforms of every node, with 16 values per node in order.
+		const float32 * worlds() const {return _worlds.data();}
+
+		/// The world transform of a node, as of the last `update`.
+		const float32 * world(std::size_t node) const {return _worlds.data() + node * 16;}
+
+	private:
+		std::vector<uint32_t> _levels, _parents, _node_levels;
+
+		/// The local transforms, stored as planes like `NodeTransforms`.
+		std::vector<float32> _locals;
+		std::size_t _plane_size = 0;
+
+		std::vector<float32> _worlds;
+
+		/// A node or level is out of date if its entry is equal to the current generation, so that advancing the generation marks every node as up to date without clearing anything.
+		std::vector<uint32_t> _node_generations, _level_generations;
+		uint32_t _generation = 1;
+
+		Parallel::Pool _pool;
+
+		std::size_t update_nodes(std::size_t first, std::size_t last);
+	};
+}
@@ -0,0 +1,466 @@
+//
+//  Simplification.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Simplification.hpp"
+#include "BVH.hpp"
+#include "Geometry.hpp"
+#include "Topology.hpp"
+#include "VertexCache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace TaggedFormat
+{
+	namespace Simplification
+	{
+		// Boundary constraint planes are weighted so that open edges are preserved in preference to interior detail.
+		const double BOUNDARY_WEIGHT = 10;
+
+		struct Vector {
+			double x, y, z;
+
+			Vector operator-(const Vector & other) const {
+				return {x - other.x, y - other.y, z - other.z};
+			}
+
+			double dot(const Vector & other) const {
+				return x * other.x + y * other.y + z * other.z;
+			}
+
+			Vector cross(const Vector & other) const {
+				return {y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x};
+			}
+
+			double length() const {
+				return std::sqrt(dot(*this));
+			}
+		};
+
+		// A symmetric 4x4 matrix representing the sum of squared distances to a set of planes.
+		struct Quadric {
+			double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+			double b0 = 0, b1 = 0, b2 = 0, c = 0;
+
+			void add_plane(const Vector & normal, double d, double weight) {
+				a00 += weight * normal.x * normal.x;
+				a01 += weight * normal.x * normal.y;
+				a02 += weight * normal.x * normal.z;
+				a11 += weight * normal.y * normal.y;
+				a12 += weight * normal.y * normal.z;
+				a22 += weight * normal.z * normal.z;
+				b0 += weight * normal.x * d;
+				b1 += weight * normal.y * d;
+				b2 += weight * normal.z * d;
+				c += weight * d * d;
+			}
+
+			Quadric & operator+=(const Quadric & other) {
+				a00 += other.a00; a01 += other.a01; a02 += other.a02;
+				a11 += other.a11; a12 += other.a12; a22 += other.a22;
+				b0 += other.b0; b1 += other.b1; b2 += other.b2;
+				c += other.c;
+
+				return *this;
+			}
+
+			double evaluate(const Vector & p) const {
+				double result =
+					a00 * p.x * p.x + 2 * a01 * p.x * p.y + 2 * a02 * p.x * p.z +
+					a11 * p.y * p.y + 2 * a12 * p.y * p.z + a22 * p.z * p.z +
+					2 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+
+				return std::fabs(result);
+			}
+		};
+
+		struct Collapse {
+			double cost;
+			uint32_t from, to;
+			uint32_t from_version, to_version;
+
+			bool operator<(const Collapse & other) const {
+				// Reversed, so that the priority queue yields the cheapest collapse:
+				return cost > other.cost;
+			}
+		};
+
+		class Simplifier {
+		public:
+			Simplifier(const std::vector<uint32_t> & indices, const std::vector<float32> & positions) : _triangles(indices), _removed(indices.size() / 3, false)
+			{
+				std::size_t vertex_count = positions.size() / 3;
+
+				_positions.reserve(vertex_count);
+				for (std::size_t i = 0; i < vertex_count; i += 1) {
+					_positions.push_back({positions[i*3], positions[i*3+1], positions[i*3+2]});
+				}
+
+				_quadrics.resize(vertex_count);
+				_vertex_triangles.resize(vertex_count);
+				_locked.assign(vertex_count, false);
+				_collapsed.assign(vertex_count, false);
+				_versions.assign(vertex_count, 0);
+
+				_live = _removed.size();
+
+				add_face_quadrics();
+				add_boundary_quadrics();
+				lock_seams();
+
+				for (std::size_t t = 0; t < _removed.size(); t += 1) {
+					for (std::size_t j = 0; j < 3; j += 1) {
+						push_collapse(_triangles[t*3+j], _triangles[t*3+(j+1)%3]);
+					}
+				}
+			}
+
+			std::size_t live() const {return _live;}
+
+			// Collapse edges until the number of triangles is at most the target.
+			// @returns false if no further collapses are possible.
+			bool simplify(std::size_t target) {
+				while (_live > target) {
+					if (_queue.empty()) return false;
+
+					Collapse collapse = _queue.top();
+					_queue.pop();
+
+					if (_collapsed[collapse.from] || _collapsed[collapse.to]) continue;
+					if (_versions[collapse.from] != collapse.from_version || _versions[collapse.to] != collapse.to_version) continue;
+					if (flips(collapse.from, collapse.to)) continue;
+
+					apply(collapse);
+				}
+
+				return true;
+			}
+
+			std::vector<uint32_t> indices() const {
+				std::vector<uint32_t> result;
+				result.reserve(_live * 3);
+
+				for (std::size_t t = 0; t < _removed.size(); t += 1) {
+					if (!_removed[t])
+						result.insert(result.end(), &_triangles[t*3], &_triangles[t*3] + 3);
+				}
+
+				return result;
+			}
+
+		private:
+			std::vector<uint32_t> _triangles;
+			std::vector<bool> _removed;
+			std::size_t _live = 0;
+
+			std::vector<Vector> _positions;
+			std::vector<Quadric> _quadrics;
+			std::vector<std::vector<uint32_t>> _vertex_triangles;
+			std::vector<bool> _locked, _collapsed;
+			std::vector<uint32_t> _versions;
+
+			std::priority_queue<Collapse> _queue;
+
+			Vector normal(std::size_t t) const {
+				const uint32_t * triangle = &_triangles[t*3];
+				const Vector & p0 = _positions[triangle[0]];
+
+				return (_positions[triangle[1]] - p0).cross(_positions[triangle[2]] - p0);
+			}
+
+			void add_face_quadrics() {
+				for (std::size_t t = 0; t < _removed.size(); t += 1) {
+					const uint32_t * triangle = &_triangles[t*3];
+
+					Vector n = normal(t);
+					double length = n.length();
+
+					if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0]) {
+						_removed[t] = true;
+						_live -= 1;
+
+						continue;
+					}
+
+					for (std::size_t j = 0; j < 3; j += 1)
+						_vertex_triangles[triangle[j]].push_back(static_cast<uint32_t>(t));
+
+					if (length == 0) continue;
+
+					Vector unit{n.x / length, n.y / length, n.z / length};
+					double d = -unit.dot(_positions[triangle[0]]);
+
+					for (std::size_t j = 0; j < 3; j += 1)
+						_quadrics[triangle[j]].add_plane(unit, d, 1);
+				}
+			}
+
+			static uint64_t edge_key(uint32_t a, uint32_t b) {
+				if (a > b) std::swap(a, b);
+
+				return (static_cast<uint64_t>(a) << 32) | b;
+			}
+
+			// Edges used by a single triangle are constrained by a plane perpendicular to that triangle:
+			void add_boundary_quadrics() {
+				std::unordered_map<uint64_t, uint32_t> edge_counts;
+
+				for (std::size_t t = 0; t < _removed.size(); t += 1) {
+					if (_removed[t]) continue;
+
+					for (std::size_t j = 0; j < 3; j += 1)
+						edge_counts[edge_key(_triangles[t*3+j], _triangles[t*3+(j+1)%3])] += 1;
+				}
+
+				for (std::size_t t = 0; t < _removed.size(); t += 1) {
+					if (_removed[t]) continue;
+
+					Vector n = normal(t);
+
+					for (std::size_t j = 0; j < 3; j += 1) {
+						uint32_t a = _triangles[t*3+j], b = _triangles[t*3+(j+1)%3];
+
+						if (edge_counts[edge_key(a, b)] != 1) continue;
+
+						Vector edge = _positions[b] - _positions[a];
+						Vector perpendicular = edge.cross(n);
+						double length = perpendicular.length();
+
+						if (length == 0) continue;
+
+						Vector unit{perpendicular.x / length, perpendicular.y / length, perpendicular.z / length};
+						double d = -unit.dot(_positions[a]);
+						double weight = BOUNDARY_WEIGHT * edge.dot(edge);
+
+						_quadrics[a].add_plane(unit, d, weight);
+						_quadrics[b].add_plane(unit, d, weight);
+					}
+				}
+			}
+
+			// Vertices which share a position with another vertex would open a crack if moved independently:
+			void lock_seams() {
+				std::unordered_map<uint64_t, uint32_t> positions;
+
+				auto key = [&](const Vector & p) {
+					float32 values[3] = {static_cast<float32>(p.x), static_cast<float32>(p.y), static_cast<float32>(p.z)};
+					uint32_t bits[3];
+					std::memcpy(bits, values, sizeof(bits));
+
+					return (static_cast<uint64_t>(bits[0]) * 73856093) ^ (static_cast<uint64_t>(bits[1]) * 19349663) ^ (static_cast<uint64_t>(bits[2]) * 83492791);
+				};
+
+				std::unordered_multimap<uint64_t, uint32_t> buckets;
+
+				for (uint32_t i = 0; i < _positions.size(); i += 1) {
+					auto range = buckets.equal_range(key(_positions[i]));
+
+					for (auto other = range.first; other != range.second; ++other) {
+						const Vector & p = _positions[other->second];
+
+						if (p.x == _positions[i].x && p.y == _positions[i].y && p.z == _positions[i].z) {
+							_locked[i] = true;
+							_locked[other->second] = true;
+						}
+					}
+
+					buckets.emplace(key(_positions[i]), i);
+				}
+			}
+
+			void push_collapse(uint32_t a, uint32_t b) {
+				if (a == b) return;
+
+				Quadric quadric = _quadrics[a];
+				quadric += _quadrics[b];
+
+				double infinity = std::numeric_limits<double>::infinity();
+				double a_to_b = _locked[a] ? infinity : quadric.evaluate(_positions[b]);
+				double b_to_a = _locked[b] ? infinity : quadric.evaluate(_positions[a]);
+
+				if (a_to_b == infinity && b_to_a == infinity) return;
+
+				if (a_to_b <= b_to_a)
+					_queue.push({a_to_b, a, b, _versions[a], _versions[b]});
+				else
+					_queue.push({b_to_a, b, a, _versions[b], _versions[a]});
+			}
+
+			// Moving `from` onto `to` must not flip any remaining triangle:
+			bool flips(uint32_t from, uint32_t to) const {
+				for (auto t : _vertex_triangles[from]) {
+					if (_removed[t]) continue;
+
+					const uint32_t * triangle = &_triangles[t*3];
+					if (triangle[0] == to || triangle[1] == to || triangle[2] == to) continue;
+
+					Vector p[3];
+					for (std::size_t j = 0; j < 3; j += 1)
+						p[j] = _positions[triangle[j] == from ? to : triangle[j]];
+
+					Vector after = (p[1] - p[0]).cross(p[2] - p[0]);
+
+					if (normal(t).dot(after) <= 0) return true;
+				}
+
+				return false;
+			}
+
+			void apply(const Collapse & collapse) {
+				uint32_t from = collapse.from, to = collapse.to;
+
+				_collapsed[from] = true;
+				_versions[to] += 1;
+				_quadrics[to] += _quadrics[from];
+
+				for (auto t : _vertex_triangles[from]) {
+					if (_removed[t]) continue;
+
+					uint32_t * triangle = &_triangles[t*3];
+
+					if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+						_removed[t] = true;
+						_live -= 1;
+					} else {
+						for (std::size_t j = 0; j < 3; j += 1)
+							if (triangle[j] == from) triangle[j] = to;
+
+						_vertex_triangles[to].push_back(t);
+					}
+				}
+
+				_vertex_triangles[from].clear();
+
+				// Drop removed triangles, and queue the edges around the merged vertex with their new costs:
+				auto & triangles = _vertex_triangles[to];
+				triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [&](uint32_t t) {return _removed[t];}), triangles.end());
+
+				for (auto t : triangles) {
+					for (std::size_t j = 0; j < 3; j += 1)
+						push_collapse(to, _triangles[t*3+j]);
+				}
+			}
+		};
+
+		// Collapse costs include the boundary constraints, which are weighted by area, so they are not a distance. Instead, the distance from each vertex removed by the level to the simplified surface is measured, i.e. the one sided Hausdorff distance from the vertices of the original mesh.
+		static float32 level_error(const std::vector<uint32_t> & indices, const std::vector<uint32_t> & level_indices, const std::vector<float32> & positions) {
+			std::vector<BVHNode> nodes;
+			std::vector<BVHTriangle> triangles;
+			BVH::build(level_indices, positions, nodes, triangles);
+
+			BVH::Tree tree;
+			tree.nodes = nodes.data();
+			tree.node_count = nodes.size();
+			tree.triangles = triangles.data();
+			tree.triangle_count = triangles.size();
+
+			std::vector<bool> measured(positions.size() / 3, false);
+
+			// Vertices of the level are on its surface:
+			for (auto index : level_indices)
+				measured[index] = true;
+
+			float32 error = 0;
+
+			for (auto index : indices) {
+				if (measured[index]) continue;
+				measured[index] = true;
+
+				BVH::ClosestPoint closest;
+
+				if (BVH::closest_point(tree, &positions[index * 3], std::numeric_limits<float32>::max(), closest))
+					error = std::max(error, std::sqrt(closest.distance_squared));
+			}
+
+			return error;
+		}
+
+		std::vector<Level> generate_levels(const std::vector<uint32_t> & indices, const std::vector<float32> & positions, std::size_t level_count, float32 ratio) {
+			std::vector<Level> levels;
+			std::size_t vertex_count = positions.size() / 3;
+
+			if (indices.size() % 3 != 0) return levels;
+
+			for (auto index : indices) {
+				if (index >= vertex_count) return levels;
+			}
+
+			Simplifier simplifier(indices, positions);
+			std::size_t previous = simplifier.live();
+
+			while (levels.size() < level_count && previous > 1) {
+				std::size_t target = static_cast<std::size_t>(previous * ratio);
+				bool complete = simplifier.simplify(target);
+
+				// Stop if the mesh could not be simplified significantly further:
+				if (simplifier.live() >= previous || (!complete && simplifier.live() > previous * (1 + ratio) / 2))
+					break;
+
+				previous = simplifier.live();
+
+				Level level;
+				level.indices = simplifier.indices();
+
+				// Coarser levels never have less error, so that a level can be selected by searching for the first level within a threshold:
+				level.error = std::max(level_error(indices, level.indices, positions), levels.empty() ? 0 : levels.back().error);
+
+				levels.push_back(std::move(level));
+
+				if (!complete) break;
+			}
+
+			return levels;
+		}
+
+		OffsetT generate_mesh_levels(Writer & writer, OffsetT mesh_offset, std::size_t level_count) {
+			auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+
+			if (mesh->layout != Mesh::Layout::TRIANGLES || !mesh->indices_offset || !mesh->vertices_offset)
+				return 0;
+
+			auto positions = read_positions(*writer.block_at_offset<Block>(mesh->vertices_offset));
+			auto indices = read_indices(*writer.block_at_offset<Block>(mesh->indices_offset));
+
+			auto levels = generate_levels(indices, positions, level_count);
+
+			if (levels.empty()) return 0;
+
+			std::size_t vertex_count = positions.size() / 3;
+			TagT tag = vertex_count <= Topology::INDEX16_VERTEX_LIMIT ? Index16::TAG : Index32::TAG;
+
+			std::vector<MeshLevel> entries;
+
+			for (auto & level : levels) {
+				auto optimized = VertexCache::optimize(level.indices, vertex_count);
+
+				MeshLevel entry;
+				entry.indices_offset = append_indices(writer, optimized, tag);
+				entry.error = level.error;
+				entry.triangle_count = static_cast<uint32_t>(optimized.size() / 3);
+
+				entries.push_back(entry);
+			}
+
+			auto array = writer.append<Array<MeshLevel>>(Array<MeshLevel>::array_size(entries.size()));
+			std::copy(entries.begin(), entries.end(), array->begin());
+
+			set_mesh_metadata(writer, mesh_offset, METADATA_NAME, array);
+
+			return array;
+		}
+
+		float32 error_threshold(float32 pixels, float32 distance, float32 projection_scale, float32 viewport_height) {
+			// A length of 1 at distance 1 spans projection_scale * viewport_height / 2 pixels:
+			return pixels * 2 * distance / (projection_scale * viewport_height);
+		}
+	}
+}
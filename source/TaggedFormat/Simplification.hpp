@@ -0,0 +1,58 @@
+//
+//  Simplification.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// A single simplified level of a mesh, which uses the vertex array of the mesh. Levels are stored in an `Array<MeshLevel>` referenced by the `lod` entry of the mesh metadata, ordered from finest to coarsest.
+	struct MeshLevel {
+		static const TagT TAG = tag_from_identifier("MLOD");
+
+		/// The offset of a triangle list which indexes the vertex array of the mesh.
+		OffsetT indices_offset;
+
+		/// The largest distance from a vertex of the mesh to the surface of this level, or of any finer level, in the same units as the vertex positions.
+		float32 error;
+
+		/// The number of triangles in this level.
+		uint32_t triangle_count;
+	};
+
+	/// Level of detail generation using quadric error metrics (Garland and Heckbert, 1997).
+	namespace Simplification
+	{
+		/// The name of the metadata entry which references the levels of a mesh.
+		const char * const METADATA_NAME = "lod";
+
+		/// The number of levels generated by default, each with half the triangles of the previous.
+		const std::size_t DEFAULT_LEVEL_COUNT = 4;
+
+		struct Level {
+			std::vector<uint32_t> indices;
+			float32 error = 0;
+		};
+
+		/// Simplify a triangle list by collapsing edges onto existing vertices, so that every level can share the original vertex array. Each level has approximately `ratio` times the triangles of the previous level. Vertices on open boundaries are constrained, and vertices which share a position with another vertex (e.g. seams in the texture mapping) are not moved.
+		/// @param positions x, y, z triples for each vertex.
+		/// @returns up to `level_count` levels, fewer if the mesh can not be simplified further.
+		std::vector<Level> generate_levels(const std::vector<uint32_t> & indices, const std::vector<float32> & positions, std::size_t level_count, float32 ratio = 0.5);
+
+		/// Generate levels for a triangle mesh, optimized for vertex cache reuse, and reference them from the mesh metadata.
+		/// @returns the offset of the new `Array<MeshLevel>`, or 0 if the mesh is not a triangle list or could not be simplified.
+		OffsetT generate_mesh_levels(Writer & writer, OffsetT mesh_offset, std::size_t level_count = DEFAULT_LEVEL_COUNT);
+
+		/// Convert a tolerance in pixels into a geometric error threshold, for an object at the given distance from the camera. `projection_scale` is the vertical scale factor of the projection matrix, i.e. `1 / tan(fov_y / 2)`.
+		float32 error_threshold(float32 pixels, float32 distance, float32 projection_scale, float32 viewport_height);
+	}
+}
@@ -0,0 +1,303 @@
+//
+//  Skinning.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Skinning.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define TAGGED_FORMAT_SKINNING_AVX2
+#include <immintrin.h>
+#endif
+
+namespace TaggedFormat
+{
+	namespace Skinning
+	{
+		static void check_bones(const VertexP3N3M2B4 & vertex, std::size_t bone_count) {
+			for (std::size_t i = 0; i < 4; i += 1) {
+				if (vertex.bones[i] >= bone_count)
+					throw std::invalid_argument("Vertex references a bone outside the palette!");
+			}
+		}
+
+		void skin_reference(const float32 * palette, std::size_t bone_count, const VertexP3N3M2B4 * vertices, std::size_t count, float32 * positions, float32 * normals) {
+			for (std::size_t v = 0; v < count; v += 1) {
+				auto & vertex = vertices[v];
+				check_bones(vertex, bone_count);
+
+				float32 position[3] = {0, 0, 0}, normal[3] = {0, 0, 0};
+
+				for (std::size_t i = 0; i < 4; i += 1) {
+					const float32 * m = palette + vertex.bones[i] * 16;
+					float32 weight = vertex.weights[i];
+
+					for (std::size_t row = 0; row < 3; row += 1) {
+						position[row] += weight * (m[row] * vertex.position[0] + m[4 + row] * vertex.position[1] + m[8 + row] * vertex.position[2] + m[12 + row]);
+						normal[row] += weight * (m[row] * vertex.normal[0] + m[4 + row] * vertex.normal[1] + m[8 + row] * vertex.normal[2]);
+					}
+				}
+
+				std::copy(position, position + 3, positions + v * 3);
+
+				if (normals) {
+					float32 length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+					for (std::size_t row = 0; row < 3; row += 1)
+						normals[v * 3 + row] = length > 0 ? normal[row] / length : 0;
+				}
+			}
+		}
+
+#if defined(TAGGED_FORMAT_SKINNING_AVX2)
+		// Transpose 8 rows of 8 floats in place:
+		__attribute__((target("avx2,fma"), always_inline))
+		static inline void transpose_8x8(__m256 rows[8]) {
+			__m256 a[8], b[8];
+
+			for (std::size_t i = 0; i < 8; i += 2) {
+				a[i] = _mm256_unpacklo_ps(rows[i], rows[i + 1]);
+				a[i + 1] = _mm256_unpackhi_ps(rows[i], rows[i + 1]);
+			}
+
+			for (std::size_t i = 0; i < 8; i += 4) {
+				b[i] = _mm256_shuffle_ps(a[i], a[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+				b[i + 1] = _mm256_shuffle_ps(a[i], a[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+				b[i + 2] = _mm256_shuffle_ps(a[i + 1], a[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+				b[i + 3] = _mm256_shuffle_ps(a[i + 1], a[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+			}
+
+			for (std::size_t i = 0; i < 4; i += 1) {
+				rows[i] = _mm256_permute2f128_ps(b[i], b[i + 4], 0x20);
+				rows[i + 4] = _mm256_permute2f128_ps(b[i], b[i + 4], 0x31);
+			}
+		}
+
+		// Compiled for AVX2 regardless of the target, and only called if the processor supports it. The matrices of each vertex are blended two columns per register, and transposed so that each lane skins one vertex, reading the vertices with a stride of one vertex. Gathering every element of the palette instead is about twice as slow:
+		__attribute__((target("avx2,fma")))
+		static std::size_t skin_avx2(const float32 * palette, std::size_t bone_count, const VertexP3N3M2B4 * vertices, std::size_t count, float32 * positions, float32 * normals) {
+			static_assert(sizeof(VertexP3N3M2B4) % sizeof(float32) == 0, "Vertices must be gathered in floats!");
+
+			const int stride = sizeof(VertexP3N3M2B4) / sizeof(float32);
+			const __m256i lanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+
+			std::size_t v = 0;
+
+			for (; v + 8 <= count; v += 8) {
+				const VertexP3N3M2B4 * group = vertices + v;
+
+				// Checked before blending, as the call isn't inlined into this target and would spill the registers:
+				for (std::size_t k = 0; k < 8; k += 1)
+					check_bones(group[k], bone_count);
+
+				// Columns 0 and 1, and columns 2 and 3, of each blended matrix:
+				__m256 low[8], high[8];
+
+				for (std::size_t k = 0; k < 8; k += 1) {
+					auto & vertex = group[k];
+					low[k] = high[k] = _mm256_setzero_ps();
+
+					for (std::size_t i = 0; i < 4; i += 1) {
+						const float32 * m = palette + vertex.bones[i] * 16;
+						__m256 weight = _mm256_broadcast_ss(vertex.weights + i);
+
+						// The palette isn't necessarily aligned:
+						low[k] = _mm256_fmadd_ps(_mm256_loadu_ps(m), weight, low[k]);
+						high[k] = _mm256_fmadd_ps(_mm256_loadu_ps(m + 8), weight, high[k]);
+					}
+				}
+
+				// Element e of every matrix is now in low[e] or high[e - 8]:
+				transpose_8x8(low);
+				transpose_8x8(high);
+
+				__m256 position[3] = {
+					_mm256_i32gather_ps(group->position + 0, lanes, 4),
+					_mm256_i32gather_ps(group->position + 1, lanes, 4),
+					_mm256_i32gather_ps(group->position + 2, lanes, 4),
+				};
+
+				alignas(32) float32 result[3][8];
+
+				for (std::size_t row = 0; row < 3; row += 1) {
+					__m256 value = _mm256_fmadd_ps(low[row], position[0], _mm256_fmadd_ps(low[4 + row], position[1], _mm256_fmadd_ps(high[row], position[2], high[4 + row])));
+					_mm256_store_ps(result[row], value);
+				}
+
+				for (std::size_t k = 0; k < 8; k += 1) {
+					for (std::size_t row = 0; row < 3; row += 1)
+						positions[(v + k) * 3 + row] = result[row][k];
+				}
+
+				if (normals) {
+					__m256 normal[3] = {
+						_mm256_i32gather_ps(group->normal + 0, lanes, 4),
+						_mm256_i32gather_ps(group->normal + 1, lanes, 4),
+						_mm256_i32gather_ps(group->normal + 2, lanes, 4),
+					};
+
+					__m256 value[3];
+
+					for (std::size_t row = 0; row < 3; row += 1)
+						value[row] = _mm256_fmadd_ps(low[row], normal[0], _mm256_fmadd_ps(low[4 + row], normal[1], _mm256_mul_ps(high[row], normal[2])));
+
+					// A degenerate normal stays zero rather than becoming NaN:
+					__m256 length = _mm256_fmadd_ps(value[0], value[0], _mm256_fmadd_ps(value[1], value[1], _mm256_mul_ps(value[2], value[2])));
+					length = _mm256_max_ps(_mm256_sqrt_ps(length), _mm256_set1_ps(1e-30f));
+
+					for (std::size_t row = 0; row < 3; row += 1)
+						_mm256_store_ps(result[row], _mm256_div_ps(value[row], length));
+
+					for (std::size_t k = 0; k < 8; k += 1) {
+						for (std::size_t row = 0; row < 3; row += 1)
+							normals[(v + k) * 3 + row] = result[row][k];
+					}
+				}
+			}
+
+			return v;
+		}
+
+		static bool has_avx2() {
+			static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+
+			return supported;
+		}
+#endif
+
+		void skin(const float32 * palette, std::size_t bone_count, const VertexP3N3M2B4 * vertices, std::size_t count, float32 * positions, float32 * normals) {
+			std::size_t first = 0;
+
+#if defined(TAGGED_FORMAT_SKINNING_AVX2)
+			// The remaining vertices are skinned one at a time:
+			if (has_avx2())
+				first = skin_avx2(palette, bone_count, vertices, count, positions, normals);
+#endif
+
+			for (std::size_t v = first; v < count; v += 1) {
+				auto & vertex = vertices[v];
+				check_bones(vertex, bone_count);
+
+#if defined(__SSE__)
+				__m128 c0 = _mm_setzero_ps(), c1 = _mm_setzero_ps(), c2 = _mm_setzero_ps(), c3 = _mm_setzero_ps();
+
+				// The palette isn't necessarily aligned:
+				for (std::size_t i = 0; i < 4; i += 1) {
+					const float32 * m = palette + vertex.bones[i] * 16;
+					__m128 weight = _mm_set1_ps(vertex.weights[i]);
+
+					c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(m), weight));
+					c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(m + 4), weight));
+					c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(m + 8), weight));
+					c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(m + 12), weight));
+				}
+
+				alignas(16) float32 result[4];
+
+				__m128 position = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(vertex.position[0])), _mm_mul_ps(c1, _mm_set1_ps(vertex.position[1]))),
+					_mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(vertex.position[2])), c3)
+				);
+
+				_mm_store_ps(result, position);
+				std::copy(result, result + 3, positions + v * 3);
+
+				if (normals) {
+					__m128 normal = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(vertex.normal[0])), _mm_mul_ps(c1, _mm_set1_ps(vertex.normal[1]))),
+						_mm_mul_ps(c2, _mm_set1_ps(vertex.normal[2]))
+					);
+
+					// The last row of an affine matrix is (0, 0, 0, 1), so the fourth component is zero and the sum of every lane is the squared length:
+					__m128 length = _mm_mul_ps(normal, normal);
+					length = _mm_add_ps(length, _mm_shuffle_ps(length, length, _MM_SHUFFLE(2, 3, 0, 1)));
+					length = _mm_add_ps(length, _mm_shuffle_ps(length, length, _MM_SHUFFLE(1, 0, 3, 2)));
+
+					// A degenerate normal stays zero rather than becoming NaN:
+					length = _mm_max_ps(_mm_sqrt_ps(length), _mm_set1_ps(1e-30f));
+
+					_mm_store_ps(result, _mm_div_ps(normal, length));
+					std::copy(result, result + 3, normals + v * 3);
+				}
+#elif defined(__ARM_NEON)
+				float32x4_t c0 = vdupq_n_f32(0), c1 = vdupq_n_f32(0), c2 = vdupq_n_f32(0), c3 = vdupq_n_f32(0);
+
+				for (std::size_t i = 0; i < 4; i += 1) {
+					const float32 * m = palette + vertex.bones[i] * 16;
+					float32 weight = vertex.weights[i];
+
+					c0 = vmlaq_n_f32(c0, vld1q_f32(m), weight);
+					c1 = vmlaq_n_f32(c1, vld1q_f32(m + 4), weight);
+					c2 = vmlaq_n_f32(c2, vld1q_f32(m + 8), weight);
+					c3 = vmlaq_n_f32(c3, vld1q_f32(m + 12), weight);
+				}
+
+				float32 result[4];
+
+				float32x4_t position = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(c3, c0, vertex.position[0]), c1, vertex.position[1]), c2, vertex.position[2]);
+
+				vst1q_f32(result, position);
+				std::copy(result, result + 3, positions + v * 3);
+
+				if (normals) {
+					float32x4_t normal = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(c0, vertex.normal[0]), c1, vertex.normal[1]), c2, vertex.normal[2]);
+
+					vst1q_f32(result, normal);
+
+					float32 length = std::max(std::sqrt(result[0] * result[0] + result[1] * result[1] + result[2] * result[2]), 1e-30f);
+
+					for (std::size_t row = 0; row < 3; row += 1)
+						normals[v * 3 + row] = result[row] / length;
+				}
+#else
+				float32 m[16] = {0};
+
+				for (std::size_t i = 0; i < 4; i += 1) {
+					const float32 * bone = palette + vertex.bones[i] * 16;
+
+					for (std::size_t k = 0; k < 16; k += 1)
+						m[k] += bone[k] * vertex.weights[i];
+				}
+
+				for (std::size_t row = 0; row < 3; row += 1)
+					positions[v * 3 + row] = m[row] * vertex.position[0] + m[4 + row] * vertex.position[1] + m[8 + row] * vertex.position[2] + m[12 + row];
+
+				if (normals) {
+					float32 normal[3];
+
+					for (std::size_t row = 0; row < 3; row += 1)
+						normal[row] = m[row] * vertex.normal[0] + m[4 + row] * vertex.normal[1] + m[8 + row] * vertex.normal[2];
+
+					float32 length = std::max(std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]), 1e-30f);
+
+					for (std::size_t row = 0; row < 3; row += 1)
+						normals[v * 3 + row] = normal[row] / length;
+				}
+#endif
+			}
+		}
+
+		void skin(Parallel::Pool & pool, const float32 * palette, std::size_t bone_count, const VertexP3N3M2B4 * vertices, std::size_t count, float32 * positions, float32 * normals) {
+			std::size_t chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+			pool.each(chunks, [&](std::size_t chunk, std::size_t) {
+				std::size_t first = chunk * CHUNK_SIZE, size = std::min(CHUNK_SIZE, count - first);
+
+				skin(palette, bone_count, vertices + first, size, positions + first * 3, normals ? normals + first * 3 : nullptr);
+			});
+		}
+	}
+}
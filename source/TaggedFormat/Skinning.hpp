@@ -0,0 +1,33 @@
+//
+//  Skinning.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Parallel.hpp"
+#include "Skeleton.hpp"
+
+namespace TaggedFormat
+{
+	/// Linear blend skinning on the CPU, e.g. for hit detection on a server without a GPU. The palette has one column major matrix per bone, e.g. from `PoseBatch::palette`, and the weights of each vertex should sum to 1. Normals are transformed by the blended matrix and normalized, which is exact for rotations and uniform scales. Skinned positions and normals are written as 3 packed floats per vertex, which is the layout used by `BVH::build`, so that animated meshes can be raycast.
+	namespace Skinning
+	{
+		/// The number of vertices skinned by each task.
+		const std::size_t CHUNK_SIZE = 2048;
+
+		/// Skin each vertex by transforming it with every influencing bone and summing the weighted results. Used to verify and measure the other kernels.
+		/// @param normals space for 3 floats per vertex, or nullptr to skip normals.
+		/// @throws std::invalid_argument if a vertex references a bone outside the palette.
+		void skin_reference(const float32 * palette, std::size_t bone_count, const VertexP3N3M2B4 * vertices, std::size_t count, float32 * positions, float32 * normals);
+
+		/// Skin each vertex by blending the matrices of its bones and transforming it once, a column per SIMD register. Processors with AVX2 skin 8 vertices at a time instead, a vertex per lane.
+		void skin(const float32 * palette, std::size_t bone_count, const VertexP3N3M2B4 * vertices, std::size_t count, float32 * positions, float32 * normals);
+
+		/// As above, with chunks of `CHUNK_SIZE` vertices distributed across the threads of the pool.
+		void skin(Parallel::Pool & pool, const float32 * palette, std::size_t bone_count, const VertexP3N3M2B4 * vertices, std::size_t count, float32 * positions, float32 * normals);
+	}
+}
@@ -0,0 +1,393 @@
+//
+//  SpatialIndex.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "SpatialIndex.hpp"
+#include "Bounds.hpp"
+#include "Geometry.hpp"
+#include "Instancing.hpp"
+#include "Reader.hpp"
+#include "SceneGraph.hpp"
+#include "Table.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace TaggedFormat
+{
+	namespace SpatialIndex
+	{
+		class InstanceCollector {
+		public:
+			InstanceCollector(Writer & writer, std::vector<SceneInstance> & instances) : _writer(writer), _instances(instances)
+			{
+			}
+
+			void collect(OffsetT offset, const float32 parent[16]) {
+				// Guard against cycles, which would otherwise recurse forever:
+				if (std::find(_path.begin(), _path.end(), offset) != _path.end()) return;
+
+				float32 world[16];
+				multiply_matrices(parent, _writer.block_at_offset<Node>(offset)->transform, world);
+
+				std::vector<OffsetT> references;
+				for (auto & reference : **_writer.block_at_offset<Node>(offset))
+					references.push_back(reference.offset);
+
+				_path.push_back(offset);
+
+				for (auto reference : references) {
+					if (!reference) continue;
+
+					TagT tag = _writer.block_at_offset<Block>(reference)->tag;
+
+					if (tag == Node::TAG)
+						collect(reference, world);
+					else if (tag == GeometryInstance::TAG)
+						add_instance(reference, _writer.block_at_offset<GeometryInstance>(reference)->mesh_offset, 0, world);
+					else if (tag == InstanceBatch::TAG)
+						add_batch(reference, world);
+				}
+
+				_path.pop_back();
+			}
+
+		private:
+			Writer & _writer;
+			std::vector<SceneInstance> & _instances;
+
+			std::vector<OffsetT> _path;
+			std::map<OffsetT, Bounds> _mesh_bounds;
+			std::set<OffsetT> _empty_meshes;
+
+			bool mesh_bounds(OffsetT mesh_offset, Bounds & bounds) {
+				auto existing = _mesh_bounds.find(mesh_offset);
+
+				if (existing != _mesh_bounds.end()) {
+					bounds = existing->second;
+
+					return true;
+				}
+
+				if (_empty_meshes.count(mesh_offset)) return false;
+
+				// Meshes split by `--split-meshes` are tables of parts, bounded by the union of their parts:
+				if (_writer.block_at_offset<Block>(mesh_offset)->tag == OffsetTable::TAG) {
+					std::vector<OffsetT> parts;
+
+					for (auto & entry : **_writer.block_at_offset<OffsetTable>(mesh_offset))
+						parts.push_back(entry.offset);
+
+					bool valid = false;
+
+					for (auto part : parts) {
+						Bounds part_bounds;
+
+						if (!part || _writer.block_at_offset<Block>(part)->tag != Mesh::TAG || !mesh_bounds(part, part_bounds)) continue;
+
+						if (valid)
+							BoundingVolumes::merge(bounds, part_bounds);
+						else
+							bounds = part_bounds;
+
+						valid = true;
+					}
+
+					if (!valid) {
+						_empty_meshes.insert(mesh_offset);
+
+						return false;
+					}
+				} else if (!BoundingVolumes::stored_mesh_bounds(_writer, mesh_offset, bounds)) {
+					OffsetT vertices_offset = _writer.block_at_offset<Mesh>(mesh_offset)->vertices_offset;
+
+					if (!vertices_offset || !BoundingVolumes::compute(read_positions(*_writer.block_at_offset<Block>(vertices_offset)), bounds)) {
+						_empty_meshes.insert(mesh_offset);
+
+						return false;
+					}
+				}
+
+				_mesh_bounds[mesh_offset] = bounds;
+
+				return true;
+			}
+
+			void add_instance(OffsetT instance_offset, OffsetT mesh_offset, uint32_t batch_index, const float32 world[16]) {
+				if (!mesh_offset) return;
+
+				TagT tag = _writer.block_at_offset<Block>(mesh_offset)->tag;
+				if (tag != Mesh::TAG && tag != OffsetTable::TAG) return;
+
+				Bounds local, bounds;
+
+				if (!mesh_bounds(mesh_offset, local)) return;
+
+				BoundingVolumes::transform(local, world, bounds);
+
+				SceneInstance instance;
+				std::copy_n(bounds.minimum, 3, instance.minimum);
+				std::copy_n(bounds.maximum, 3, instance.maximum);
+				std::copy_n(world, 16, instance.transform);
+				instance.instance_offset = instance_offset;
+				instance.batch_index = batch_index;
+
+				_instances.push_back(instance);
+			}
+
+			void add_batch(OffsetT batch_offset, const float32 parent[16]) {
+				OffsetT mesh_offset = _writer.block_at_offset<InstanceBatch>(batch_offset)->mesh_offset;
+				std::size_t count = _writer.block_at_offset<InstanceBatch>(batch_offset)->count();
+
+				for (std::size_t i = 0; i < count; i += 1) {
+					float32 local[16], world[16];
+
+					Instancing::unpack(_writer.block_at_offset<InstanceBatch>(batch_offset)->at(i), local);
+					multiply_matrices(parent, local, world);
+
+					add_instance(batch_offset, mesh_offset, i, world);
+				}
+			}
+		};
+
+		void collect_instances(Writer & writer, OffsetT node_offset, std::vector<SceneInstance> & instances) {
+			const float32 identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+			InstanceCollector collector(writer, instances);
+			collector.collect(node_offset, identity);
+		}
+
+		static OffsetT build_scene_index(Writer & writer, OffsetT node_offset) {
+			std::vector<SceneInstance> instances;
+			collect_instances(writer, node_offset, instances);
+
+			if (instances.empty()) return 0;
+
+			std::vector<float32> boxes;
+			boxes.reserve(instances.size() * 6);
+
+			for (auto & instance : instances) {
+				boxes.insert(boxes.end(), instance.minimum, instance.minimum + 3);
+				boxes.insert(boxes.end(), instance.maximum, instance.maximum + 3);
+			}
+
+			std::vector<BVHNode> nodes;
+			std::vector<uint32_t> order;
+			BVH::build_boxes(boxes, nodes, order);
+
+			auto nodes_block = writer.append<Array<BVHNode>>(Array<BVHNode>::array_size(nodes.size()));
+			std::copy(nodes.begin(), nodes.end(), nodes_block->begin());
+
+			auto instances_block = writer.append<Array<SceneInstance>>(Array<SceneInstance>::array_size(order.size()));
+			for (std::size_t i = 0; i < order.size(); i += 1)
+				instances_block->begin()[i] = instances[order[i]];
+
+			auto index = writer.append<SceneIndex>();
+			index->nodes_offset = nodes_block;
+			index->instances_offset = instances_block;
+
+			return index;
+		}
+
+		void build_scene_indices(Writer & writer, const std::vector<OffsetT> & offsets) {
+			SceneGraph::attach_to_roots(writer, offsets, SceneIndex::TAG, [&](OffsetT node_offset) {
+				return build_scene_index(writer, node_offset);
+			});
+		}
+
+		bool tree_for_node(Reader & reader, const Node * node, Tree & tree) {
+			for (auto & reference : *node) {
+				auto index = reader.block_at_offset<SceneIndex>(reference.offset);
+				if (!index) continue;
+
+				auto nodes = reader.block_at_offset<Array<BVHNode>>(index->nodes_offset);
+				auto instances = reader.block_at_offset<Array<SceneInstance>>(index->instances_offset);
+
+				if (!nodes || !instances || nodes->count() == 0) return false;
+
+				tree.nodes = nodes->begin();
+				tree.node_count = nodes->count();
+				tree.instances = instances->begin();
+				tree.instance_count = instances->count();
+
+				return true;
+			}
+
+			return false;
+		}
+
+		void frustum_from_matrices(const float32 view_matrix[16], const float32 projection_matrix[16], Frustum & frustum) {
+			float32 matrix[16];
+			multiply_matrices(projection_matrix, view_matrix, matrix);
+
+			// Each plane is the sum or difference of the last row and one of the other rows:
+			for (std::size_t axis = 0; axis < 3; axis += 1) {
+				for (std::size_t k = 0; k < 4; k += 1) {
+					frustum.planes[axis * 2][k] = matrix[k * 4 + 3] + matrix[k * 4 + axis];
+					frustum.planes[axis * 2 + 1][k] = matrix[k * 4 + 3] - matrix[k * 4 + axis];
+				}
+			}
+		}
+
+		void frustum_for_camera(const Camera * camera, Frustum & frustum) {
+			frustum_from_matrices(camera->view_matrix, camera->projection_matrix, frustum);
+		}
+
+		// Classify the 4 child boxes of a node against the frustum.
+		// @returns a mask of the children which may intersect, and assigns a mask of those entirely inside.
+		static int classify_frustum(const BVHNode & node, const Frustum & frustum, int & inside) {
+			int outside = 0, partial = 0;
+
+			for (auto & plane : frustum.planes) {
+				// The corner furthest along the normal is the last to leave the plane, and the nearest corner the first:
+				const float32 * far_x = plane[0] >= 0 ? node.maximum_x : node.minimum_x, * near_x = plane[0] >= 0 ? node.minimum_x : node.maximum_x;
+				const float32 * far_y = plane[1] >= 0 ? node.maximum_y : node.minimum_y, * near_y = plane[1] >= 0 ? node.minimum_y : node.maximum_y;
+				const float32 * far_z = plane[2] >= 0 ? node.maximum_z : node.minimum_z, * near_z = plane[2] >= 0 ? node.minimum_z : node.maximum_z;
+
+#if defined(__SSE__)
+				__m128 a = _mm_set1_ps(plane[0]), b = _mm_set1_ps(plane[1]), c = _mm_set1_ps(plane[2]), d = _mm_set1_ps(plane[3]);
+
+				__m128 far = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, _mm_loadu_ps(far_x)), _mm_mul_ps(b, _mm_loadu_ps(far_y))), _mm_add_ps(_mm_mul_ps(c, _mm_loadu_ps(far_z)), d));
+				__m128 near = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, _mm_loadu_ps(near_x)), _mm_mul_ps(b, _mm_loadu_ps(near_y))), _mm_add_ps(_mm_mul_ps(c, _mm_loadu_ps(near_z)), d));
+
+				outside |= _mm_movemask_ps(_mm_cmplt_ps(far, _mm_setzero_ps()));
+				partial |= _mm_movemask_ps(_mm_cmplt_ps(near, _mm_setzero_ps()));
+#else
+				for (std::size_t i = 0; i < 4; i += 1) {
+					if (plane[0] * far_x[i] + plane[1] * far_y[i] + plane[2] * far_z[i] + plane[3] < 0) outside |= 1 << i;
+					if (plane[0] * near_x[i] + plane[1] * near_y[i] + plane[2] * near_z[i] + plane[3] < 0) partial |= 1 << i;
+				}
+#endif
+			}
+
+			inside = ~(outside | partial) & 0xF;
+
+			return ~outside & 0xF;
+		}
+
+		static bool intersects_frustum(const SceneInstance & instance, const Frustum & frustum) {
+			for (auto & plane : frustum.planes) {
+				float32 x = plane[0] >= 0 ? instance.maximum[0] : instance.minimum[0];
+				float32 y = plane[1] >= 0 ? instance.maximum[1] : instance.minimum[1];
+				float32 z = plane[2] >= 0 ? instance.maximum[2] : instance.minimum[2];
+
+				if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0) return false;
+			}
+
+			return true;
+		}
+
+		static int classify_box(const BVHNode & node, const float32 minimum[3], const float32 maximum[3], int & inside) {
+#if defined(__SSE__)
+			__m128 overlap = _mm_and_ps(
+				_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node.minimum_x), _mm_set1_ps(maximum[0])), _mm_cmpge_ps(_mm_loadu_ps(node.maximum_x), _mm_set1_ps(minimum[0]))),
+				_mm_and_ps(
+					_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node.minimum_y), _mm_set1_ps(maximum[1])), _mm_cmpge_ps(_mm_loadu_ps(node.maximum_y), _mm_set1_ps(minimum[1]))),
+					_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node.minimum_z), _mm_set1_ps(maximum[2])), _mm_cmpge_ps(_mm_loadu_ps(node.maximum_z), _mm_set1_ps(minimum[2])))
+				)
+			);
+
+			__m128 contained = _mm_and_ps(
+				_mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(node.minimum_x), _mm_set1_ps(minimum[0])), _mm_cmple_ps(_mm_loadu_ps(node.maximum_x), _mm_set1_ps(maximum[0]))),
+				_mm_and_ps(
+					_mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(node.minimum_y), _mm_set1_ps(minimum[1])), _mm_cmple_ps(_mm_loadu_ps(node.maximum_y), _mm_set1_ps(maximum[1]))),
+					_mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(node.minimum_z), _mm_set1_ps(minimum[2])), _mm_cmple_ps(_mm_loadu_ps(node.maximum_z), _mm_set1_ps(maximum[2])))
+				)
+			);
+
+			inside = _mm_movemask_ps(contained);
+
+			return _mm_movemask_ps(overlap);
+#else
+			int mask = 0;
+			inside = 0;
+
+			for (std::size_t i = 0; i < 4; i += 1) {
+				if (node.minimum_x[i] <= maximum[0] && node.maximum_x[i] >= minimum[0] && node.minimum_y[i] <= maximum[1] && node.maximum_y[i] >= minimum[1] && node.minimum_z[i] <= maximum[2] && node.maximum_z[i] >= minimum[2])
+					mask |= 1 << i;
+
+				if (node.minimum_x[i] >= minimum[0] && node.maximum_x[i] <= maximum[0] && node.minimum_y[i] >= minimum[1] && node.maximum_y[i] <= maximum[1] && node.minimum_z[i] >= minimum[2] && node.maximum_z[i] <= maximum[2])
+					inside |= 1 << i;
+			}
+
+			return mask;
+#endif
+		}
+
+		static bool overlaps_box(const SceneInstance & instance, const float32 minimum[3], const float32 maximum[3]) {
+			for (std::size_t k = 0; k < 3; k += 1) {
+				if (instance.minimum[k] > maximum[k] || instance.maximum[k] < minimum[k]) return false;
+			}
+
+			return true;
+		}
+
+		// Visit the tree, testing children with `classify` and the instances of partially contained leaves with `accept`. Everything below a child which is entirely inside is appended without further tests.
+		template <typename ClassifyT, typename AcceptT>
+		static void query(const Tree & tree, ClassifyT && classify, AcceptT && accept, std::vector<const SceneInstance *> & instances) {
+			if (tree.node_count == 0) return;
+
+			std::vector<std::pair<uint32_t, bool>> stack{{0, false}};
+
+			// Each node is visited at most once in a valid tree:
+			std::size_t visits = 0;
+
+			while (!stack.empty() && visits < tree.node_count) {
+				auto entry = stack.back();
+				stack.pop_back();
+
+				if (entry.first >= tree.node_count) continue;
+				visits += 1;
+
+				const BVHNode & node = tree.nodes[entry.first];
+
+				int inside = 0xF, mask = 0xF;
+
+				if (!entry.second)
+					mask = classify(node, inside);
+
+				for (std::size_t i = 0; i < 4; i += 1) {
+					if (!(mask & (1 << i)) || node.children[i] == BVHNode::EMPTY) continue;
+
+					bool contained = (inside & (1 << i)) != 0;
+
+					if (node.counts[i]) {
+						std::size_t first = node.children[i], last = std::min<std::size_t>(first + node.counts[i], tree.instance_count);
+
+						for (std::size_t j = first; j < last; j += 1) {
+							if (contained || accept(tree.instances[j]))
+								instances.push_back(tree.instances + j);
+						}
+					} else {
+						stack.push_back({node.children[i], contained});
+					}
+				}
+			}
+		}
+
+		void visible_instances(const Tree & tree, const Frustum & frustum, std::vector<const SceneInstance *> & instances) {
+			query(tree, [&](const BVHNode & node, int & inside) {
+				return classify_frustum(node, frustum, inside);
+			}, [&](const SceneInstance & instance) {
+				return intersects_frustum(instance, frustum);
+			}, instances);
+		}
+
+		void instances_in_box(const Tree & tree, const float32 minimum[3], const float32 maximum[3], std::vector<const SceneInstance *> & instances) {
+			query(tree, [&](const BVHNode & node, int & inside) {
+				return classify_box(node, minimum, maximum, inside);
+			}, [&](const SceneInstance & instance) {
+				return overlaps_box(instance, minimum, maximum);
+			}, instances);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+//
+//  SpatialIndex.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "BVH.hpp"
+#include "Camera.hpp"
+#include "Scene.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	class Reader;
+
+	/// A geometry instance placed in world space by the nodes above it.
+	struct SceneInstance {
+		static const TagT TAG = tag_from_identifier("SINS");
+
+		/// The world space bounds of the mesh.
+		float32 minimum[3], maximum[3];
+
+		/// The column major world transform.
+		float32 transform[16];
+
+		/// The `GeometryInstance` or `InstanceBatch`. It appears once for every path to it through the node hierarchy, and a batch once for each of its instances.
+		OffsetT instance_offset;
+
+		/// The index of the instance within an `InstanceBatch`, or 0 for a `GeometryInstance`.
+		uint32_t batch_index;
+	};
+
+	/// A bounding volume hierarchy over the geometry instances of a node hierarchy, stored as one of the references of the root node.
+	struct SceneIndex : public Block {
+		static const TagT TAG = tag_from_identifier("SIDX");
+
+		/// An `Array<BVHNode>`, where leaves refer to ranges of instances.
+		OffsetT nodes_offset;
+
+		/// An `Array<SceneInstance>`, ordered so that every leaf is a contiguous range.
+		OffsetT instances_offset;
+	};
+
+	/// Spatial indexing of scenes at conversion time, and visibility queries which run directly over the stored blocks.
+	namespace SpatialIndex
+	{
+		/// Collect the geometry instances below a node in world space, including each instance of an `InstanceBatch`. Mesh bounds are taken from the mesh metadata if present, or computed from the vertices otherwise.
+		void collect_instances(Writer & writer, OffsetT node_offset, std::vector<SceneInstance> & instances);
+
+		/// Build an index for every root node within `offsets`, i.e. every node which is not a child of another node. Root nodes are replaced by a copy with an additional reference to their index, and all references to the original nodes within `offsets` and the header are updated.
+		void build_scene_indices(Writer & writer, const std::vector<OffsetT> & offsets);
+
+		/// A view of a stored index.
+		struct Tree {
+			const BVHNode * nodes = nullptr;
+			std::size_t node_count = 0;
+
+			const SceneInstance * instances = nullptr;
+			std::size_t instance_count = 0;
+		};
+
+		/// @returns true if the node has a valid index, which is assigned to the tree.
+		bool tree_for_node(Reader & reader, const Node * node, Tree & tree);
+
+		/// Six planes `a*x + b*y + c*z + d >= 0` which contain the view volume.
+		struct Frustum {
+			float32 planes[6][4];
+		};
+
+		/// Extract the frustum planes from column major view and projection matrices (Gribb and Hartmann, 2001). Clip space depth is assumed to be from -w to w, which also contains the volume of projections with depth from 0 to w.
+		void frustum_from_matrices(const float32 view_matrix[16], const float32 projection_matrix[16], Frustum & frustum);
+
+		void frustum_for_camera(const Camera * camera, Frustum & frustum);
+
+		/// Append the instances whose bounds intersect the frustum. Boxes outside the frustum but near its edges may be included.
+		void visible_instances(const Tree & tree, const Frustum & frustum, std::vector<const SceneInstance *> & instances);
+
+		/// Append the instances whose bounds overlap the given box.
+		void instances_in_box(const Tree & tree, const float32 minimum[3], const float32 maximum[3], std::vector<const SceneInstance *> & instances);
+	}
+}
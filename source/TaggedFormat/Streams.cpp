@@ -0,0 +1,276 @@
+//
+//  Streams.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Streams.hpp"
+#include "Geometry.hpp"
+#include "Reader.hpp"
+
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace TaggedFormat
+{
+	std::string VertexStream::name_for_attribute(Attribute attribute) {
+		switch (attribute) {
+			case Attribute::POSITION:
+				return "position";
+
+			case Attribute::NORMAL:
+				return "normal";
+
+			case Attribute::MAPPING:
+				return "mapping";
+
+			case Attribute::COLOR:
+				return "color";
+
+			case Attribute::BONES:
+				return "bones";
+
+			case Attribute::WEIGHTS:
+				return "weights";
+
+			case Attribute::TANGENT:
+				return "tangent";
+
+			default:
+				return "unspecified/unknown";
+		}
+	}
+
+	namespace Streams
+	{
+		// Every vertex type is a sequence of 32-bit words; an attribute is a range of those words.
+		struct AttributeLayout {
+			VertexStream::Attribute attribute;
+			std::size_t first, components;
+		};
+
+		static std::vector<AttributeLayout> attributes_for_tag(TagT tag) {
+			typedef VertexStream::Attribute A;
+
+			switch (tag) {
+				case VertexP2::TAG:
+					return {{A::POSITION, 0, 2}};
+
+				case VertexP2C4::TAG:
+					return {{A::POSITION, 0, 2}, {A::COLOR, 2, 4}};
+
+				case VertexP3::TAG:
+					return {{A::POSITION, 0, 3}};
+
+				case VertexP3N3::TAG:
+					return {{A::POSITION, 0, 3}, {A::NORMAL, 3, 3}};
+
+				case VertexP3N3M2::TAG:
+					return {{A::POSITION, 0, 3}, {A::NORMAL, 3, 3}, {A::MAPPING, 6, 2}};
+
+				case VertexP3N3M2C4::TAG:
+					return {{A::POSITION, 0, 3}, {A::NORMAL, 3, 3}, {A::MAPPING, 6, 2}, {A::COLOR, 8, 4}};
+
+				case VertexP3N3M2B4::TAG:
+					return {{A::POSITION, 0, 3}, {A::NORMAL, 3, 3}, {A::MAPPING, 6, 2}, {A::BONES, 8, 1}, {A::WEIGHTS, 9, 4}};
+
+				case VertexP3N3M2T4::TAG:
+					return {{A::POSITION, 0, 3}, {A::NORMAL, 3, 3}, {A::MAPPING, 6, 2}, {A::TANGENT, 8, 4}};
+
+				default:
+					return {};
+			}
+		}
+
+		static std::size_t plane_size_for_count(std::size_t count) {
+			return (count + 3) & ~std::size_t(3);
+		}
+
+		// Copy word `w` of each of `count` vertices into `planes[w]`. Groups of 4 words by 4 vertices are transposed in registers.
+		static void deinterleave_words(const uint32_t * vertices, std::size_t words, std::size_t count, uint32_t * const * planes) {
+			std::size_t i = 0;
+
+#if defined(__SSE2__)
+			for (; i + 4 <= count; i += 4) {
+				const float * row = reinterpret_cast<const float *>(vertices + i * words);
+				std::size_t w = 0;
+
+				for (; w + 4 <= words; w += 4) {
+					__m128 r0 = _mm_loadu_ps(row + w);
+					__m128 r1 = _mm_loadu_ps(row + words + w);
+					__m128 r2 = _mm_loadu_ps(row + 2 * words + w);
+					__m128 r3 = _mm_loadu_ps(row + 3 * words + w);
+
+					_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+					_mm_storeu_ps(reinterpret_cast<float *>(planes[w] + i), r0);
+					_mm_storeu_ps(reinterpret_cast<float *>(planes[w+1] + i), r1);
+					_mm_storeu_ps(reinterpret_cast<float *>(planes[w+2] + i), r2);
+					_mm_storeu_ps(reinterpret_cast<float *>(planes[w+3] + i), r3);
+				}
+
+				for (; w < words; w += 1) {
+					for (std::size_t j = 0; j < 4; j += 1)
+						planes[w][i+j] = vertices[(i+j) * words + w];
+				}
+			}
+#endif
+
+			for (; i < count; i += 1) {
+				for (std::size_t w = 0; w < words; w += 1)
+					planes[w][i] = vertices[i * words + w];
+			}
+		}
+
+		// The inverse of `deinterleave_words`, writing only the given range of words of each vertex.
+		static void interleave_words(const uint32_t * const * planes, std::size_t first, std::size_t components, std::size_t count, uint32_t * vertices, std::size_t words) {
+			std::size_t i = 0;
+
+#if defined(__SSE2__)
+			for (; i + 4 <= count; i += 4) {
+				float * row = reinterpret_cast<float *>(vertices + i * words + first);
+				std::size_t c = 0;
+
+				for (; c + 4 <= components; c += 4) {
+					__m128 r0 = _mm_loadu_ps(reinterpret_cast<const float *>(planes[c] + i));
+					__m128 r1 = _mm_loadu_ps(reinterpret_cast<const float *>(planes[c+1] + i));
+					__m128 r2 = _mm_loadu_ps(reinterpret_cast<const float *>(planes[c+2] + i));
+					__m128 r3 = _mm_loadu_ps(reinterpret_cast<const float *>(planes[c+3] + i));
+
+					_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+					_mm_storeu_ps(row + c, r0);
+					_mm_storeu_ps(row + words + c, r1);
+					_mm_storeu_ps(row + 2 * words + c, r2);
+					_mm_storeu_ps(row + 3 * words + c, r3);
+				}
+
+				for (; c < components; c += 1) {
+					for (std::size_t j = 0; j < 4; j += 1)
+						vertices[(i+j) * words + first + c] = planes[c][i+j];
+				}
+			}
+#endif
+
+			for (; i < count; i += 1) {
+				for (std::size_t c = 0; c < components; c += 1)
+					vertices[i * words + first + c] = planes[c][i];
+			}
+		}
+
+		OffsetT deinterleave(Writer & writer, OffsetT vertices_offset) {
+			auto block = writer.block_at_offset<Block>(vertices_offset);
+			TagT tag = block->tag;
+
+			auto attributes = attributes_for_tag(tag);
+			std::size_t vertex_size = vertex_size_for_tag(tag);
+
+			if (attributes.empty() || vertex_size % sizeof(uint32_t) != 0)
+				return 0;
+
+			std::size_t count = vertex_count(*block);
+			std::size_t words = vertex_size / sizeof(uint32_t);
+			std::size_t plane_size = plane_size_for_count(count);
+
+			// Transpose into temporary planes, as appending streams may move the vertex array:
+			std::vector<uint32_t> data(words * plane_size, 0);
+			std::vector<uint32_t *> planes(words);
+
+			for (std::size_t w = 0; w < words; w += 1)
+				planes[w] = data.data() + w * plane_size;
+
+			auto vertices = reinterpret_cast<const uint32_t *>(reinterpret_cast<const Byte *>(*block) + sizeof(Block));
+			deinterleave_words(vertices, words, count, planes.data());
+
+			std::vector<OffsetT> stream_offsets;
+
+			for (auto & layout : attributes) {
+				writer.align(VertexStream::ALIGNMENT);
+
+				auto stream = writer.append<VertexStream>(layout.components * plane_size * sizeof(uint32_t));
+				stream->attribute = layout.attribute;
+				stream->components = static_cast<uint32_t>(layout.components);
+				stream->reserved = 0;
+				stream->plane_size = plane_size;
+
+				std::memcpy(stream->plane(0), planes[layout.first], layout.components * plane_size * sizeof(uint32_t));
+
+				stream_offsets.push_back(stream);
+			}
+
+			auto streams = writer.append<VertexStreams>(VertexStreams::array_size(stream_offsets.size()));
+			streams->vertex_tag = tag;
+			streams->vertex_count = count;
+
+			for (std::size_t i = 0; i < stream_offsets.size(); i += 1)
+				streams->begin()[i].offset = stream_offsets[i];
+
+			return streams;
+		}
+
+		// The stream has the expected layout, and room for every vertex:
+		static bool stream_fits(const VertexStream * stream, std::size_t components, std::size_t count) {
+			if (!stream || stream->components != components || stream->plane_size < count)
+				return false;
+
+			// Divided rather than multiplied, since the sizes come from the file and could overflow:
+			return stream->size >= sizeof(VertexStream) && (stream->size - sizeof(VertexStream)) / (components * sizeof(uint32_t)) >= stream->plane_size;
+		}
+
+		std::size_t interleaved_size(Reader & reader, const VertexStreams * streams) {
+			auto attributes = attributes_for_tag(streams->vertex_tag);
+			std::size_t vertex_size = vertex_size_for_tag(streams->vertex_tag);
+			std::size_t count = streams->vertex_count;
+
+			if (attributes.empty() || vertex_size % sizeof(uint32_t) != 0)
+				return 0;
+
+			for (auto & layout : attributes) {
+				if (!stream_fits(stream_for_attribute(reader, streams, layout.attribute), layout.components, count))
+					return 0;
+			}
+
+			return sizeof(Block) + vertex_size * count;
+		}
+
+		void interleave(Reader & reader, const VertexStreams * streams, Byte * output) {
+			std::size_t count = streams->vertex_count;
+			std::size_t words = vertex_size_for_tag(streams->vertex_tag) / sizeof(uint32_t);
+
+			auto block = reinterpret_cast<Block *>(output);
+			block->tag = streams->vertex_tag;
+			block->size = sizeof(Block) + words * sizeof(uint32_t) * count;
+
+			auto vertices = reinterpret_cast<uint32_t *>(output + sizeof(Block));
+			std::memset(vertices, 0, block->size - sizeof(Block));
+
+			// Every stream was checked by interleaved_size:
+			for (auto & layout : attributes_for_tag(streams->vertex_tag)) {
+				auto stream = stream_for_attribute(reader, streams, layout.attribute);
+
+				std::vector<const uint32_t *> planes(layout.components);
+
+				for (std::size_t c = 0; c < layout.components; c += 1)
+					planes[c] = reinterpret_cast<const uint32_t *>(stream->plane(c));
+
+				interleave_words(planes.data(), layout.first, layout.components, count, vertices, words);
+			}
+		}
+
+		const VertexStream * stream_for_attribute(Reader & reader, const VertexStreams * streams, VertexStream::Attribute attribute) {
+			for (auto & reference : *streams) {
+				auto stream = reader.block_at_offset<VertexStream>(reference.offset);
+
+				if (stream && stream->attribute == attribute)
+					return stream;
+			}
+
+			return nullptr;
+		}
+	}
+}
@@ -0,0 +1,87 @@
+//
+//  Streams.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Block.hpp"
+#include "Writer.hpp"
+
+namespace TaggedFormat
+{
+	class Reader;
+
+	/// A single vertex attribute stored as planes, one per component, e.g. all x coordinates followed by all y coordinates. Each plane is padded to a multiple of 4 elements, and the block is aligned so that planes start on a 16 byte boundary.
+	struct VertexStream : public Block {
+		static const TagT TAG = tag_from_identifier("STRM");
+
+		/// The alignment of the block within the file.
+		static const std::size_t ALIGNMENT = 16;
+
+		enum class Attribute : uint32_t {
+			POSITION = 0,
+			NORMAL = 1,
+			MAPPING = 2,
+			COLOR = 3,
+			/// Bone indices, stored as a single component of 4 packed `BoneID`s.
+			BONES = 4,
+			WEIGHTS = 5,
+			/// The tangent and the sign of the bitangent.
+			TANGENT = 6
+		};
+
+		Aligned<Attribute>::TypeT attribute;
+
+		/// The number of components, e.g. 3 for positions.
+		uint32_t components;
+
+		/// Unused, keeps the planes aligned to 16 bytes.
+		uint32_t reserved;
+
+		/// The number of elements in each plane, including padding.
+		OffsetT plane_size;
+
+		/// The planes of 32-bit components which follow this structure.
+		const float32 * plane(std::size_t component) const {
+			return reinterpret_cast<const float32 *>(reinterpret_cast<const Byte *>(this) + sizeof(VertexStream)) + component * plane_size;
+		}
+
+		float32 * plane(std::size_t component) {
+			return reinterpret_cast<float32 *>(reinterpret_cast<Byte *>(this) + sizeof(VertexStream)) + component * plane_size;
+		}
+
+		static std::string name_for_attribute(Attribute attribute);
+	};
+
+	/// A structure of arrays representation of a vertex array, which can be referenced by `Mesh::vertices_offset` in place of an interleaved array. Contains references to one `VertexStream` per attribute.
+	struct VertexStreams : public Array<Reference, VertexStreams> {
+		static const TagT TAG = tag_from_identifier("SOAV");
+
+		/// The tag of the equivalent interleaved vertex array.
+		TagT vertex_tag;
+
+		/// The number of vertices.
+		OffsetT vertex_count;
+	};
+
+	namespace Streams
+	{
+		/// Convert an interleaved vertex array into vertex streams.
+		/// @returns the offset of the new `VertexStreams` block, or 0 if the block is not a known vertex array.
+		OffsetT deinterleave(Writer & writer, OffsetT vertices_offset);
+
+		/// The vertex count comes from the file, so every stream is checked before the interleaved array is allocated.
+		/// @returns the size of the equivalent interleaved array block, including the block header, or 0 if the vertex type is unknown or a stream is missing or too small for the vertex count.
+		std::size_t interleaved_size(Reader & reader, const VertexStreams * streams);
+
+		/// Convert vertex streams back into an interleaved array block, which must have space for `interleaved_size()` bytes, which must not be 0.
+		void interleave(Reader & reader, const VertexStreams * streams, Byte * output);
+
+		/// @returns the stream for the given attribute, or nullptr if there is none.
+		const VertexStream * stream_for_attribute(Reader & reader, const VertexStreams * streams, VertexStream::Attribute attribute);
+	}
+}
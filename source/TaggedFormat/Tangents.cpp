@@ -0,0 +1,236 @@
+//
+//  Tangents.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Tangents.hpp"
+#include "Geometry.hpp"
+#include "Parallel.hpp"
+#include "Topology.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace TaggedFormat
+{
+	namespace Tangents
+	{
+		static float32 dot(const float32 a[3], const float32 b[3]) {
+			return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+		}
+
+		// @returns the length of the vector before it was normalized, or 0 if it was left unchanged:
+		static float32 normalize(float32 v[3]) {
+			float32 length = std::sqrt(dot(v, v));
+
+			if (!(length > 0) || !std::isfinite(length)) return 0;
+
+			for (std::size_t k = 0; k < 3; k += 1) v[k] /= length;
+
+			return length;
+		}
+
+		// Remove the component of `v` along the unit vector `n`:
+		static void project(float32 v[3], const float32 n[3]) {
+			float32 d = dot(v, n);
+
+			for (std::size_t k = 0; k < 3; k += 1) v[k] -= n[k] * d;
+		}
+
+		// The unit tangent and bitangent of a triangle, which are zero if its texture coordinates are degenerate, and the angle at each corner:
+		struct Face {
+			float32 tangent[3], bitangent[3];
+			float32 angles[3];
+		};
+
+		static float32 corner_angle(const float32 a[3], const float32 b[3], const float32 c[3]) {
+			float32 u[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+			float32 v[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+
+			if (!normalize(u) || !normalize(v)) return 0;
+
+			return std::acos(std::max<float32>(-1, std::min<float32>(1, dot(u, v))));
+		}
+
+		static Face face_for_triangle(const VertexP3N3M2 & a, const VertexP3N3M2 & b, const VertexP3N3M2 & c) {
+			Face face;
+
+			float32 e1[3] = {b.position[0] - a.position[0], b.position[1] - a.position[1], b.position[2] - a.position[2]};
+			float32 e2[3] = {c.position[0] - a.position[0], c.position[1] - a.position[1], c.position[2] - a.position[2]};
+
+			float32 du1 = b.mapping[0] - a.mapping[0], dv1 = b.mapping[1] - a.mapping[1];
+			float32 du2 = c.mapping[0] - a.mapping[0], dv2 = c.mapping[1] - a.mapping[1];
+
+			// Only the direction matters, so the determinant of the mapping is reduced to its sign:
+			float32 r = du1 * dv2 - du2 * dv1;
+			float32 sign = r > 0 ? 1 : (r < 0 ? -1 : 0);
+
+			for (std::size_t k = 0; k < 3; k += 1) {
+				face.tangent[k] = (e1[k] * dv2 - e2[k] * dv1) * sign;
+				face.bitangent[k] = (e2[k] * du1 - e1[k] * du2) * sign;
+			}
+
+			if (!normalize(face.tangent)) std::fill_n(face.tangent, 3, 0);
+			if (!normalize(face.bitangent)) std::fill_n(face.bitangent, 3, 0);
+
+			face.angles[0] = corner_angle(a.position, b.position, c.position);
+			face.angles[1] = corner_angle(b.position, c.position, a.position);
+			face.angles[2] = corner_angle(c.position, a.position, b.position);
+
+			return face;
+		}
+
+		// Any unit vector perpendicular to the unit normal, for vertices whose triangles don't define a tangent:
+		static void perpendicular(const float32 normal[3], float32 tangent[3]) {
+			std::size_t axis = 0;
+
+			for (std::size_t k = 1; k < 3; k += 1) {
+				if (std::abs(normal[k]) < std::abs(normal[axis])) axis = k;
+			}
+
+			std::fill_n(tangent, 3, 0);
+			tangent[axis] = 1;
+
+			project(tangent, normal);
+
+			if (!normalize(tangent)) {
+				std::fill_n(tangent, 3, 0);
+				tangent[0] = 1;
+			}
+		}
+
+		std::vector<float32> generate_tangents(const std::vector<VertexP3N3M2> & vertices, const std::vector<uint32_t> & triangles) {
+			std::size_t vertex_count = vertices.size(), triangle_count = triangles.size() / 3;
+
+			// The corners of the triangles using each vertex, in order of triangles, which fixes the order of accumulation:
+			std::vector<uint32_t> starts(vertex_count + 1, 0), corners(triangle_count * 3);
+
+			for (std::size_t i = 0; i < triangle_count * 3; i += 1) {
+				if (triangles[i] >= vertex_count)
+					throw std::invalid_argument("Triangle references a vertex beyond the vertex array!");
+
+				starts[triangles[i] + 1] += 1;
+			}
+
+			for (std::size_t v = 0; v < vertex_count; v += 1)
+				starts[v + 1] += starts[v];
+
+			{
+				std::vector<uint32_t> cursors(starts.begin(), starts.end() - 1);
+
+				for (std::size_t i = 0; i < triangle_count * 3; i += 1)
+					corners[cursors[triangles[i]]++] = i;
+			}
+
+			std::vector<Face> faces(triangle_count);
+
+			Parallel::each((triangle_count + CHUNK_SIZE - 1) / CHUNK_SIZE, [&](std::size_t chunk) {
+				std::size_t last = std::min(triangle_count, (chunk + 1) * CHUNK_SIZE);
+
+				for (std::size_t t = chunk * CHUNK_SIZE; t < last; t += 1)
+					faces[t] = face_for_triangle(vertices[triangles[t * 3]], vertices[triangles[t * 3 + 1]], vertices[triangles[t * 3 + 2]]);
+			});
+
+			std::vector<float32> tangents(vertex_count * 4);
+
+			Parallel::each((vertex_count + CHUNK_SIZE - 1) / CHUNK_SIZE, [&](std::size_t chunk) {
+				std::size_t last = std::min(vertex_count, (chunk + 1) * CHUNK_SIZE);
+
+				for (std::size_t v = chunk * CHUNK_SIZE; v < last; v += 1) {
+					float32 normal[3] = {vertices[v].normal[0], vertices[v].normal[1], vertices[v].normal[2]};
+					normalize(normal);
+
+					float32 tangent[3] = {0, 0, 0}, bitangent[3] = {0, 0, 0};
+
+					for (std::size_t i = starts[v]; i < starts[v + 1]; i += 1) {
+						const Face & face = faces[corners[i] / 3];
+						float32 angle = face.angles[corners[i] % 3];
+
+						float32 face_tangent[3] = {face.tangent[0], face.tangent[1], face.tangent[2]};
+						float32 face_bitangent[3] = {face.bitangent[0], face.bitangent[1], face.bitangent[2]};
+
+						project(face_tangent, normal);
+						project(face_bitangent, normal);
+
+						if (normalize(face_tangent)) {
+							for (std::size_t k = 0; k < 3; k += 1) tangent[k] += face_tangent[k] * angle;
+						}
+
+						if (normalize(face_bitangent)) {
+							for (std::size_t k = 0; k < 3; k += 1) bitangent[k] += face_bitangent[k] * angle;
+						}
+					}
+
+					// Accumulated tangents are in the plane of the normal, so only need to be normalized:
+					if (!normalize(tangent))
+						perpendicular(normal, tangent);
+
+					float32 side[3] = {
+						normal[1] * tangent[2] - normal[2] * tangent[1],
+						normal[2] * tangent[0] - normal[0] * tangent[2],
+						normal[0] * tangent[1] - normal[1] * tangent[0],
+					};
+
+					float32 * output = &tangents[v * 4];
+					std::copy_n(tangent, 3, output);
+					output[3] = dot(side, bitangent) < 0 ? -1 : 1;
+				}
+			});
+
+			return tangents;
+		}
+
+		bool generate_mesh_tangents(Writer & writer, OffsetT mesh_offset) {
+			auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+
+			if (!mesh->vertices_offset) return false;
+
+			TagT vertex_tag = writer.block_at_offset<Block>(mesh->vertices_offset)->tag;
+
+			if (vertex_tag != VertexP3N3M2::TAG && vertex_tag != VertexP3N3M2T4::TAG) return false;
+
+			std::vector<VertexP3N3M2> vertices;
+			auto block = writer.block_at_offset<Block>(mesh->vertices_offset);
+
+			if (vertex_tag == VertexP3N3M2::TAG)
+				vertices.assign(static_cast<Array<VertexP3N3M2> *>(*block)->begin(), static_cast<Array<VertexP3N3M2> *>(*block)->end());
+			else
+				vertices.assign(static_cast<Array<VertexP3N3M2T4> *>(*block)->begin(), static_cast<Array<VertexP3N3M2T4> *>(*block)->end());
+
+			std::vector<uint32_t> triangles;
+
+			if (mesh->indices_offset) {
+				if (mesh->layout == Mesh::Layout::TRIANGLES)
+					triangles = read_indices(*writer.block_at_offset<Block>(mesh->indices_offset));
+				else if (mesh->layout == Mesh::Layout::TRIANGLE_STRIP)
+					triangles = Topology::triangles_from_strip(read_indices(*writer.block_at_offset<Block>(mesh->indices_offset)));
+				else
+					return false;
+			} else if (mesh->layout == Mesh::Layout::TRIANGLES) {
+				for (std::size_t i = 0; i < vertices.size(); i += 1) triangles.push_back(i);
+			} else {
+				return false;
+			}
+
+			auto tangents = generate_tangents(vertices, triangles);
+
+			auto array = writer.append<Array<VertexP3N3M2T4>>(Array<VertexP3N3M2T4>::array_size(vertices.size()));
+
+			for (std::size_t i = 0; i < vertices.size(); i += 1) {
+				VertexP3N3M2T4 & vertex = array->begin()[i];
+
+				static_cast<VertexP3N3M2 &>(vertex) = vertices[i];
+				std::copy_n(&tangents[i * 4], 4, vertex.tangent);
+			}
+
+			OffsetT vertices_offset = array;
+			writer.block_at_offset<Mesh>(mesh_offset)->vertices_offset = vertices_offset;
+
+			return true;
+		}
+	}
+}
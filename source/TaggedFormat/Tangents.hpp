@@ -0,0 +1,33 @@
+//
+//  Tangents.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// Generation of tangent frames for normal mapping at conversion time, so that they don't need to be computed when loading.
+	namespace Tangents
+	{
+		/// The number of triangles or vertices processed by one thread at a time.
+		const std::size_t CHUNK_SIZE = 4096;
+
+		/// Compute the tangent frame of every vertex from the triangles which use it, similar to MikkTSpace: the tangent and bitangent of each triangle are projected into the plane of the vertex normal and weighted by the angle of the triangle at the vertex. Triangles are processed in parallel, and each vertex sums its triangles in order, so the result doesn't depend on the number of threads. Vertices without usable texture coordinates get an arbitrary tangent perpendicular to their normal.
+		/// @param triangles a triangle list indexing `vertices`.
+		/// @returns the tangent of every vertex as in `VertexP3N3M2T4`, 4 components per vertex.
+		std::vector<float32> generate_tangents(const std::vector<VertexP3N3M2> & vertices, const std::vector<uint32_t> & triangles);
+
+		/// Replace the vertex array of a triangle list or strip with `VertexP3N3M2` or `VertexP3N3M2T4` vertices by an array of `VertexP3N3M2T4` with generated tangents. The order of vertices is unchanged.
+		/// @returns true if the mesh was updated.
+		bool generate_mesh_tangents(Writer & writer, OffsetT mesh_offset);
+	}
+}
@@ -0,0 +1,245 @@
+//
+//  Topology.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Topology.hpp"
+#include "Geometry.hpp"
+#include "Table.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace TaggedFormat
+{
+	namespace Topology
+	{
+		std::vector<uint32_t> triangles_from_strip(const std::vector<uint32_t> & strip) {
+			std::vector<uint32_t> triangles;
+
+			for (std::size_t i = 0; i + 2 < strip.size(); i += 1) {
+				uint32_t a = strip[i], b = strip[i+1], c = strip[i+2];
+
+				if (a == b || b == c || c == a) continue;
+
+				// Every second triangle in a strip has reversed winding:
+				if (i & 1)
+					triangles.insert(triangles.end(), {b, a, c});
+				else
+					triangles.insert(triangles.end(), {a, b, c});
+			}
+
+			return triangles;
+		}
+
+		static uint64_t edge_key(uint32_t a, uint32_t b) {
+			return (static_cast<uint64_t>(a) << 32) | b;
+		}
+
+		std::vector<uint32_t> strip_from_triangles(const std::vector<uint32_t> & triangles) {
+			std::size_t triangle_count = triangles.size() / 3;
+
+			// Map each directed edge to the triangles which contain it, and the vertex opposite:
+			std::unordered_multimap<uint64_t, uint32_t> edges;
+			for (std::size_t t = 0; t < triangle_count; t += 1) {
+				const uint32_t * triangle = &triangles[t * 3];
+
+				for (std::size_t j = 0; j < 3; j += 1) {
+					edges.emplace(edge_key(triangle[j], triangle[(j+1) % 3]), t);
+				}
+			}
+
+			std::vector<bool> emitted(triangle_count, false);
+			std::vector<uint32_t> output, strip;
+
+			// Find an unemitted triangle containing the directed edge, and return the opposite vertex:
+			auto take = [&](uint32_t a, uint32_t b, uint32_t & opposite) {
+				auto range = edges.equal_range(edge_key(a, b));
+
+				for (auto i = range.first; i != range.second; ++i) {
+					uint32_t t = i->second;
+					if (emitted[t]) continue;
+
+					const uint32_t * triangle = &triangles[t * 3];
+					for (std::size_t j = 0; j < 3; j += 1) {
+						if (triangle[j] != a && triangle[j] != b) {
+							emitted[t] = true;
+							opposite = triangle[j];
+
+							return true;
+						}
+					}
+				}
+
+				return false;
+			};
+
+			for (std::size_t t = 0; t < triangle_count; t += 1) {
+				if (emitted[t]) continue;
+				emitted[t] = true;
+
+				strip.assign(&triangles[t * 3], &triangles[t * 3] + 3);
+
+				while (true) {
+					std::size_t n = strip.size();
+					uint32_t p = strip[n-2], q = strip[n-1], r;
+
+					// The next triangle is (p, q, r) at even positions and (q, p, r) at odd positions:
+					bool found = ((n - 2) & 1) ? take(q, p, r) : take(p, q, r);
+
+					if (!found) break;
+
+					strip.push_back(r);
+				}
+
+				if (!output.empty()) {
+					// Stitch with degenerate triangles, keeping the new strip at an even position so the winding is preserved:
+					uint32_t last = output.back();
+					bool pad = (output.size() & 1) == 1;
+
+					output.push_back(last);
+					output.push_back(strip.front());
+
+					if (pad) output.push_back(strip.front());
+				}
+
+				output.insert(output.end(), strip.begin(), strip.end());
+			}
+
+			return output;
+		}
+
+		bool narrow_indices(Writer & writer, OffsetT mesh_offset) {
+			auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+
+			if (!mesh->indices_offset) return false;
+			if (writer.block_at_offset<Block>(mesh->indices_offset)->tag != Index32::TAG) return false;
+
+			auto indices = read_indices(*writer.block_at_offset<Block>(mesh->indices_offset));
+
+			for (auto index : indices) {
+				if (index >= INDEX16_VERTEX_LIMIT) return false;
+			}
+
+			OffsetT indices_offset = append_indices(writer, indices, Index16::TAG);
+			mesh->indices_offset = indices_offset;
+
+			return true;
+		}
+
+		bool convert_layout(Writer & writer, OffsetT mesh_offset) {
+			auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+
+			if (!mesh->indices_offset) return false;
+
+			auto block = writer.block_at_offset<Block>(mesh->indices_offset);
+			TagT tag = block->tag;
+			auto indices = read_indices(*block);
+
+			std::vector<uint32_t> converted;
+			Mesh::Layout layout;
+
+			if (mesh->layout == Mesh::Layout::TRIANGLES && indices.size() % 3 == 0) {
+				converted = strip_from_triangles(indices);
+				layout = Mesh::Layout::TRIANGLE_STRIP;
+			} else if (mesh->layout == Mesh::Layout::TRIANGLE_STRIP) {
+				converted = triangles_from_strip(indices);
+				layout = Mesh::Layout::TRIANGLES;
+			} else {
+				return false;
+			}
+
+			if (indices.empty() || converted.size() >= indices.size()) return false;
+
+			OffsetT indices_offset = append_indices(writer, converted, tag);
+
+			mesh->indices_offset = indices_offset;
+			mesh->layout = layout;
+
+			return true;
+		}
+
+		OffsetT split_mesh(Writer & writer, OffsetT mesh_offset, std::size_t vertex_limit) {
+			auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+
+			if (mesh->layout != Mesh::Layout::TRIANGLES || !mesh->indices_offset || !mesh->vertices_offset || vertex_limit < 3)
+				return 0;
+
+			std::size_t count = vertex_count(*writer.block_at_offset<Block>(mesh->vertices_offset));
+			auto indices = read_indices(*writer.block_at_offset<Block>(mesh->indices_offset));
+
+			if (count <= vertex_limit || indices.size() % 3 != 0)
+				return 0;
+
+			for (auto index : indices) {
+				if (index >= count) return 0;
+			}
+
+			const uint32_t UNUSED = ~uint32_t(0);
+
+			// Each part records the vertices it uses and its local indices:
+			struct Part {
+				std::vector<uint32_t> vertices, indices;
+			};
+
+			std::vector<Part> parts(1);
+			std::vector<uint32_t> local(count, UNUSED);
+
+			for (std::size_t i = 0; i < indices.size(); i += 3) {
+				std::size_t added = 0;
+
+				for (std::size_t j = 0; j < 3; j += 1) {
+					if (local[indices[i+j]] == UNUSED) added += 1;
+				}
+
+				if (parts.back().vertices.size() + added > vertex_limit) {
+					for (auto vertex : parts.back().vertices) local[vertex] = UNUSED;
+					parts.emplace_back();
+				}
+
+				Part & part = parts.back();
+
+				for (std::size_t j = 0; j < 3; j += 1) {
+					uint32_t & index = local[indices[i+j]];
+
+					if (index == UNUSED) {
+						index = static_cast<uint32_t>(part.vertices.size());
+						part.vertices.push_back(indices[i+j]);
+					}
+
+					part.indices.push_back(index);
+				}
+			}
+
+			std::vector<OffsetT> offsets;
+
+			for (auto & part : parts) {
+				auto vertices_offset = append_vertices(writer, mesh->vertices_offset, part.vertices);
+				auto indices_offset = append_indices(writer, part.indices, part.vertices.size() <= INDEX16_VERTEX_LIMIT ? Index16::TAG : Index32::TAG);
+
+				auto part_mesh = writer.append<Mesh>();
+				part_mesh->layout = mesh->layout;
+				part_mesh->indices_offset = indices_offset;
+				part_mesh->vertices_offset = vertices_offset;
+				part_mesh->axes_offset = mesh->axes_offset;
+				part_mesh->metadata_offset = mesh->metadata_offset;
+
+				offsets.push_back(part_mesh);
+			}
+
+			auto table = writer.append<OffsetTable>(OffsetTable::array_size(offsets.size()));
+
+			for (std::size_t i = 0; i < offsets.size(); i += 1) {
+				auto & entry = table->begin()[i];
+
+				entry.name = std::to_string(i);
+				entry.offset = offsets[i];
+			}
+
+			return table;
+		}
+	}
+}
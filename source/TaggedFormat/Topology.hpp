@@ -0,0 +1,42 @@
+//
+//  Topology.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// Conversions between index layouts and widths.
+	namespace Topology
+	{
+		/// The number of vertices which can be addressed by `Index16`.
+		const std::size_t INDEX16_VERTEX_LIMIT = 65536;
+
+		/// Expand a triangle strip into a triangle list, preserving winding and dropping degenerate triangles.
+		std::vector<uint32_t> triangles_from_strip(const std::vector<uint32_t> & strip);
+
+		/// Greedily join adjacent triangles into strips, following the order of the input. Strips are stitched together using degenerate triangles.
+		std::vector<uint32_t> strip_from_triangles(const std::vector<uint32_t> & triangles);
+
+		/// Replace an `Index32` array with an `Index16` array if every index fits.
+		/// @returns true if the indices were replaced.
+		bool narrow_indices(Writer & writer, OffsetT mesh_offset);
+
+		/// Convert between `TRIANGLES` and `TRIANGLE_STRIP`, if the other layout requires fewer indices.
+		/// @returns true if the layout was changed.
+		bool convert_layout(Writer & writer, OffsetT mesh_offset);
+
+		/// Split a triangle mesh into sub-meshes, each referencing at most `vertex_limit` vertices from its own vertex array, and each using `Index16` when possible. The sub-meshes are grouped in an `OffsetTable`, named by their index.
+		/// @returns the offset of the table, or 0 if the mesh did not need to be split.
+		OffsetT split_mesh(Writer & writer, OffsetT mesh_offset, std::size_t vertex_limit = INDEX16_VERTEX_LIMIT);
+	}
+}
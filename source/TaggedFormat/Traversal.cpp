@@ -0,0 +1,140 @@
+//
+//  Traversal.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Traversal.hpp"
+#include "Update.hpp"
+#include "Writer.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace TaggedFormat
+{
+	static const Block * block_at(const Buffer & buffer, OffsetT offset) {
+		if (offset == 0 || offset + sizeof(Block) > buffer.size())
+			return nullptr;
+
+		auto block = reinterpret_cast<const Block *>(buffer + offset);
+
+		if (block->size < sizeof(Block) || offset + block->size > buffer.size())
+			return nullptr;
+
+		return block;
+	}
+
+	std::vector<OffsetT> reachable_offsets(const Buffer & buffer) {
+		if (buffer.size() < sizeof(Header))
+			return {};
+
+		return reachable_offsets(buffer, Update::top_offset(buffer));
+	}
+
+	std::vector<OffsetT> reachable_offsets(const Buffer & buffer, OffsetT top_offset) {
+		std::set<OffsetT> visited;
+		std::vector<OffsetT> pending{top_offset};
+
+		while (!pending.empty()) {
+			OffsetT offset = pending.back();
+			pending.pop_back();
+
+			auto block = block_at(buffer, offset);
+
+			if (!block || !visited.insert(offset).second)
+				continue;
+
+			each_offset(block, [&](OffsetT child) {
+				if (child) pending.push_back(child);
+			});
+		}
+
+		return std::vector<OffsetT>(visited.begin(), visited.end());
+	}
+
+	void relocate_offsets(Writer & writer, const std::vector<OffsetT> & offsets, const std::map<OffsetT, OffsetT> & replacements) {
+		if (replacements.empty()) return;
+
+		auto replace = [&](OffsetT & offset) {
+			auto replacement = replacements.find(offset);
+
+			if (replacement != replacements.end())
+				offset = replacement->second;
+		};
+
+		each_offset(*writer.header(), replace);
+
+		for (auto offset : offsets)
+			each_offset(*writer.block_at_offset<Block>(offset), replace);
+
+		for (auto & replacement : replacements)
+			each_offset(*writer.block_at_offset<Block>(replacement.second), replace);
+	}
+
+	// Blocks which require more than the natural alignment of the format:
+	std::size_t block_alignment(TagT tag) {
+		switch (tag) {
+			case VertexStream::TAG:
+				return VertexStream::ALIGNMENT;
+
+			case NodeTransforms::TAG:
+				return NodeTransforms::ALIGNMENT;
+
+			default:
+				return 1;
+		}
+	}
+
+	void compact(const Buffer & input, ResizableBuffer & output, bool checksums) {
+		compact(input, output, reachable_offsets(input), checksums);
+	}
+
+	void compact(const Buffer & input, ResizableBuffer & output, const std::vector<OffsetT> & offsets, bool checksums) {
+		Writer writer(output);
+		auto header = writer.header();
+
+		std::map<OffsetT, OffsetT> relocations;
+
+		// Lay out the blocks first, so that each copy is final, and its checksum can be computed, as soon as it is written:
+		OffsetT position = output.size();
+
+		for (auto offset : offsets) {
+			auto block = block_at(input, offset);
+			std::size_t alignment = block_alignment(block->tag);
+
+			position += (alignment - position % alignment) % alignment;
+			relocations[offset] = position;
+			position += block->size;
+		}
+
+		auto relocate = [&](OffsetT & offset) {
+			auto relocation = relocations.find(offset);
+
+			if (relocation != relocations.end())
+				offset = relocation->second;
+			else
+				offset = 0;
+		};
+
+		writer.record_checksums(checksums);
+
+		for (auto offset : offsets) {
+			auto block = block_at(input, offset);
+
+			writer.align(block_alignment(block->tag));
+			writer.copy(block, [&](Block * copy) {
+				each_offset(copy, relocate);
+			});
+		}
+
+		header->top_offset = Update::top_offset(input);
+		relocate(header->top_offset);
+
+		if (checksums)
+			writer.append_checksums();
+	}
+}
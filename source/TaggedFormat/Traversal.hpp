@@ -0,0 +1,205 @@
+//
+//  Traversal.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "AnimationCompression.hpp"
+#include "AnimationTracks.hpp"
+#include "BVH.hpp"
+#include "Clusters.hpp"
+#include "Instancing.hpp"
+#include "Merging.hpp"
+#include "Mesh.hpp"
+#include "Morph.hpp"
+#include "Progressive.hpp"
+#include "Skeleton.hpp"
+#include "Scene.hpp"
+#include "SceneGraph.hpp"
+#include "Simplification.hpp"
+#include "SpatialIndex.hpp"
+#include "Streams.hpp"
+#include "Table.hpp"
+
+#include <Buffers/ResizableBuffer.hpp>
+
+#include <map>
+#include <vector>
+
+namespace TaggedFormat
+{
+	class Writer;
+
+	using Buffers::Buffer;
+	using Buffers::ResizableBuffer;
+
+	/// Invoke the callback with a reference to every offset stored in the given block. Blocks with unknown tags are assumed to contain no offsets.
+	template <typename CallbackT>
+	void each_offset(Block * block, CallbackT && callback) {
+		switch (block->tag) {
+			case Header::TAG:
+				callback(static_cast<Header *>(block)->top_offset);
+				break;
+
+			case Mesh::TAG: {
+				auto mesh = static_cast<Mesh *>(block);
+				callback(mesh->indices_offset);
+				callback(mesh->vertices_offset);
+				callback(mesh->axes_offset);
+				callback(mesh->metadata_offset);
+				break;
+			}
+
+			case Skeleton::TAG: {
+				auto skeleton = static_cast<Skeleton *>(block);
+				callback(skeleton->bones_offset);
+				callback(skeleton->sequences_offset);
+				break;
+			}
+
+			case SkeletonAnimation::TAG:
+				callback(static_cast<SkeletonAnimation *>(block)->key_frames_offset);
+				break;
+
+			case CompressedAnimation::TAG: {
+				auto compressed_animation = static_cast<CompressedAnimation *>(block);
+				callback(compressed_animation->tracks_offset);
+				callback(compressed_animation->keys_offset);
+				break;
+			}
+
+			case ResampledAnimation::TAG: {
+				auto resampled_animation = static_cast<ResampledAnimation *>(block);
+				callback(resampled_animation->samples_offset);
+				callback(resampled_animation->key_frames_offset);
+				break;
+			}
+
+			case GeometryInstance::TAG: {
+				auto geometry_instance = static_cast<GeometryInstance *>(block);
+				callback(geometry_instance->mesh_offset);
+				callback(geometry_instance->skeleton_offset);
+				callback(geometry_instance->material_offset);
+				break;
+			}
+
+			case InstanceBatch::TAG: {
+				auto instance_batch = static_cast<InstanceBatch *>(block);
+				callback(instance_batch->mesh_offset);
+				callback(instance_batch->skeleton_offset);
+				callback(instance_batch->material_offset);
+				break;
+			}
+
+			case MorphTarget::TAG:
+				callback(static_cast<MorphTarget *>(block)->mesh_offset);
+				break;
+
+			case Node::TAG:
+				for (auto & reference : *static_cast<Node *>(block))
+					callback(reference.offset);
+				break;
+
+			case OffsetTable::TAG:
+				for (auto & entry : *static_cast<OffsetTable *>(block))
+					callback(entry.offset);
+				break;
+
+			case MeshClusters::TAG: {
+				auto mesh_clusters = static_cast<MeshClusters *>(block);
+				callback(mesh_clusters->clusters_offset);
+				callback(mesh_clusters->vertices_offset);
+				callback(mesh_clusters->triangles_offset);
+				break;
+			}
+
+			case TriangleBVH::TAG: {
+				auto triangle_bvh = static_cast<TriangleBVH *>(block);
+				callback(triangle_bvh->nodes_offset);
+				callback(triangle_bvh->triangles_offset);
+				break;
+			}
+
+			case SceneIndex::TAG: {
+				auto scene_index = static_cast<SceneIndex *>(block);
+				callback(scene_index->nodes_offset);
+				callback(scene_index->instances_offset);
+				break;
+			}
+
+			case FlatScene::TAG: {
+				auto flat_scene = static_cast<FlatScene *>(block);
+				callback(flat_scene->levels_offset);
+				callback(flat_scene->parents_offset);
+				callback(flat_scene->transforms_offset);
+
+				for (auto & reference : *flat_scene)
+					callback(reference.offset);
+				break;
+			}
+
+			case SceneInstance::TAG:
+				for (auto & instance : *static_cast<Array<SceneInstance> *>(block))
+					callback(instance.instance_offset);
+				break;
+
+			case MergedSource::TAG:
+				for (auto & source : *static_cast<Array<MergedSource> *>(block))
+					callback(source.node_offset);
+				break;
+
+			case MeshLevel::TAG:
+				for (auto & level : *static_cast<Array<MeshLevel> *>(block))
+					callback(level.indices_offset);
+				break;
+
+			case VertexStreams::TAG:
+				for (auto & reference : *static_cast<VertexStreams *>(block))
+					callback(reference.offset);
+				break;
+
+			case VertexChunks::TAG:
+				for (auto & reference : *static_cast<VertexChunks *>(block))
+					callback(reference.offset);
+				break;
+
+			case ProgressiveLevel::TAG:
+				for (auto & level : *static_cast<Array<ProgressiveLevel> *>(block)) {
+					callback(level.indices_offset);
+					callback(level.vertices_offset);
+				}
+				break;
+		}
+	}
+
+	/// Invoke the callback with the value of every offset stored in the given block.
+	template <typename CallbackT>
+	void each_offset(const Block * block, CallbackT && callback) {
+		each_offset(const_cast<Block *>(block), [&](OffsetT & offset) {
+			callback(static_cast<OffsetT>(offset));
+		});
+	}
+
+	/// @returns the offsets of all blocks reachable from the header, in file order. The header itself is not included.
+	std::vector<OffsetT> reachable_offsets(const Buffer & buffer);
+
+	/// @returns the offsets of all blocks reachable from the given top block, in file order.
+	std::vector<OffsetT> reachable_offsets(const Buffer & buffer, OffsetT top_offset);
+
+	/// @returns the alignment required by blocks with the given tag.
+	std::size_t block_alignment(TagT tag);
+
+	/// Update every offset which refers to a replaced block, in the header, the given blocks and the replacements themselves.
+	void relocate_offsets(Writer & writer, const std::vector<OffsetT> & offsets, const std::map<OffsetT, OffsetT> & replacements);
+
+	/// Copy all blocks reachable from the header of the input into the output, preserving their order and alignment requirements and updating offsets. Unreachable blocks, e.g. those replaced by a conversion stage, are discarded.
+	/// @param checksums if true, the checksum of every block is written to a directory at the end of the output.
+	void compact(const Buffer & input, ResizableBuffer & output, bool checksums = false);
+
+	/// Copy the given blocks of the input into the output in the given order, e.g. from `Progressive::streaming_order`, which must include every reachable block.
+	void compact(const Buffer & input, ResizableBuffer & output, const std::vector<OffsetT> & offsets, bool checksums = false);
+}
@@ -0,0 +1,463 @@
+//
+//  Update.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Update.hpp"
+#include "Bundle.hpp"
+#include "Reader.hpp"
+#include "Table.hpp"
+#include "Traversal.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TaggedFormat
+{
+	static_assert(sizeof(Generation) <= Generation::ALIGNMENT, "generation must fit within its alignment");
+
+	namespace Update
+	{
+		uint32_t generation_crc(const Generation * generation)
+		{
+			return Checksum::crc32c(generation, sizeof(Generation) - sizeof(generation->crc));
+		}
+
+		// A valid generation at the given offset:
+		static const Generation * verified_generation(const Byte * data, OffsetT offset)
+		{
+			auto generation = reinterpret_cast<const Generation *>(data + offset);
+
+			if (generation->tag != Generation::TAG || generation->size != sizeof(Generation))
+				return nullptr;
+
+			if (generation_crc(generation) != generation->crc)
+				return nullptr;
+
+			// Generations only refer to blocks which were written before them:
+			if (generation->top_offset >= offset || generation->previous_offset >= offset || generation->checksums_offset >= offset)
+				return nullptr;
+
+			return generation;
+		}
+
+		// The generation at the end of the first `size` bytes of the data, or the copy of the previous generation in the slot before it:
+		static const Generation * generation_at(const Byte * data, std::size_t size)
+		{
+			if (size < sizeof(Header) + sizeof(Generation))
+				return nullptr;
+
+			// An interrupted write may leave the file shorter than a whole generation, so the last slot is the last aligned offset with room for one:
+			OffsetT offset = (size - sizeof(Generation)) / Generation::ALIGNMENT * Generation::ALIGNMENT;
+
+			if (offset == size - sizeof(Generation)) {
+				if (auto generation = verified_generation(data, offset))
+					return generation;
+
+				offset -= Generation::ALIGNMENT;
+			}
+
+			if (offset < sizeof(Header))
+				return nullptr;
+
+			return verified_generation(data, offset);
+		}
+
+		// The checksum trailer of the first `size` bytes of the data:
+		static OffsetT checksums_offset_at(const Byte * data, std::size_t size)
+		{
+			if (auto generation = generation_at(data, size))
+				return generation->checksums_offset;
+
+			if (size < sizeof(Header) + sizeof(ChecksumTrailer))
+				return 0;
+
+			OffsetT offset = size - sizeof(ChecksumTrailer);
+			auto trailer = reinterpret_cast<const ChecksumTrailer *>(data + offset);
+
+			if (trailer->tag != ChecksumTrailer::TAG || trailer->size != sizeof(ChecksumTrailer))
+				return 0;
+
+			return offset;
+		}
+
+		const Generation * latest_generation(const Buffer & buffer)
+		{
+			return generation_at(buffer.begin(), buffer.size());
+		}
+
+		Generation current_generation(const Buffer & buffer, std::size_t size)
+		{
+			Generation current;
+
+			if (auto existing = generation_at(buffer.begin(), size)) {
+				current = *existing;
+			} else {
+				clear(current);
+				current.number = 0;
+				current.top_offset = reinterpret_cast<const Header *>(buffer.begin())->top_offset;
+				current.previous_offset = 0;
+				current.checksums_offset = checksums_offset_at(buffer.begin(), size);
+				current.crc = generation_crc(&current);
+			}
+
+			return current;
+		}
+
+		OffsetT top_offset(const Buffer & buffer)
+		{
+			if (auto generation = latest_generation(buffer))
+				return generation->top_offset;
+
+			return reinterpret_cast<const Header *>(buffer.begin())->top_offset;
+		}
+
+		OffsetT checksums_offset(const Buffer & buffer)
+		{
+			return checksums_offset_at(buffer.begin(), buffer.size());
+		}
+
+		static void write_all(int descriptor, const Byte * data, std::size_t size, std::size_t offset)
+		{
+			while (size) {
+				auto written = ::pwrite(descriptor, data, size, offset);
+
+				if (written == -1) {
+					if (errno == EINTR) continue;
+
+					throw std::system_error(errno, std::generic_category(), "pwrite");
+				}
+
+				data += written;
+				size -= written;
+				offset += written;
+			}
+		}
+
+		static void synchronize(int descriptor)
+		{
+			if (::fsync(descriptor) == -1)
+				throw std::system_error(errno, std::generic_category(), "fsync");
+		}
+
+		void publish(const std::string & path, const Buffer & buffer, std::size_t published_size)
+		{
+			if (buffer.size() == published_size)
+				return;
+
+			if (published_size < sizeof(Header) || buffer.size() < published_size + sizeof(Generation) + Generation::ALIGNMENT)
+				throw std::invalid_argument("Buffer does not end with a new generation!");
+
+			OffsetT generation_offset = buffer.size() - sizeof(Generation);
+			OffsetT previous_offset = generation_offset - Generation::ALIGNMENT;
+
+			auto generation = verified_generation(buffer.begin(), generation_offset);
+			auto previous = verified_generation(buffer.begin(), previous_offset);
+
+			// The generation which is current in the file remains current until the new generation is written:
+			Generation current = current_generation(buffer, published_size);
+
+			if (generation_offset % Generation::ALIGNMENT || !generation || !previous || std::memcmp(previous, &current, sizeof(Generation)) != 0)
+				throw std::invalid_argument("Buffer does not end with a new generation!");
+
+			int descriptor = ::open(path.c_str(), O_WRONLY);
+
+			if (descriptor == -1)
+				throw std::system_error(errno, std::generic_category(), "open " + path);
+
+			try {
+				struct stat status;
+
+				if (::fstat(descriptor, &status) == -1)
+					throw std::system_error(errno, std::generic_category(), "fstat " + path);
+
+				if (static_cast<std::size_t>(status.st_size) != published_size)
+					throw std::invalid_argument("File has changed since it was read: " + path);
+
+				// The file ends with the copy of the current generation while the blocks are written:
+				write_all(descriptor, buffer + previous_offset, Generation::ALIGNMENT, previous_offset);
+				synchronize(descriptor);
+
+				write_all(descriptor, buffer + published_size, previous_offset - published_size, published_size);
+				synchronize(descriptor);
+
+				// The new generation is in a fresh slot, so if this write is interrupted, the copy is still valid:
+				write_all(descriptor, buffer + generation_offset, sizeof(Generation), generation_offset);
+				synchronize(descriptor);
+			} catch (...) {
+				::close(descriptor);
+
+				throw;
+			}
+
+			::close(descriptor);
+		}
+	}
+
+	Updater::Updater(ResizableBuffer & buffer, bool checksums) : _buffer(buffer), _writer(buffer), _checksums(checksums), _committed_size(buffer.size()), _published_size(buffer.size())
+	{
+		if (buffer.size() < sizeof(Header))
+			throw std::invalid_argument("Buffer is not a binary file!");
+
+		auto header = reinterpret_cast<const Header *>(buffer.begin());
+
+		if (header->tag != Header::TAG || header->magic != 42)
+			throw std::invalid_argument("Buffer is not a binary file!");
+
+		auto generation = Update::latest_generation(buffer);
+
+		_generation_offset = generation ? reinterpret_cast<const Byte *>(generation) - buffer.begin() : 0;
+		_generation_number = generation ? generation->number : 0;
+
+		_top_offset = Update::top_offset(buffer);
+		_checksums_offset = Update::checksums_offset(buffer);
+
+		// Existing checksums are not read, as the new directory only refers to them:
+		if (_checksums_offset)
+			_checksums = true;
+	}
+
+	OffsetT Updater::copy(OffsetT offset, OffsetT capacity)
+	{
+		if (offset < sizeof(Header) || offset + sizeof(Block) > _buffer.size())
+			throw std::invalid_argument("No block at offset " + std::to_string(offset));
+
+		auto block = reinterpret_cast<const Block *>(_buffer + offset);
+
+		if (block->size < sizeof(Block) || offset + block->size > _buffer.size())
+			throw std::invalid_argument("No block at offset " + std::to_string(offset));
+
+		// Appending may move the buffer, so copy the block first:
+		std::vector<Byte> bytes(_buffer + offset, _buffer + offset + block->size);
+
+		_writer.align(block_alignment(block->tag));
+
+		OffsetT replacement = _buffer.size();
+		_buffer.expand(bytes.size() + capacity);
+
+		std::memcpy(_buffer + replacement, bytes.data(), bytes.size());
+		std::memset(_buffer + replacement + bytes.size(), 0, capacity);
+
+		_writer.block_at_offset<Block>(replacement)->size += capacity;
+		_replacements[offset] = replacement;
+
+		return replacement;
+	}
+
+	void Updater::replace(OffsetT offset, OffsetT replacement)
+	{
+		_replacements[offset] = replacement;
+	}
+
+	OffsetT Updater::append_file(const Buffer & input)
+	{
+		Reader reader(input);
+		auto header = reader.header();
+
+		if (!header || header->tag != Header::TAG)
+			throw std::invalid_argument("Input is not a binary file!");
+
+		if (!reader.verify_all().empty())
+			throw std::invalid_argument("Input has corrupt blocks!");
+
+		auto offsets = reachable_offsets(input);
+
+		_writer.align(BundleWriter::ALIGNMENT);
+		OffsetT base = _writer.copy(input);
+
+		// Offsets are relative to the start of the file, so relocation is a single addition:
+		for (auto offset : offsets) {
+			each_offset(*_writer.block_at_offset<Block>(base + offset), [&](OffsetT & child) {
+				if (child) child += base;
+			});
+		}
+
+		return header->top_offset ? base + header->top_offset : 0;
+	}
+
+	void Updater::set_asset(const std::string & name, OffsetT offset)
+	{
+		if (name.empty() || name.size() > sizeof(NamedOffset::name))
+			throw std::invalid_argument("Asset name must be between 1 and 32 characters: " + name);
+
+		// The table may already have been replaced in this generation:
+		OffsetT table_offset = _top_offset;
+		auto replacement = _replacements.find(table_offset);
+
+		if (replacement != _replacements.end())
+			table_offset = replacement->second;
+
+		std::vector<NamedOffset> entries;
+
+		if (table_offset) {
+			auto table = reinterpret_cast<const OffsetTable *>(_buffer + table_offset);
+
+			if (table_offset + sizeof(Block) > _buffer.size() || table->tag != OffsetTable::TAG || table_offset + table->size > _buffer.size())
+				throw std::invalid_argument("Top block is not an offset table!");
+
+			entries.assign(table->begin(), table->end());
+		}
+
+		auto existing = std::find_if(entries.begin(), entries.end(), [&](const NamedOffset & entry) {
+			return entry.match(name);
+		});
+
+		if (existing == entries.end()) {
+			entries.emplace_back();
+			existing = entries.end() - 1;
+
+			std::memset(&existing->name, 0, sizeof(existing->name));
+			existing->name = name;
+		}
+
+		existing->offset = offset;
+
+		auto table = _writer.append<OffsetTable>(OffsetTable::array_size(entries.size()));
+		std::copy(entries.begin(), entries.end(), table->begin());
+
+		if (_top_offset)
+			replace(_top_offset, table);
+		else
+			_top_offset = table;
+	}
+
+	void Updater::add_parents(OffsetT offset)
+	{
+		each_offset(reinterpret_cast<const Block *>(_buffer + offset), [&](OffsetT child) {
+			if (child) _parents[child].push_back(offset);
+		});
+	}
+
+	OffsetT Updater::commit()
+	{
+		// Only the top block has no parents, so replacing it alone doesn't need the index:
+		bool nested = std::any_of(_replacements.begin(), _replacements.end(), [&](const std::pair<const OffsetT, OffsetT> & replacement) {
+			return replacement.first != _top_offset;
+		});
+
+		if (nested) {
+			if (!_parents_loaded) {
+				for (auto offset : reachable_offsets(_buffer, _top_offset))
+					add_parents(offset);
+
+				_parents_loaded = true;
+			}
+
+			// Every block which refers to a replaced block is replaced too, up to the top block:
+			std::vector<OffsetT> pending;
+
+			for (auto & replacement : _replacements)
+				pending.push_back(replacement.first);
+
+			while (!pending.empty()) {
+				auto offset = pending.back();
+				pending.pop_back();
+
+				auto parents = _parents.find(offset);
+				if (parents == _parents.end()) continue;
+
+				for (auto parent : parents->second) {
+					if (_replacements.count(parent)) continue;
+
+					copy(parent, 0);
+					pending.push_back(parent);
+				}
+			}
+		}
+
+		auto replace = [&](OffsetT & offset) {
+			auto replacement = _replacements.find(offset);
+
+			if (replacement != _replacements.end())
+				offset = replacement->second;
+		};
+
+		replace(_top_offset);
+
+		// Update the new blocks, which can only be reached through other new blocks:
+		std::set<OffsetT> appended;
+		std::vector<OffsetT> pending{_top_offset};
+
+		while (!pending.empty()) {
+			auto offset = pending.back();
+			pending.pop_back();
+
+			if (offset < _committed_size || offset + sizeof(Block) > _buffer.size() || !appended.insert(offset).second)
+				continue;
+
+			each_offset(*_writer.block_at_offset<Block>(offset), [&](OffsetT & child) {
+				replace(child);
+
+				if (child) pending.push_back(child);
+			});
+		}
+
+		if (_parents_loaded) {
+			// Replaced blocks are no longer reachable from the new top block, but the blocks appended in their place are:
+			for (auto & replacement : _replacements) {
+				if (replacement.first >= _committed_size) continue;
+
+				each_offset(reinterpret_cast<const Block *>(_buffer + replacement.first), [&](OffsetT child) {
+					auto & parents = _parents[child];
+					parents.erase(std::remove(parents.begin(), parents.end(), replacement.first), parents.end());
+				});
+			}
+
+			for (auto offset : appended)
+				add_parents(offset);
+		}
+
+		OffsetT checksums_offset = _checksums_offset;
+
+		// The directory only contains the new blocks, and refers to the directory of the previous generation for the rest:
+		if (_checksums && !appended.empty()) {
+			for (auto offset : appended)
+				_writer.checksum(offset);
+
+			checksums_offset = _writer.append_checksums(_checksums_offset);
+		}
+
+		// If writing the new generation is interrupted, the file falls back to this copy of the generation which is current in the file:
+		_writer.align(Generation::ALIGNMENT);
+		auto previous = _writer.append<Generation>();
+		**previous = Update::current_generation(_buffer, _published_size);
+
+		_writer.align(Generation::ALIGNMENT);
+		auto generation = _writer.append<Generation>();
+
+		generation->number = _generation_number + 1;
+		generation->top_offset = _top_offset;
+		generation->previous_offset = _generation_offset;
+		generation->checksums_offset = checksums_offset;
+
+		uint32_t crc = Update::generation_crc(*generation);
+		generation->crc = crc;
+
+		_generation_offset = generation;
+		_generation_number += 1;
+		_checksums_offset = checksums_offset;
+
+		_committed_size = _buffer.size();
+		_replacements.clear();
+
+		return generation;
+	}
+
+	void Updater::publish(const std::string & path)
+	{
+		Update::publish(path, _buffer, _published_size);
+
+		_published_size = _buffer.size();
+	}
+}
@@ -0,0 +1,133 @@
+//
+//  Update.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Writer.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace TaggedFormat
+{
+	using Buffers::Buffer;
+
+	/// The last block of a file which has been updated in place. It replaces the top offset of the header, which is never rewritten. Each generation refers to the previous one, so the history of the file is preserved. Each generation is preceded by a copy of the generation which was current when it was committed, so that the file can fall back to it if writing the new generation is interrupted.
+	struct Generation : public Block {
+		static const TagT TAG = tag_from_identifier("GENR");
+
+		/// Generations are placed at this alignment so that they never cross a disk sector, and are written atomically.
+		static const std::size_t ALIGNMENT = 64;
+
+		/// The header is generation 0.
+		uint32_t number;
+
+		OffsetT top_offset;
+
+		/// The previous generation, or 0 if the previous generation is the header.
+		OffsetT previous_offset;
+
+		/// The `ChecksumTrailer` of this generation, or 0 if it has no checksums.
+		OffsetT checksums_offset;
+
+		/// The checksum of all preceding fields.
+		uint32_t crc;
+	};
+
+	namespace Update
+	{
+		/// @returns the checksum of the generation, excluding the `crc` field itself.
+		uint32_t generation_crc(const Generation * generation);
+
+		/// @returns the generation at the end of the buffer, or if it fails verification, e.g. because writing it was interrupted, the copy of the previous generation which precedes it, or nullptr if the file has never been updated.
+		const Generation * latest_generation(const Buffer & buffer);
+
+		/// @returns a copy of the latest generation within the first `size` bytes of the buffer, or of the header as generation 0 if there is none.
+		Generation current_generation(const Buffer & buffer, std::size_t size);
+
+		/// @returns the top offset of the latest generation, or of the header.
+		OffsetT top_offset(const Buffer & buffer);
+
+		/// @returns the offset of the `ChecksumTrailer` of the latest generation, or of the file if it has never been updated, or 0 if there is none.
+		OffsetT checksums_offset(const Buffer & buffer);
+
+		/// Append the bytes of the buffer after `published_size` to the file at the given path, which must contain exactly the first `published_size` bytes of the buffer, and end with a new generation preceded by a copy of the current generation, as appended by `Updater::commit`. The copy is written first, then the blocks before it, and the new generation is written last at a fresh offset, so that the end of the file is always a valid generation, even if the update is interrupted.
+		/// @throws std::system_error if the file can't be written, or std::invalid_argument if it doesn't match the buffer.
+		void publish(const std::string & path, const Buffer & buffer, std::size_t published_size);
+	}
+
+	/// Appends new versions of changed blocks to an existing file, followed by a new generation. Blocks which refer to a replaced block, and so on up to the top block, are copied with updated offsets. Everything else is shared with previous generations, so the cost of an update is proportional to the size of the changed blocks rather than the size of the file.
+	class Updater {
+	public:
+		/// @param checksums if true, or if the file already has checksums, the checksums of the new blocks of each generation are added to a new checksum directory, which is chained to the directory of the previous generation.
+		/// @throws std::invalid_argument if the buffer is not a valid file.
+		Updater(ResizableBuffer & buffer, bool checksums = false);
+
+		/// The writer used to append new blocks, e.g. a new animation, which can then be referred to by replaced blocks.
+		Writer & writer() {return _writer;}
+
+		/// The top offset of the generation being written.
+		OffsetT top_offset() const {return _top_offset;}
+		void set_top_offset(OffsetT offset) {_top_offset = offset;}
+
+		/// Append a copy of the block at the given offset with additional capacity, which replaces it in the new generation.
+		/// @throws std::invalid_argument if there is no such block.
+		template <typename BlockT>
+		BufferedOffset<BlockT> replace(OffsetT offset, OffsetT capacity = 0) {
+			auto replacement = copy(offset, capacity);
+
+			return _writer.block_at_offset<BlockT>(replacement);
+		}
+
+		/// Replace the block at the given offset with a block which has already been appended.
+		void replace(OffsetT offset, OffsetT replacement);
+
+		/// Append a copy of an entire file, e.g. a newly converted asset, relocating its offsets.
+		/// @returns the relocated top offset of the file, or 0 if it has none.
+		/// @throws std::invalid_argument if the input is not a valid file.
+		OffsetT append_file(const Buffer & input);
+
+		/// Add or replace the named entry of the top `OffsetTable`, e.g. of a bundle, by appending a new table which replaces the existing one.
+		/// @throws std::invalid_argument if the name is invalid or the top block is not an `OffsetTable`.
+		void set_asset(const std::string & name, OffsetT offset);
+
+		/// Append new versions of all blocks which refer to replaced blocks, the checksums of the new blocks, a copy of the generation which is current in the published file and a new generation.
+		/// @returns the offset of the new generation.
+		OffsetT commit();
+
+		/// Append everything committed since the file was opened or last published to the file at the given path, using `Update::publish`.
+		void publish(const std::string & path);
+
+	private:
+		ResizableBuffer & _buffer;
+		Writer _writer;
+
+		bool _checksums;
+
+		/// Blocks before this offset belong to previous generations.
+		std::size_t _committed_size;
+		std::size_t _published_size;
+
+		OffsetT _generation_offset;
+		uint32_t _generation_number;
+
+		/// The checksum trailer of the latest generation, or 0 if there is none.
+		OffsetT _checksums_offset = 0;
+
+		OffsetT _top_offset;
+		std::map<OffsetT, OffsetT> _replacements;
+
+		/// The blocks which refer to each block, built on first use when a block other than the top block is replaced, and updated by each commit.
+		bool _parents_loaded = false;
+		std::map<OffsetT, std::vector<OffsetT>> _parents;
+
+		OffsetT copy(OffsetT offset, OffsetT capacity);
+		void add_parents(OffsetT offset);
+	};
+}
@@ -0,0 +1,204 @@
+//
+//  VertexCache.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "VertexCache.hpp"
+#include "Geometry.hpp"
+
+namespace TaggedFormat
+{
+	namespace VertexCache
+	{
+		Statistics analyze(const std::vector<uint32_t> & indices, std::size_t vertex_count, std::size_t cache_size) {
+			Statistics statistics;
+
+			// Each vertex records the time at which it entered the cache, a miss occurs when it has since been pushed out:
+			std::vector<std::size_t> cached_at(vertex_count, 0);
+			std::vector<bool> referenced(vertex_count, false);
+
+			std::size_t time = cache_size + 1, misses = 0, unique = 0;
+
+			for (auto index : indices) {
+				if (index >= vertex_count) continue;
+
+				if (time - cached_at[index] > cache_size) {
+					cached_at[index] = time;
+					time += 1;
+					misses += 1;
+				}
+
+				if (!referenced[index]) {
+					referenced[index] = true;
+					unique += 1;
+				}
+			}
+
+			std::size_t triangles = indices.size() / 3;
+
+			if (triangles) statistics.acmr = double(misses) / triangles;
+			if (unique) statistics.atvr = double(misses) / unique;
+
+			return statistics;
+		}
+
+		// Adjacency from each vertex to the triangles which use it, stored as offsets into a single list:
+		struct Adjacency {
+			std::vector<uint32_t> offsets, counts, triangles;
+
+			Adjacency(const std::vector<uint32_t> & indices, std::size_t vertex_count) : offsets(vertex_count + 1, 0), counts(vertex_count, 0), triangles(indices.size()) {
+				for (auto index : indices) counts[index] += 1;
+
+				for (std::size_t i = 0; i < vertex_count; i += 1) {
+					offsets[i+1] = offsets[i] + counts[i];
+				}
+
+				std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+
+				for (std::size_t i = 0; i < indices.size(); i += 1) {
+					triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+				}
+			}
+		};
+
+		std::vector<uint32_t> optimize(const std::vector<uint32_t> & indices, std::size_t vertex_count, std::size_t cache_size) {
+			std::size_t triangle_count = indices.size() / 3;
+
+			if (indices.size() % 3 != 0) return indices;
+
+			for (auto index : indices) {
+				if (index >= vertex_count) return indices;
+			}
+
+			Adjacency adjacency(indices, vertex_count);
+
+			// The number of triangles which have yet to be emitted for each vertex:
+			std::vector<uint32_t> live(adjacency.counts);
+			std::vector<std::size_t> cached_at(vertex_count, 0);
+			std::vector<bool> emitted(triangle_count, false);
+
+			std::vector<uint32_t> output, dead_end, candidates;
+			output.reserve(triangle_count * 3);
+
+			std::size_t time = cache_size + 1, cursor = 1;
+			std::ptrdiff_t fanning = vertex_count ? 0 : -1;
+
+			while (fanning >= 0) {
+				candidates.clear();
+
+				// Emit all remaining triangles around the fanning vertex:
+				for (std::size_t i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning+1]; i += 1) {
+					uint32_t triangle = adjacency.triangles[i];
+
+					if (emitted[triangle]) continue;
+					emitted[triangle] = true;
+
+					for (std::size_t j = 0; j < 3; j += 1) {
+						uint32_t vertex = indices[triangle * 3 + j];
+
+						output.push_back(vertex);
+						dead_end.push_back(vertex);
+						candidates.push_back(vertex);
+
+						live[vertex] -= 1;
+
+						if (time - cached_at[vertex] > cache_size) {
+							cached_at[vertex] = time;
+							time += 1;
+						}
+					}
+				}
+
+				// Prefer the candidate which will remain in the cache longest while its remaining triangles are emitted:
+				fanning = -1;
+				std::ptrdiff_t best_priority = -1;
+
+				for (auto vertex : candidates) {
+					if (live[vertex] == 0) continue;
+
+					std::ptrdiff_t priority = 0;
+
+					if (time - cached_at[vertex] + 2 * live[vertex] <= cache_size)
+						priority = time - cached_at[vertex];
+
+					if (priority > best_priority) {
+						best_priority = priority;
+						fanning = vertex;
+					}
+				}
+
+				if (fanning == -1) {
+					// Skip the dead end by returning to a recently used vertex, or failing that, the next vertex in input order:
+					while (!dead_end.empty() && fanning == -1) {
+						uint32_t vertex = dead_end.back();
+						dead_end.pop_back();
+
+						if (live[vertex] > 0) fanning = vertex;
+					}
+
+					while (cursor < vertex_count && fanning == -1) {
+						if (live[cursor] > 0) fanning = cursor;
+						cursor += 1;
+					}
+				}
+			}
+
+			return output;
+		}
+
+		std::vector<uint32_t> fetch_order(const std::vector<uint32_t> & indices, std::size_t vertex_count) {
+			const uint32_t UNUSED = ~uint32_t(0);
+			std::vector<uint32_t> remap(vertex_count, UNUSED);
+			uint32_t next = 0;
+
+			for (auto index : indices) {
+				if (index < vertex_count && remap[index] == UNUSED)
+					remap[index] = next++;
+			}
+
+			for (auto & index : remap) {
+				if (index == UNUSED) index = next++;
+			}
+
+			return remap;
+		}
+
+		Report optimize_mesh(Writer & writer, OffsetT mesh_offset, std::size_t cache_size) {
+			Report report;
+			auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+
+			if (mesh->layout != Mesh::Layout::TRIANGLES || !mesh->indices_offset || !mesh->vertices_offset)
+				return report;
+
+			auto indices_block = writer.block_at_offset<Block>(mesh->indices_offset);
+			auto vertices_block = writer.block_at_offset<Block>(mesh->vertices_offset);
+
+			auto indices = read_indices(*indices_block);
+			std::size_t count = vertex_count(*vertices_block);
+
+			if (indices.empty() || count == 0 || indices.size() % 3 != 0)
+				return report;
+
+			for (auto index : indices) {
+				if (index >= count) return report;
+			}
+
+			report.before = analyze(indices, count, cache_size);
+
+			indices = optimize(indices, count, cache_size);
+
+			auto remap = fetch_order(indices, count);
+			for (auto & index : indices) index = remap[index];
+
+			write_indices(*indices_block, indices);
+			remap_vertices(*vertices_block, remap);
+
+			report.after = analyze(indices, count, cache_size);
+
+			return report;
+		}
+	}
+}
@@ -0,0 +1,51 @@
+//
+//  VertexCache.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// Reordering of triangle lists for post-transform vertex cache reuse, and of vertices for fetch locality.
+	namespace VertexCache
+	{
+		/// The cache size assumed when optimizing; most hardware has an effective FIFO of about this size.
+		const std::size_t DEFAULT_CACHE_SIZE = 16;
+
+		struct Statistics {
+			/// Average cache miss ratio: transformed vertices per triangle, between 0.5 and 3.
+			double acmr = 0;
+
+			/// Average transform to vertex ratio: transformed vertices per referenced vertex, ideally 1.
+			double atvr = 0;
+		};
+
+		/// Simulate a FIFO vertex cache of the given size over a triangle list.
+		Statistics analyze(const std::vector<uint32_t> & indices, std::size_t vertex_count, std::size_t cache_size = DEFAULT_CACHE_SIZE);
+
+		/// Reorder triangles for vertex cache reuse using the Tipsify algorithm (Sander, Nehab and Barczak, 2007).
+		/// @returns the reordered triangle list.
+		std::vector<uint32_t> optimize(const std::vector<uint32_t> & indices, std::size_t vertex_count, std::size_t cache_size = DEFAULT_CACHE_SIZE);
+
+		/// Compute a vertex order where vertices are sorted by first use. Unreferenced vertices are moved to the end.
+		/// @returns a mapping from the current vertex index to the new vertex index.
+		std::vector<uint32_t> fetch_order(const std::vector<uint32_t> & indices, std::size_t vertex_count);
+
+		struct Report {
+			Statistics before, after;
+		};
+
+		/// Optimize a triangle mesh in place, first reordering triangles and then vertices. Meshes with other layouts, or without index and vertex arrays, are left unchanged. The arrays must not be shared with other meshes.
+		/// @returns the statistics before and after optimization.
+		Report optimize_mesh(Writer & writer, OffsetT mesh_offset, std::size_t cache_size = DEFAULT_CACHE_SIZE);
+	}
+}
@@ -0,0 +1,201 @@
+//
+//  Welding.cpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Welding.hpp"
+#include "Geometry.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace TaggedFormat
+{
+	namespace Welding
+	{
+		typedef std::pair<uint64_t, uint32_t> EntryT;
+
+		// Cells are clamped so that the conversion to an integer is defined for very large or non-finite components:
+		static int64_t cell_for(double value, float32 cell_size) {
+			double cell = std::floor(value / cell_size);
+
+			if (!(cell > -4e18)) return -4000000000000000000;
+			if (cell > 4e18) return 4000000000000000000;
+
+			return static_cast<int64_t>(cell);
+		}
+
+		static uint64_t hash_cell(const int64_t cell[3]) {
+			uint64_t hash = 1469598103934665603ULL;
+
+			for (std::size_t k = 0; k < 3; k += 1) {
+				hash ^= static_cast<uint64_t>(cell[k]);
+				hash *= 1099511628211ULL;
+				hash ^= hash >> 29;
+			}
+
+			return hash;
+		}
+
+		static bool equivalent(const float32 * a, const float32 * b, std::size_t component_count, float32 tolerance, const std::vector<bool> & exact) {
+			for (std::size_t k = 0; k < component_count; k += 1) {
+				if (!exact.empty() && exact[k]) {
+					if (std::memcmp(a + k, b + k, sizeof(float32)) != 0) return false;
+				} else if (!(std::abs(static_cast<double>(a[k]) - b[k]) <= tolerance)) {
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		std::vector<uint32_t> weld(const float32 * components, std::size_t component_count, std::size_t count, float32 tolerance, const std::vector<bool> & exact) {
+			if (!(tolerance >= 0) || !std::isfinite(tolerance))
+				throw std::invalid_argument("Welding tolerance must be finite and not negative!");
+
+			std::size_t hashed = std::min<std::size_t>(component_count, 3);
+
+			// Cells are at least as large as the tolerance, so duplicates are in the same or an adjacent cell:
+			float32 cell_size = tolerance > 0 ? tolerance : 1;
+
+			std::size_t chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+			std::vector<EntryT> entries(count);
+
+			Parallel::each(chunks, [&](std::size_t chunk) {
+				std::size_t last = std::min(count, (chunk + 1) * CHUNK_SIZE);
+
+				for (std::size_t i = chunk * CHUNK_SIZE; i < last; i += 1) {
+					int64_t cell[3] = {0, 0, 0};
+
+					for (std::size_t k = 0; k < hashed; k += 1)
+						cell[k] = cell_for(components[i * component_count + k], cell_size);
+
+					entries[i] = {hash_cell(cell), static_cast<uint32_t>(i)};
+				}
+			});
+
+			// Within each cell, vertices are in order, so the first match is the earliest:
+			std::sort(entries.begin(), entries.end());
+
+			// The earliest vertex which each vertex duplicates, or itself:
+			std::vector<uint32_t> earliest(count);
+
+			Parallel::each(chunks, [&](std::size_t chunk) {
+				std::size_t last = std::min(count, (chunk + 1) * CHUNK_SIZE);
+
+				for (std::size_t i = chunk * CHUNK_SIZE; i < last; i += 1) {
+					const float32 * vertex = components + i * component_count;
+
+					// Adjacent cells are only searched along the axes where the vertex is within the tolerance of the edge of its cell:
+					int64_t lower[3] = {0, 0, 0}, upper[3] = {0, 0, 0};
+
+					for (std::size_t k = 0; k < hashed; k += 1) {
+						lower[k] = cell_for(static_cast<double>(vertex[k]) - tolerance, cell_size);
+						upper[k] = cell_for(static_cast<double>(vertex[k]) + tolerance, cell_size);
+					}
+
+					uint32_t match = i;
+					int64_t probe[3];
+
+					for (probe[0] = lower[0]; probe[0] <= upper[0]; probe[0] += 1) {
+						for (probe[1] = lower[1]; probe[1] <= upper[1]; probe[1] += 1) {
+							for (probe[2] = lower[2]; probe[2] <= upper[2]; probe[2] += 1) {
+								uint64_t hash = hash_cell(probe);
+								auto entry = std::lower_bound(entries.begin(), entries.end(), EntryT(hash, 0));
+
+								for (; entry != entries.end() && entry->first == hash && entry->second < match; ++entry) {
+									if (equivalent(components + entry->second * component_count, vertex, component_count, tolerance, exact)) {
+										match = entry->second;
+										break;
+									}
+								}
+							}
+						}
+					}
+
+					earliest[i] = match;
+				}
+			});
+
+			// Each vertex is merged into the vertex which its earliest duplicate was merged into, as long as that is also within the tolerance, so that merged vertices never drift further than the tolerance:
+			std::vector<uint32_t> remap(count);
+			std::vector<uint32_t> kept;
+
+			for (std::size_t i = 0; i < count; i += 1) {
+				uint32_t target = kept.empty() ? i : kept[remap[earliest[i]]];
+
+				if (earliest[i] != i && (target == earliest[i] || equivalent(components + target * component_count, components + i * component_count, component_count, tolerance, exact))) {
+					remap[i] = remap[earliest[i]];
+				} else {
+					remap[i] = kept.size();
+					kept.push_back(i);
+				}
+			}
+
+			return remap;
+		}
+
+		// Vertices are made of 32-bit components, which are floats apart from the packed bone indices of skinned vertices:
+		static std::vector<bool> exact_components(TagT tag, std::size_t component_count) {
+			std::vector<bool> exact(component_count, false);
+
+			if (tag == VertexP3N3M2B4::TAG)
+				exact[member_offset(&VertexP3N3M2B4::bones) / sizeof(float32)] = true;
+
+			return exact;
+		}
+
+		std::size_t weld_mesh(Writer & writer, OffsetT mesh_offset, float32 tolerance) {
+			auto mesh = writer.block_at_offset<Mesh>(mesh_offset);
+			OffsetT indices_offset = mesh->indices_offset, vertices_offset = mesh->vertices_offset;
+
+			if (!indices_offset || !vertices_offset) return 0;
+
+			TagT index_tag = writer.block_at_offset<Block>(indices_offset)->tag;
+			TagT vertex_tag = writer.block_at_offset<Block>(vertices_offset)->tag;
+			std::size_t vertex_size = vertex_size_for_tag(vertex_tag);
+
+			if ((index_tag != Index16::TAG && index_tag != Index32::TAG) || !vertex_size) return 0;
+
+			std::size_t count = vertex_count(*writer.block_at_offset<Block>(vertices_offset));
+			std::size_t component_count = vertex_size / sizeof(float32);
+
+			std::vector<float32> components(count * component_count);
+			std::memcpy(components.data(), reinterpret_cast<const Byte *>(*writer.block_at_offset<Block>(vertices_offset)) + sizeof(Block), components.size() * sizeof(float32));
+
+			auto remap = weld(components.data(), component_count, count, tolerance, exact_components(vertex_tag, component_count));
+
+			std::vector<uint32_t> selection;
+
+			for (std::size_t i = 0; i < count; i += 1) {
+				if (remap[i] == selection.size()) selection.push_back(i);
+			}
+
+			if (selection.size() == count) return 0;
+
+			auto indices = read_indices(*writer.block_at_offset<Block>(indices_offset));
+
+			for (auto & index : indices) {
+				if (index >= count)
+					throw std::invalid_argument("Mesh index references a vertex beyond the vertex array!");
+
+				index = remap[index];
+			}
+
+			OffsetT welded_vertices_offset = append_vertices(writer, vertices_offset, selection);
+			OffsetT welded_indices_offset = append_indices(writer, indices, index_tag);
+
+			mesh = writer.block_at_offset<Mesh>(mesh_offset);
+			mesh->vertices_offset = welded_vertices_offset;
+			mesh->indices_offset = welded_indices_offset;
+
+			return count - selection.size();
+		}
+	}
+}
@@ -0,0 +1,37 @@
+//
+//  Welding.hpp
+//  This file is part of the "Tagged Format" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 19/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Mesh.hpp"
+#include "Writer.hpp"
+
+#include <vector>
+
+namespace TaggedFormat
+{
+	/// Merging of duplicate vertices, e.g. along seams in texture coordinates which are not seams in the model.
+	namespace Welding
+	{
+		/// The largest difference between the components of vertices which are merged by `--weld-vertices`.
+		const float32 DEFAULT_TOLERANCE = 1e-5f;
+
+		/// The number of vertices processed by one thread at a time.
+		const std::size_t CHUNK_SIZE = 4096;
+
+		/// Find the vertices which duplicate an earlier vertex, i.e. every component is within `tolerance` of it. Vertices are hashed by the cell of a grid containing their first three components, usually the position, and compared with the vertices in the same and adjacent cells, so duplicates are always found. Large arrays are processed in parallel, and the result doesn't depend on the number of threads.
+		/// @param components the components of every vertex in order, `component_count` per vertex.
+		/// @param exact for each component, true if it is compared bit for bit rather than within the tolerance, e.g. packed bone indices. May be empty.
+		/// @returns the index of every vertex in the welded array, which contains the vertices which are not duplicates, in order.
+		std::vector<uint32_t> weld(const float32 * components, std::size_t component_count, std::size_t count, float32 tolerance, const std::vector<bool> & exact = {});
+
+		/// Weld the vertex array of a mesh and remap its `Index16` or `Index32` indices. New arrays are appended, so arrays shared with other meshes are not modified. Meshes without indices are not welded, as their vertices are their primitives.
+		/// @returns the number of vertices which were removed.
+		std::size_t weld_mesh(Writer & writer, OffsetT mesh_offset, float32 tolerance = DEFAULT_TOLERANCE);
+	}
+}
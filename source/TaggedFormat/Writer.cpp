@@ -8,10 +8,16 @@
 
 #include "Writer.hpp"
 
+#include <algorithm>
+
 namespace TaggedFormat
 {
 	Writer::Writer(ResizableBuffer & buffer) : _buffer(buffer)
 	{
+		// Continue writing to an existing file:
+		if (_buffer.size() >= sizeof(Header)) {
+			_header = BufferedOffset<Header>(0, &_buffer);
+		}
 	}
 	
 	Writer::~Writer()
@@ -27,4 +33,63 @@ namespace TaggedFormat
 		
 		return _header;
 	}
+	
+	void Writer::align(std::size_t alignment)
+	{
+		auto offset = _buffer.size();
+		auto padding = (alignment - offset % alignment) % alignment;
+		
+		if (padding) {
+			_buffer.expand(padding);
+			std::memset(_buffer + offset, 0, padding);
+		}
+	}
+	
+	OffsetT Writer::copy(const Block * block)
+	{
+		auto offset = _buffer.size();
+		
+		_buffer.expand(block->size);
+		std::memcpy(_buffer + offset, block, block->size);
+		
+		if (_record_checksums) checksum(offset);
+		
+		return offset;
+	}
+	
+	OffsetT Writer::copy(const Buffers::Buffer & buffer)
+	{
+		auto offset = _buffer.size();
+		
+		_buffer.expand(buffer.size());
+		std::memcpy(_buffer + offset, buffer.begin(), buffer.size());
+		
+		return offset;
+	}
+	
+	void Writer::checksum(OffsetT offset)
+	{
+		_checksums.push_back({offset, Checksum::block_crc(reinterpret_cast<const Block *>(_buffer + offset))});
+	}
+	
+	OffsetT Writer::append_checksums(OffsetT previous_offset)
+	{
+		std::sort(_checksums.begin(), _checksums.end(), [](const BlockChecksum & a, const BlockChecksum & b) {
+			return a.offset < b.offset;
+		});
+		
+		auto directory = append<Array<BlockChecksum>>(Array<BlockChecksum>::array_size(_checksums.size()));
+		std::copy(_checksums.begin(), _checksums.end(), directory->begin());
+		
+		uint32_t directory_crc = Checksum::block_crc(*directory);
+		
+		auto trailer = append<ChecksumTrailer>();
+		trailer->directory_offset = directory;
+		trailer->directory_crc = directory_crc;
+		trailer->previous_offset = previous_offset;
+		
+		_checksums.clear();
+		
+		return trailer;
+	}
 }
@@ -9,10 +9,12 @@
 #pragma once
 
 #include "Block.hpp"
+#include "Checksum.hpp"
 
 #include <Buffers/ResizableBuffer.hpp>
 
 #include <cstring>
+#include <vector>
 
 namespace TaggedFormat {
 	using Buffers::MutableBuffer;
@@ -61,6 +63,55 @@ namespace TaggedFormat {
 		
 		BufferedOffset<Header> header();
 		
+		/// @returns the block at the given offset, for modifying blocks which have already been written.
+		template <typename BlockT>
+		BufferedOffset<BlockT> block_at_offset(OffsetT offset) {
+			return BufferedOffset<BlockT>(offset, &_buffer);
+		}
+		
+		/// Pad the buffer with zeros so that the next block is appended at a multiple of the given alignment.
+		void align(std::size_t alignment);
+		
+		/// Append a verbatim copy of an existing block, which may be from a different buffer.
+		OffsetT copy(const Block * block);
+		
+		/// Append a verbatim copy of an entire buffer, e.g. another file.
+		/// @returns the offset of the first byte of the copy.
+		OffsetT copy(const Buffers::Buffer & buffer);
+		
+		/// Append a copy of an existing block, and invoke the callback with the copy so that it can be updated, e.g. to relocate offsets, before its checksum is recorded.
+		template <typename CallbackT>
+		OffsetT copy(const Block * block, CallbackT && callback) {
+			auto offset = _buffer.size();
+			
+			_buffer.expand(block->size);
+			std::memcpy(_buffer + offset, block, block->size);
+			
+			callback(reinterpret_cast<Block *>(_buffer + offset));
+			
+			if (_record_checksums) checksum(offset);
+			
+			return offset;
+		}
+		
+		/// Record the checksum of every block subsequently copied. Appended blocks are usually modified after they are appended, so their checksums must be recorded explicitly.
+		void record_checksums(bool enabled = true) {
+			_record_checksums = enabled;
+		}
+		
+		/// Record the checksum of a block whose contents are final.
+		void checksum(OffsetT offset);
+		
+		/// Record the known checksum of a block, e.g. from an existing checksum directory.
+		void checksum(OffsetT offset, uint32_t crc) {
+			_checksums.push_back({offset, crc});
+		}
+		
+		/// Append a directory of the recorded checksums, followed by the trailer which refers to it. This must be the last block in the file.
+		/// @param previous_offset the trailer of the checksums of the previous generation, which covers the blocks before this directory.
+		/// @returns the offset of the trailer.
+		OffsetT append_checksums(OffsetT previous_offset = 0);
+		
 		template <typename BlockT>
 		BufferedOffset<BlockT> append(OffsetT capacity = 0) {
 			BlockT block;
@@ -82,5 +133,8 @@ namespace TaggedFormat {
 	protected:
 		ResizableBuffer & _buffer;
 		BufferedOffset<Header> _header;
+		
+		bool _record_checksums = false;
+		std::vector<BlockChecksum> _checksums;
 	};
 }
@@ -41,6 +41,22 @@ define_target 'tagged-format-test' do |target|
 	end
 end
 
+define_target 'tagged-format-benchmark' do |target|
+	target.depends 'Library/TaggedFormat'
+	
+	target.depends 'Language/C++14'
+	
+	target.depends :executor
+	
+	target.provides 'Benchmark/TaggedFormat' do |*arguments|
+		benchmark_root = target.package.path + 'benchmark'
+		
+		executable_path = build executable: 'TaggedFormat-benchmark', source_files: benchmark_root.glob('TaggedFormat/**/*.cpp')
+		
+		run executable_file: executable_path, arguments: arguments
+	end
+end
+
 define_target 'tagged-format-executable' do |target|
 	target.depends 'Library/TaggedFormat'
 	
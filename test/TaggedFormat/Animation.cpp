@@ -0,0 +1,174 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Animation.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+
+namespace TaggedFormat {
+	const char * AnimationSkeletonText =
+		"animation: array skeleton-animation-key-frame\n"
+		"	1 linear 30.0 1 0 0 0 0 1 0 0 0 0 1 0 0 10 0 1\n"
+		"	1 linear 0.0 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+		"	2 linear 0.0 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+		"	2 bezier 10.0 0 1 0 0 -1 0 0 0 0 0 1 0 0 0 0 1\n"
+		"	2 linear 20.0 -1 0 0 0 0 -1 0 0 0 0 1 0 0 0 0 1\n"
+		"end\n"
+		"skeleton: skeleton\n"
+		"	bones: array skeleton-bone\n"
+		"		root 0 1 0 0 0 0 1 0 0 0 0 1 0 0 5 0 1\n"
+		"		arm 0 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+		"		hand 1 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+		"	end\n"
+		"end\n"
+		"top: offset-table\n"
+		"	skeleton: $skeleton\n"
+		"	animation: $animation\n"
+		"end\n";
+
+	static bool close_to(float32 a, float32 b) {
+		return std::abs(a - b) < 1e-4;
+	}
+
+	static float32 rotation_angle(const Transform & transform) {
+		return 2 * std::atan2(transform.rotation[2], transform.rotation[3]);
+	}
+
+	UnitTest::Suite AnimationTestSuite {
+		"Test Animation",
+
+		{"it can decompose and compose transforms",
+			[](UnitTest::Examiner & examiner) {
+				// A rotation of 90 degrees about z, scaled by 2 and translated:
+				float32 matrix[16] = {
+					0, 2, 0, 0,
+					-2, 0, 0, 0,
+					0, 0, 2, 0,
+					1, 2, 3, 1
+				};
+
+				Transform transform;
+				Animation::decompose(matrix, transform);
+
+				examiner.check(close_to(transform.translation[2], 3));
+				examiner.check(close_to(transform.scale[0], 2));
+				examiner.check(close_to(rotation_angle(transform), M_PI / 2));
+
+				float32 result[16];
+				Animation::compose(transform, result);
+
+				std::size_t mismatches = 0;
+
+				for (std::size_t i = 0; i < 16; i += 1) {
+					if (!close_to(matrix[i], result[i])) mismatches += 1;
+				}
+
+				examiner.expect(mismatches) == 0;
+			}
+		},
+
+		{"it interpolates rotations along the shortest arc",
+			[](UnitTest::Examiner & examiner) {
+				Transform from = {{0, 0, 0, 0}, {0, 0, 0, 1}, {1, 1, 1, 0}};
+				Transform to = from;
+
+				// 90 degrees about z, given as the negated quaternion:
+				to.rotation[2] = -std::sin(M_PI / 4);
+				to.rotation[3] = -std::cos(M_PI / 4);
+
+				Transform result;
+				Animation::interpolate(from, to, 0.5, result);
+
+				examiner.check(close_to(std::abs(rotation_angle(result)), M_PI / 4));
+				examiner.check(close_to(result.rotation[0] * result.rotation[0] + result.rotation[1] * result.rotation[1] + result.rotation[2] * result.rotation[2] + result.rotation[3] * result.rotation[3], 1));
+			}
+		},
+
+		{"it can sample a skeleton",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(AnimationSkeletonText);
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Reader reader(buffer);
+				auto skeleton = reader.block_at_offset<Skeleton>(reader.asset_offset("skeleton"));
+				auto bones = reader.array_at_offset<SkeletonBone>(skeleton->bones_offset);
+				auto key_frames = reader.array_at_offset<SkeletonAnimationKeyFrame>(reader.asset_offset("animation"));
+
+				AnimationSampler sampler(bones, key_frames);
+				examiner.expect(sampler.bone_count()) == 3;
+				examiner.expect(sampler.start_time()) == 0;
+				examiner.expect(sampler.end_time()) == 30;
+
+				auto cursors = sampler.cursors();
+				Transform pose[3];
+
+				sampler.sample(15, cursors, pose);
+
+				// Bones without key frames use the bind pose:
+				examiner.check(close_to(pose[0].translation[1], 5));
+
+				// Key frames are sorted by time:
+				examiner.check(close_to(pose[1].translation[1], 5));
+
+				// The rotation is held after the last key frame:
+				sampler.sample(40, cursors, pose);
+				examiner.check(close_to(pose[1].translation[1], 10));
+				examiner.check(close_to(std::abs(rotation_angle(pose[2])), M_PI));
+
+				// The first segment is linear:
+				sampler.sample(5, cursors, pose);
+				examiner.check(close_to(rotation_angle(pose[2]), M_PI / 4));
+
+				// The second segment eases in and out:
+				sampler.sample(12.5, cursors, pose);
+				examiner.check(close_to(rotation_angle(pose[2]), M_PI / 2 + M_PI / 2 * 0.15625));
+			}
+		},
+
+		{"it gives the same results for playback and seeking",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream text;
+				text << "top: array skeleton-animation-key-frame\n";
+
+				for (std::size_t i = 0; i < 100; i += 1) {
+					float32 angle = i * 0.3;
+					text << "	" << (i % 4) << " linear " << (i / 4) * 0.5 << " " << std::cos(angle) << " " << std::sin(angle) << " 0 0 " << -std::sin(angle) << " " << std::cos(angle) << " 0 0 0 0 1 0 " << i << " 0 0 1\n";
+				}
+
+				text << "end\n";
+
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(text, buffer);
+
+				Reader reader(buffer);
+				AnimationSampler sampler(nullptr, reader.array_at_offset<SkeletonAnimationKeyFrame>(reader.header()->top_offset));
+				examiner.expect(sampler.bone_count()) == 4;
+
+				auto playback = sampler.cursors();
+				std::size_t mismatches = 0;
+
+				auto compare = [&](float32 time) {
+					auto seek = sampler.cursors();
+					Transform a[4], b[4];
+
+					sampler.sample(time, playback, a);
+					sampler.sample(time, seek, b);
+
+					for (std::size_t i = 0; i < 4; i += 1) {
+						if (!close_to(a[i].translation[0], b[i].translation[0]) || !close_to(a[i].rotation[2], b[i].rotation[2])) mismatches += 1;
+					}
+				};
+
+				for (float32 time = -1; time < 14; time += 0.07) compare(time);
+				for (float32 time = 14; time > -1; time -= 1.3) compare(time);
+
+				examiner.expect(mismatches) == 0;
+			}
+		},
+	};
+}
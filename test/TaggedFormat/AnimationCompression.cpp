@@ -0,0 +1,188 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/AnimationCompression.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+#include <sstream>
+
+namespace TaggedFormat {
+	// Bone 0 moves at a constant speed, bone 1 swings back and forth and bone 2 doesn't move:
+	static void compression_animation(std::size_t count, Buffers::DynamicBuffer & buffer) {
+		std::stringstream text;
+
+		text << "animation: array skeleton-animation-key-frame\n";
+
+		for (std::size_t i = 0; i < count; i += 1) {
+			float32 time = i * 0.1f, angle = std::sin(time);
+
+			text << "	0 linear " << time << " 1 0 0 0 0 1 0 0 0 0 1 0 " << time << " 0 0 1\n";
+			text << "	1 linear " << time << " " << std::cos(angle) << " " << -std::sin(angle) << " 0 0 " << std::sin(angle) << " " << std::cos(angle) << " 0 0 0 0 1 0 0 2 0 1\n";
+			text << "	2 linear " << time << " 2 0 0 0 0 2 0 0 0 0 2 0 0 0 1 1\n";
+		}
+
+		text << "end\n";
+		text << "walk: skeleton-animation 0 " << (count - 1) * 0.1f << "\n";
+		text << "	key-frames: $animation\n";
+		text << "end\n";
+		text << "top: offset-table\n";
+		text << "	walk: $walk\n";
+		text << "end\n";
+
+		Parser::serialize(text, buffer);
+	}
+
+	// A single bone which accelerates over the given distance, wobbling from side to side:
+	static void travel_animation(float32 distance, Buffers::DynamicBuffer & buffer) {
+		std::stringstream text;
+
+		text << "animation: array skeleton-animation-key-frame\n";
+
+		for (std::size_t i = 0; i <= 100; i += 1) {
+			float32 time = i * 0.1f;
+
+			text << "	0 linear " << time << " 1 0 0 0 0 1 0 0 0 0 1 0 " << distance * i * i / 10000 << " " << std::sin(time * 5) / 10 << " 0 1\n";
+		}
+
+		text << "end\n";
+		text << "travel: skeleton-animation 0 10\n";
+		text << "	key-frames: $animation\n";
+		text << "end\n";
+		text << "top: offset-table\n";
+		text << "	travel: $travel\n";
+		text << "end\n";
+
+		Parser::serialize(text, buffer);
+	}
+
+	UnitTest::Suite AnimationCompressionTestSuite {
+		"Test Animation Compression",
+
+		{"it has the correct size",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(CompressedKey)) == 20;
+				examiner.expect(sizeof(CompressedTrack)) == 60;
+			}
+		},
+
+		{"it removes keys which can be interpolated",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer buffer;
+				compression_animation(101, buffer);
+
+				Reader reader(buffer);
+				auto keys = AnimationSampler::decompose_key_frames(reader.array_at_offset<SkeletonAnimationKeyFrame>(reader.block_at_offset<SkeletonAnimation>(reader.asset_offset("walk"))->key_frames_offset));
+
+				examiner.expect(keys.size()) == 303;
+
+				auto reduced = AnimationCompression::reduce(keys, 0.01);
+				std::size_t counts[3] = {0, 0, 0};
+
+				for (auto & key : reduced) counts[key.bone] += 1;
+
+				// The first and last key of the linear motion, and the first key of the constant one:
+				examiner.expect(counts[0]) == 2;
+				examiner.expect(counts[2]) == 1;
+
+				// The swing needs some keys, but not all of them:
+				examiner.check(counts[1] > 2 && counts[1] < 101);
+			}
+		},
+
+		{"it compresses animations within the tolerance",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer buffer, output;
+				compression_animation(101, buffer);
+
+				Pipeline pipeline;
+				pipeline.animation_tolerance = 0.01;
+				pipeline.apply(buffer, output);
+
+				Reader original_reader(buffer), compressed_reader(output);
+
+				auto original_animation = original_reader.block_at_offset<SkeletonAnimation>(original_reader.asset_offset("walk"));
+				auto compressed_animation = compressed_reader.block_at_offset<SkeletonAnimation>(compressed_reader.asset_offset("walk"));
+
+				auto original_key_frames = original_reader.block_at_offset(original_animation->key_frames_offset);
+				auto compressed = compressed_reader.block_at_offset<CompressedAnimation>(compressed_animation->key_frames_offset);
+
+				examiner.expect(compressed->tag) == CompressedAnimation::TAG;
+
+				std::size_t compressed_size = compressed->size + compressed_reader.block_at_offset(compressed->tracks_offset)->size + compressed_reader.block_at_offset(compressed->keys_offset)->size;
+				examiner.check(original_key_frames->size >= compressed_size * 5);
+
+				AnimationSampler original(nullptr, AnimationCompression::read_keys(original_reader, original_animation->key_frames_offset));
+				AnimationSampler sampler(nullptr, AnimationCompression::read_keys(compressed_reader, compressed_animation->key_frames_offset));
+
+				examiner.expect(sampler.bone_count()) == 3;
+
+				auto original_cursors = original.cursors(), cursors = sampler.cursors();
+				float32 maximum = 0;
+
+				for (std::size_t i = 0; i <= 1000; i += 1) {
+					float32 time = i * 0.01f;
+
+					Transform expected[3], pose[3];
+					original.sample(time, original_cursors, expected);
+					sampler.sample(time, cursors, pose);
+
+					for (std::size_t bone = 0; bone < 3; bone += 1)
+						maximum = std::max(maximum, AnimationCompression::error(expected[bone], pose[bone]));
+				}
+
+				// Quantization adds a small error to the tolerance:
+				examiner.check(maximum < 0.012);
+			}
+		},
+
+		{"it includes quantization error for tracks with a large range",
+			[](UnitTest::Examiner & examiner) {
+				const float32 tolerance = 0.001;
+
+				for (float32 distance : {20.0f, 200.0f}) {
+					Buffers::DynamicBuffer buffer, output;
+					travel_animation(distance, buffer);
+
+					Pipeline pipeline;
+					pipeline.animation_tolerance = tolerance;
+					pipeline.apply(buffer, output);
+
+					Reader original_reader(buffer), compressed_reader(output);
+
+					auto original_animation = original_reader.block_at_offset<SkeletonAnimation>(original_reader.asset_offset("travel"));
+					auto compressed_animation = compressed_reader.block_at_offset<SkeletonAnimation>(compressed_reader.asset_offset("travel"));
+
+					auto tag = compressed_reader.block_at_offset(compressed_animation->key_frames_offset)->tag;
+
+					// A 16 bit step over 200m is 3mm, so quantization alone exceeds the tolerance, and the key frames are kept:
+					if (distance > 100) {
+						examiner.expect(tag) == SkeletonAnimationKeyFrame::TAG;
+						continue;
+					}
+
+					examiner.expect(tag) == CompressedAnimation::TAG;
+
+					auto keys = AnimationCompression::read_keys(original_reader, original_animation->key_frames_offset);
+					AnimationSampler sampler(nullptr, AnimationCompression::read_keys(compressed_reader, compressed_animation->key_frames_offset));
+
+					auto cursors = sampler.cursors();
+					float32 maximum = 0;
+
+					for (auto & key : keys) {
+						Transform transform;
+						sampler.sample_bone(key.bone, key.time, cursors, transform);
+
+						maximum = std::max(maximum, AnimationCompression::error(transform, key.transform));
+					}
+
+					examiner.expect(maximum) <= tolerance;
+				}
+			}
+		},
+	};
+}
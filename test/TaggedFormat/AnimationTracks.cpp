@@ -0,0 +1,204 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/AnimationTracks.hpp>
+#include <TaggedFormat/AnimationCompression.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/Skeleton.hpp>
+#include <TaggedFormat/Table.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+
+namespace TaggedFormat {
+	const char * AnimationTracksText =
+		"animation: array skeleton-animation-key-frame\n"
+		"	0 linear 0.0 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+		"	0 linear 10.0 1 0 0 0 0 1 0 0 0 0 1 0 5 0 0 1\n"
+		"	1 bezier 0.0 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+		"	1 linear 4.0 0 1 0 0 -1 0 0 0 0 0 1 0 0 0 0 1\n"
+		"	1 linear 10.0 -1 0 0 0 0 -1 0 0 0 0 1 0 0 0 0 1\n"
+		"	2 linear 0.0 1 0 0 0 0 1 0 0 0 0 1 0 0 1 0 1\n"
+		"	2 linear 5.0 2 0 0 0 0 2 0 0 0 0 2 0 0 1 0 1\n"
+		"end\n"
+		"walk: skeleton-animation 0.0 10.0\n"
+		"	key-frames: $animation\n"
+		"end\n"
+		"top: offset-table\n"
+		"	walk: $walk\n"
+		"end\n";
+
+	static void resample_tracks(Buffers::DynamicBuffer & output, ResampledAnimation::Layout layout, float32 tolerance = 0) {
+		std::stringstream input(AnimationTracksText);
+		Buffers::DynamicBuffer buffer;
+		Parser::serialize(input, buffer);
+
+		Pipeline pipeline;
+		pipeline.sample_rate = 10;
+		pipeline.sample_layout = layout;
+		pipeline.animation_tolerance = tolerance;
+		pipeline.apply(buffer, output);
+	}
+
+	static const ResampledAnimation * resampled_animation(Reader & reader) {
+		return reader.block_at_offset<ResampledAnimation>(reader.block_at_offset<SkeletonAnimation>(reader.asset_offset("walk"))->key_frames_offset);
+	}
+
+	UnitTest::Suite AnimationTracksTestSuite {
+		"Test Animation Tracks",
+
+		{"it has the correct size",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(TrackSample)) == 40;
+			}
+		},
+
+		{"it matches the key frame sampler in either layout",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer frame_major_buffer, bone_major_buffer;
+				resample_tracks(frame_major_buffer, ResampledAnimation::Layout::FRAME_MAJOR);
+				resample_tracks(bone_major_buffer, ResampledAnimation::Layout::BONE_MAJOR);
+
+				Reader frame_major_reader(frame_major_buffer), bone_major_reader(bone_major_buffer);
+				auto frame_major_animation = resampled_animation(frame_major_reader), bone_major_animation = resampled_animation(bone_major_reader);
+
+				examiner.expect(frame_major_animation->tag) == ResampledAnimation::TAG;
+				examiner.expect(frame_major_animation->frame_count) == 101;
+				examiner.expect(frame_major_animation->bone_count) == 3;
+				examiner.check(bone_major_animation->layout == ResampledAnimation::Layout::BONE_MAJOR);
+
+				TrackSampler frame_major(frame_major_animation, frame_major_reader.array_at_offset<TrackSample>(frame_major_animation->samples_offset));
+				TrackSampler bone_major(bone_major_animation, bone_major_reader.array_at_offset<TrackSample>(bone_major_animation->samples_offset));
+
+				// The key frames are kept:
+				AnimationSampler sampler(nullptr, AnimationCompression::read_keys(frame_major_reader, frame_major_animation->key_frames_offset));
+				auto cursors = sampler.cursors();
+
+				examiner.expect(frame_major.end_time()) == 10;
+
+				float32 frame_error = 0, between_error = 0;
+				std::size_t mismatches = 0;
+
+				for (std::size_t i = 0; i <= 200; i += 1) {
+					float32 time = i * 0.05f;
+
+					Transform expected[3], pose[3], bone_major_pose[3];
+					sampler.sample(time, cursors, expected);
+					frame_major.sample(time, pose);
+					bone_major.sample(time, bone_major_pose);
+
+					for (std::size_t bone = 0; bone < 3; bone += 1) {
+						float32 error = AnimationCompression::error(expected[bone], pose[bone]);
+
+						if (i % 2) between_error = std::max(between_error, error);
+						else frame_error = std::max(frame_error, error);
+
+						if (AnimationCompression::error(pose[bone], bone_major_pose[bone]) != 0) mismatches += 1;
+
+						Transform single;
+						bone_major.sample_bone(bone, time, single);
+
+						if (AnimationCompression::error(pose[bone], single) != 0) mismatches += 1;
+					}
+				}
+
+				examiner.check(frame_error < 1e-3);
+				examiner.check(between_error < 1e-2);
+				examiner.expect(mismatches) == 0;
+			}
+		},
+
+		{"it holds the first and last frames",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer buffer;
+				resample_tracks(buffer, ResampledAnimation::Layout::FRAME_MAJOR);
+
+				Reader reader(buffer);
+				auto animation = resampled_animation(reader);
+				TrackSampler sampler(animation, reader.array_at_offset<TrackSample>(animation->samples_offset));
+
+				Transform before, first, after, last;
+				sampler.sample_bone(0, -5, before);
+				sampler.sample_bone(0, 0, first);
+				sampler.sample_bone(0, 50, after);
+				sampler.sample_bone(0, 10, last);
+
+				examiner.expect(AnimationCompression::error(before, first)) == 0;
+				examiner.expect(AnimationCompression::error(after, last)) == 0;
+				examiner.check(std::abs(last.translation[0] - 5) < 1e-4);
+			}
+		},
+
+		{"it can be combined with compression",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer buffer;
+				resample_tracks(buffer, ResampledAnimation::Layout::FRAME_MAJOR, AnimationCompression::DEFAULT_TOLERANCE);
+
+				Reader reader(buffer);
+				auto animation = resampled_animation(reader);
+
+				examiner.expect(animation->tag) == ResampledAnimation::TAG;
+				examiner.expect(reader.block_at_offset(animation->key_frames_offset)->tag) == CompressedAnimation::TAG;
+
+				auto keys = AnimationCompression::read_keys(reader, reader.block_at_offset<SkeletonAnimation>(reader.asset_offset("walk"))->key_frames_offset);
+				examiner.check(keys.size() > 0);
+
+				TrackSampler sampler(animation, reader.array_at_offset<TrackSample>(animation->samples_offset));
+				examiner.expect(sampler.frame_count()) == 101;
+			}
+		},
+
+		{"it uses the bind pose of bones without key frames",
+			[](UnitTest::Examiner & examiner) {
+				// Only the first bone has key frames, the others keep their bind pose:
+				std::stringstream input(
+					"animation: array skeleton-animation-key-frame\n"
+					"	0 linear 0.0 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+					"	0 linear 1.0 1 0 0 0 0 1 0 0 0 0 1 0 4 0 0 1\n"
+					"end\n"
+					"top: skeleton\n"
+					"	bones: array skeleton-bone\n"
+					"		root 0 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+					"		arm 0 1 0 0 0 0 1 0 0 0 0 1 0 0 0 7 1\n"
+					"		hand 1 1 0 0 0 0 1 0 0 0 0 1 0 0 3 0 1\n"
+					"	end\n"
+					"	sequences: offset-table\n"
+					"		wave: skeleton-animation 0.0 1.0\n"
+					"			key-frames: $animation\n"
+					"		end\n"
+					"	end\n"
+					"end\n"
+				);
+				Buffers::DynamicBuffer buffer, output;
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.sample_rate = 10;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto skeleton = reader.block_at_offset<Skeleton>(reader.header()->top_offset);
+				auto sequence = reader.block_at_offset<SkeletonAnimation>(reader.block_at_offset<OffsetTable>(skeleton->sequences_offset)->offset_named("wave"));
+				auto animation = reader.block_at_offset<ResampledAnimation>(sequence->key_frames_offset);
+
+				examiner.check(animation);
+				examiner.expect(animation->bone_count) == 3;
+
+				TrackSampler sampler(animation, reader.array_at_offset<TrackSample>(animation->samples_offset));
+
+				Transform root, arm, hand;
+				sampler.sample_bone(0, 1, root);
+				sampler.sample_bone(1, 0.5, arm);
+				sampler.sample_bone(2, 0.5, hand);
+
+				examiner.check(std::abs(root.translation[0] - 4) < 1e-4);
+				examiner.check(std::abs(arm.translation[2] - 7) < 1e-4);
+				examiner.check(std::abs(hand.translation[1] - 3) < 1e-4);
+				examiner.check(std::abs(hand.rotation[3] - 1) < 1e-4);
+			}
+		},
+	};
+}
@@ -0,0 +1,199 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/BVH.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+
+namespace TaggedFormat {
+	// A height field with enough triangles for several levels of nodes:
+	static void height_field(std::size_t size, std::vector<uint32_t> & indices, std::vector<float32> & positions) {
+		for (std::size_t y = 0; y <= size; y += 1) {
+			for (std::size_t x = 0; x <= size; x += 1) {
+				positions.insert(positions.end(), {float32(x), float32(y), std::sin(x * 0.7f) * std::cos(y * 0.3f)});
+			}
+		}
+
+		for (std::size_t y = 0; y < size; y += 1) {
+			for (std::size_t x = 0; x < size; x += 1) {
+				uint32_t a = uint32_t(y * (size + 1) + x), b = a + 1, c = a + uint32_t(size + 1), d = c + 1;
+
+				indices.insert(indices.end(), {a, b, c, c, b, d});
+			}
+		}
+	}
+
+	static float brute_force_raycast(const std::vector<uint32_t> & indices, const std::vector<float32> & positions, const float32 origin[3], const float32 direction[3]) {
+		float best = 1e9f;
+
+		for (std::size_t t = 0; t < indices.size(); t += 3) {
+			BVHTriangle triangle;
+			const float32 * a = &positions[indices[t] * 3], * b = &positions[indices[t+1] * 3], * c = &positions[indices[t+2] * 3];
+
+			for (std::size_t k = 0; k < 3; k += 1) {
+				triangle.origin[k] = a[k];
+				triangle.edge1[k] = b[k] - a[k];
+				triangle.edge2[k] = c[k] - a[k];
+			}
+
+			triangle.index = uint32_t(t / 3);
+
+			BVH::Tree tree;
+			BVHNode node;
+			std::fill_n(node.minimum_x, 4, -1e9f); std::fill_n(node.minimum_y, 4, -1e9f); std::fill_n(node.minimum_z, 4, -1e9f);
+			std::fill_n(node.maximum_x, 4, 1e9f); std::fill_n(node.maximum_y, 4, 1e9f); std::fill_n(node.maximum_z, 4, 1e9f);
+			std::fill_n(node.children, 4, BVHNode::EMPTY);
+			std::fill_n(node.counts, 4, 0);
+			node.children[0] = 0;
+			node.counts[0] = 1;
+
+			tree.nodes = &node;
+			tree.node_count = 1;
+			tree.triangles = &triangle;
+			tree.triangle_count = 1;
+
+			BVH::Hit hit;
+			if (BVH::raycast(tree, origin, direction, best, hit))
+				best = hit.distance;
+		}
+
+		return best;
+	}
+
+	UnitTest::Suite BVHTestSuite {
+		"Test BVH",
+
+		{"it has the expected layout",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(BVHNode)) == 128;
+				examiner.expect(sizeof(BVHTriangle)) == 40;
+			}
+		},
+
+		{"it can raycast against a height field",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices;
+				std::vector<float32> positions;
+				height_field(32, indices, positions);
+
+				std::vector<BVHNode> nodes;
+				std::vector<BVHTriangle> triangles;
+				BVH::build(indices, positions, nodes, triangles);
+
+				examiner.expect(triangles.size()) == indices.size() / 3;
+				examiner.expect(nodes.size()) > 1;
+
+				BVH::Tree tree;
+				tree.nodes = nodes.data();
+				tree.node_count = nodes.size();
+				tree.triangles = triangles.data();
+				tree.triangle_count = triangles.size();
+
+				std::size_t matches = 0, count = 0;
+
+				for (std::size_t i = 0; i < 50; i += 1) {
+					float32 origin[3] = {float32(i % 7) * 4.3f + 1, float32(i % 11) * 2.7f + 1, 5};
+					float32 direction[3] = {0.1f * float32(i % 3), -0.05f * float32(i % 5), -1};
+
+					float expected = brute_force_raycast(indices, positions, origin, direction);
+
+					BVH::Hit hit;
+					bool found = BVH::raycast(tree, origin, direction, 1e9f, hit);
+
+					count += 1;
+					if (found && std::fabs(hit.distance - expected) < 1e-4f) matches += 1;
+				}
+
+				examiner.expect(matches) == count;
+
+				// Pointing away from the surface:
+				float32 origin[3] = {10, 10, 5}, up[3] = {0, 0, 1};
+				BVH::Hit hit;
+				examiner.expect(BVH::raycast(tree, origin, up, 1e9f, hit)) == false;
+
+				float32 below[3] = {10, 10, -5};
+				examiner.expect(BVH::intersects_segment(tree, origin, below)) == true;
+
+				float32 beside[3] = {10, 20, 5};
+				examiner.expect(BVH::intersects_segment(tree, origin, beside)) == false;
+			}
+		},
+
+		{"it can find the closest point",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices;
+				std::vector<float32> positions;
+				height_field(16, indices, positions);
+
+				std::vector<BVHNode> nodes;
+				std::vector<BVHTriangle> triangles;
+				BVH::build(indices, positions, nodes, triangles);
+
+				BVH::Tree tree;
+				tree.nodes = nodes.data();
+				tree.node_count = nodes.size();
+				tree.triangles = triangles.data();
+				tree.triangle_count = triangles.size();
+
+				// Directly above a corner of the grid, which is at height 0:
+				float32 point[3] = {-3, -4, 0};
+				BVH::ClosestPoint result;
+
+				examiner.expect(BVH::closest_point(tree, point, 1e9f, result)) == true;
+				examiner.expect(std::fabs(result.distance_squared - 25)) < 1e-4f;
+				examiner.expect(std::fabs(result.point[0])) < 1e-5f;
+				examiner.expect(std::fabs(result.point[1])) < 1e-5f;
+
+				// Nothing is within the limit:
+				examiner.expect(BVH::closest_point(tree, point, 1, result)) == false;
+			}
+		},
+
+		{"it can build a hierarchy for a mesh",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(
+					"Quad: mesh triangles\n"
+					"	indices: array index16\n"
+					"		0 1 2 2 1 3\n"
+					"	end\n"
+					"	vertices: array vertex-p3n3m2\n"
+					"		0 0 0 0 0 1 0 0\n"
+					"		1 0 0 0 0 1 1 0\n"
+					"		0 1 0 0 0 1 0 1\n"
+					"		1 1 0 0 0 1 1 1\n"
+					"	end\n"
+					"end\n"
+					"top: $Quad\n"
+				);
+
+				Buffers::DynamicBuffer buffer, output;
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.build_bvh = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+
+				auto mesh = reader.block_at_offset<Mesh>(reader.header()->top_offset);
+				examiner.check(mesh);
+
+				BVH::Tree tree;
+				examiner.expect(BVH::tree_for_mesh(reader, mesh, tree)) == true;
+				examiner.expect(tree.triangle_count) == 2;
+
+				float32 origin[3] = {0.75f, 0.75f, 1}, direction[3] = {0, 0, -1};
+				BVH::Hit hit;
+
+				examiner.expect(BVH::raycast(tree, origin, direction, 10, hit)) == true;
+				examiner.expect(hit.triangle) == 1;
+				examiner.expect(std::fabs(hit.distance - 1)) < 1e-6f;
+			}
+		},
+	};
+}
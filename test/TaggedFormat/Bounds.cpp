@@ -0,0 +1,102 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Bounds.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+namespace TaggedFormat {
+	const char * BoundsSceneText =
+		"Box-mesh: mesh triangles\n"
+		"	indices: array index16\n"
+		"		0 1 2 2 1 3\n"
+		"	end\n"
+		"	vertices: array vertex-p3n3m2\n"
+		"		-1 -2 -3 0 0 1 0 0\n"
+		"		 1 -2 -3 0 0 1 1 0\n"
+		"		-1  2  3 0 0 1 0 1\n"
+		"		 1  2  3 0 0 1 1 1\n"
+		"	end\n"
+		"end\n"
+		"Scene: node\n"
+		"	root 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+		"	node\n"
+		"		child 2 0 0 0 0 2 0 0 0 0 2 0 10 0 0 1\n"
+		"		geometry-instance\n"
+		"			mesh: $Box-mesh\n"
+		"		end\n"
+		"	end\n"
+		"end\n"
+		"top: $Scene\n";
+
+	UnitTest::Suite BoundsTestSuite {
+		"Test Bounds",
+
+		{"it can compute the minimum and maximum",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<float32> positions;
+
+				for (std::size_t i = 0; i < 11; i += 1) {
+					positions.insert(positions.end(), {float32(i), -float32(i) * 2, float32((i * 7) % 5)});
+				}
+
+				float32 minimum[3], maximum[3];
+				BoundingVolumes::minimum_maximum(positions.data(), 11, minimum, maximum);
+
+				examiner.expect(minimum[0]) == 0;
+				examiner.expect(maximum[0]) == 10;
+				examiner.expect(minimum[1]) == -20;
+				examiner.expect(maximum[1]) == 0;
+				examiner.expect(minimum[2]) == 0;
+				examiner.expect(maximum[2]) == 4;
+			}
+		},
+
+		{"it can compute bounds for meshes and nodes",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(BoundsSceneText);
+				Buffers::DynamicBuffer buffer, output;
+
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.compute_bounds = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+				examiner.check(root);
+				examiner.check_equal(root->name, "root");
+
+				auto root_bounds = BoundingVolumes::node_bounds(reader, root);
+				examiner.check(root_bounds);
+
+				// The child scales by 2 and translates by 10 along x:
+				examiner.expect(root_bounds->minimum[0]) == 8;
+				examiner.expect(root_bounds->maximum[0]) == 12;
+				examiner.expect(root_bounds->minimum[2]) == -6;
+				examiner.expect(root_bounds->maximum[2]) == 6;
+				examiner.expect(root_bounds->center[0]) == 10;
+
+				auto child = reader.block_at_offset<Node>(root->at(0));
+				examiner.check(child);
+
+				auto instance = reader.block_at_offset<GeometryInstance>(child->at(0));
+				examiner.check(instance);
+
+				auto mesh = reader.block_at_offset<Mesh>(instance->mesh_offset);
+				auto mesh_bounds = reader.block_at_offset<Bounds>(reader.metadata_offset(mesh, BoundingVolumes::METADATA_NAME));
+				examiner.check(mesh_bounds);
+
+				examiner.expect(mesh_bounds->minimum[1]) == -2;
+				examiner.expect(mesh_bounds->maximum[1]) == 2;
+				examiner.expect(mesh_bounds->radius) > 3.7f;
+				examiner.expect(mesh_bounds->radius) < 3.75f;
+			}
+		},
+	};
+}
@@ -0,0 +1,121 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Bundle.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/Streams.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <stdexcept>
+
+namespace TaggedFormat {
+	const char * BundleMeshText =
+		"Quad: mesh triangles\n"
+		"	indices: array index16\n"
+		"		0 1 2 2 1 3\n"
+		"	end\n"
+		"	vertices: array vertex-p3n3m2\n"
+		"		0 0 0 0 0 1 0 0\n"
+		"		1 0 0 0 0 1 1 0\n"
+		"		0 1 0 0 0 1 0 1\n"
+		"		1 1 0 0 0 1 1 1\n"
+		"	end\n"
+		"end\n"
+		"top: $Quad\n";
+
+	static void convert_bundle_asset(const Pipeline & pipeline, Buffers::DynamicBuffer & output) {
+		std::stringstream input(BundleMeshText);
+		Buffers::DynamicBuffer buffer;
+
+		Parser::serialize(input, buffer);
+		pipeline.apply(buffer, output);
+	}
+
+	UnitTest::Suite BundleTestSuite {
+		"Test Bundle",
+
+		{"it can merge files",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer plain, streams, output;
+
+				Pipeline pipeline;
+				pipeline.checksums = true;
+				convert_bundle_asset(pipeline, plain);
+
+				pipeline.vertex_streams = true;
+				convert_bundle_asset(pipeline, streams);
+
+				BundleWriter bundle_writer(output, true);
+				bundle_writer.append("plain", plain);
+				bundle_writer.append("streams", streams);
+				bundle_writer.finish();
+
+				Reader reader(output);
+
+				examiner.expect(reader.verify_all().size()) == 0;
+				examiner.expect(reader.checksum_count()) > 0;
+
+				examiner.expect(reader.asset_offset("missing")) == 0;
+
+				for (auto name : {"plain", "streams"}) {
+					auto mesh = reader.block_at_offset<Mesh>(reader.asset_offset(name));
+					examiner.check(mesh);
+
+					auto indices = reader.array_at_offset<Index16>(mesh->indices_offset);
+					examiner.check(indices);
+					examiner.expect(indices->count()) == 6;
+					examiner.expect(indices->begin()[5].value) == 3;
+
+					auto vertices = reader.array_at_offset<VertexP3N3M2>(mesh->vertices_offset);
+					examiner.check(vertices);
+					examiner.expect(vertices->count()) == 4;
+					examiner.expect(vertices->begin()[3].position[1]) == 1;
+				}
+
+				// Streams remain aligned after relocation:
+				auto mesh = reader.block_at_offset<Mesh>(reader.asset_offset("streams"));
+				auto vertex_streams = reader.block_at_offset<VertexStreams>(mesh->vertices_offset);
+				examiner.check(vertex_streams);
+
+				for (auto & reference : *vertex_streams) {
+					examiner.expect(reference.offset % VertexStream::ALIGNMENT) == 0;
+				}
+			}
+		},
+
+		{"it rejects duplicate names and invalid files",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer asset, invalid, output;
+
+				Pipeline pipeline;
+				pipeline.narrow_indices = true;
+				convert_bundle_asset(pipeline, asset);
+
+				invalid.resize(4);
+
+				BundleWriter bundle_writer(output);
+				bundle_writer.append("quad", asset);
+
+				bool duplicate = false, rejected = false;
+
+				try {
+					bundle_writer.append("quad", asset);
+				} catch (std::invalid_argument &) {
+					duplicate = true;
+				}
+
+				try {
+					bundle_writer.append("invalid", invalid);
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(duplicate) == true;
+				examiner.expect(rejected) == true;
+			}
+		},
+	};
+}
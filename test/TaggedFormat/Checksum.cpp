@@ -0,0 +1,119 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Checksum.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+namespace TaggedFormat {
+	const char * ChecksumMeshText =
+		"Quad: mesh triangles\n"
+		"	indices: array index16\n"
+		"		0 1 2 2 1 3\n"
+		"	end\n"
+		"	vertices: array vertex-p3n3m2\n"
+		"		0 0 0 0 0 1 0 0\n"
+		"		1 0 0 0 0 1 1 0\n"
+		"		0 1 0 0 0 1 0 1\n"
+		"		1 1 0 0 0 1 1 1\n"
+		"	end\n"
+		"end\n"
+		"top: $Quad\n";
+
+	UnitTest::Suite ChecksumTestSuite {
+		"Test Checksum",
+
+		{"it has the expected layout",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(BlockChecksum)) == 12;
+				examiner.expect(sizeof(ChecksumTrailer)) == 32;
+			}
+		},
+
+		{"it computes the standard check value",
+			[](UnitTest::Examiner & examiner) {
+				const char * check = "123456789";
+
+				examiner.expect(Checksum::crc32c(check, 9)) == 0xE3069283;
+				examiner.expect(Checksum::crc32c(check, 0)) == 0;
+			}
+		},
+
+		{"it can continue from a previous checksum",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<Byte> data(1000);
+
+				for (std::size_t i = 0; i < data.size(); i += 1)
+					data[i] = Byte(i * 31 + (i >> 3));
+
+				uint32_t whole = Checksum::crc32c(data.data(), data.size());
+
+				for (std::size_t split : {1, 7, 8, 13, 500, 999}) {
+					uint32_t crc = Checksum::crc32c(data.data(), split);
+					crc = Checksum::crc32c(data.data() + split, data.size() - split, crc);
+
+					examiner.expect(crc) == whole;
+				}
+			}
+		},
+
+		{"it verifies blocks when they are read",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(ChecksumMeshText);
+				Buffers::DynamicBuffer buffer, output;
+
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.checksums = true;
+				pipeline.apply(buffer, output);
+
+				OffsetT vertices_offset = 0;
+
+				{
+					Reader reader(output);
+
+					examiner.expect(reader.checksum_count()) == 3;
+					examiner.expect(reader.verify_all().size()) == 0;
+
+					auto mesh = reader.block_at_offset<Mesh>(reader.header()->top_offset);
+					examiner.check(mesh);
+
+					vertices_offset = mesh->vertices_offset;
+				}
+
+				// Flip a bit in the vertex data:
+				output.begin()[vertices_offset + sizeof(Block) + 5] ^= 0x10;
+
+				Reader reader(output);
+
+				auto mesh = reader.block_at_offset<Mesh>(reader.header()->top_offset);
+				examiner.check(mesh);
+
+				examiner.expect(reader.block_at_offset(mesh->indices_offset) != nullptr) == true;
+				examiner.expect(reader.block_at_offset(vertices_offset) == nullptr) == true;
+
+				auto corrupt = reader.verify_all();
+				examiner.expect(corrupt.size()) == 1;
+				examiner.expect(corrupt.front()) == vertices_offset;
+			}
+		},
+
+		{"it reads files without checksums",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(ChecksumMeshText);
+				Buffers::DynamicBuffer buffer;
+
+				Parser::serialize(input, buffer);
+
+				Reader reader(buffer);
+
+				examiner.expect(reader.checksum_count()) == 0;
+				examiner.check(reader.block_at_offset<Mesh>(reader.header()->top_offset));
+			}
+		},
+	};
+}
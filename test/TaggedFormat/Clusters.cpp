@@ -0,0 +1,153 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Clusters.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace TaggedFormat {
+	static std::string flat_mesh_text(const std::string & name, std::size_t size) {
+		std::stringstream text;
+
+		text << "	" << name << ": mesh triangles\n";
+		text << "		indices: array index32\n";
+
+		for (std::size_t y = 0; y < size; y += 1) {
+			for (std::size_t x = 0; x < size; x += 1) {
+				std::size_t i = y * (size + 1) + x;
+				text << "			" << i << " " << i + 1 << " " << i + size + 1 << " ";
+				text << i + 1 << " " << i + size + 2 << " " << i + size + 1 << "\n";
+			}
+		}
+
+		text << "		end\n";
+		text << "		vertices: array vertex-p3n3m2\n";
+
+		for (std::size_t y = 0; y <= size; y += 1) {
+			for (std::size_t x = 0; x <= size; x += 1) {
+				text << "			" << x << " " << y << " 0 0 0 1 0 0\n";
+			}
+		}
+
+		text << "		end\n";
+		text << "	end\n";
+
+		return text.str();
+	}
+
+	UnitTest::Suite ClustersTestSuite {
+		"Test Clusters",
+
+		{"it has the correct size",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(Cluster)) == 60;
+				examiner.expect(sizeof(MeshClusters)) == 36;
+			}
+		},
+
+		{"it can partition a triangle list",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices;
+				std::vector<float32> positions;
+				std::size_t size = 20;
+
+				for (std::size_t y = 0; y <= size; y += 1) {
+					for (std::size_t x = 0; x <= size; x += 1) {
+						positions.insert(positions.end(), {float32(x), float32(y), 0});
+					}
+				}
+
+				for (uint32_t y = 0; y < size; y += 1) {
+					for (uint32_t x = 0; x < size; x += 1) {
+						uint32_t i = y * (size + 1) + x, w = size + 1;
+						indices.insert(indices.end(), {i, i + 1, i + w, i + 1, i + w + 1, i + w});
+					}
+				}
+
+				auto partition = Clusters::partition(indices, positions);
+				examiner.expect(partition.clusters.size()) > 1;
+
+				std::vector<uint32_t> reconstructed;
+
+				for (auto & cluster : partition.clusters) {
+					examiner.expect(cluster.vertex_count) <= Clusters::DEFAULT_VERTEX_LIMIT;
+					examiner.expect(cluster.triangle_count) <= Clusters::DEFAULT_TRIANGLE_LIMIT;
+
+					for (std::size_t i = 0; i < cluster.triangle_count * 3; i += 1) {
+						uint8_t local = partition.triangles[cluster.triangle_offset * 3 + i];
+						examiner.expect(local) < cluster.vertex_count;
+
+						reconstructed.push_back(partition.vertices[cluster.vertex_offset + local]);
+					}
+
+					for (std::size_t i = 0; i < cluster.vertex_count; i += 1) {
+						const float32 * p = &positions[partition.vertices[cluster.vertex_offset + i] * 3];
+						float32 dx = p[0] - cluster.center[0], dy = p[1] - cluster.center[1], dz = p[2] - cluster.center[2];
+
+						examiner.expect(std::sqrt(dx*dx + dy*dy + dz*dz)) <= cluster.radius * 1.0001f;
+					}
+				}
+
+				// Every triangle is emitted exactly once, with the same winding:
+				std::vector<uint32_t> expected(indices);
+				auto canonical = [](std::vector<uint32_t> & triangles) {
+					std::vector<std::array<uint32_t, 3>> result;
+
+					for (std::size_t i = 0; i < triangles.size(); i += 3) {
+						std::array<uint32_t, 3> t{{triangles[i], triangles[i+1], triangles[i+2]}};
+						std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+						result.push_back(t);
+					}
+
+					std::sort(result.begin(), result.end());
+					return result;
+				};
+
+				examiner.check(canonical(reconstructed) == canonical(expected));
+			}
+		},
+
+		{"it can cull backfacing clusters",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream text;
+				text << "top: offset-table\n" << flat_mesh_text("a", 12) << flat_mesh_text("b", 4) << "end\n";
+
+				Buffers::DynamicBuffer buffer, output;
+				Parser::serialize(text, buffer);
+
+				Pipeline pipeline;
+				pipeline.build_clusters = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto table = reader.block_at_offset<OffsetTable>(reader.header()->top_offset);
+				examiner.check(table);
+
+				for (auto name : {"a", "b"}) {
+					auto mesh = reader.block_at_offset<Mesh>(table->offset_named(name));
+					examiner.check(mesh);
+
+					auto mesh_clusters = reader.block_at_offset<MeshClusters>(reader.metadata_offset(mesh, Clusters::METADATA_NAME));
+					examiner.check(mesh_clusters);
+
+					auto clusters = reader.array_at_offset<Cluster>(mesh_clusters->clusters_offset);
+					examiner.check(clusters);
+
+					float32 above[3] = {2, 2, 10}, below[3] = {2, 2, -10};
+
+					for (auto & cluster : *clusters) {
+						examiner.check(Clusters::is_backfacing(cluster, below));
+						examiner.check(!Clusters::is_backfacing(cluster, above));
+					}
+				}
+			}
+		},
+	};
+}
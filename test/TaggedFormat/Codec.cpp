@@ -0,0 +1,200 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Codec.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+namespace TaggedFormat {
+	// A grid of quads, each made from two triangles:
+	static std::string grid_mesh_text(std::size_t size, const std::string & layout = "triangles") {
+		std::stringstream text;
+
+		text << "top: mesh " << layout << "\n";
+		text << "	indices: array index32\n";
+
+		for (std::size_t y = 0; y < size; y += 1) {
+			for (std::size_t x = 0; x < size; x += 1) {
+				std::size_t i = y * (size + 1) + x;
+				text << "		" << i << " " << i + 1 << " " << i + size + 1 << " ";
+				text << i + 1 << " " << i + size + 2 << " " << i + size + 1 << "\n";
+			}
+		}
+
+		text << "	end\n";
+		text << "	vertices: array vertex-p3n3m2\n";
+
+		for (std::size_t y = 0; y <= size; y += 1) {
+			for (std::size_t x = 0; x <= size; x += 1) {
+				text << "		" << x << " " << y << " 0 0 0 1 " << x / float(size) << " " << y / float(size) << "\n";
+			}
+		}
+
+		text << "	end\n";
+		text << "end\n";
+
+		return text.str();
+	}
+
+	UnitTest::Suite CodecTestSuite {
+		"Test Codec",
+
+		{"it has the correct size",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(PackedArray)) == 32;
+			}
+		},
+
+		{"it can pack and unpack triangle meshes",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(grid_mesh_text(16));
+				Buffers::DynamicBuffer buffer, packed_buffer;
+
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.pack_meshes = true;
+				pipeline.apply(buffer, packed_buffer);
+
+				examiner << "Packed size " << packed_buffer.size() << " is smaller than " << buffer.size() << std::endl;
+				examiner.expect(packed_buffer.size()) < buffer.size();
+
+				Reader reader(buffer), packed_reader(packed_buffer);
+
+				auto mesh = reader.block_at_offset<Mesh>(reader.header()->top_offset);
+				auto packed_mesh = packed_reader.block_at_offset<Mesh>(packed_reader.header()->top_offset);
+				examiner.check(packed_mesh);
+
+				examiner.expect(packed_reader.block_at_offset(packed_mesh->indices_offset)->tag) == PackedArray::TAG;
+				examiner.expect(packed_reader.block_at_offset(packed_mesh->vertices_offset)->tag) == PackedArray::TAG;
+
+				auto indices = reader.array_at_offset<Index32>(mesh->indices_offset);
+				auto unpacked_indices = packed_reader.array_at_offset<Index32>(packed_mesh->indices_offset);
+				examiner.check(unpacked_indices);
+
+				examiner.expect(unpacked_indices->count()) == indices->count();
+				examiner.check(std::memcmp(indices, unpacked_indices, indices->size) == 0);
+
+				auto vertices = reader.array_at_offset<VertexP3N3M2>(mesh->vertices_offset);
+				auto unpacked_vertices = packed_reader.array_at_offset<VertexP3N3M2>(packed_mesh->vertices_offset);
+				examiner.check(unpacked_vertices);
+
+				examiner.expect(unpacked_vertices->count()) == vertices->count();
+				examiner.check(std::memcmp(vertices, unpacked_vertices, vertices->size) == 0);
+			}
+		},
+
+		{"it can pack and unpack index sequences",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(grid_mesh_text(8, "triangle-strip"));
+				Buffers::DynamicBuffer buffer, packed_buffer;
+
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.pack_meshes = true;
+				pipeline.apply(buffer, packed_buffer);
+
+				Reader reader(buffer), packed_reader(packed_buffer);
+
+				auto mesh = reader.block_at_offset<Mesh>(reader.header()->top_offset);
+				auto packed_mesh = packed_reader.block_at_offset<Mesh>(packed_reader.header()->top_offset);
+
+				auto packed = packed_reader.block_at_offset<PackedArray>(packed_mesh->indices_offset);
+				examiner.check(packed);
+				examiner.check(packed->method == PackedArray::Method::INDEX_SEQUENCE);
+
+				auto indices = reader.array_at_offset<Index32>(mesh->indices_offset);
+				auto unpacked_indices = packed_reader.array_at_offset<Index32>(packed_mesh->indices_offset);
+				examiner.check(std::memcmp(indices, unpacked_indices, indices->size) == 0);
+			}
+		},
+
+		{"it rejects packed arrays with inconsistent headers before decoding",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(grid_mesh_text(4));
+				Buffers::DynamicBuffer buffer, packed_buffer;
+
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.pack_meshes = true;
+				pipeline.apply(buffer, packed_buffer);
+
+				Reader packed_reader(packed_buffer);
+				auto packed_mesh = packed_reader.block_at_offset<Mesh>(packed_reader.header()->top_offset);
+				auto packed = const_cast<PackedArray *>(packed_reader.block_at_offset<PackedArray>(packed_mesh->vertices_offset));
+
+				auto rejected = [&]() {
+					try {
+						Codec::validate(packed);
+					} catch (Codec::DecodeError &) {
+						return true;
+					}
+
+					return false;
+				};
+
+				examiner.expect(rejected()) == false;
+
+				// A larger element size would decode beyond the end of the output:
+				packed->element_size *= 2;
+				examiner.expect(rejected()) == true;
+				packed->element_size /= 2;
+
+				packed->count = std::size_t(1) << 40;
+				examiner.expect(rejected()) == true;
+
+				packed->array_tag = Index32::TAG;
+				examiner.expect(rejected()) == true;
+
+				// The reader treats it like a block with the wrong tag:
+				examiner.expect(packed_reader.unpacked_block_at_offset(packed_mesh->vertices_offset) == nullptr) == true;
+				examiner.expect(packed_reader.array_at_offset<VertexP3N3M2>(packed_mesh->vertices_offset) == nullptr) == true;
+			}
+		},
+
+		{"it rejects triangles which refer to the empty cache",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer buffer;
+				Writer writer(buffer);
+
+				auto packed = writer.append<PackedArray>(4);
+				packed->method = PackedArray::Method::INDEX_TRIANGLES;
+				packed->array_tag = Index32::TAG;
+				packed->element_size = sizeof(Index32);
+				packed->count = 3;
+
+				// The first triangle reuses the most recent edge and vertex, neither of which exist yet:
+				Byte * data = reinterpret_cast<Byte *>(*packed) + sizeof(PackedArray);
+				data[0] = 1;
+
+				std::vector<Byte> output(packed->decoded_size());
+				bool rejected = false;
+
+				try {
+					Codec::unpack(*packed, output.data());
+				} catch (Codec::DecodeError &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+
+				// Triangles are decoded three indices at a time, so a partial triangle would leave indices uninitialized:
+				packed->count = 4;
+				rejected = false;
+
+				try {
+					Codec::validate(*packed);
+				} catch (Codec::DecodeError &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+			}
+		},
+	};
+}
@@ -0,0 +1,240 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Bounds.hpp>
+#include <TaggedFormat/Instancing.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/SpatialIndex.hpp>
+#include <TaggedFormat/Traversal.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+#include <set>
+
+namespace TaggedFormat {
+	// Five rocks and two trees, each with their own node and geometry instance, along with a bush, a rock with a projective transform and a rock with a child, which can't be batched:
+	static std::string instancing_scene_text() {
+		std::stringstream text;
+
+		text <<
+			"Rock-mesh: mesh triangles\n"
+			"end\n"
+			"Tree-mesh: mesh triangles\n"
+			"end\n"
+			"Bush-mesh: mesh triangles\n"
+			"end\n"
+			"Scene: node\n"
+			"	root 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n";
+
+		auto instance = [&](const char * name, const char * mesh, float32 x, const char * last_row = "1") {
+			text << "	node\n";
+			text << "		" << name << " 2 0 0 0 0 2 0 0 0 0 2 0 " << x << " 0 1 " << last_row << "\n";
+			text << "		geometry-instance\n			mesh: $" << mesh << "\n		end\n";
+		};
+
+		for (std::size_t i = 0; i < 5; i += 1) {
+			instance("rock", "Rock-mesh", i);
+			text << "	end\n";
+
+			if (i == 2) {
+				instance("tree", "Tree-mesh", 10);
+				text << "	end\n";
+			}
+		}
+
+		instance("tree", "Tree-mesh", 11);
+		text << "	end\n";
+
+		instance("bush", "Bush-mesh", 20);
+		text << "	end\n";
+
+		instance("projected-rock", "Rock-mesh", 30, "2");
+		text << "	end\n";
+
+		instance("parent-rock", "Rock-mesh", 40);
+		text << "		node\n			child 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n		end\n";
+		text << "	end\n";
+
+		text << "end\ntop: $Scene\n";
+
+		return text.str();
+	}
+
+	static std::vector<const InstanceBatch *> instance_batches(Reader & reader, const Node * node) {
+		std::vector<const InstanceBatch *> batches;
+
+		for (auto & reference : *node) {
+			if (auto batch = reader.block_at_offset<InstanceBatch>(reference.offset))
+				batches.push_back(batch);
+		}
+
+		return batches;
+	}
+
+	UnitTest::Suite InstancingTestSuite {
+		"Test Instancing",
+
+		{"it has the correct size",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(BatchedInstance)) == 52;
+			}
+		},
+
+		{"it batches repeated instances",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(instancing_scene_text());
+				Buffers::DynamicBuffer buffer, output, unbatched;
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.batch_instances = true;
+				pipeline.apply(buffer, output);
+
+				compact(buffer, unbatched);
+				examiner.check(output.size() < unbatched.size());
+
+				Reader reader(output);
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+				examiner.check(root);
+
+				// The bush, the projected rock and the parent rock remain, followed by the batches in order:
+				examiner.expect(root->count()) == 5;
+
+				auto batches = instance_batches(reader, root);
+				examiner.expect(batches.size()) == 2;
+
+				auto rocks = batches[0], trees = batches[1];
+				examiner.expect(rocks->count()) == 5;
+				examiner.expect(trees->count()) == 2;
+
+				examiner.check(reader.block_at_offset<Mesh>(rocks->mesh_offset));
+				examiner.expect(rocks->skeleton_offset) == 0;
+				examiner.check(rocks->mesh_offset != trees->mesh_offset);
+
+				// Identifiers are unique:
+				examiner.expect(rocks->begin()[4].id) == 4;
+				examiner.expect(trees->begin()[0].id) == 5;
+
+				float32 transform[16];
+				Instancing::unpack(rocks->begin()[3], transform);
+
+				examiner.expect(transform[0]) == 2;
+				examiner.expect(transform[12]) == 3;
+				examiner.expect(transform[14]) == 1;
+				examiner.expect(transform[15]) == 1;
+				examiner.expect(transform[11]) == 0;
+			}
+		},
+
+		{"it computes world transforms of instances",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(instancing_scene_text());
+				Buffers::DynamicBuffer buffer, output;
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.batch_instances = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto trees = instance_batches(reader, reader.block_at_offset<Node>(reader.header()->top_offset))[1];
+
+				// A rotation of 90 degrees about z, followed by a translation along y:
+				float32 parent[16] = {0, 1, 0, 0, -1, 0, 0, 0, 0, 0, 1, 0, 0, 5, 0, 1};
+				std::vector<float32> transforms(trees->count() * 16);
+
+				Instancing::world_transforms(trees, parent, transforms.data());
+
+				// The second tree is at (11, 0, 1) relative to the root:
+				const float32 * world = transforms.data() + 16;
+				examiner.check(std::abs(world[12] - 0) < 1e-5);
+				examiner.check(std::abs(world[13] - 16) < 1e-5);
+				examiner.check(std::abs(world[14] - 1) < 1e-5);
+				examiner.check(std::abs(world[1] - 2) < 1e-5);
+				examiner.expect(world[15]) == 1;
+			}
+		},
+
+		{"it only batches groups of the minimum size",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(instancing_scene_text());
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Writer writer(buffer);
+				examiner.expect(Instancing::batch_instances(writer, reachable_offsets(buffer), 3)) == 5;
+
+				Reader reader(buffer);
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+
+				examiner.expect(instance_batches(reader, root).size()) == 1;
+				examiner.expect(root->count()) == 6;
+			}
+		},
+
+		{"it bounds and indexes batched instances",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input;
+
+				input <<
+					"Quad-mesh: mesh triangles\n"
+					"	indices: array index16\n"
+					"		0 1 2 2 1 3\n"
+					"	end\n"
+					"	vertices: array vertex-p3n3m2\n"
+					"		0 0 0 0 1 0 0 0\n"
+					"		1 0 0 0 1 0 1 0\n"
+					"		0 0 1 0 1 0 0 1\n"
+					"		1 0 1 0 1 0 1 1\n"
+					"	end\n"
+					"end\n"
+					"top: node\n"
+					"	root 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n";
+
+				for (std::size_t i = 0; i < 10; i += 1)
+					input << "	node\n		quad 1 0 0 0 0 1 0 0 0 0 1 0 " << i * 2 << " 0 0 1\n		geometry-instance\n			mesh: $Quad-mesh\n		end\n	end\n";
+
+				input << "end\n";
+
+				Buffers::DynamicBuffer buffer, output;
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.batch_instances = true;
+				pipeline.compute_bounds = true;
+				pipeline.build_scene_index = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+
+				// The index refers to the batch, so the original geometry instances are no longer in the file:
+				std::size_t geometry_instances = 0;
+				for (auto offset : reachable_offsets(output)) {
+					if (reader.block_at_offset<GeometryInstance>(offset)) geometry_instances += 1;
+				}
+
+				examiner.expect(geometry_instances) == 0;
+
+				SpatialIndex::Tree tree;
+				examiner.expect(SpatialIndex::tree_for_node(reader, root, tree)) == true;
+				examiner.expect(tree.instance_count) == 10;
+
+				std::set<uint32_t> indices;
+				for (std::size_t i = 0; i < tree.instance_count; i += 1) {
+					examiner.check(reader.block_at_offset<InstanceBatch>(tree.instances[i].instance_offset));
+					indices.insert(tree.instances[i].batch_index);
+				}
+
+				examiner.expect(indices.size()) == 10;
+
+				auto bounds = BoundingVolumes::node_bounds(reader, root);
+				examiner.check(bounds);
+				examiner.expect(bounds->maximum[0]) == 19;
+			}
+		},
+	};
+}
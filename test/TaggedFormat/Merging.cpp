@@ -0,0 +1,237 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Geometry.hpp>
+#include <TaggedFormat/Merging.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/Traversal.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace TaggedFormat {
+	// Stone quads in two cells, one of them mirrored, two wooden quads, and stone quads which can't be merged because they are skinned or reached twice:
+	static std::string merging_scene_text() {
+		std::stringstream text;
+
+		text <<
+			"Quad-mesh: mesh triangles\n"
+			"	indices: array index16\n"
+			"		0 1 2 2 1 3\n"
+			"	end\n"
+			"	vertices: array vertex-p3n3m2\n"
+			"		0 0 0 0 1 0 0 0\n"
+			"		1 0 0 0 1 0 1 0\n"
+			"		0 0 1 0 1 0 0 1\n"
+			"		1 0 1 0 1 0 1 1\n"
+			"	end\n"
+			"end\n"
+			"Stone: external stone.material\n"
+			"Wood: external wood.material\n"
+			"Quad-skeleton: skeleton\n"
+			"end\n";
+
+		auto instance = [&](const char * name, const char * material, const char * transform, const char * skeleton = nullptr) {
+			text << "	node\n		" << name << " " << transform << "\n";
+			text << "		geometry-instance\n			mesh: $Quad-mesh\n			material: $" << material << "\n";
+			if (skeleton) text << "			skeleton: $" << skeleton << "\n";
+			text << "		end\n	end\n";
+		};
+
+		text << "Shared: node\n	shared 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n	geometry-instance\n		mesh: $Quad-mesh\n		material: $Stone\n	end\nend\n";
+
+		text << "Scene: node\n	root 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n";
+
+		instance("a1", "Stone", "1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1");
+		instance("a2", "Stone", "1 0 0 0 0 1 0 0 0 0 1 0 10 0 0 1");
+		instance("a3", "Stone", "1 0 0 0 0 1 0 0 0 0 1 0 100 0 0 1");
+		instance("a4", "Stone", "-1 0 0 0 0 1 0 0 0 0 1 0 20 0 0 1");
+		instance("b1", "Wood", "1 0 0 0 0 1 0 0 0 0 1 0 0 0 5 1");
+		instance("b2", "Wood", "1 0 0 0 0 1 0 0 0 0 1 0 0 0 8 1");
+		instance("skinned", "Stone", "1 0 0 0 0 1 0 0 0 0 1 0 30 0 0 1", "Quad-skeleton");
+
+		text << "	$Shared\n	$Shared\nend\ntop: $Scene\n";
+
+		return text.str();
+	}
+
+	static std::vector<const Node *> merged_nodes(Reader & reader, const Node * root) {
+		std::vector<const Node *> nodes;
+
+		for (auto & reference : *root) {
+			auto node = reader.block_at_offset<Node>(reference.offset);
+
+			if (node && node->name == "merged")
+				nodes.push_back(node);
+		}
+
+		return nodes;
+	}
+
+	UnitTest::Suite MergingTestSuite {
+		"Test Merging",
+
+		{"it has the correct size",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(MergedSource)) == 16;
+			}
+		},
+
+		{"it merges static instances by material and cell",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(merging_scene_text());
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Writer writer(buffer);
+				examiner.expect(Merging::merge_static_instances(writer, reachable_offsets(buffer))) == 5;
+
+				Reader reader(buffer);
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+				auto nodes = merged_nodes(reader, root);
+
+				// The lone stone quad in the second cell, the skinned quad and the shared quad are left alone:
+				examiner.expect(nodes.size()) == 2;
+
+				auto stones = reader.block_at_offset<GeometryInstance>(nodes[0]->begin()[0].offset);
+				auto sources = reader.block_at_offset<Array<MergedSource>>(nodes[0]->begin()[1].offset);
+
+				examiner.expect(stones->material_offset) == reader.block_at_offset<GeometryInstance>(reader.block_at_offset<Node>(root->begin()[2].offset)->begin()[0].offset)->material_offset;
+				examiner.expect(sources->count()) == 3;
+
+				auto mesh = reader.block_at_offset<Mesh>(stones->mesh_offset);
+				auto positions = read_positions(reader.block_at_offset(mesh->vertices_offset));
+				auto indices = read_indices(reader.block_at_offset(mesh->indices_offset));
+
+				examiner.expect(positions.size()) == 36;
+				examiner.expect(indices.size()) == 18;
+
+				// The second quad is moved along x:
+				examiner.expect(positions[4 * 3]) == 10;
+
+				// Picking maps triangles back to the nodes, which no longer contain the merged instances:
+				auto source = Merging::source_for_triangle(sources, 3);
+				examiner.check(source);
+				examiner.check(reader.block_at_offset<Node>(source->node_offset)->name == "a2");
+				examiner.expect(reader.block_at_offset<Node>(source->node_offset)->count()) == 0;
+				examiner.check(Merging::source_for_triangle(sources, 6) == nullptr);
+
+				// The mirrored quad keeps the orientation of its triangles relative to its normals:
+				auto facing = [&](std::size_t triangle) {
+					const float32 * a = &positions[indices[triangle * 3] * 3], * b = &positions[indices[triangle * 3 + 1] * 3], * c = &positions[indices[triangle * 3 + 2] * 3];
+					float32 u[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]}, v[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+
+					// The normal of every vertex is (0, 1, 0), so only the y component of the cross product matters:
+					return u[2] * v[0] - u[0] * v[2];
+				};
+
+				examiner.check(facing(0) * facing(4) > 0);
+			}
+		},
+
+		{"it merges every cell together with an infinite cell size",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(merging_scene_text());
+				Buffers::DynamicBuffer buffer, output;
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.merge_cell_size = std::numeric_limits<float32>::infinity();
+				pipeline.optimize_vertex_cache = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+				auto nodes = merged_nodes(reader, root);
+
+				examiner.expect(nodes.size()) == 2;
+				examiner.expect(reader.block_at_offset<Array<MergedSource>>(nodes[0]->begin()[1].offset)->count()) == 4;
+
+				// The root keeps the nodes which were merged, followed by the merged nodes:
+				examiner.expect(root->count()) == 11;
+			}
+		},
+
+		{"it merges instances relative to a transformed root",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(
+					"Quad-mesh: mesh triangles\n"
+					"	indices: array index16\n"
+					"		0 1 2 2 1 3\n"
+					"	end\n"
+					"	vertices: array vertex-p3n3m2\n"
+					"		0 0 0 0 1 0 0 0\n"
+					"		1 0 0 0 1 0 1 0\n"
+					"		0 0 1 0 1 0 0 1\n"
+					"		1 0 1 0 1 0 1 1\n"
+					"	end\n"
+					"end\n"
+					"top: node\n"
+					"	root 1 0 0 0 0 1 0 0 0 0 1 0 100 0 0 1\n"
+					"	node\n"
+					"		a 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+					"		geometry-instance\n"
+					"			mesh: $Quad-mesh\n"
+					"		end\n"
+					"	end\n"
+					"	node\n"
+					"		b 1 0 0 0 0 1 0 0 0 0 1 0 2 0 0 1\n"
+					"		geometry-instance\n"
+					"			mesh: $Quad-mesh\n"
+					"		end\n"
+					"	end\n"
+					"end\n"
+				);
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Writer writer(buffer);
+				examiner.expect(Merging::merge_static_instances(writer, reachable_offsets(buffer), 1e9f)) == 2;
+
+				Reader reader(buffer);
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+				auto nodes = merged_nodes(reader, root);
+
+				examiner.expect(nodes.size()) == 1;
+
+				auto geometry = reader.block_at_offset<GeometryInstance>(nodes[0]->begin()[0].offset);
+				auto positions = read_positions(reader.block_at_offset(reader.block_at_offset<Mesh>(geometry->mesh_offset)->vertices_offset));
+
+				// The root still translates the merged node, so the vertices don't include its transform:
+				float32 minimum = positions[0], maximum = positions[0];
+
+				for (std::size_t i = 0; i < positions.size(); i += 3) {
+					minimum = std::min(minimum, positions[i]);
+					maximum = std::max(maximum, positions[i]);
+				}
+
+				examiner.expect(minimum) == 0;
+				examiner.expect(maximum) == 3;
+				examiner.expect(root->transform[12]) == 100;
+			}
+		},
+
+		{"it rejects cells without size",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(merging_scene_text());
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Writer writer(buffer);
+				bool rejected = false;
+
+				try {
+					Merging::merge_static_instances(writer, reachable_offsets(buffer), 0);
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+			}
+		},
+	};
+}
@@ -0,0 +1,207 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Morph.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+
+namespace TaggedFormat {
+	const char * MorphText =
+		"face: mesh triangles\n"
+		"	indices: array index16\n"
+		"		4 3 5 2 3 4 0 1 2 2 1 3\n"
+		"	end\n"
+		"	vertices: array vertex-p3n3m2\n"
+		"		0 0 0 0 0 1 0 0\n"
+		"		1 0 0 0 0 1 1 0\n"
+		"		0 1 0 0 0 1 0 1\n"
+		"		1 1 0 0 0 1 1 1\n"
+		"		0 2 0 0 0 1 0 2\n"
+		"		1 2 0 0 0 1 1 2\n"
+		"	end\n"
+		"end\n"
+		"smile: morph-target $face\n"
+		"	5 0.0 0.5 0.0 0.0 -0.2 0.0\n"
+		"	0 0.25 0.0 -0.1 0.1 0.0 0.0\n"
+		"end\n"
+		"blink: morph-target $face\n"
+		"	2 0.0 0.0 1.0 0.0 0.0 0.0\n"
+		"	5 -1.0 0.0 0.0 0.0 0.0 0.0\n"
+		"end\n"
+		"smile-copy: array vertex-p3n3m2\n"
+		"	0.25 0 -0.1 0.1 0 1 0 0\n"
+		"	1 0 0 0 0 1 1 0\n"
+		"	0 1 0 0 0 1 0 1\n"
+		"	1 1 0 0 0 1 1 1\n"
+		"	0 2 0 0 0 1 0 2\n"
+		"	1 2.5 0 0 -0.2 1 1 2\n"
+		"end\n"
+		"top: offset-table\n"
+		"	face: $face\n"
+		"	smile: $smile\n"
+		"	blink: $blink\n"
+		"	smile-copy: $smile-copy\n"
+		"end\n";
+
+	static bool close_to(float32 a, float32 b) {
+		return std::abs(a - b) < 1e-4;
+	}
+
+	UnitTest::Suite MorphTestSuite {
+		"Test Morph",
+
+		{"it has the correct size",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(MorphDelta)) == 16;
+			}
+		},
+
+		{"it can parse sparse targets",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(MorphText);
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Reader reader(buffer);
+				auto smile = reader.block_at_offset<MorphTarget>(reader.asset_offset("smile"));
+
+				examiner.expect(smile->tag) == MorphTarget::TAG;
+				examiner.expect(smile->mesh_offset) == reader.asset_offset("face");
+				examiner.expect(smile->count()) == 2;
+
+				// Sorted by index:
+				auto & delta = smile->begin()[0];
+				examiner.expect(delta.index) == 0;
+				examiner.check(close_to(delta.position[0] * smile->position_scale, 0.25));
+				examiner.check(close_to(delta.position[2] * smile->position_scale, -0.1));
+				examiner.check(close_to(delta.normal[0] * smile->normal_scale, 0.1));
+			}
+		},
+
+		{"it applies weighted targets",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(MorphText);
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Reader reader(buffer);
+				auto face = reader.block_at_offset<Mesh>(reader.asset_offset("face"));
+
+				std::vector<float32> positions, normals;
+				Morph::read_attributes(reader.block_at_offset(face->vertices_offset), positions, normals);
+
+				examiner.expect(positions.size()) == 18;
+
+				const MorphTarget * targets[] = {
+					reader.block_at_offset<MorphTarget>(reader.asset_offset("smile")),
+					reader.block_at_offset<MorphTarget>(reader.asset_offset("blink")),
+					nullptr
+				};
+
+				float32 weights[] = {0.5, 2, 1};
+				Morph::apply(targets, weights, 3, 6, positions.data(), normals.data());
+
+				float32 expected_positions[18] = {
+					0.125, 0, -0.05,
+					1, 0, 0,
+					0, 1, 2,
+					1, 1, 0,
+					0, 2, 0,
+					-1, 2.25, 0,
+				};
+
+				float32 expected_normals[18] = {
+					0.05, 0, 1,
+					0, 0, 1,
+					0, 0, 1,
+					0, 0, 1,
+					0, 0, 1,
+					0, -0.1, 1,
+				};
+
+				std::size_t mismatches = 0;
+
+				for (std::size_t i = 0; i < 18; i += 1) {
+					if (!close_to(positions[i], expected_positions[i])) mismatches += 1;
+					if (!close_to(normals[i], expected_normals[i])) mismatches += 1;
+				}
+
+				examiner.expect(mismatches) == 0;
+
+				// Normals are optional, and a delta beyond the vertices is rejected:
+				bool rejected = false;
+
+				try {
+					Morph::apply(targets, weights, 2, 5, positions.data(), nullptr);
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+			}
+		},
+
+		{"it builds sparse targets from complete copies",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(MorphText);
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Writer writer(buffer);
+				Reader parsed(buffer);
+
+				OffsetT face_offset = parsed.asset_offset("face"), copy_offset = parsed.asset_offset("smile-copy");
+				OffsetT target_offset = Morph::build_target(writer, face_offset, copy_offset);
+
+				Reader reader(buffer);
+				auto target = reader.block_at_offset<MorphTarget>(target_offset);
+				auto parsed_target = reader.block_at_offset<MorphTarget>(reader.asset_offset("smile"));
+
+				examiner.expect(target->count()) == 2;
+				examiner.check(target->size < reader.block_at_offset(copy_offset)->size);
+
+				std::size_t mismatches = 0;
+
+				for (std::size_t i = 0; i < 2; i += 1) {
+					auto & built = target->begin()[i], & expected = parsed_target->begin()[i];
+
+					if (built.index != expected.index) mismatches += 1;
+
+					for (std::size_t k = 0; k < 3; k += 1) {
+						if (!close_to(built.position[k] * target->position_scale, expected.position[k] * parsed_target->position_scale)) mismatches += 1;
+						if (!close_to(built.normal[k] * target->normal_scale, expected.normal[k] * parsed_target->normal_scale)) mismatches += 1;
+					}
+				}
+
+				examiner.expect(mismatches) == 0;
+			}
+		},
+
+		{"it doesn't reorder the vertices of morphed meshes",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(MorphText);
+				Buffers::DynamicBuffer buffer, output;
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.optimize_vertex_cache = true;
+				pipeline.split_meshes = true;
+				pipeline.apply(buffer, output);
+
+				Reader original(buffer), reader(output);
+
+				std::vector<float32> before, after, normals;
+				Morph::read_attributes(original.block_at_offset(original.block_at_offset<Mesh>(original.asset_offset("face"))->vertices_offset), before, normals);
+				Morph::read_attributes(reader.block_at_offset(reader.block_at_offset<Mesh>(reader.asset_offset("face"))->vertices_offset), after, normals);
+
+				examiner.check(before == after);
+				examiner.expect(reader.block_at_offset<MorphTarget>(reader.asset_offset("smile"))->mesh_offset) == reader.asset_offset("face");
+			}
+		},
+	};
+}
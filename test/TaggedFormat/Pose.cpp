@@ -0,0 +1,206 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Pose.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+
+namespace TaggedFormat {
+	// The hand is listed before its parent:
+	const char * PoseSkeletonText =
+		"bones: array skeleton-bone\n"
+		"	hand 2 1 0 0 0 0 1 0 0 0 0 1 0 0 2 0 1\n"
+		"	root 1 1 0 0 0 0 1 0 0 0 0 1 0 0 0 1 1\n"
+		"	arm 1 0 1 0 0 -1 0 0 0 0 0 1 0 0 3 0 1\n"
+		"end\n"
+		"animation: array skeleton-animation-key-frame\n"
+		"	2 linear 0.0 0 1 0 0 -1 0 0 0 0 0 1 0 0 3 0 1\n"
+		"	2 linear 1.0 1 0 0 0 0 1 0 0 0 0 1 0 0 3 0 1\n"
+		"	0 bezier 0.0 1 0 0 0 0 1 0 0 0 0 1 0 0 2 0 1\n"
+		"	0 linear 2.0 2 0 0 0 0 2 0 0 0 0 2 0 1 2 0 1\n"
+		"end\n"
+		"cyclic: array skeleton-bone\n"
+		"	a 1 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+		"	b 0 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n"
+		"end\n"
+		"top: offset-table\n"
+		"	bones: $bones\n"
+		"	animation: $animation\n"
+		"	cyclic: $cyclic\n"
+		"end\n";
+
+	static void multiply_reference(const float32 a[16], const float32 b[16], float32 result[16]) {
+		for (std::size_t column = 0; column < 4; column += 1) {
+			for (std::size_t row = 0; row < 4; row += 1) {
+				result[column * 4 + row] = 0;
+
+				for (std::size_t k = 0; k < 4; k += 1)
+					result[column * 4 + row] += a[k * 4 + row] * b[column * 4 + k];
+			}
+		}
+	}
+
+	// The world transforms of the bones, by walking up the hierarchy:
+	static void world_reference(const Array<SkeletonBone> * bones, const float32 (*local)[16], std::size_t bone, float32 world[16]) {
+		std::copy(local[bone], local[bone] + 16, world);
+
+		for (std::size_t parent = bones->at(bone).parent; parent != bone; bone = parent, parent = bones->at(bone).parent) {
+			float32 result[16];
+			multiply_reference(local[parent], world, result);
+			std::copy(result, result + 16, world);
+		}
+	}
+
+	UnitTest::Suite PoseTestSuite {
+		"Test Pose",
+
+		{"it computes the same palettes as a scalar evaluation",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(PoseSkeletonText);
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Reader reader(buffer);
+				auto bones = reader.array_at_offset<SkeletonBone>(reader.asset_offset("bones"));
+				auto key_frames = reader.array_at_offset<SkeletonAnimationKeyFrame>(reader.asset_offset("animation"));
+
+				AnimationSampler walk(bones, key_frames), rest(bones, nullptr);
+
+				PoseBatch batch(3);
+				std::size_t skeleton = batch.add_skeleton(bones);
+
+				// More instances than fit in one group, with different animations:
+				for (std::size_t i = 0; i < 11; i += 1)
+					batch.add_instance(skeleton, i % 3 ? &walk : &rest, i * 0.2);
+
+				float32 bind_local[3][16], bind_world[3][16], inverse_bind[3][16];
+
+				for (std::size_t bone = 0; bone < 3; bone += 1)
+					std::copy(bones->at(bone).transform, bones->at(bone).transform + 16, bind_local[bone]);
+
+				for (std::size_t bone = 0; bone < 3; bone += 1) {
+					world_reference(bones, bind_local, bone, bind_world[bone]);
+
+					// The bind pose has no scale, so the inverse is the transpose of the rotation:
+					Transform transform;
+					Animation::decompose(bind_world[bone], transform);
+
+					for (std::size_t i = 0; i < 4; i += 1) transform.rotation[i] = i < 3 ? -transform.rotation[i] : transform.rotation[i];
+					for (std::size_t i = 0; i < 3; i += 1) transform.translation[i] = 0;
+
+					float32 rotation[16], translation[16];
+					Animation::compose(transform, rotation);
+
+					Transform offset = {{-bind_world[bone][12], -bind_world[bone][13], -bind_world[bone][14], 0}, {0, 0, 0, 1}, {1, 1, 1, 0}};
+					Animation::compose(offset, translation);
+
+					multiply_reference(rotation, translation, inverse_bind[bone]);
+				}
+
+				for (std::size_t frame = 0; frame < 3; frame += 1) {
+					batch.evaluate();
+
+					std::size_t mismatches = 0;
+
+					for (std::size_t i = 0; i < batch.instance_count(); i += 1) {
+						examiner.expect(batch.bone_count(i)) == 3;
+						examiner.expect(batch.palette(i)) == batch.palettes() + i * 3 * 16;
+
+						auto & sampler = i % 3 ? walk : rest;
+						auto cursors = sampler.cursors();
+
+						Transform pose[3];
+						sampler.sample(batch.time(i), cursors, pose);
+
+						float32 local[3][16];
+						for (std::size_t bone = 0; bone < 3; bone += 1) Animation::compose(pose[bone], local[bone]);
+
+						for (std::size_t bone = 0; bone < 3; bone += 1) {
+							float32 world[16], skinning[16];
+							world_reference(bones, local, bone, world);
+							multiply_reference(world, inverse_bind[bone], skinning);
+
+							for (std::size_t k = 0; k < 16; k += 1) {
+								if (std::abs(skinning[k] - batch.palette(i)[bone * 16 + k]) > 1e-4) mismatches += 1;
+
+								// The bind pose doesn't move any vertices:
+								if (&sampler == &rest && std::abs(batch.palette(i)[bone * 16 + k] - (k % 5 == 0)) > 1e-4) mismatches += 1;
+							}
+						}
+
+						batch.set_time(i, batch.time(i) + 0.1);
+					}
+
+					examiner.expect(mismatches) == 0;
+				}
+			}
+		},
+
+		{"it rejects invalid skeletons and animations",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(PoseSkeletonText);
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Reader reader(buffer);
+
+				PoseBatch batch(1);
+				bool rejected = false;
+
+				try {
+					batch.add_skeleton(reader.array_at_offset<SkeletonBone>(reader.asset_offset("cyclic")));
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+
+				AnimationSampler sampler(nullptr, reader.array_at_offset<SkeletonAnimationKeyFrame>(reader.asset_offset("animation")));
+				std::size_t skeleton = batch.add_skeleton(reader.array_at_offset<SkeletonBone>(reader.asset_offset("bones")));
+				rejected = false;
+
+				// A sampler without a bind pose only knows of the bones which have key frames:
+				try {
+					AnimationSampler partial(nullptr, nullptr);
+					batch.add_instance(skeleton, &partial);
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+				examiner.expect(batch.add_instance(skeleton, &sampler)) == 0;
+			}
+		},
+
+		{"it plays a different animation from its start",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(PoseSkeletonText);
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Reader reader(buffer);
+				auto bones = reader.array_at_offset<SkeletonBone>(reader.asset_offset("bones"));
+
+				// Only the second key frame of each bone, so the animation starts later:
+				std::vector<AnimationSampler::Key> keys;
+
+				for (auto & key : AnimationSampler::decompose_key_frames(reader.array_at_offset<SkeletonAnimationKeyFrame>(reader.asset_offset("animation")))) {
+					if (key.time > 0) keys.push_back(key);
+				}
+
+				AnimationSampler rest(bones, nullptr), late(bones, keys);
+				examiner.expect(late.start_time()) == 1;
+
+				PoseBatch batch(1);
+				std::size_t instance = batch.add_instance(batch.add_skeleton(bones), &rest, 0.5);
+
+				batch.set_sampler(instance, &late);
+				examiner.expect(batch.time(instance)) == 1;
+			}
+		},
+	};
+}
@@ -0,0 +1,187 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Progressive.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/Geometry.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+
+namespace TaggedFormat {
+	// A curved grid of quads:
+	static void progressive_grid(std::size_t size, std::vector<uint32_t> & indices, std::vector<float32> & positions, Buffers::DynamicBuffer & buffer) {
+		for (std::size_t y = 0; y <= size; y += 1) {
+			for (std::size_t x = 0; x <= size; x += 1) {
+				positions.insert(positions.end(), {float32(x), float32(y), float32(std::sin(x * 0.4) * std::cos(y * 0.3) * 2)});
+			}
+		}
+
+		for (std::size_t y = 0; y < size; y += 1) {
+			for (std::size_t x = 0; x < size; x += 1) {
+				uint32_t i = static_cast<uint32_t>(y * (size + 1) + x), w = static_cast<uint32_t>(size + 1);
+				indices.insert(indices.end(), {i, i + 1, i + w, i + 1, i + w + 1, i + w});
+			}
+		}
+
+		std::stringstream text;
+		text << "terrain: mesh triangles\n";
+		text << "	indices: array index32\n";
+		for (auto index : indices) text << "		" << index << "\n";
+		text << "	end\n";
+		text << "	vertices: array vertex-p3n3m2\n";
+		for (std::size_t i = 0; i < positions.size(); i += 3) {
+			text << "		" << positions[i] << " " << positions[i+1] << " " << positions[i+2] << " 0 0 1 0 0\n";
+		}
+		text << "	end\n";
+		text << "end\n";
+		text << "top: offset-table\n";
+		text << "	terrain: $terrain\n";
+		text << "end\n";
+
+		Parser::serialize(text, buffer);
+	}
+
+	UnitTest::Suite ProgressiveTestSuite {
+		"Test Progressive",
+
+		{"it has the correct size",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(ProgressiveLevel)) == 24;
+				examiner.expect(sizeof(VertexChunks)) == 24;
+			}
+		},
+
+		{"it orders levels from coarsest to finest",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices;
+				std::vector<float32> positions;
+				Buffers::DynamicBuffer buffer, output;
+				progressive_grid(24, indices, positions, buffer);
+
+				Pipeline pipeline;
+				pipeline.level_count = 3;
+				pipeline.progressive = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto mesh = reader.block_at_offset<Mesh>(reader.asset_offset("terrain"));
+				examiner.check(mesh != nullptr);
+
+				auto levels = reader.array_at_offset<ProgressiveLevel>(reader.metadata_offset(mesh, Progressive::METADATA_NAME));
+				examiner.check(levels != nullptr);
+				examiner.expect(levels->count()) == 4;
+
+				// The finest level is the mesh itself:
+				examiner.expect(levels->at(3).indices_offset) == mesh->indices_offset;
+				examiner.expect(levels->at(3).vertex_count) == positions.size() / 3;
+
+				std::size_t previous = 0;
+
+				for (auto & level : *levels) {
+					examiner.expect(level.vertex_count) > previous;
+
+					auto level_indices = read_indices(reader.block_at_offset(level.indices_offset));
+					examiner.check(!level_indices.empty());
+
+					for (auto index : level_indices)
+						examiner.expect(index) < level.vertex_count;
+
+					// Each level is stored after the coarser levels:
+					examiner.expect(level.indices_offset) > reinterpret_cast<const Byte *>(levels) - output.begin();
+
+					previous = level.vertex_count;
+				}
+
+				for (std::size_t i = 1; i < levels->count(); i += 1)
+					examiner.expect(levels->at(i).vertices_offset) > levels->at(i-1).vertices_offset;
+			}
+		},
+
+		{"it preserves the geometry of the mesh",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices;
+				std::vector<float32> positions;
+				Buffers::DynamicBuffer buffer, output;
+				progressive_grid(16, indices, positions, buffer);
+
+				Pipeline pipeline;
+				pipeline.progressive = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto mesh = reader.block_at_offset<Mesh>(reader.asset_offset("terrain"));
+				examiner.check(mesh != nullptr);
+				examiner.expect(reader.block_at_offset(mesh->vertices_offset)->tag) == VertexChunks::TAG;
+
+				// The chunks are concatenated into a single vertex array:
+				auto vertices = reader.array_at_offset<VertexP3N3M2>(mesh->vertices_offset);
+				examiner.check(vertices != nullptr);
+				examiner.expect(vertices->count()) == positions.size() / 3;
+
+				auto remapped = read_indices(reader.block_at_offset(mesh->indices_offset));
+				examiner.expect(remapped.size()) == indices.size();
+
+				// Positions are compared approximately, as they were written as text:
+				std::size_t mismatches = 0;
+
+				for (std::size_t i = 0; i < indices.size(); i += 1) {
+					auto & vertex = vertices->at(remapped[i]);
+
+					for (std::size_t j = 0; j < 3; j += 1) {
+						if (std::abs(vertex.position[j] - positions[indices[i] * 3 + j]) > 1e-4) mismatches += 1;
+					}
+				}
+
+				examiner.expect(mismatches) == 0;
+			}
+		},
+
+		{"it makes levels available as the file is received",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices;
+				std::vector<float32> positions;
+				Buffers::DynamicBuffer buffer, output;
+				progressive_grid(24, indices, positions, buffer);
+
+				Pipeline pipeline;
+				pipeline.level_count = 3;
+				pipeline.progressive = true;
+				pipeline.narrow_indices = true;
+				pipeline.pack_meshes = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto mesh = reader.block_at_offset<Mesh>(reader.asset_offset("terrain"));
+				examiner.check(mesh != nullptr);
+
+				auto levels = reader.array_at_offset<ProgressiveLevel>(reader.metadata_offset(mesh, Progressive::METADATA_NAME));
+				examiner.check(levels != nullptr);
+
+				// The structure and the coarsest level are a small prefix of the file:
+				OffsetT coarsest_end = std::max(levels->at(0).indices_offset + reader.block_at_offset(levels->at(0).indices_offset)->size, levels->at(0).vertices_offset + reader.block_at_offset(levels->at(0).vertices_offset)->size);
+
+				examiner.expect(coarsest_end) < output.size() / 2;
+				examiner.expect(Progressive::available_levels(reader, mesh, sizeof(Header))) == 0;
+				examiner.expect(Progressive::available_levels(reader, mesh, coarsest_end)) == 1;
+
+				std::size_t previous = 0;
+
+				for (std::size_t size = 0; size <= output.size(); size += 256) {
+					auto available = Progressive::available_levels(reader, mesh, size);
+					examiner.expect(available) >= previous;
+					previous = available;
+				}
+
+				examiner.expect(Progressive::available_levels(reader, mesh, output.size())) == levels->count();
+
+				auto vertices = reader.array_at_offset<VertexP3N3M2>(mesh->vertices_offset);
+				examiner.check(vertices != nullptr);
+				examiner.expect(vertices->count()) == positions.size() / 3;
+			}
+		},
+	};
+}
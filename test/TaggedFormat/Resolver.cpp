@@ -0,0 +1,175 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Bundle.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/Resolver.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TaggedFormat {
+	const char * ResolverMeshText =
+		"Quad: mesh triangles\n"
+		"	indices: array index16\n"
+		"		0 1 2 2 1 3\n"
+		"	end\n"
+		"	vertices: array vertex-p3n3m2\n"
+		"		0 0 0 0 0 1 0 0\n"
+		"		1 0 0 0 0 1 1 0\n"
+		"		0 1 0 0 0 1 0 1\n"
+		"		1 1 0 0 0 1 1 1\n"
+		"	end\n"
+		"end\n"
+		"top: $Quad\n";
+
+	// Files written to a temporary directory, which are removed at the end of the test:
+	class ResolverFixture {
+	public:
+		ResolverFixture() {
+			char path[] = "/tmp/tagged-format-XXXXXX";
+			root = mkdtemp(path);
+
+			std::stringstream input(ResolverMeshText);
+			Buffers::DynamicBuffer mesh, bundle;
+			Parser::serialize(input, mesh);
+
+			write("shared.tfb", mesh);
+			write("other.tfb", mesh);
+
+			BundleWriter bundle_writer(bundle);
+			bundle_writer.append("crate", mesh);
+			bundle_writer.finish();
+			write("bundle.tfb", bundle);
+
+			directories.push_back(root + "/store");
+			directories.push_back(root + "/store/ab");
+			for (auto & directory : directories) mkdir(directory.c_str(), 0700);
+
+			write("store/ab/cdef0123", mesh);
+		}
+
+		~ResolverFixture() {
+			for (auto & file : files) unlink(file.c_str());
+
+			for (auto directory = directories.rbegin(); directory != directories.rend(); ++directory)
+				rmdir(directory->c_str());
+
+			rmdir(root.c_str());
+		}
+
+		std::string root;
+
+		void write(const std::string & name, const Buffers::DynamicBuffer & buffer) {
+			files.push_back(root + "/" + name);
+			buffer.write_to_file(files.back());
+		}
+
+	private:
+		std::vector<std::string> files, directories;
+	};
+
+	static std::vector<OffsetT> parse_externals(const std::string & text, Buffers::DynamicBuffer & buffer) {
+		std::stringstream input(text);
+		Parser::serialize(input, buffer);
+
+		Reader reader(buffer);
+		std::vector<OffsetT> offsets;
+
+		auto table = reader.block_at_offset<OffsetTable>(reader.header()->top_offset);
+		for (auto & entry : *table) offsets.push_back(entry.offset);
+
+		return offsets;
+	}
+
+	UnitTest::Suite ResolverTestSuite {
+		"Test Resolver",
+
+		{"it can follow external references",
+			[](UnitTest::Examiner & examiner) {
+				ResolverFixture fixture;
+				auto cache = std::make_shared<MappedFileCache>(4);
+
+				auto resolver = std::make_shared<CompositeResolver>();
+				resolver->add(std::make_shared<FileResolver>(fixture.root, cache));
+				resolver->add(std::make_shared<ContentStoreResolver>(fixture.root + "/store", cache));
+
+				Buffers::DynamicBuffer buffer;
+				auto offsets = parse_externals(
+					"top: offset-table\n"
+					"	a: external shared.tfb\n"
+					"	b: external bundle.tfb#crate\n"
+					"	c: external cas:abcdef0123\n"
+					"	d: external ../shared.tfb\n"
+					"	e: external missing.tfb\n"
+					"	f: external bundle.tfb#missing\n"
+					"end\n", buffer);
+
+				Reader reader(buffer);
+
+				auto external = reader.block_at_offset<External>(offsets[0]);
+				examiner.check(external);
+				examiner.check_equal(external->location(), "shared.tfb");
+
+				// Without a resolver, nothing is followed:
+				OffsetT offset = offsets[0];
+				examiner.expect(reader.resolve_offset(offset) == nullptr) == true;
+
+				reader.set_resolver(resolver);
+
+				for (std::size_t i = 0; i < 3; i += 1) {
+					offset = offsets[i];
+					Reader * owner = reader.resolve_offset(offset);
+
+					examiner.check(owner);
+					examiner.check(owner != &reader);
+
+					auto mesh = owner->block_at_offset<Mesh>(offset);
+					examiner.check(mesh);
+					examiner.expect(owner->array_at_offset<VertexP3N3M2>(mesh->vertices_offset)->count()) == 4;
+				}
+
+				for (std::size_t i = 3; i < 6; i += 1) {
+					offset = offsets[i];
+					examiner.expect(reader.resolve_offset(offset) == nullptr) == true;
+				}
+
+				// Blocks which are not external are returned as they are:
+				offset = reader.header()->top_offset;
+				examiner.expect(reader.resolve_offset(offset) == &reader) == true;
+			}
+		},
+
+		{"it shares mapped files between readers",
+			[](UnitTest::Examiner & examiner) {
+				ResolverFixture fixture;
+				auto cache = std::make_shared<MappedFileCache>(2);
+
+				auto shared = cache->open(fixture.root + "/shared.tfb");
+				examiner.check(shared != nullptr);
+				examiner.expect(cache->open(fixture.root + "/shared.tfb") == shared) == true;
+
+				auto bundle = cache->open(fixture.root + "/bundle.tfb");
+
+				// Using the shared file makes the bundle the least recently used:
+				cache->open(fixture.root + "/shared.tfb");
+				cache->open(fixture.root + "/other.tfb");
+
+				examiner.expect(cache->size()) == 2;
+				examiner.expect(cache->open(fixture.root + "/shared.tfb") == shared) == true;
+				examiner.expect(cache->open(fixture.root + "/bundle.tfb") == bundle) == false;
+
+				// The evicted mapping is still valid while it is in use:
+				examiner.expect(bundle->size()) > sizeof(Header);
+
+				examiner.expect(cache->open(fixture.root + "/missing.tfb") == nullptr) == true;
+			}
+		},
+	};
+}
@@ -0,0 +1,258 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/SceneGraph.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+#include <random>
+
+namespace TaggedFormat {
+	// The arm is rotated 90 degrees about z, and is shared by both shoulders:
+	const char * SceneGraphText =
+		"Arm: node\n"
+		"	arm 0 1 0 0 -1 0 0 0 0 0 1 0 1 0 0 1\n"
+		"	node\n"
+		"		hand 1 0 0 0 0 1 0 0 0 0 1 0 0 1 0 1\n"
+		"	end\n"
+		"end\n"
+		"Scene: node\n"
+		"	root 1 0 0 0 0 1 0 0 0 0 1 0 0 0 5 1\n"
+		"	node\n"
+		"		left 1 0 0 0 0 1 0 0 0 0 1 0 -2 0 0 1\n"
+		"		$Arm\n"
+		"	end\n"
+		"	node\n"
+		"		right 1 0 0 0 0 1 0 0 0 0 1 0 2 0 0 1\n"
+		"		$Arm\n"
+		"	end\n"
+		"end\n"
+		"top: $Scene\n";
+
+	// A root with 40 children, each of which has 30 children, with random affine transforms:
+	static std::string scene_graph_wide_text() {
+		std::mt19937 generator(11);
+		std::uniform_real_distribution<float32> unit(-1, 1);
+		std::stringstream text;
+
+		auto transform = [&]() {
+			for (std::size_t column = 0; column < 4; column += 1) {
+				for (std::size_t row = 0; row < 3; row += 1)
+					text << " " << unit(generator);
+
+				text << (column == 3 ? " 1" : " 0");
+			}
+
+			text << "\n";
+		};
+
+		text << "Scene: node\n	root";
+		transform();
+
+		for (std::size_t i = 0; i < 40; i += 1) {
+			text << "	node\n		branch";
+			transform();
+
+			for (std::size_t j = 0; j < 30; j += 1) {
+				text << "		node\n			leaf";
+				transform();
+				text << "		end\n";
+			}
+
+			text << "	end\n";
+		}
+
+		text << "end\ntop: $Scene\n";
+
+		return text.str();
+	}
+
+	static void flatten_scene_text(const std::string & text, Buffers::DynamicBuffer & output) {
+		std::stringstream input(text);
+		Buffers::DynamicBuffer buffer;
+		Parser::serialize(input, buffer);
+
+		Pipeline pipeline;
+		pipeline.flatten_scenes = true;
+		pipeline.apply(buffer, output);
+	}
+
+	static bool close_to(float32 a, float32 b) {
+		return std::abs(a - b) < 1e-4 * std::max<float32>(1, std::abs(a));
+	}
+
+	static bool translation_is(const float32 * world, float32 x, float32 y, float32 z) {
+		return close_to(world[12], x) && close_to(world[13], y) && close_to(world[14], z);
+	}
+
+	UnitTest::Suite SceneGraphTestSuite {
+		"Test Scene Graph",
+
+		{"it has the expected layout",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(NodeTransforms)) == 32;
+				examiner.expect(sizeof(NodeTransforms) % NodeTransforms::ALIGNMENT) == 0;
+			}
+		},
+
+		{"it flattens hierarchies in breadth first order",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer output;
+				flatten_scene_text(SceneGraphText, output);
+
+				Reader reader(output);
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+				examiner.check(root);
+
+				auto scene = SceneGraph::scene_for_node(reader, root);
+				examiner.check(scene);
+				examiner.expect(scene->count()) == 7;
+
+				// The shared arm appears once below each shoulder:
+				examiner.expect(scene->begin()[0].offset) == 0;
+				examiner.expect(scene->begin()[3].offset) == scene->begin()[4].offset;
+				examiner.check(reader.block_at_offset<Node>(scene->begin()[5].offset)->name == "hand");
+
+				auto levels = reader.block_at_offset<Array<Index32>>(scene->levels_offset);
+				auto parents = reader.block_at_offset<Array<Index32>>(scene->parents_offset);
+
+				std::vector<uint32_t> level_values, parent_values;
+				for (auto & level : *levels) level_values.push_back(level.value);
+				for (auto & parent : *parents) parent_values.push_back(parent.value);
+
+				examiner.check(level_values == std::vector<uint32_t>({0, 1, 3, 5, 7}));
+				examiner.check(parent_values == std::vector<uint32_t>({0, 0, 0, 1, 2, 3, 4}));
+
+				examiner.expect(scene->transforms_offset % NodeTransforms::ALIGNMENT) == 0;
+
+				auto transforms = reader.block_at_offset<NodeTransforms>(scene->transforms_offset);
+				examiner.expect(transforms->node_count) == 7;
+				examiner.expect(transforms->plane_size) == 8;
+				examiner.check(close_to(transforms->plane(12)[1], -2));
+			}
+		},
+
+		{"it computes world transforms",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer output;
+				flatten_scene_text(SceneGraphText, output);
+
+				Reader reader(output);
+				auto scene = SceneGraph::scene_for_node(reader, reader.block_at_offset<Node>(reader.header()->top_offset));
+
+				SceneTransforms transforms(reader, scene, 2);
+				examiner.expect(transforms.level_count()) == 4;
+				examiner.expect(transforms.update()) == 7;
+
+				// The hand is offset along y, which the arm rotates onto -x:
+				examiner.check(translation_is(transforms.world(3), -1, 0, 5));
+				examiner.check(translation_is(transforms.world(5), -2, 0, 5));
+				examiner.check(translation_is(transforms.world(6), 2, 0, 5));
+			}
+		},
+
+		{"it only recomputes changed subtrees",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer output;
+				flatten_scene_text(SceneGraphText, output);
+
+				Reader reader(output);
+				auto scene = SceneGraph::scene_for_node(reader, reader.block_at_offset<Node>(reader.header()->top_offset));
+
+				SceneTransforms transforms(reader, scene, 2);
+				transforms.update();
+
+				examiner.expect(transforms.update()) == 0;
+
+				float32 local[16];
+				transforms.local(1, local);
+				local[13] = 3;
+				transforms.set_local(1, local);
+
+				// The left shoulder, arm and hand:
+				examiner.expect(transforms.update()) == 3;
+				examiner.check(translation_is(transforms.world(5), -2, 3, 5));
+				examiner.check(translation_is(transforms.world(6), 2, 0, 5));
+
+				// Moving the root moves everything:
+				transforms.local(0, local);
+				local[14] = 0;
+				transforms.set_local(0, local);
+
+				examiner.expect(transforms.update()) == 7;
+				examiner.check(translation_is(transforms.world(6), 2, 0, 0));
+			}
+		},
+
+		{"it matches a scalar product in parallel",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer output;
+				flatten_scene_text(scene_graph_wide_text(), output);
+
+				Reader reader(output);
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+				auto scene = SceneGraph::scene_for_node(reader, root);
+
+				// The last level spans several chunks:
+				SceneTransforms transforms(reader, scene, 3);
+				examiner.expect(transforms.node_count()) == 1241;
+				examiner.expect(transforms.update()) == 1241;
+
+				std::vector<float32> expected(transforms.node_count() * 16);
+				std::size_t mismatches = 0;
+
+				for (std::size_t i = 0; i < transforms.node_count(); i += 1) {
+					auto node = i ? reader.block_at_offset<Node>(scene->begin()[i].offset) : root;
+					const float32 * parent = expected.data() + transforms.parent(i) * 16;
+					float32 * world = expected.data() + i * 16;
+
+					for (std::size_t column = 0; column < 4; column += 1) {
+						for (std::size_t row = 0; row < 4; row += 1) {
+							if (i == 0) {
+								world[column * 4 + row] = node->transform[column * 4 + row];
+							} else {
+								world[column * 4 + row] = 0;
+
+								for (std::size_t k = 0; k < 4; k += 1)
+									world[column * 4 + row] += parent[k * 4 + row] * node->transform[column * 4 + k];
+							}
+						}
+					}
+
+					for (std::size_t element = 0; element < 16; element += 1) {
+						if (!close_to(world[element], transforms.world(i)[element])) mismatches += 1;
+					}
+				}
+
+				examiner.expect(mismatches) == 0;
+			}
+		},
+
+		{"it rejects parents outside the previous level",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer output;
+				flatten_scene_text(SceneGraphText, output);
+
+				Writer writer(output);
+				Reader reader(output);
+				auto scene = SceneGraph::scene_for_node(reader, reader.block_at_offset<Node>(reader.header()->top_offset));
+
+				writer.block_at_offset<Array<Index32>>(scene->parents_offset)->begin()[5].value = 0;
+
+				bool rejected = false;
+
+				try {
+					SceneTransforms transforms(reader, scene);
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+			}
+		},
+	};
+}
@@ -0,0 +1,195 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Simplification.hpp>
+#include <TaggedFormat/BVH.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+
+namespace TaggedFormat {
+	// A grid of quads with the given height function:
+	template <typename HeightT>
+	static void height_field(std::size_t size, HeightT height, std::vector<uint32_t> & indices, std::vector<float32> & positions) {
+		for (std::size_t y = 0; y <= size; y += 1) {
+			for (std::size_t x = 0; x <= size; x += 1) {
+				positions.insert(positions.end(), {float32(x), float32(y), height(x, y)});
+			}
+		}
+
+		for (std::size_t y = 0; y < size; y += 1) {
+			for (std::size_t x = 0; x < size; x += 1) {
+				uint32_t i = static_cast<uint32_t>(y * (size + 1) + x), w = static_cast<uint32_t>(size + 1);
+				indices.insert(indices.end(), {i, i + 1, i + w, i + 1, i + w + 1, i + w});
+			}
+		}
+	}
+
+	// The largest distance from any of the points to the surface of the triangles:
+	static float32 surface_distance(const std::vector<float32> & points, const std::vector<uint32_t> & indices, const std::vector<float32> & positions) {
+		std::vector<BVHNode> nodes;
+		std::vector<BVHTriangle> triangles;
+		BVH::build(indices, positions, nodes, triangles);
+
+		BVH::Tree tree;
+		tree.nodes = nodes.data();
+		tree.node_count = nodes.size();
+		tree.triangles = triangles.data();
+		tree.triangle_count = triangles.size();
+
+		float32 distance = 0;
+
+		for (std::size_t i = 0; i < points.size(); i += 3) {
+			BVH::ClosestPoint result;
+
+			if (BVH::closest_point(tree, &points[i], 1e9f, result))
+				distance = std::max(distance, std::sqrt(result.distance_squared));
+		}
+
+		return distance;
+	}
+
+	// The centroids and edge midpoints of the triangles, where they are furthest from their vertices:
+	static std::vector<float32> surface_samples(const std::vector<uint32_t> & indices, const std::vector<float32> & positions) {
+		std::vector<float32> samples;
+
+		for (std::size_t t = 0; t < indices.size(); t += 3) {
+			const float32 * p[3] = {&positions[indices[t]*3], &positions[indices[t+1]*3], &positions[indices[t+2]*3]};
+
+			for (std::size_t k = 0; k < 3; k += 1)
+				samples.push_back((p[0][k] + p[1][k] + p[2][k]) / 3);
+
+			for (std::size_t j = 0; j < 3; j += 1) {
+				for (std::size_t k = 0; k < 3; k += 1)
+					samples.push_back((p[j][k] + p[(j+1)%3][k]) / 2);
+			}
+		}
+
+		return samples;
+	}
+
+	UnitTest::Suite SimplificationTestSuite {
+		"Test Simplification",
+
+		{"it has the correct size",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(MeshLevel)) == 16;
+			}
+		},
+
+		{"it can simplify a flat grid without error",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices;
+				std::vector<float32> positions;
+				height_field(16, [](std::size_t, std::size_t) {return 0.0f;}, indices, positions);
+
+				auto levels = Simplification::generate_levels(indices, positions, 4);
+				examiner.expect(levels.size()) == 4;
+
+				std::size_t previous = indices.size();
+
+				for (auto & level : levels) {
+					examiner.expect(level.indices.size()) < previous;
+					examiner.expect(level.error) < 1e-3;
+
+					previous = level.indices.size();
+				}
+			}
+		},
+
+		{"it reports increasing error for curved surfaces",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices;
+				std::vector<float32> positions;
+				height_field(24, [](std::size_t x, std::size_t y) {return float32(std::sin(x * 0.4) * std::cos(y * 0.3) * 2);}, indices, positions);
+
+				auto levels = Simplification::generate_levels(indices, positions, 3);
+				examiner.expect(levels.size()) == 3;
+
+				float32 previous = 0;
+
+				for (auto & level : levels) {
+					examiner.expect(level.error) >= previous;
+					previous = level.error;
+
+					for (auto index : level.indices) {
+						examiner.expect(index) < positions.size() / 3;
+					}
+				}
+
+				examiner.expect(levels.back().error) > 0;
+			}
+		},
+
+		{"it reports the distance to the simplified surface",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices;
+				std::vector<float32> positions;
+				height_field(24, [](std::size_t x, std::size_t y) {return float32(std::sin(x * 0.4) * std::cos(y * 0.3) * 2);}, indices, positions);
+
+				auto levels = Simplification::generate_levels(indices, positions, 4);
+				examiner.expect(levels.size()) == 4;
+
+				float32 previous = 0;
+
+				for (auto & level : levels) {
+					// The distance from the original vertices to the simplified surface is the error, which never decreases:
+					float32 removed = surface_distance(positions, level.indices, positions);
+					previous = std::max(previous, removed);
+
+					examiner.expect(std::fabs(level.error - previous)) < 1e-4f;
+
+					// The distance from the simplified surface to the original surface is similar:
+					float32 added = surface_distance(surface_samples(level.indices, positions), indices, positions);
+					examiner.expect(added) <= level.error * 2;
+				}
+			}
+		},
+
+		{"it can select a level by error threshold",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices;
+				std::vector<float32> positions;
+				height_field(12, [](std::size_t x, std::size_t y) {return float32((x * y) % 3);}, indices, positions);
+
+				std::stringstream text;
+				text << "top: mesh triangles\n";
+				text << "	indices: array index32\n";
+				for (auto index : indices) text << "		" << index << "\n";
+				text << "	end\n";
+				text << "	vertices: array vertex-p3n3m2\n";
+				for (std::size_t i = 0; i < positions.size(); i += 3) {
+					text << "		" << positions[i] << " " << positions[i+1] << " " << positions[i+2] << " 0 0 1 0 0\n";
+				}
+				text << "	end\n";
+				text << "end\n";
+
+				Buffers::DynamicBuffer buffer, output;
+				Parser::serialize(text, buffer);
+
+				Pipeline pipeline;
+				pipeline.level_count = 2;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto mesh = reader.block_at_offset<Mesh>(reader.header()->top_offset);
+				examiner.check(mesh);
+
+				auto levels = reader.array_at_offset<MeshLevel>(reader.metadata_offset(mesh, Simplification::METADATA_NAME));
+				examiner.check(levels);
+				examiner.expect(levels->count()) == 2;
+
+				examiner.expect(reader.level_of_detail(mesh, -1)) == mesh->indices_offset;
+				examiner.expect(reader.level_of_detail(mesh, 1e6)) == levels->at(1).indices_offset;
+
+				auto coarsest = reader.array_at_offset<Index16>(levels->at(1).indices_offset);
+				examiner.check(coarsest);
+				examiner.expect(coarsest->count()) == levels->at(1).triangle_count * 3;
+			}
+		},
+	};
+}
@@ -0,0 +1,157 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Skinning.hpp>
+#include <TaggedFormat/Animation.hpp>
+#include <TaggedFormat/BVH.hpp>
+
+#include <cmath>
+#include <random>
+
+namespace TaggedFormat {
+	// Rigid transforms with uniform scale, and vertices influenced by up to four of them:
+	static void skinning_scene(std::size_t bone_count, std::size_t vertex_count, std::vector<float32> & palette, std::vector<VertexP3N3M2B4> & vertices) {
+		std::mt19937 generator(7);
+		std::uniform_real_distribution<float32> unit(-1, 1);
+		std::uniform_int_distribution<int> bone(0, bone_count - 1);
+
+		palette.resize(bone_count * 16);
+
+		for (std::size_t i = 0; i < bone_count; i += 1) {
+			Transform transform = {{unit(generator), unit(generator), unit(generator), 0}, {unit(generator), unit(generator), unit(generator), unit(generator)}, {0, 0, 0, 0}};
+
+			float32 length = std::sqrt(transform.rotation[0] * transform.rotation[0] + transform.rotation[1] * transform.rotation[1] + transform.rotation[2] * transform.rotation[2] + transform.rotation[3] * transform.rotation[3]);
+			for (std::size_t k = 0; k < 4; k += 1) transform.rotation[k] /= length;
+
+			float32 scale = 1 + unit(generator) * 0.5f;
+			for (std::size_t k = 0; k < 3; k += 1) transform.scale[k] = scale;
+
+			Animation::compose(transform, palette.data() + i * 16);
+		}
+
+		vertices.resize(vertex_count);
+
+		for (auto & vertex : vertices) {
+			float32 total = 0;
+
+			for (std::size_t k = 0; k < 3; k += 1) {
+				vertex.position[k] = unit(generator) * 10;
+				vertex.normal[k] = unit(generator);
+			}
+
+			for (std::size_t k = 0; k < 4; k += 1) {
+				vertex.bones[k] = bone(generator);
+				vertex.weights[k] = unit(generator) + 1;
+				total += vertex.weights[k];
+			}
+
+			for (std::size_t k = 0; k < 4; k += 1) vertex.weights[k] /= total;
+		}
+	}
+
+	static std::size_t skinning_mismatches(const std::vector<float32> & expected, const std::vector<float32> & actual) {
+		std::size_t mismatches = 0;
+
+		for (std::size_t i = 0; i < expected.size(); i += 1) {
+			if (std::abs(expected[i] - actual[i]) > 1e-4 * std::max<float32>(1, std::abs(expected[i]))) mismatches += 1;
+		}
+
+		return mismatches;
+	}
+
+	UnitTest::Suite SkinningTestSuite {
+		"Test Skinning",
+
+		{"it matches the scalar reference",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<float32> palette;
+				std::vector<VertexP3N3M2B4> vertices;
+				// Not a multiple of 8, so the last few vertices are skinned one at a time:
+				skinning_scene(40, 5003, palette, vertices);
+
+				std::vector<float32> expected_positions(vertices.size() * 3), expected_normals(vertices.size() * 3);
+				Skinning::skin_reference(palette.data(), 40, vertices.data(), vertices.size(), expected_positions.data(), expected_normals.data());
+
+				std::vector<float32> positions(vertices.size() * 3), normals(vertices.size() * 3);
+				Skinning::skin(palette.data(), 40, vertices.data(), vertices.size(), positions.data(), normals.data());
+
+				examiner.expect(skinning_mismatches(expected_positions, positions)) == 0;
+				examiner.expect(skinning_mismatches(expected_normals, normals)) == 0;
+
+				// The last chunk is partial:
+				Parallel::Pool pool(3);
+				std::vector<float32> parallel_positions(vertices.size() * 3);
+				Skinning::skin(pool, palette.data(), 40, vertices.data(), vertices.size(), parallel_positions.data(), nullptr);
+
+				examiner.expect(skinning_mismatches(expected_positions, parallel_positions)) == 0;
+			}
+		},
+
+		{"it rejects bones outside the palette",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<float32> palette;
+				std::vector<VertexP3N3M2B4> vertices;
+				skinning_scene(4, 10, palette, vertices);
+
+				vertices[5].bones[2] = 4;
+
+				std::vector<float32> positions(vertices.size() * 3);
+				Parallel::Pool pool(2);
+				bool rejected = false;
+
+				try {
+					Skinning::skin(pool, palette.data(), 4, vertices.data(), vertices.size(), positions.data(), nullptr);
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+			}
+		},
+
+		{"it produces positions which can be raycast",
+			[](UnitTest::Examiner & examiner) {
+				// A unit square in the xy plane, moved along z by the second bone:
+				std::vector<VertexP3N3M2B4> vertices(4);
+				float32 corners[4][2] = {{0, 0}, {1, 0}, {0, 1}, {1, 1}};
+
+				for (std::size_t i = 0; i < 4; i += 1) {
+					vertices[i].position[0] = corners[i][0];
+					vertices[i].position[1] = corners[i][1];
+					vertices[i].position[2] = 0;
+					vertices[i].normal[0] = vertices[i].normal[1] = 0;
+					vertices[i].normal[2] = 1;
+
+					for (std::size_t k = 0; k < 4; k += 1) {
+						vertices[i].bones[k] = 1;
+						vertices[i].weights[k] = 0.25;
+					}
+				}
+
+				std::vector<float32> palette = {
+					1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1,
+					1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 5, 1,
+				};
+
+				std::vector<float32> positions(vertices.size() * 3);
+				Skinning::skin(palette.data(), 2, vertices.data(), vertices.size(), positions.data(), nullptr);
+
+				std::vector<BVHNode> nodes;
+				std::vector<BVHTriangle> triangles;
+				BVH::build({0, 1, 2, 2, 1, 3}, positions, nodes, triangles);
+
+				BVH::Tree tree;
+				tree.nodes = nodes.data();
+				tree.node_count = nodes.size();
+				tree.triangles = triangles.data();
+				tree.triangle_count = triangles.size();
+
+				float32 origin[3] = {0.25, 0.25, 10}, direction[3] = {0, 0, -1};
+				BVH::Hit hit;
+
+				examiner.check(BVH::raycast(tree, origin, direction, 100, hit));
+				examiner.check(std::abs(hit.distance - 5) < 1e-4);
+			}
+		},
+	};
+}
@@ -0,0 +1,205 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/SpatialIndex.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <set>
+
+namespace TaggedFormat {
+	// A grid of 10x10 instances of a unit quad, 4 units apart in the x-z plane, in front of the origin:
+	static std::string spatial_index_scene_text() {
+		std::stringstream text;
+
+		text <<
+			"Quad-mesh: mesh triangles\n"
+			"	indices: array index16\n"
+			"		0 1 2 2 1 3\n"
+			"	end\n"
+			"	vertices: array vertex-p3n3m2\n"
+			"		0 0 0 0 1 0 0 0\n"
+			"		1 0 0 0 1 0 1 0\n"
+			"		0 0 1 0 1 0 0 1\n"
+			"		1 0 1 0 1 0 1 1\n"
+			"	end\n"
+			"end\n"
+			"Scene: node\n"
+			"	root 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n";
+
+		for (std::size_t i = 0; i < 10; i += 1) {
+			for (std::size_t j = 0; j < 10; j += 1) {
+				text << "	node\n";
+				text << "		cell 1 0 0 0 0 1 0 0 0 0 1 0 " << (float(i) * 4 - 20) << " 0 " << (-float(j) * 4 - 2) << " 1\n";
+				text << "		geometry-instance\n			mesh: $Quad-mesh\n		end\n";
+				text << "	end\n";
+			}
+		}
+
+		text << "end\ntop: $Scene\n";
+
+		return text.str();
+	}
+
+	UnitTest::Suite SpatialIndexTestSuite {
+		"Test Spatial Index",
+
+		{"it has the expected layout",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(SceneInstance)) == 100;
+			}
+		},
+
+		{"it can query visible instances",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(spatial_index_scene_text());
+				Buffers::DynamicBuffer buffer, output;
+
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.build_scene_index = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+				examiner.check(root);
+
+				SpatialIndex::Tree tree;
+				examiner.expect(SpatialIndex::tree_for_node(reader, root, tree)) == true;
+				examiner.expect(tree.instance_count) == 100;
+
+				// A perspective projection with a 90 degree field of view, looking down -z:
+				float32 near = 1, far = 25;
+				float32 view[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+				float32 projection[16] = {
+					1, 0, 0, 0,
+					0, 1, 0, 0,
+					0, 0, (far + near) / (near - far), -1,
+					0, 0, 2 * far * near / (near - far), 0
+				};
+
+				SpatialIndex::Frustum frustum;
+				SpatialIndex::frustum_from_matrices(view, projection, frustum);
+
+				std::vector<const SceneInstance *> visible;
+				SpatialIndex::visible_instances(tree, frustum, visible);
+
+				// Compare with testing every instance:
+				std::set<const SceneInstance *> expected;
+
+				for (std::size_t i = 0; i < tree.instance_count; i += 1) {
+					auto & instance = tree.instances[i];
+					bool inside = true;
+
+					for (auto & plane : frustum.planes) {
+						float32 x = plane[0] >= 0 ? instance.maximum[0] : instance.minimum[0];
+						float32 y = plane[1] >= 0 ? instance.maximum[1] : instance.minimum[1];
+						float32 z = plane[2] >= 0 ? instance.maximum[2] : instance.minimum[2];
+
+						if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0) inside = false;
+					}
+
+					if (inside) expected.insert(&instance);
+				}
+
+				examiner.expect(visible.size()) == std::set<const SceneInstance *>(visible.begin(), visible.end()).size();
+				examiner.expect(visible.size()) < tree.instance_count;
+
+				std::size_t found = 0;
+				for (auto instance : visible)
+					if (expected.count(instance)) found += 1;
+
+				examiner.expect(found) == visible.size();
+				examiner.expect(visible.size()) == expected.size();
+
+				// In front of the camera, and far off to one side:
+				bool center = false, side = false;
+
+				for (auto instance : visible) {
+					if (instance->transform[12] == 0 && instance->transform[14] == -10) center = true;
+					if (instance->transform[12] == -20 && instance->transform[14] == -2) side = true;
+				}
+
+				examiner.expect(center) == true;
+				examiner.expect(side) == false;
+
+				for (auto instance : visible) {
+					auto geometry_instance = reader.block_at_offset<GeometryInstance>(instance->instance_offset);
+					examiner.check(geometry_instance);
+				}
+			}
+		},
+
+		{"it can query instances in a region",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(spatial_index_scene_text());
+				Buffers::DynamicBuffer buffer, output;
+
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.compute_bounds = true;
+				pipeline.build_scene_index = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+
+				SpatialIndex::Tree tree;
+				examiner.expect(SpatialIndex::tree_for_node(reader, root, tree)) == true;
+
+				// Covers the first two columns of the first three rows:
+				float32 minimum[3] = {-20.5f, -1, -11.5f}, maximum[3] = {-15.5f, 1, -1.5f};
+
+				std::vector<const SceneInstance *> instances;
+				SpatialIndex::instances_in_box(tree, minimum, maximum, instances);
+
+				examiner.expect(instances.size()) == 6;
+
+				for (auto instance : instances) {
+					examiner.expect(instance->transform[12]) <= -16;
+				}
+			}
+		},
+
+		{"it indexes meshes which were split",
+			[](UnitTest::Examiner & examiner) {
+				// A mesh with more vertices than 16-bit indices can address, made of separate triangles along x:
+				const std::size_t COUNT = 70002;
+				std::stringstream input;
+
+				input << "Large-mesh: mesh triangles\n	indices: array index32\n";
+				for (std::size_t i = 0; i < COUNT; i += 1) input << "		" << i << "\n";
+				input << "	end\n	vertices: array vertex-p3n3m2\n";
+				for (std::size_t i = 0; i < COUNT; i += 1) input << "		" << (i / 3) << " 0 " << (i % 3 == 2) << " 0 1 0 0 0\n";
+				input << "	end\nend\n";
+				input << "top: node\n	root 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n	geometry-instance\n		mesh: $Large-mesh\n	end\nend\n";
+
+				Buffers::DynamicBuffer buffer, output;
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.split_meshes = true;
+				pipeline.build_scene_index = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto root = reader.block_at_offset<Node>(reader.header()->top_offset);
+
+				SpatialIndex::Tree tree;
+				examiner.expect(SpatialIndex::tree_for_node(reader, root, tree)) == true;
+				examiner.expect(tree.instance_count) == 1;
+
+				// The bounds cover every part:
+				examiner.expect(tree.instances[0].minimum[0]) == 0;
+				examiner.expect(tree.instances[0].maximum[0]) == (COUNT - 1) / 3;
+			}
+		},
+	};
+}
@@ -0,0 +1,113 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Streams.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+namespace TaggedFormat {
+	static std::string vertex_mesh_text(std::size_t count) {
+		std::stringstream text;
+
+		text << "top: mesh triangles\n";
+		text << "	vertices: array vertex-p3n3m2\n";
+
+		for (std::size_t i = 0; i < count; i += 1) {
+			text << "		" << i << " " << i * 2 << " " << i * 3 << " 0 1 0 " << i / 10.0 << " 0.5\n";
+		}
+
+		text << "	end\n";
+		text << "end\n";
+
+		return text.str();
+	}
+
+	UnitTest::Suite StreamsTestSuite {
+		"Test Streams",
+
+		{"it has the correct size",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(VertexStream)) == 32;
+				examiner.expect(sizeof(VertexStream) % VertexStream::ALIGNMENT) == 0;
+			}
+		},
+
+		{"it can convert vertices to aligned streams and back",
+			[](UnitTest::Examiner & examiner) {
+				// Not a multiple of 4, to exercise the remainder of each plane:
+				std::stringstream input(vertex_mesh_text(11));
+				Buffers::DynamicBuffer buffer, streams_buffer;
+
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.vertex_streams = true;
+				pipeline.apply(buffer, streams_buffer);
+
+				Reader reader(buffer), streams_reader(streams_buffer);
+
+				auto mesh = reader.block_at_offset<Mesh>(reader.header()->top_offset);
+				auto streams_mesh = streams_reader.block_at_offset<Mesh>(streams_reader.header()->top_offset);
+				examiner.check(streams_mesh);
+
+				auto streams = streams_reader.block_at_offset<VertexStreams>(streams_mesh->vertices_offset);
+				examiner.check(streams);
+				examiner.expect(streams->vertex_count) == 11;
+				examiner.expect(streams->count()) == 3;
+
+				for (auto & reference : *streams) {
+					examiner.expect(reference.offset % VertexStream::ALIGNMENT) == 0;
+				}
+
+				auto position = Streams::stream_for_attribute(streams_reader, streams, VertexStream::Attribute::POSITION);
+				examiner.check(position);
+				examiner.expect(position->components) == 3;
+				examiner.expect(position->plane_size) == 12;
+				examiner.expect(position->plane(0)[10]) == 10;
+				examiner.expect(position->plane(1)[10]) == 20;
+				examiner.expect(position->plane(2)[10]) == 30;
+
+				auto vertices = reader.array_at_offset<VertexP3N3M2>(mesh->vertices_offset);
+				auto interleaved = streams_reader.array_at_offset<VertexP3N3M2>(streams_mesh->vertices_offset);
+				examiner.check(interleaved);
+
+				examiner.expect(interleaved->size) == vertices->size;
+				examiner.check(std::memcmp(vertices, interleaved, vertices->size) == 0);
+			}
+		},
+
+		{"it rejects a vertex count larger than its streams",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(vertex_mesh_text(11));
+				Buffers::DynamicBuffer buffer, streams_buffer;
+
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.vertex_streams = true;
+				pipeline.apply(buffer, streams_buffer);
+
+				Reader reader(streams_buffer);
+				auto mesh = reader.block_at_offset<Mesh>(reader.header()->top_offset);
+				auto streams = const_cast<VertexStreams *>(reader.block_at_offset<VertexStreams>(mesh->vertices_offset));
+				examiner.check(streams);
+
+				// Within the padding of each plane is fine:
+				streams->vertex_count = 12;
+				examiner.expect(Streams::interleaved_size(reader, streams)) == sizeof(Block) + sizeof(VertexP3N3M2) * 12;
+
+				// Beyond it, or so large that the size would overflow, is not:
+				streams->vertex_count = 13;
+				examiner.expect(Streams::interleaved_size(reader, streams)) == 0;
+
+				streams->vertex_count = std::size_t(1) << 62;
+				examiner.expect(Streams::interleaved_size(reader, streams)) == 0;
+
+				examiner.expect(reader.array_at_offset<VertexP3N3M2>(mesh->vertices_offset) == nullptr) == true;
+			}
+		},
+	};
+}
@@ -0,0 +1,195 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Geometry.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/Tangents.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+
+namespace TaggedFormat {
+	// A quad facing up, with u increasing along x and v increasing along z:
+	static const char * TANGENTS_MESH_TEXT =
+		"top: mesh triangles\n"
+		"	indices: array index16\n"
+		"		0 2 1 1 2 3\n"
+		"	end\n"
+		"	vertices: array vertex-p3n3m2\n"
+		"		0 0 0 0 1 0 0 0\n"
+		"		1 0 0 0 1 0 1 0\n"
+		"		0 0 1 0 1 0 0 1\n"
+		"		1 0 1 0 1 0 1 1\n"
+		"	end\n"
+		"end\n";
+
+	static VertexP3N3M2 make_vertex(float32 x, float32 y, float32 z, float32 u, float32 v) {
+		VertexP3N3M2 vertex;
+
+		vertex.position[0] = x, vertex.position[1] = y, vertex.position[2] = z;
+		vertex.normal[0] = 0, vertex.normal[1] = 1, vertex.normal[2] = 0;
+		vertex.mapping[0] = u, vertex.mapping[1] = v;
+
+		return vertex;
+	}
+
+	static std::vector<VertexP3N3M2> quad_vertices(float32 u_direction) {
+		std::vector<VertexP3N3M2> vertices(4);
+
+		for (std::size_t i = 0; i < 4; i += 1) {
+			float32 x = i & 1, z = i >> 1;
+
+			vertices[i] = make_vertex(x, 0, z, x * u_direction, z);
+		}
+
+		return vertices;
+	}
+
+	UnitTest::Suite TangentsTestSuite {
+		"Test Tangents",
+
+		{"it has the correct layout",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(VertexP3N3M2T4)) == 48;
+				examiner.expect(member_offset(&VertexP3N3M2T4::tangent)) == 32;
+			}
+		},
+
+		{"it generates tangents along the texture coordinates",
+			[](UnitTest::Examiner & examiner) {
+				auto tangents = Tangents::generate_tangents(quad_vertices(1), {0, 2, 1, 1, 2, 3});
+
+				examiner.expect(tangents.size()) == 16;
+
+				for (std::size_t i = 0; i < 4; i += 1) {
+					examiner.expect(tangents[i * 4]) == 1;
+					examiner.expect(tangents[i * 4 + 1]) == 0;
+					examiner.expect(tangents[i * 4 + 2]) == 0;
+
+					// cross(normal, tangent) is -z, but v increases along +z:
+					examiner.expect(tangents[i * 4 + 3]) == -1;
+				}
+			}
+		},
+
+		{"it follows mirrored texture coordinates",
+			[](UnitTest::Examiner & examiner) {
+				auto tangents = Tangents::generate_tangents(quad_vertices(-1), {0, 2, 1, 1, 2, 3});
+
+				examiner.expect(tangents[0]) == -1;
+				examiner.expect(tangents[3]) == 1;
+			}
+		},
+
+		{"it generates perpendicular tangents without texture coordinates",
+			[](UnitTest::Examiner & examiner) {
+				auto vertices = quad_vertices(0);
+				auto tangents = Tangents::generate_tangents(vertices, {0, 2, 1, 1, 2, 3, 3, 3, 3});
+
+				bool perpendicular = true;
+
+				for (std::size_t i = 0; i < 4; i += 1) {
+					const float32 * tangent = &tangents[i * 4];
+					float32 length = std::sqrt(tangent[0] * tangent[0] + tangent[1] * tangent[1] + tangent[2] * tangent[2]);
+
+					perpendicular = perpendicular && std::abs(length - 1) < 1e-6f && std::abs(tangent[1]) < 1e-6f;
+				}
+
+				examiner.check(perpendicular);
+			}
+		},
+
+		{"it generates the same tangents for large meshes every time",
+			[](UnitTest::Examiner & examiner) {
+				// A curved grid, large enough to be split between threads:
+				const uint32_t SIZE = 128;
+				std::vector<VertexP3N3M2> vertices;
+				std::vector<uint32_t> triangles;
+
+				for (uint32_t y = 0; y < SIZE; y += 1) {
+					for (uint32_t x = 0; x < SIZE; x += 1) {
+						float32 height = std::sin(x * 0.1f) * std::cos(y * 0.07f);
+						vertices.push_back(make_vertex(x, height, y, x / float32(SIZE), y / float32(SIZE)));
+					}
+				}
+
+				for (uint32_t y = 0; y + 1 < SIZE; y += 1) {
+					for (uint32_t x = 0; x + 1 < SIZE; x += 1) {
+						uint32_t i = y * SIZE + x;
+						triangles.insert(triangles.end(), {i, i + SIZE, i + 1, i + 1, i + SIZE, i + SIZE + 1});
+					}
+				}
+
+				auto first = Tangents::generate_tangents(vertices, triangles);
+				auto second = Tangents::generate_tangents(vertices, triangles);
+
+				examiner.check(first == second);
+
+				bool perpendicular = true;
+
+				for (std::size_t i = 0; i < vertices.size(); i += 1)
+					perpendicular = perpendicular && std::abs(first[i * 4 + 1]) < 1e-5f && first[i * 4] > 0.9f;
+
+				examiner.check(perpendicular);
+			}
+		},
+
+		{"it rejects indices beyond the vertex array",
+			[](UnitTest::Examiner & examiner) {
+				bool rejected = false;
+
+				try {
+					Tangents::generate_tangents(quad_vertices(1), {0, 1, 4});
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+			}
+		},
+
+		{"it converts meshes in the pipeline",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(TANGENTS_MESH_TEXT);
+				Buffers::DynamicBuffer buffer, output;
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.generate_tangents = true;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto mesh = reader.block_at_offset<Mesh>(reader.header()->top_offset);
+				auto vertices = reader.block_at_offset<Array<VertexP3N3M2T4>>(mesh->vertices_offset);
+
+				examiner.check(vertices);
+				examiner.expect(vertices->count()) == 4;
+				examiner.expect(vertices->begin()[3].mapping[0]) == 1;
+				examiner.expect(vertices->begin()[3].tangent[0]) == 1;
+				examiner.expect(vertices->begin()[3].tangent[3]) == -1;
+			}
+		},
+
+		{"it parses tangent vertices",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(
+					"top: array vertex-p3n3m2t4\n"
+					"	0 0 0 0 1 0 0 0 1 0 0 -1\n"
+					"end\n"
+				);
+				Buffers::DynamicBuffer buffer;
+				Parser::serialize(input, buffer);
+
+				Reader reader(buffer);
+				auto vertices = reader.block_at_offset<Array<VertexP3N3M2T4>>(reader.header()->top_offset);
+
+				examiner.check(vertices);
+				examiner.expect(vertices->count()) == 1;
+				examiner.expect(vertices->begin()[0].tangent[3]) == -1;
+			}
+		},
+	};
+}
@@ -0,0 +1,119 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Topology.hpp>
+#include <TaggedFormat/Geometry.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/Table.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace TaggedFormat {
+	static std::vector<std::array<uint32_t, 3>> normalized_triangles(const std::vector<uint32_t> & indices) {
+		std::vector<std::array<uint32_t, 3>> triangles;
+
+		for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+			std::array<uint32_t, 3> triangle{{indices[i], indices[i+1], indices[i+2]}};
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(triangle);
+		}
+
+		std::sort(triangles.begin(), triangles.end());
+
+		return triangles;
+	}
+
+	const char * QuadMeshText =
+		"top: mesh triangles\n"
+		"	indices: array index32\n"
+		"		0 1 2 2 1 3\n"
+		"	end\n"
+		"	vertices: array vertex-p3n3\n"
+		"		0 0 0 0 0 1\n"
+		"		1 0 0 0 0 1\n"
+		"		0 1 0 0 0 1\n"
+		"		1 1 0 0 0 1\n"
+		"	end\n"
+		"end\n";
+
+	UnitTest::Suite TopologyTestSuite {
+		"Test Topology",
+
+		{"it can convert triangles to strips and back",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> triangles;
+				std::size_t size = 8;
+
+				for (uint32_t y = 0; y < size; y += 1) {
+					for (uint32_t x = 0; x < size; x += 1) {
+						uint32_t i = y * (size + 1) + x;
+						triangles.insert(triangles.end(), {i, i + 1, uint32_t(i + size + 1), i + 1, uint32_t(i + size + 2), uint32_t(i + size + 1)});
+					}
+				}
+
+				auto strip = Topology::strip_from_triangles(triangles);
+				examiner << "Strip has " << strip.size() << " indices, list has " << triangles.size() << std::endl;
+				examiner.expect(strip.size()) < triangles.size();
+
+				auto expanded = Topology::triangles_from_strip(strip);
+				examiner.check(normalized_triangles(expanded) == normalized_triangles(triangles));
+			}
+		},
+
+		{"it can narrow indices",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(QuadMeshText);
+				Buffers::DynamicBuffer buffer;
+
+				Parser::serialize(input, buffer);
+
+				Writer writer(buffer);
+				OffsetT mesh_offset = writer.header()->top_offset;
+				examiner.check(Topology::narrow_indices(writer, mesh_offset));
+
+				Reader reader(buffer);
+				auto mesh = reader.block_at_offset<Mesh>(mesh_offset);
+				auto indices = reader.array_at_offset<Index16>(mesh->indices_offset);
+				examiner.check(indices);
+				examiner.expect(indices->count()) == 6;
+				examiner.expect(indices->at(5).value) == 3;
+			}
+		},
+
+		{"it can split meshes by vertex count",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(QuadMeshText);
+				Buffers::DynamicBuffer buffer;
+
+				Parser::serialize(input, buffer);
+
+				Writer writer(buffer);
+				OffsetT table_offset = Topology::split_mesh(writer, writer.header()->top_offset, 3);
+				examiner.check(table_offset != 0);
+
+				Reader reader(buffer);
+				auto table = reader.block_at_offset<OffsetTable>(table_offset);
+				examiner.check(table);
+				examiner.expect(table->count()) == 2;
+
+				auto part = reader.block_at_offset<Mesh>(table->offset_named("1"));
+				examiner.check(part);
+
+				auto indices = reader.array_at_offset<Index16>(part->indices_offset);
+				auto vertices = reader.array_at_offset<VertexP3N3>(part->vertices_offset);
+				examiner.expect(indices->count()) == 3;
+				examiner.expect(vertices->count()) == 3;
+
+				// The second triangle (2, 1, 3) is remapped to its own vertices:
+				examiner.expect(indices->at(0).value) == 0;
+				examiner.expect(vertices->at(0).position[1]) == 1.0f;
+				examiner.expect(vertices->at(2).position[0]) == 1.0f;
+				examiner.expect(vertices->at(2).position[1]) == 1.0f;
+			}
+		},
+	};
+}
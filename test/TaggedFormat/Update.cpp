@@ -0,0 +1,356 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/Update.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+#include <Buffers/File.hpp>
+
+#include <cstdlib>
+#include <unistd.h>
+
+namespace TaggedFormat {
+	const char * UpdateSceneText =
+		"Quad: mesh triangles\n"
+		"	indices: array index16\n"
+		"		0 1 2 2 1 3\n"
+		"	end\n"
+		"	vertices: array vertex-p3n3m2\n"
+		"		0 0 0 0 0 1 0 0\n"
+		"		1 0 0 0 0 1 1 0\n"
+		"		0 1 0 0 0 1 0 1\n"
+		"		1 1 0 0 0 1 1 1\n"
+		"	end\n"
+		"end\n"
+		"top: offset-table\n"
+		"	quad: $Quad\n"
+		"	other: $Quad\n"
+		"end\n";
+
+	static void convert_update_scene(Buffers::DynamicBuffer & output, bool checksums) {
+		std::stringstream input(UpdateSceneText);
+		Buffers::DynamicBuffer buffer;
+
+		Pipeline pipeline;
+		pipeline.checksums = checksums;
+
+		Parser::serialize(input, buffer);
+		pipeline.apply(buffer, output);
+	}
+
+	static const Mesh * quad_mesh(Reader & reader) {
+		return reader.block_at_offset<Mesh>(reader.asset_offset("quad"));
+	}
+
+	UnitTest::Suite UpdateTestSuite {
+		"Test Update",
+
+		{"it has the expected layout",
+			[](UnitTest::Examiner & examiner) {
+				examiner.expect(sizeof(Generation)) == 44;
+			}
+		},
+
+		{"it appends only the changed blocks and their parents",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer buffer;
+				convert_update_scene(buffer, true);
+
+				std::vector<Byte> original(buffer.begin(), buffer.begin() + buffer.size());
+
+				OffsetT mesh_offset, vertices_offset;
+				std::size_t checksum_count;
+
+				{
+					Reader reader(buffer);
+					examiner.expect(reader.generation() == nullptr) == true;
+
+					mesh_offset = reader.asset_offset("quad");
+					vertices_offset = quad_mesh(reader)->vertices_offset;
+					checksum_count = reader.checksum_count();
+				}
+
+				Updater updater(buffer);
+
+				auto vertices = updater.replace<Array<VertexP3N3M2>>(vertices_offset);
+				for (auto & vertex : **vertices) vertex.position[2] = 5;
+
+				OffsetT generation_offset = updater.commit();
+				examiner.expect(generation_offset % Generation::ALIGNMENT) == 0;
+
+				// The original file is untouched:
+				examiner.check(std::equal(original.begin(), original.end(), buffer.begin()));
+
+				// The vertices, the mesh and the table are appended, but not the indices:
+				auto vertices_size = reinterpret_cast<const Block *>(buffer + vertices_offset)->size;
+				auto mesh_size = reinterpret_cast<const Block *>(buffer + mesh_offset)->size;
+				auto table_size = reinterpret_cast<const Block *>(buffer + reinterpret_cast<const Header *>(buffer.begin())->top_offset)->size;
+				// Only the checksums of the new blocks are appended:
+				auto checksums_size = 3 * sizeof(BlockChecksum) + sizeof(Block) + sizeof(ChecksumTrailer);
+
+				examiner.expect(buffer.size() - original.size()) <= vertices_size + mesh_size + table_size + checksums_size + Generation::ALIGNMENT * 3 + sizeof(Generation);
+
+				Reader reader(buffer);
+
+				auto generation = reader.generation();
+				examiner.check(generation != nullptr);
+				examiner.expect(generation->number) == 1;
+				examiner.expect(generation->previous_offset) == 0;
+
+				examiner.expect(reader.verify_all().size()) == 0;
+				examiner.expect(reader.checksum_count()) == checksum_count + 3;
+
+				auto mesh = quad_mesh(reader);
+				examiner.check(mesh);
+				examiner.expect(reader.asset_offset("quad") > mesh_offset) == true;
+				examiner.expect(reader.asset_offset("other")) == reader.asset_offset("quad");
+
+				auto updated = reader.array_at_offset<VertexP3N3M2>(mesh->vertices_offset);
+				examiner.check(updated);
+				examiner.expect(updated->begin()[3].position[2]) == 5;
+
+				// Unchanged blocks are shared with the previous generation:
+				examiner.expect(mesh->indices_offset) == reinterpret_cast<const Mesh *>(buffer + mesh_offset)->indices_offset;
+			}
+		},
+
+		{"it chains the checksums of each generation",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer buffer;
+				convert_update_scene(buffer, true);
+
+				std::size_t checksum_count = Reader(buffer).checksum_count();
+				OffsetT first_checksums_offset = 0;
+
+				Updater updater(buffer);
+
+				for (std::size_t i = 0; i < 2; i += 1) {
+					OffsetT mesh_offset = reinterpret_cast<const OffsetTable *>(buffer + updater.top_offset())->offset_named("quad");
+					OffsetT vertices_offset = reinterpret_cast<const Mesh *>(buffer + mesh_offset)->vertices_offset;
+
+					auto vertices = updater.replace<Array<VertexP3N3M2>>(vertices_offset);
+					for (auto & vertex : **vertices) vertex.position[2] = i + 1;
+
+					updater.commit();
+
+					if (i == 0) first_checksums_offset = Update::checksums_offset(buffer);
+				}
+
+				// The second directory only contains the blocks of the second generation, and refers to the first directory:
+				OffsetT checksums_offset = Update::checksums_offset(buffer);
+				auto trailer = reinterpret_cast<const ChecksumTrailer *>(buffer + checksums_offset);
+				auto directory = reinterpret_cast<const Array<BlockChecksum> *>(buffer + trailer->directory_offset);
+
+				examiner.expect(directory->count()) == 3;
+				examiner.expect(trailer->previous_offset) == first_checksums_offset;
+
+				Reader reader(buffer);
+				examiner.expect(reader.checksum_count()) == checksum_count + 6;
+				examiner.expect(reader.verify_all().size()) == 0;
+
+				// Blocks of every generation are verified:
+				OffsetT indices_offset = quad_mesh(reader)->indices_offset;
+				buffer.begin()[indices_offset + sizeof(Block)] ^= 1;
+
+				Reader corrupted(buffer);
+				examiner.expect(corrupted.verify(indices_offset)) == false;
+				examiner.expect(corrupted.verify_all().size()) == 1;
+			}
+		},
+
+		{"it can add assets to the top offset table",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer buffer, asset;
+				convert_update_scene(buffer, true);
+				convert_update_scene(asset, false);
+
+				OffsetT quad_offset = Reader(buffer).asset_offset("quad");
+
+				Updater updater(buffer);
+
+				OffsetT top_offset = updater.append_file(asset);
+				OffsetT mesh_offset = reinterpret_cast<const OffsetTable *>(buffer + top_offset)->offset_named("quad");
+
+				updater.set_asset("added", mesh_offset);
+				updater.set_asset("other", 0);
+				updater.commit();
+
+				Reader reader(buffer);
+				examiner.expect(reader.verify_all().size()) == 0;
+				examiner.expect(reader.asset_offset("quad")) == quad_offset;
+				examiner.expect(reader.asset_offset("added")) == mesh_offset;
+				examiner.expect(reader.asset_offset("other")) == 0;
+
+				auto mesh = reader.block_at_offset<Mesh>(mesh_offset);
+				examiner.check(mesh != nullptr);
+				examiner.check(reader.array_at_offset<VertexP3N3M2>(mesh->vertices_offset) != nullptr);
+
+				bool rejected = false;
+
+				try {
+					updater.set_asset("", mesh_offset);
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+			}
+		},
+
+		{"it chains generations and falls back from an incomplete generation",
+			[](UnitTest::Examiner & examiner) {
+				Buffers::DynamicBuffer buffer;
+				convert_update_scene(buffer, false);
+
+				OffsetT base_top_offset = reinterpret_cast<const Header *>(buffer.begin())->top_offset;
+				OffsetT first, second;
+
+				{
+					Updater updater(buffer);
+
+					// Replace the mesh by a new block:
+					OffsetT mesh_offset = Update::top_offset(buffer);
+					mesh_offset = reinterpret_cast<const OffsetTable *>(buffer + mesh_offset)->offset_named("quad");
+
+					OffsetT replacement = updater.writer().copy(reinterpret_cast<const Block *>(buffer + mesh_offset));
+					updater.replace(mesh_offset, replacement);
+
+					first = updater.commit();
+				}
+
+				{
+					Updater updater(buffer);
+
+					// Remove one of the entries from the table:
+					auto table = updater.replace<OffsetTable>(Update::top_offset(buffer));
+
+					for (auto & entry : **table) {
+						if (entry.match("other")) entry.offset = 0;
+					}
+
+					second = updater.commit();
+				}
+
+				{
+					Reader reader(buffer);
+
+					auto generation = reader.generation();
+					examiner.check(generation != nullptr);
+					examiner.expect(generation->number) == 2;
+					examiner.expect(reinterpret_cast<const Byte *>(generation) - buffer.begin()) == second;
+					examiner.expect(generation->previous_offset) == first;
+					examiner.expect(reader.checksum_count()) == 0;
+
+					examiner.expect(reader.asset_offset("other")) == 0;
+					examiner.check(quad_mesh(reader) != nullptr);
+				}
+
+				// An incomplete generation is not used, and the copy of the previous generation which precedes it is used instead:
+				buffer.begin()[buffer.size() - 1] ^= 1;
+
+				{
+					Reader reader(buffer);
+
+					auto generation = reader.generation();
+					examiner.check(generation != nullptr);
+					examiner.expect(generation->number) == 1;
+					examiner.expect(reader.asset_offset("other")) == reader.asset_offset("quad");
+				}
+
+				// The same happens if the file was truncated while writing the generation:
+				{
+					Buffers::DynamicBuffer truncated;
+					truncated.resize(buffer.size() - 8);
+					std::copy(buffer.begin(), buffer.begin() + truncated.size(), truncated.begin());
+
+					Reader reader(truncated);
+					examiner.check(reader.generation() != nullptr);
+					examiner.expect(reader.generation()->number) == 1;
+				}
+
+				// Without any valid generation, the header is used:
+				{
+					Buffers::DynamicBuffer truncated;
+					truncated.resize(first - Generation::ALIGNMENT);
+					std::copy(buffer.begin(), buffer.begin() + truncated.size(), truncated.begin());
+
+					Reader reader(truncated);
+
+					examiner.expect(reader.generation() == nullptr) == true;
+					examiner.expect(reader.header()->top_offset) == base_top_offset;
+				}
+
+				bool rejected = false;
+
+				try {
+					Buffers::DynamicBuffer invalid;
+					invalid.resize(4);
+
+					Updater updater(invalid);
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+			}
+		},
+
+		{"it can publish updates to a file",
+			[](UnitTest::Examiner & examiner) {
+				char path[] = "/tmp/tagged-format-XXXXXX";
+				int descriptor = mkstemp(path);
+				close(descriptor);
+
+				Buffers::DynamicBuffer buffer;
+				convert_update_scene(buffer, true);
+				buffer.write_to_file(path);
+
+				Updater updater(buffer);
+
+				OffsetT mesh_offset = reinterpret_cast<const OffsetTable *>(buffer + Update::top_offset(buffer))->offset_named("quad");
+				auto mesh = updater.replace<Mesh>(mesh_offset);
+				mesh->axes_offset = 0;
+
+				updater.commit();
+				updater.publish(path);
+
+				// Publishing again has nothing to write:
+				updater.publish(path);
+
+				Buffers::File file(path);
+
+				file.read([&](Buffers::Buffer & published) {
+					examiner.expect(published.size()) == buffer.size();
+					examiner.check(std::equal(buffer.begin(), buffer.begin() + buffer.size(), published.begin()));
+
+					Reader reader(published);
+					examiner.check(reader.generation() != nullptr);
+					examiner.expect(reader.verify_all().size()) == 0;
+				});
+
+				// The file no longer matches the original buffer:
+				Buffers::DynamicBuffer stale;
+				convert_update_scene(stale, true);
+
+				Updater stale_updater(stale);
+				stale_updater.replace<Mesh>(mesh_offset);
+				stale_updater.commit();
+
+				bool rejected = false;
+
+				try {
+					stale_updater.publish(path);
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+
+				unlink(path);
+			}
+		},
+	};
+}
@@ -0,0 +1,126 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/VertexCache.hpp>
+#include <TaggedFormat/Geometry.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Reader.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace TaggedFormat {
+	// A grid of quads with the rows visited in a scattered order, which gives poor cache reuse:
+	static std::vector<uint32_t> scattered_grid_indices(std::size_t size) {
+		std::vector<uint32_t> indices;
+
+		for (std::size_t k = 0; k < size; k += 1) {
+			std::size_t y = (k * 7) % size;
+
+			for (std::size_t x = 0; x < size; x += 1) {
+				uint32_t i = y * (size + 1) + x;
+				indices.insert(indices.end(), {i, i + 1, uint32_t(i + size + 1), i + 1, uint32_t(i + size + 2), uint32_t(i + size + 1)});
+			}
+		}
+
+		return indices;
+	}
+
+	static std::vector<std::array<uint32_t, 3>> sorted_triangles(const std::vector<uint32_t> & indices) {
+		std::vector<std::array<uint32_t, 3>> triangles;
+
+		for (std::size_t i = 0; i < indices.size(); i += 3) {
+			std::array<uint32_t, 3> triangle{{indices[i], indices[i+1], indices[i+2]}};
+
+			// Normalize the rotation, which does not change the triangle:
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(triangle);
+		}
+
+		std::sort(triangles.begin(), triangles.end());
+
+		return triangles;
+	}
+
+	UnitTest::Suite VertexCacheTestSuite {
+		"Test Vertex Cache",
+
+		{"it can analyze a triangle list",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices = {0, 1, 2, 2, 1, 3};
+				auto statistics = VertexCache::analyze(indices, 4);
+
+				examiner.expect(statistics.acmr) == 2.0;
+				examiner.expect(statistics.atvr) == 1.0;
+			}
+		},
+
+		{"it reduces cache misses without changing triangles",
+			[](UnitTest::Examiner & examiner) {
+				std::size_t size = 32, vertex_count = (size + 1) * (size + 1);
+				auto indices = scattered_grid_indices(size);
+
+				auto before = VertexCache::analyze(indices, vertex_count);
+				auto optimized = VertexCache::optimize(indices, vertex_count);
+				auto after = VertexCache::analyze(optimized, vertex_count);
+
+				examiner << "ACMR " << before.acmr << " -> " << after.acmr << std::endl;
+				examiner.expect(after.acmr) < before.acmr;
+
+				examiner.check(sorted_triangles(indices) == sorted_triangles(optimized));
+			}
+		},
+
+		{"it orders vertices by first use",
+			[](UnitTest::Examiner & examiner) {
+				std::vector<uint32_t> indices = {3, 1, 2};
+				auto remap = VertexCache::fetch_order(indices, 5);
+
+				examiner.expect(remap[3]) == 0;
+				examiner.expect(remap[1]) == 1;
+				examiner.expect(remap[2]) == 2;
+				examiner.expect(remap[0]) == 3;
+				examiner.expect(remap[4]) == 4;
+			}
+		},
+
+		{"it can optimize a mesh in place",
+			[](UnitTest::Examiner & examiner) {
+				const char * text =
+					"top: mesh triangles\n"
+					"	indices: array index16\n"
+					"		2 1 0 3 2 0\n"
+					"	end\n"
+					"	vertices: array vertex-p3n3\n"
+					"		0 0 0 0 0 1\n"
+					"		1 0 0 0 0 1\n"
+					"		1 1 0 0 0 1\n"
+					"		0 1 0 0 0 1\n"
+					"	end\n"
+					"end\n";
+
+				std::stringstream input(text);
+				Buffers::DynamicBuffer buffer;
+
+				Parser::serialize(input, buffer);
+
+				Writer writer(buffer);
+				auto report = VertexCache::optimize_mesh(writer, writer.header()->top_offset);
+				examiner.expect(report.after.acmr) <= report.before.acmr;
+
+				Reader reader(buffer);
+				auto mesh = reader.block_at_offset<Mesh>(reader.header()->top_offset);
+				auto indices = reader.array_at_offset<Index16>(mesh->indices_offset);
+				auto vertices = reader.array_at_offset<VertexP3N3>(mesh->vertices_offset);
+
+				examiner.expect(indices->at(0).value) == 0;
+
+				// The first vertex referenced was originally vertex 2:
+				examiner.expect(vertices->at(0).position[0]) == 1.0f;
+				examiner.expect(vertices->at(0).position[1]) == 1.0f;
+			}
+		},
+	};
+}
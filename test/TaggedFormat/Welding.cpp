@@ -0,0 +1,146 @@
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <TaggedFormat/Geometry.hpp>
+#include <TaggedFormat/Parser.hpp>
+#include <TaggedFormat/Pipeline.hpp>
+#include <TaggedFormat/Reader.hpp>
+#include <TaggedFormat/Welding.hpp>
+
+#include <Buffers/DynamicBuffer.hpp>
+
+#include <cmath>
+
+namespace TaggedFormat {
+	// Two quads which share an edge, with every vertex of the shared edge duplicated, one of them slightly moved and one of them with different texture coordinates:
+	static const char * WELDING_MESH_TEXT =
+		"top: mesh triangles\n"
+		"	indices: array index16\n"
+		"	0 1 2 2 1 3 4 5 6 6 5 7\n"
+		"	end\n"
+		"	vertices: array vertex-p3n3m2\n"
+		"		0 0 0 0 1 0 0 0\n"
+		"		1 0 0 0 1 0 1 0\n"
+		"		0 0 1 0 1 0 0 1\n"
+		"		1 0 1 0 1 0 1 1\n"
+		"		1.000001 0 0 0 1 0 1 0\n"
+		"		2 0 0 0 1 0 0 0\n"
+		"		1 0 1 0 1 0 0 1\n"
+		"		2 0 1 0 1 0 0 1\n"
+		"	end\n"
+		"end\n";
+
+	UnitTest::Suite WeldingTestSuite {
+		"Test Welding",
+
+		{"it merges duplicates within the tolerance",
+			[](UnitTest::Examiner & examiner) {
+				const float32 components[] = {
+					0, 0, 0,
+					1, 0, 0,
+					0, 0, 0,
+					1.001f, 0, 0,
+					1.0004f, 0, 0,
+				};
+
+				auto remap = Welding::weld(components, 3, 5, 0.0005f);
+
+				examiner.check(remap == std::vector<uint32_t>({0, 1, 0, 2, 1}));
+
+				// Without tolerance, only exact duplicates are merged:
+				remap = Welding::weld(components, 3, 5, 0);
+				examiner.check(remap == std::vector<uint32_t>({0, 1, 0, 2, 3}));
+			}
+		},
+
+		{"it never merges vertices further apart than the tolerance",
+			[](UnitTest::Examiner & examiner) {
+				// The second vertex is within the tolerance of the first and third vertices, which are not within the tolerance of each other:
+				const float32 components[] = {0, 0.75f, 1.5f};
+
+				auto remap = Welding::weld(components, 1, 3, 1);
+
+				examiner.check(remap == std::vector<uint32_t>({0, 0, 1}));
+			}
+		},
+
+		{"it compares exact components bit for bit",
+			[](UnitTest::Examiner & examiner) {
+				uint32_t bones[] = {0x01000000, 0x01000001};
+				float32 components[6] = {0, 0, 0, 0, 0, 0};
+
+				std::memcpy(components + 2, bones, sizeof(uint32_t));
+				std::memcpy(components + 5, bones + 1, sizeof(uint32_t));
+
+				examiner.check(Welding::weld(components, 3, 2, 0.5f) == std::vector<uint32_t>({0, 0}));
+				examiner.check(Welding::weld(components, 3, 2, 0.5f, {false, false, true}) == std::vector<uint32_t>({0, 1}));
+			}
+		},
+
+		{"it rejects invalid tolerances",
+			[](UnitTest::Examiner & examiner) {
+				const float32 components[] = {0, 0, 0};
+				bool rejected = false;
+
+				try {
+					Welding::weld(components, 3, 1, -1);
+				} catch (std::invalid_argument &) {
+					rejected = true;
+				}
+
+				examiner.expect(rejected) == true;
+			}
+		},
+
+		{"it welds large arrays in parallel",
+			[](UnitTest::Examiner & examiner) {
+				// A grid of points, each followed by a copy which is moved by less than the tolerance, crossing cell boundaries:
+				const std::size_t SIZE = 200;
+				const float32 tolerance = 0.001f;
+				std::vector<float32> components;
+
+				for (std::size_t y = 0; y < SIZE; y += 1) {
+					for (std::size_t x = 0; x < SIZE; x += 1) {
+						float32 point[3] = {x * 0.01f, y * 0.01f, 0.0005f};
+
+						components.insert(components.end(), point, point + 3);
+						components.insert(components.end(), {point[0] + 0.0009f, point[1] - 0.0009f, point[2] - 0.0009f});
+					}
+				}
+
+				std::size_t count = components.size() / 3;
+				auto remap = Welding::weld(components.data(), 3, count, tolerance);
+
+				bool merged = true;
+
+				for (std::size_t i = 0; i < count; i += 1)
+					merged = merged && remap[i] == i / 2;
+
+				examiner.check(merged);
+			}
+		},
+
+		{"it welds meshes and remaps their indices",
+			[](UnitTest::Examiner & examiner) {
+				std::stringstream input(WELDING_MESH_TEXT);
+				Buffers::DynamicBuffer buffer, output;
+				Parser::serialize(input, buffer);
+
+				Pipeline pipeline;
+				pipeline.weld_tolerance = Welding::DEFAULT_TOLERANCE * 10;
+				pipeline.apply(buffer, output);
+
+				Reader reader(output);
+				auto mesh = reader.block_at_offset<Mesh>(reader.header()->top_offset);
+				auto vertices = reader.block_at_offset<Array<VertexP3N3M2>>(mesh->vertices_offset);
+				auto indices = read_indices(reader.block_at_offset(mesh->indices_offset));
+
+				// The moved vertex is merged, but the vertex with different texture coordinates is kept:
+				examiner.expect(vertices->count()) == 7;
+				examiner.expect(reader.block_at_offset(mesh->indices_offset)->tag) == Index16::TAG;
+				examiner.check(indices == std::vector<uint32_t>({0, 1, 2, 2, 1, 3, 1, 4, 5, 5, 4, 6}));
+				examiner.expect(vertices->begin()[4].position[0]) == 2;
+			}
+		},
+	};
+}